@@ -56,7 +56,16 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
-
+void DMA1_Channel1_IRQHandler(void);
+void ADC1_2_IRQHandler(void);
+void I2C2_EV_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+void DMA1_Channel4_IRQHandler(void);
+void DMA2_Channel4_5_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void USART1_IRQHandler(void);
+void UART4_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -37,14 +37,63 @@ extern UART_HandleTypeDef huart4;
 extern UART_HandleTypeDef huart1;
 
 /* USER CODE BEGIN Private defines */
+/* 每个串口发送环形缓冲区大小（必须为2的幂） */
+#define UART_TX_BUF_SIZE 512U
 
+/**
+ * @结构体名    : UART_TxStats
+ * @描述        : 非阻塞发送通道的统计计数
+ */
+typedef struct
+{
+  uint32_t bytes_sent;     // DMA已发送完成的字节数
+  uint32_t overflow_count; // 因缓冲区空间不足被丢弃的消息数
+  uint32_t dropped_bytes;  // 因缓冲区空间不足被丢弃的字节数
+  uint16_t high_water;     // 缓冲区占用的历史最大值（字节）
+} UART_TxStats;
 /* USER CODE END Private defines */
 
 void MX_UART4_Init(void);
 void MX_USART1_UART_Init(void);
 
 /* USER CODE BEGIN Prototypes */
+/**
+ * @函数名      : UART_TxEnqueue
+ * @描述        : 将数据写入串口发送环形缓冲区并立即返回，由DMA在后台发送
+ * @参数        : huart - 串口句柄（huart1或huart4）
+ *                data - 待发送数据
+ *                len - 数据长度
+ * @返回值      : HAL_OK - 已入队
+ *                HAL_BUSY - 缓冲区剩余空间不足，整条消息被丢弃（计入溢出统计）
+ *                HAL_ERROR - 串口未配置发送通道
+ * @注意事项    : 仅可在主循环上下文中调用（单生产者），不可在中断中调用
+ */
+HAL_StatusTypeDef UART_TxEnqueue(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+
+/**
+ * @函数名      : UART_TxEnqueueStr
+ * @描述        : 将以'\0'结尾的字符串写入串口发送缓冲区
+ * @参数        : huart - 串口句柄
+ *                str - 字符串
+ * @返回值      : 同UART_TxEnqueue
+ */
+HAL_StatusTypeDef UART_TxEnqueueStr(UART_HandleTypeDef *huart, const char *str);
 
+/**
+ * @函数名      : UART_TxPending
+ * @描述        : 获取发送缓冲区中尚未发送完成的字节数
+ * @参数        : huart - 串口句柄
+ * @返回值      : uint16_t - 待发送字节数
+ */
+uint16_t UART_TxPending(UART_HandleTypeDef *huart);
+
+/**
+ * @函数名      : UART_TxGetStats
+ * @描述        : 获取发送通道的统计计数
+ * @参数        : huart - 串口句柄
+ * @返回值      : const UART_TxStats* - 统计计数，串口未配置发送通道时返回NULL
+ */
+const UART_TxStats *UART_TxGetStats(UART_HandleTypeDef *huart);
 /* USER CODE END Prototypes */
 
 #ifdef __cplusplus
@@ -21,7 +21,7 @@
 #include "adc.h"
 
 /* USER CODE BEGIN 0 */
-
+DMA_HandleTypeDef hdma_adc1;
 /* USER CODE END 0 */
 
 ADC_HandleTypeDef hadc1;
@@ -133,7 +133,26 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
   /* USER CODE BEGIN ADC1_MspInit 1 */
-
+    /* ADC1 DMA Init */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hdma_adc1.Instance = DMA1_Channel1;
+    hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_adc1.Init.Mode = DMA_CIRCULAR;
+    hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_adc1) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(adcHandle,DMA_Handle,hdma_adc1);
+
+    /* DMA1_Channel1_IRQn interrupt Init */
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 4, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
   /* USER CODE END ADC1_MspInit 1 */
   }
   else if(adcHandle->Instance==ADC2)
@@ -153,7 +172,9 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
   /* USER CODE BEGIN ADC2_MspInit 1 */
-
+    /* ADC2由TIM3_TRGO触发，转换完成中断读取结果（F1的ADC2无DMA请求） */
+    HAL_NVIC_SetPriority(ADC1_2_IRQn, 4, 0);
+    HAL_NVIC_EnableIRQ(ADC1_2_IRQn);
   /* USER CODE END ADC2_MspInit 1 */
   }
 }
@@ -175,7 +196,8 @@ void HAL_ADC_MspDeInit(ADC_HandleTypeDef* adcHandle)
     HAL_GPIO_DeInit(GPIOC, GPIO_PIN_0);
 
   /* USER CODE BEGIN ADC1_MspDeInit 1 */
-
+    HAL_DMA_DeInit(adcHandle->DMA_Handle);
+    HAL_NVIC_DisableIRQ(DMA1_Channel1_IRQn);
   /* USER CODE END ADC1_MspDeInit 1 */
   }
   else if(adcHandle->Instance==ADC2)
@@ -192,7 +214,7 @@ void HAL_ADC_MspDeInit(ADC_HandleTypeDef* adcHandle)
     HAL_GPIO_DeInit(GPIOC, GPIO_PIN_2);
 
   /* USER CODE BEGIN ADC2_MspDeInit 1 */
-
+    HAL_NVIC_DisableIRQ(ADC1_2_IRQn);
   /* USER CODE END ADC2_MspDeInit 1 */
   }
 }
@@ -0,0 +1,153 @@
+/**
+ * @文件        : adc_acq.c
+ * @描述        : ADC1多通道连续扫描采集引擎实现
+ * @注意事项    : ADC时钟12MHz，采样时间239.5周期，每次转换21us，
+ *                3通道一次扫描约63us；默认每块16次扫描，约1ms抽取一次
+ */
+
+#include "adc_acq.h"
+
+/* 内部参考电压与温度传感器典型参数（STM32F103数据手册） */
+#define VREFINT_MV 1200	  // 内部参考电压(mV)
+#define TEMP_V25_X10 14300 // 25℃时温度传感器输出(0.1mV)
+#define TEMP_SLOPE_X10 43  // 温度系数(0.1mV/℃)
+
+/* 扫描序列，顺序与ADC_Acq_Channel一致 */
+static const uint32_t scan_channels[ADC_ACQ_CH_COUNT] = {
+	ADC_CHANNEL_10,
+	ADC_CHANNEL_TEMPSENSOR,
+	ADC_CHANNEL_VREFINT,
+};
+
+/* DMA双缓冲区与抽取结果 */
+static uint16_t buffer[2][ADC_ACQ_SCANS_PER_BLOCK][ADC_ACQ_CH_COUNT];
+static volatile uint16_t latest[ADC_ACQ_CH_COUNT];
+static volatile uint32_t block_count = 0;
+static ADC_HandleTypeDef *hadc_acq = NULL;
+
+/**
+ * @函数名      : ADC_Acq_Start
+ * @描述        : 将ADC配置为多通道连续扫描并启动循环DMA采集
+ * @参数        : hadc - ADC1句柄
+ * @返回值      : HAL_OK - 启动成功; 其他 - 配置或启动失败
+ * @实现细节    :
+ *   1. 改为扫描+连续转换模式，按scan_channels配置规则组
+ *   2. 执行ADC自校准
+ *   3. 以两个块的总长度启动DMA，DMA为循环模式，半传输和传输完成中断分别对应两个块
+ */
+HAL_StatusTypeDef ADC_Acq_Start(ADC_HandleTypeDef *hadc)
+{
+	ADC_ChannelConfTypeDef sConfig = {0};
+	HAL_StatusTypeDef status;
+
+	hadc_acq = hadc;
+	hadc->Init.ScanConvMode = ADC_SCAN_ENABLE;
+	hadc->Init.ContinuousConvMode = ENABLE;
+	hadc->Init.DiscontinuousConvMode = DISABLE;
+	hadc->Init.ExternalTrigConv = ADC_SOFTWARE_START;
+	hadc->Init.DataAlign = ADC_DATAALIGN_RIGHT;
+	hadc->Init.NbrOfConversion = ADC_ACQ_CH_COUNT;
+	status = HAL_ADC_Init(hadc);
+	if (status != HAL_OK)
+		return status;
+
+	sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5; // 温度传感器要求采样时间大于17.1us
+	for (uint8_t i = 0; i < ADC_ACQ_CH_COUNT; i++)
+	{
+		sConfig.Channel = scan_channels[i];
+		sConfig.Rank = ADC_REGULAR_RANK_1 + i;
+		status = HAL_ADC_ConfigChannel(hadc, &sConfig);
+		if (status != HAL_OK)
+			return status;
+	}
+
+	status = HAL_ADCEx_Calibration_Start(hadc);
+	if (status != HAL_OK)
+		return status;
+
+	return HAL_ADC_Start_DMA(hadc, (uint32_t *)buffer, sizeof(buffer) / sizeof(buffer[0][0][0]));
+}
+
+/**
+ * @函数名      : ADC_Acq_DMA_Callback
+ * @描述        : 半缓冲/全缓冲传输完成处理，对刚填满的块做过采样抽取
+ * @参数        : hadc - 触发回调的ADC句柄
+ *                block - 刚填满的块（0为前半，1为后半）
+ * @返回值      : 无
+ * @实现细节    : DMA此时正在写另一个块，本块内容在下一次回调前保持稳定；
+ *                每通道累加4^n个样本后右移n位，得到12+n位结果
+ */
+void ADC_Acq_DMA_Callback(ADC_HandleTypeDef *hadc, uint8_t block)
+{
+	if (hadc != hadc_acq)
+		return;
+
+	uint32_t sum[ADC_ACQ_CH_COUNT] = {0};
+	for (uint32_t scan = 0; scan < ADC_ACQ_SCANS_PER_BLOCK; scan++)
+	{
+		for (uint8_t ch = 0; ch < ADC_ACQ_CH_COUNT; ch++)
+			sum[ch] += buffer[block][scan][ch];
+	}
+
+	for (uint8_t ch = 0; ch < ADC_ACQ_CH_COUNT; ch++)
+		latest[ch] = (uint16_t)(sum[ch] >> ADC_ACQ_OVERSAMPLE_BITS);
+	block_count++;
+}
+
+/**
+ * @函数名      : ADC_Acq_Get
+ * @描述        : 获取通道最新的过采样结果
+ * @参数        : ch - 通道
+ * @返回值      : uint16_t - 0至ADC_ACQ_FULL_SCALE
+ */
+uint16_t ADC_Acq_Get(ADC_Acq_Channel ch)
+{
+	if (ch >= ADC_ACQ_CH_COUNT)
+		return 0;
+	return latest[ch];
+}
+
+/**
+ * @函数名      : ADC_Acq_GetBlockCount
+ * @描述        : 获取已完成抽取的块数
+ * @参数        : 无
+ * @返回值      : uint32_t - 块计数（回绕）
+ */
+uint32_t ADC_Acq_GetBlockCount(void)
+{
+	return block_count;
+}
+
+/**
+ * @函数名      : ADC_Acq_GetVddMv
+ * @描述        : 根据内部参考电压计算实际的VDDA
+ * @参数        : 无
+ * @返回值      : uint16_t - VDDA(mV)，尚无数据时返回0
+ * @实现细节    : VDDA = 1200mV * 满量程 / Vref读数
+ */
+uint16_t ADC_Acq_GetVddMv(void)
+{
+	const uint32_t vref = latest[ADC_ACQ_CH_VREF];
+	if (vref == 0)
+		return 0;
+	return (uint16_t)((uint32_t)VREFINT_MV * ADC_ACQ_FULL_SCALE / vref);
+}
+
+/**
+ * @函数名      : ADC_Acq_GetTempX10
+ * @描述        : 计算芯片内部温度
+ * @参数        : 无
+ * @返回值      : int16_t - 温度(0.1℃)，尚无数据时返回0
+ * @实现细节    : 以Vref为基准换算传感器电压，消除VDDA波动的影响：
+ *                Vsense = 1200mV * 温度读数 / Vref读数
+ *                T = (V25 - Vsense) / Avg_Slope + 25
+ */
+int16_t ADC_Acq_GetTempX10(void)
+{
+	const uint32_t vref = latest[ADC_ACQ_CH_VREF];
+	if (vref == 0)
+		return 0;
+
+	const int32_t vsense_x10 = (int32_t)((uint32_t)VREFINT_MV * 10U * latest[ADC_ACQ_CH_TEMP] / vref);
+	return (int16_t)((TEMP_V25_X10 - vsense_x10) * 10 / TEMP_SLOPE_X10 + 250);
+}
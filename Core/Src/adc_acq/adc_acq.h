@@ -0,0 +1,104 @@
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : adc_acq.h
+ * @描述        : ADC1多通道连续扫描采集引擎
+ * @注意事项    : ADC1以连续扫描模式依次转换MQ4、内部温度和内部参考电压通道，
+ *                结果经DMA1通道1循环写入双缓冲区；每半个缓冲区填满后在中断中
+ *                对该块做过采样累加并抽取为每通道一个结果，写入共享的最新值表
+ *                各传感器驱动只读取最新值，不再启动转换或轮询等待
+ *
+ *   缓冲区布局（每格16位）：
+ *     [块0: 扫描0 {MQ4, 温度, Vref} 扫描1 {...} ... 扫描N-1]
+ *     [块1: 同上]
+ *   N = 4^ADC_ACQ_OVERSAMPLE_BITS，每块累加N次后右移ADC_ACQ_OVERSAMPLE_BITS位，
+ *   得到12 + ADC_ACQ_OVERSAMPLE_BITS位的结果
+ */
+
+#include "stm32f1xx_hal.h"
+
+/* 过采样增加的分辨率位数（0-4），每增加1位，每块的扫描次数变为4倍 */
+#ifndef ADC_ACQ_OVERSAMPLE_BITS
+#define ADC_ACQ_OVERSAMPLE_BITS 2
+#endif
+
+/* 每块扫描次数与结果满量程 */
+#define ADC_ACQ_SCANS_PER_BLOCK (1U << (2 * ADC_ACQ_OVERSAMPLE_BITS))
+#define ADC_ACQ_FULL_SCALE ((4096U << ADC_ACQ_OVERSAMPLE_BITS) - 1U)
+
+	/**
+	 * @枚举名      : ADC_Acq_Channel
+	 * @描述        : 扫描序列中的通道，顺序与规则组转换顺序一致
+	 */
+	typedef enum
+	{
+		ADC_ACQ_CH_MQ4 = 0, // PC0 ADC_IN10，MQ4甲烷传感器
+		ADC_ACQ_CH_TEMP,	// ADC_IN16，内部温度传感器
+		ADC_ACQ_CH_VREF,	// ADC_IN17，内部参考电压(1.20V)
+		ADC_ACQ_CH_COUNT
+	} ADC_Acq_Channel;
+
+	/**
+	 * @函数名      : ADC_Acq_Start
+	 * @描述        : 将ADC配置为多通道连续扫描并启动循环DMA采集
+	 * @参数        : hadc - ADC1句柄（须已由MX_ADC1_Init初始化并关联DMA）
+	 * @返回值      : HAL_OK - 启动成功; 其他 - 配置或启动失败
+	 * @注意事项    : 启动后前两个块（约2ms）内读取到的值为0
+	 *                粉尘传感器须在LED点亮后的固定时刻采样，不在此扫描序列中，见gp2y1014au
+	 */
+	HAL_StatusTypeDef ADC_Acq_Start(ADC_HandleTypeDef *hadc);
+
+	/**
+	 * @函数名      : ADC_Acq_DMA_Callback
+	 * @描述        : 半缓冲/全缓冲传输完成处理，对刚填满的块做过采样抽取
+	 * @参数        : hadc - 触发回调的ADC句柄
+	 *                block - 刚填满的块（0为前半，1为后半）
+	 * @返回值      : 无
+	 * @注意事项    : 需在HAL_ADC_ConvHalfCpltCallback和HAL_ADC_ConvCpltCallback中调用
+	 */
+	void ADC_Acq_DMA_Callback(ADC_HandleTypeDef *hadc, uint8_t block);
+
+	/**
+	 * @函数名      : ADC_Acq_Get
+	 * @描述        : 获取通道最新的过采样结果
+	 * @参数        : ch - 通道
+	 * @返回值      : uint16_t - 0至ADC_ACQ_FULL_SCALE
+	 */
+	uint16_t ADC_Acq_Get(ADC_Acq_Channel ch);
+
+	/**
+	 * @函数名      : ADC_Acq_GetBlockCount
+	 * @描述        : 获取已完成抽取的块数，可用于判断是否有新数据
+	 * @参数        : 无
+	 * @返回值      : uint32_t - 块计数（回绕）
+	 */
+	uint32_t ADC_Acq_GetBlockCount(void);
+
+	/**
+	 * @函数名      : ADC_Acq_GetVddMv
+	 * @描述        : 根据内部参考电压计算实际的VDDA
+	 * @参数        : 无
+	 * @返回值      : uint16_t - VDDA(mV)，尚无数据时返回0
+	 */
+	uint16_t ADC_Acq_GetVddMv(void);
+
+	/**
+	 * @函数名      : ADC_Acq_GetTempX10
+	 * @描述        : 计算芯片内部温度
+	 * @参数        : 无
+	 * @返回值      : int16_t - 温度(0.1℃)，尚无数据时返回0
+	 * @注意事项    : 内部传感器出厂偏差约±1.5℃，只适合监测芯片温度变化
+	 */
+	int16_t ADC_Acq_GetTempX10(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_ACQ_H */
@@ -0,0 +1,80 @@
+#ifndef CRC_H
+#define CRC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : crc.h
+ * @描述        : 查表法CRC校验（纯函数，不依赖HAL）
+ * @注意事项    : CRC8用于Sensirion传感器（SGP30等）的数据字校验，
+ *                CRC16用于遥测帧和Flash参数区记录
+ *                两张表均为const数组，存放在Flash中，共768字节
+ */
+
+#include <stdint.h>
+
+/* Sensirion CRC8参数：多项式0x31(x8+x5+x4+1)，初值0xFF，不反转，无异或输出 */
+#define CRC8_SENSIRION_INIT 0xFF
+
+/* CRC16-CCITT-FALSE参数：多项式0x1021，初值0xFFFF，不反转，无异或输出 */
+#define CRC16_CCITT_INIT 0xFFFF
+
+/* Sensirion数据字格式：2字节数据（高字节在前）+ 1字节CRC */
+#define CRC8_WORD_SIZE 3
+
+	/**
+	 * @函数名      : CRC8_Sensirion
+	 * @描述        : 计算Sensirion CRC8
+	 * @参数        : data - 数据
+	 *                len - 数据长度
+	 * @返回值      : uint8_t - CRC值
+	 */
+	uint8_t CRC8_Sensirion(const uint8_t *data, uint16_t len);
+
+	/**
+	 * @函数名      : CRC8_VerifyWords
+	 * @描述        : 一次校验Sensirion多字响应中的全部数据字
+	 * @参数        : data - 响应数据，每个字3字节（数据高字节、低字节、CRC）
+	 *                count - 字数
+	 *                words - 输出的数据字，可为NULL（仅校验）
+	 * @返回值      : uint8_t - 1: 全部校验通过; 0: 任一字校验失败
+	 * @注意事项    : 校验失败时words的内容不完整，不应使用
+	 */
+	uint8_t CRC8_VerifyWords(const uint8_t *data, uint8_t count, uint16_t *words);
+
+	/**
+	 * @函数名      : CRC8_PackWord
+	 * @描述        : 按Sensirion格式写入一个数据字及其CRC
+	 * @参数        : out - 输出缓冲区（3字节）
+	 *                word - 数据字
+	 * @返回值      : 无
+	 */
+	void CRC8_PackWord(uint8_t *out, uint16_t word);
+
+	/**
+	 * @函数名      : CRC16_CCITT_Update
+	 * @描述        : 在已有CRC值上继续计算CRC16-CCITT，用于分段数据
+	 * @参数        : crc - 当前CRC值，首段传入CRC16_CCITT_INIT
+	 *                data - 数据
+	 *                len - 数据长度
+	 * @返回值      : uint16_t - 更新后的CRC值
+	 */
+	uint16_t CRC16_CCITT_Update(uint16_t crc, const uint8_t *data, uint32_t len);
+
+	/**
+	 * @函数名      : CRC16_CCITT
+	 * @描述        : 计算CRC16-CCITT（多项式0x1021，初值0xFFFF）
+	 * @参数        : data - 数据
+	 *                len - 数据长度
+	 * @返回值      : uint16_t - CRC值
+	 */
+	uint16_t CRC16_CCITT(const uint8_t *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_H */
@@ -2,34 +2,103 @@
  * @文件        : dht11.c
  * @描述        : DHT11温湿度传感器驱动实现
  * @注意事项    : DHT11采用单总线通信方式，需要严格遵循时序要求
+ *                每个传感器的引脚和读取状态保存在各自的句柄中，可同时驱动多个传感器
  */
 
 #include "dht11.h"
 #include "main.h"
 
+/* 异步读取时序参数 */
+#define DHT11_START_MS 20			// 起始信号低电平时间(ms)，手册要求>18ms
+#define DHT11_CAPTURE_TIMEOUT_MS 10 // 采集超时(ms)，完整传输约4.3ms
+
+/**
+ * 异步读取状态
+ */
+typedef enum
+{
+	DHT11_STATE_IDLE,	 // 空闲
+	DHT11_STATE_START,	 // 正在输出起始信号
+	DHT11_STATE_CAPTURE // 正在通过下降沿中断采集数据
+} DHT11_State;
+
 /* 私有变量 */
-static GPIO_TypeDef *DHT_GPIO;	   // DHT11连接的GPIO端口
-static uint16_t DHT_PIN;		   // DHT11连接的GPIO引脚
-static void delay_us(uint32_t us); // 微秒延时函数声明
+static DHT11_Handle *instances[DHT11_MAX_INSTANCES]; // 已注册的传感器，用于中断和状态机分发
+static uint8_t instance_count = 0;					  // 已注册的传感器数量
+static void delay_us(uint32_t us);					  // 微秒延时函数声明
+
+/**
+ * @函数名      : exti_irqn
+ * @描述        : 根据引脚编号获取对应的EXTI中断号
+ */
+static IRQn_Type exti_irqn(uint8_t pin_num)
+{
+	if (pin_num < 5)
+		return (IRQn_Type)(EXTI0_IRQn + pin_num);
+	if (pin_num < 10)
+		return EXTI9_5_IRQn;
+	return EXTI15_10_IRQn;
+}
+
+/**
+ * @函数名      : exti_setup
+ * @描述        : 将数据引脚映射到EXTI线并配置为下降沿触发，中断默认屏蔽
+ * @实现细节    : 引脚保持开漏输出模式，EXTI取自输入通路，输出模式下同样有效，
+ *                因此采集期间无需调用HAL_GPIO_Init切换方向
+ * @注意事项    : 同一EXTI线只能映射到一个端口，各传感器须使用不同的引脚编号
+ */
+static void exti_setup(const DHT11_Handle *hdht)
+{
+	uint8_t pin_num = 0;
+	while (!(hdht->pin & (1U << pin_num)))
+		pin_num++;
+
+	__HAL_RCC_AFIO_CLK_ENABLE();
+	uint32_t exticr = AFIO->EXTICR[pin_num >> 2];
+	exticr &= ~(0x0FU << (4U * (pin_num & 0x03U)));
+	exticr |= GPIO_GET_INDEX(hdht->port) << (4U * (pin_num & 0x03U));
+	AFIO->EXTICR[pin_num >> 2] = exticr;
+
+	EXTI->IMR &= ~hdht->pin;
+	EXTI->EMR &= ~hdht->pin;
+	EXTI->RTSR &= ~hdht->pin;
+	EXTI->FTSR |= hdht->pin;
+	__HAL_GPIO_EXTI_CLEAR_IT(hdht->pin);
+
+	HAL_NVIC_SetPriority(exti_irqn(pin_num), 1, 0); // 高于串口/DMA，保证时间戳精度
+	HAL_NVIC_EnableIRQ(exti_irqn(pin_num));
+}
 
 /**
  * @函数名      : DHT11_Init
- * @描述        : 初始化DHT11传感器
- * @参数        : GPIOx - DHT11传感器连接的GPIO端口
+ * @描述        : 初始化DHT11传感器句柄并注册到驱动
+ * @参数        : hdht - 传感器句柄
+ *                GPIOx - DHT11传感器连接的GPIO端口
  *                GPIO_Pin - DHT11传感器连接的GPIO引脚
- * @返回值      : 无
- * @实现细节    : 保存DHT11连接的GPIO信息，为后续通信做准备
+ * @返回值      : HAL_OK - 成功; HAL_ERROR - 传感器数量已达上限
+ * @实现细节    : 保存DHT11连接的GPIO信息，释放总线并配置下降沿中断
  */
-void DHT11_Init(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+uint8_t DHT11_Init(DHT11_Handle *hdht, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
 {
-	DHT_GPIO = GPIOx;
-	DHT_PIN = GPIO_Pin;
+	if (instance_count >= DHT11_MAX_INSTANCES)
+		return HAL_ERROR;
+
+	*hdht = (DHT11_Handle){0};
+	hdht->port = GPIOx;
+	hdht->pin = GPIO_Pin;
+	hdht->state = DHT11_STATE_IDLE;
+	HAL_GPIO_WritePin(hdht->port, hdht->pin, GPIO_PIN_SET); // 释放总线
+	exti_setup(hdht);
+
+	instances[instance_count++] = hdht;
+	return HAL_OK;
 }
 
 /**
  * @函数名      : DHT11_Read
  * @描述        : 从DHT11传感器读取温湿度数据
- * @参数        : data - 指向存储读取数据的结构体的指针
+ * @参数        : hdht - 传感器句柄
+ *                data - 指向存储读取数据的结构体的指针
  * @返回值      : HAL_OK(0x00) - 读取成功
  *                HAL_ERROR(0x01) - 读取失败
  * @实现细节    :
@@ -43,25 +112,25 @@ void DHT11_Init(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
  *   2. 通过测量高电平时间来判断数据位是0还是1
  *   3. 通过校验和验证数据正确性（校验和 = 前四个字节之和）
  */
-uint8_t DHT11_Read(DHT11_Data *data)
+uint8_t DHT11_Read(DHT11_Handle *hdht, DHT11_Data *data)
 {
 	uint8_t buffer[5] = {0}; // 用于存储接收到的5个字节数据
 	uint8_t retry = 0;		 // 重试计数变量（未使用）
 	uint32_t timeout = 0;	 // 超时计数器，防止无限等待
 
-	/* 阶段1: 发送开始信号 */
-	DHT11_SetMode(GPIO_MODE_OUTPUT_PP);					  // 设置为推挽输出模式，提供更强的驱动能力
-	HAL_GPIO_WritePin(DHT_GPIO, DHT_PIN, GPIO_PIN_RESET); // 拉低总线
+	if (hdht->state != DHT11_STATE_IDLE)
+		return HAL_ERROR; // 异步读取进行中
+
+	/* 阶段1: 发送开始信号（引脚为开漏输出，写1即释放总线，无需切换模式） */
+	HAL_GPIO_WritePin(hdht->port, hdht->pin, GPIO_PIN_RESET); // 拉低总线
 	HAL_Delay(20);										  // 保持低电平至少18ms，此处设为20ms确保足够
-	HAL_GPIO_WritePin(DHT_GPIO, DHT_PIN, GPIO_PIN_SET);	  // 拉高总线
+	HAL_GPIO_WritePin(hdht->port, hdht->pin, GPIO_PIN_SET);	  // 拉高总线
 	delay_us(30);										  // 主机拉高后等待20-40us
 
 	/* 阶段2: 等待DHT11响应 */
-	DHT11_SetMode(GPIO_MODE_INPUT); // 切换为输入模式，准备接收DHT11响应和数据
-
 	// 等待DHT11的响应信号（开始拉低总线）
 	timeout = 0;
-	while (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_SET)
+	while (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_SET)
 	{
 		delay_us(1); // 每次延时1us
 		timeout++;
@@ -71,7 +140,7 @@ uint8_t DHT11_Read(DHT11_Data *data)
 
 	// 等待DHT11的低电平响应结束
 	timeout = 0;
-	while (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_RESET)
+	while (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_RESET)
 	{
 		delay_us(1);
 		timeout++;
@@ -81,7 +150,7 @@ uint8_t DHT11_Read(DHT11_Data *data)
 
 	// 等待DHT11的高电平响应结束
 	timeout = 0;
-	while (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_SET)
+	while (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_SET)
 	{
 		delay_us(1);
 		timeout++;
@@ -96,7 +165,7 @@ uint8_t DHT11_Read(DHT11_Data *data)
 		{
 			// 等待数据位的前导低电平结束（固定50us）
 			timeout = 0;
-			while (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_RESET)
+			while (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_RESET)
 			{
 				delay_us(1);
 				timeout++;
@@ -109,12 +178,12 @@ uint8_t DHT11_Read(DHT11_Data *data)
 
 			// 如果40us后仍为高电平，则数据位为1；否则为0
 			buffer[i] <<= 1; // 数据左移1位，为新数据位腾出位置
-			if (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_SET)
+			if (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_SET)
 				buffer[i] |= 1; // 数据位为1
 
 			// 等待当前数据位的高电平结束，准备接收下一位
 			timeout = 0;
-			while (HAL_GPIO_ReadPin(DHT_GPIO, DHT_PIN) == GPIO_PIN_SET)
+			while (HAL_GPIO_ReadPin(hdht->port, hdht->pin) == GPIO_PIN_SET)
 			{
 				delay_us(1);
 				timeout++;
@@ -125,8 +194,8 @@ uint8_t DHT11_Read(DHT11_Data *data)
 	}
 
 	/* 阶段4: 数据校验与保存 */
-	// 校验数据（校验和 = 前四个字节之和）
-	if (buffer[4] == (buffer[0] + buffer[1] + buffer[2] + buffer[3]))
+	// 校验数据（校验和 = 前四个字节之和的低8位）
+	if (buffer[4] == (uint8_t)(buffer[0] + buffer[1] + buffer[2] + buffer[3]))
 	{
 		// 保存读取到的温湿度数据
 		data->humidity = buffer[0];
@@ -144,6 +213,196 @@ uint8_t DHT11_Read(DHT11_Data *data)
 	return HAL_ERROR; // 校验和错误，读取失败
 }
 
+/**
+ * @函数名      : DHT11_SetCallback
+ * @描述        : 设置异步读取完成回调
+ * @参数        : hdht - 传感器句柄
+ *                cb - 回调函数
+ * @返回值      : 无
+ */
+void DHT11_SetCallback(DHT11_Handle *hdht, DHT11_Callback cb)
+{
+	hdht->callback = cb;
+}
+
+/**
+ * @函数名      : start_signal
+ * @描述        : 拉低总线发送起始信号并记录时刻
+ */
+static void start_signal(DHT11_Handle *hdht, uint32_t now)
+{
+	HAL_GPIO_WritePin(hdht->port, hdht->pin, GPIO_PIN_RESET);
+	hdht->start_tick = now;
+	hdht->state_tick = now;
+	hdht->state = DHT11_STATE_START;
+}
+
+/**
+ * @函数名      : DHT11_StartRead
+ * @描述        : 启动一次异步读取（非阻塞）
+ * @参数        : hdht - 传感器句柄
+ * @返回值      : HAL_OK - 已启动; HAL_BUSY - 上一次读取尚未完成
+ * @实现细节    : 拉低总线并记录时刻，由DHT11_Process在20ms后释放总线，
+ *                替代原先阻塞的HAL_Delay(20)
+ */
+uint8_t DHT11_StartRead(DHT11_Handle *hdht)
+{
+	if (hdht->state != DHT11_STATE_IDLE)
+		return HAL_BUSY;
+
+	start_signal(hdht, HAL_GetTick());
+	return HAL_OK;
+}
+
+/**
+ * @函数名      : DHT11_StartReadBatch
+ * @描述        : 同时启动多个传感器的异步读取
+ * @参数        : handles - 传感器句柄数组
+ *                count - 句柄数量
+ * @返回值      : HAL_OK - 全部已启动; HAL_BUSY - 部分传感器忙
+ * @实现细节    : 所有起始信号使用同一时刻，之后在同一次DHT11_Process中一起释放总线，
+ *                各传感器的应答在各自EXTI线上并行采集
+ */
+uint8_t DHT11_StartReadBatch(DHT11_Handle *const *handles, uint8_t count)
+{
+	const uint32_t now = HAL_GetTick();
+	uint8_t status = HAL_OK;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (handles[i]->state != DHT11_STATE_IDLE)
+		{
+			status = HAL_BUSY;
+			continue;
+		}
+		start_signal(handles[i], now);
+	}
+
+	return status;
+}
+
+/**
+ * @函数名      : finish_read
+ * @描述        : 结束一次采集：屏蔽中断、解码、更新统计并回调
+ */
+static void finish_read(DHT11_Handle *hdht, uint32_t now)
+{
+	EXTI->IMR &= ~hdht->pin; // 屏蔽中断
+	hdht->state = DHT11_STATE_IDLE;
+
+	uint8_t raw[5];
+	uint8_t status = HAL_TIMEOUT;
+	DHT11_Data data = {0};
+	if (hdht->edge_count == 0)
+	{
+		hdht->stats.timeouts++;
+	}
+	else if (DHT11_DecodeEdges((const uint32_t *)hdht->edges, hdht->edge_count,
+							   SystemCoreClock / 1000000, raw) != DHT11_DECODE_OK)
+	{
+		status = HAL_ERROR;
+		hdht->stats.decode_errors++;
+	}
+	else
+	{
+		data.humidity = raw[0];
+		data.humidity_dec = raw[1];
+		data.temperature = raw[2];
+		data.temperature_dec = raw[3];
+
+		// 检查数据范围合理性（湿度0-100%，温度0-85℃）
+		if (data.humidity <= 100 && data.temperature <= 85)
+		{
+			status = HAL_OK;
+		}
+		else
+		{
+			status = HAL_ERROR;
+			hdht->stats.range_errors++;
+		}
+	}
+
+	const uint16_t latency = (uint16_t)(now - hdht->start_tick);
+	hdht->stats.reads++;
+	hdht->stats.last_latency_ms = latency;
+	if (latency > hdht->stats.max_latency_ms)
+		hdht->stats.max_latency_ms = latency;
+
+	if (hdht->callback != NULL)
+		hdht->callback(hdht, status, &data);
+}
+
+/**
+ * @函数名      : DHT11_Process
+ * @描述        : 推进所有已注册传感器的异步读取状态机
+ * @参数        : 无
+ * @返回值      : 无
+ * @实现细节    :
+ *   1. START状态：起始信号满20ms后，先使能下降沿中断再释放总线，确保不漏掉DHT11的响应
+ *   2. CAPTURE状态：收齐42个下降沿或超时后屏蔽中断，调用纯函数DHT11_DecodeEdges解码
+ *   3. 解码结果经范围检查后通过回调返回
+ */
+void DHT11_Process(void)
+{
+	const uint32_t now = HAL_GetTick();
+
+	for (uint8_t i = 0; i < instance_count; i++)
+	{
+		DHT11_Handle *hdht = instances[i];
+
+		if (hdht->state == DHT11_STATE_START)
+		{
+			if (now - hdht->state_tick < DHT11_START_MS)
+				continue;
+
+			hdht->edge_count = 0;
+			__HAL_GPIO_EXTI_CLEAR_IT(hdht->pin);
+			EXTI->IMR |= hdht->pin;								  // 使能下降沿中断
+			HAL_GPIO_WritePin(hdht->port, hdht->pin, GPIO_PIN_SET); // 释放总线，等待DHT11响应
+			hdht->state_tick = now;
+			hdht->state = DHT11_STATE_CAPTURE;
+		}
+		else if (hdht->state == DHT11_STATE_CAPTURE)
+		{
+			if (hdht->edge_count >= DHT11_EDGE_COUNT || now - hdht->state_tick >= DHT11_CAPTURE_TIMEOUT_MS)
+				finish_read(hdht, now);
+		}
+	}
+}
+
+/**
+ * @函数名      : DHT11_EXTI_Callback
+ * @描述        : 数据引脚下降沿中断处理，记录DWT时间戳
+ * @参数        : GPIO_Pin - 触发中断的引脚
+ * @返回值      : 无
+ */
+void DHT11_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	const uint32_t timestamp = DWT->CYCCNT;
+
+	for (uint8_t i = 0; i < instance_count; i++)
+	{
+		DHT11_Handle *hdht = instances[i];
+		if (hdht->pin != GPIO_Pin)
+			continue;
+
+		if (hdht->state == DHT11_STATE_CAPTURE && hdht->edge_count < DHT11_EDGE_COUNT)
+			hdht->edges[hdht->edge_count++] = timestamp;
+		return;
+	}
+}
+
+/**
+ * @函数名      : DHT11_GetStats
+ * @描述        : 获取传感器的读取统计
+ * @参数        : hdht - 传感器句柄
+ * @返回值      : const DHT11_Stats* - 统计信息
+ */
+const DHT11_Stats *DHT11_GetStats(const DHT11_Handle *hdht)
+{
+	return &hdht->stats;
+}
+
 /**
  * @函数名      : delay_us
  * @描述        : 微秒级延时函数
@@ -163,16 +422,17 @@ static void delay_us(uint32_t us)
 /**
  * @函数名      : DHT11_SetMode
  * @描述        : 设置DHT11数据引脚的GPIO模式
- * @参数        : mode - GPIO模式 (GPIO_MODE_INPUT/GPIO_MODE_OUTPUT_PP等)
+ * @参数        : hdht - 传感器句柄
+ *                mode - GPIO模式 (GPIO_MODE_INPUT/GPIO_MODE_OUTPUT_PP等)
  * @返回值      : 无
  * @注意        : 此函数在读取过程中需要多次切换GPIO模式
  */
-void DHT11_SetMode(uint32_t mode)
+void DHT11_SetMode(DHT11_Handle *hdht, uint32_t mode)
 {
 	GPIO_InitTypeDef GPIO_InitStruct = {0};		  // 定义GPIO初始化结构体
-	GPIO_InitStruct.Pin = DHT_PIN;				  // 设置引脚
+	GPIO_InitStruct.Pin = hdht->pin;				  // 设置引脚
 	GPIO_InitStruct.Mode = mode;				  // 设置模式
 	GPIO_InitStruct.Pull = GPIO_PULLUP;			  // 使用上拉电阻
 	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH; // 高速模式
-	HAL_GPIO_Init(DHT_GPIO, &GPIO_InitStruct);	  // 初始化GPIO
+	HAL_GPIO_Init(hdht->port, &GPIO_InitStruct);	  // 初始化GPIO
 }
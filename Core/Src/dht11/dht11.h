@@ -6,9 +6,14 @@
  * @描述        : DHT11温湿度传感器驱动头文件
  * @注意事项    : DHT11传感器支持温湿度测量，工作电压3.3V-5.5V
  *                温度测量范围：0-50℃，湿度测量范围：20-90%RH
+ *                驱动基于句柄，每个传感器对应一个DHT11_Handle，最多支持DHT11_MAX_INSTANCES个
  */
 
 #include "stm32f1xx_hal.h"
+#include "dht11_decode.h"
+
+/* 可同时注册的传感器数量 */
+#define DHT11_MAX_INSTANCES 4
 
 /**
  * @结构体名    : DHT11_Data
@@ -22,32 +27,135 @@ typedef struct
     uint8_t temperature_dec; // 温度小数部分 (0-99)
 } DHT11_Data;
 
+/**
+ * @结构体名    : DHT11_Stats
+ * @描述        : 单个传感器的读取统计
+ */
+typedef struct
+{
+    uint32_t reads;           // 已完成的读取次数
+    uint32_t timeouts;        // 无响应次数
+    uint32_t decode_errors;   // 波形解码或校验失败次数
+    uint32_t range_errors;    // 数据超出合理范围次数
+    uint16_t last_latency_ms; // 最近一次读取耗时（启动到完成）
+    uint16_t max_latency_ms;  // 最大读取耗时
+} DHT11_Stats;
+
+typedef struct DHT11_Handle DHT11_Handle;
+
+/**
+ * @类型名      : DHT11_Callback
+ * @描述        : 异步读取完成回调
+ * @参数        : hdht - 完成读取的传感器句柄
+ *                status - HAL_OK(读取成功) / HAL_ERROR(解码、校验或范围检查失败) / HAL_TIMEOUT(无响应)
+ *                data - 读取到的数据，仅status为HAL_OK时有效
+ */
+typedef void (*DHT11_Callback)(DHT11_Handle *hdht, uint8_t status, const DHT11_Data *data);
+
+/**
+ * @结构体名    : DHT11_Handle
+ * @描述        : DHT11传感器句柄，保存引脚、异步读取状态和统计信息
+ * @注意事项    : 成员由驱动维护，调用方只应通过接口函数访问
+ */
+struct DHT11_Handle
+{
+    GPIO_TypeDef *port;                       // 数据引脚端口
+    uint16_t pin;                             // 数据引脚
+    volatile uint8_t state;                   // 异步读取状态
+    uint32_t start_tick;                      // 本次读取启动时刻(ms)
+    uint32_t state_tick;                      // 进入当前状态的时刻(ms)
+    volatile uint32_t edges[DHT11_EDGE_COUNT]; // 下降沿DWT时间戳
+    volatile uint8_t edge_count;              // 已记录的下降沿数量
+    DHT11_Callback callback;                  // 读取完成回调
+    DHT11_Stats stats;                        // 读取统计
+};
+
 /**
  * @函数名      : DHT11_Init
- * @描述        : 初始化DHT11传感器
- * @参数        : GPIOx - DHT11传感器连接的GPIO端口
+ * @描述        : 初始化DHT11传感器句柄并注册到驱动
+ * @参数        : hdht - 传感器句柄
+ *                GPIOx - DHT11传感器连接的GPIO端口
  *                GPIO_Pin - DHT11传感器连接的GPIO引脚
- * @返回值      : 无
+ * @返回值      : HAL_OK - 成功
+ *                HAL_ERROR - 已注册的传感器数量达到DHT11_MAX_INSTANCES
  */
-void DHT11_Init(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+uint8_t DHT11_Init(DHT11_Handle *hdht, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
 
 /**
  * @函数名      : DHT11_Read
- * @描述        : 从DHT11传感器读取温湿度数据
- * @参数        : data - 指向存储读取数据的结构体的指针
+ * @描述        : 从DHT11传感器读取温湿度数据（阻塞方式，约25ms）
+ * @参数        : hdht - 传感器句柄
+ *                data - 指向存储读取数据的结构体的指针
  * @返回值      : HAL_OK(0x00) - 读取成功
  *                HAL_ERROR(0x01) - 读取失败
  */
-uint8_t DHT11_Read(DHT11_Data *data);
+uint8_t DHT11_Read(DHT11_Handle *hdht, DHT11_Data *data);
+
+/**
+ * @函数名      : DHT11_SetCallback
+ * @描述        : 设置异步读取完成回调
+ * @参数        : hdht - 传感器句柄
+ *                cb - 回调函数，在DHT11_Process的调用上下文中执行
+ * @返回值      : 无
+ */
+void DHT11_SetCallback(DHT11_Handle *hdht, DHT11_Callback cb);
+
+/**
+ * @函数名      : DHT11_StartRead
+ * @描述        : 启动一次异步读取（非阻塞）
+ * @参数        : hdht - 传感器句柄
+ * @返回值      : HAL_OK - 已启动
+ *                HAL_BUSY - 上一次读取尚未完成
+ * @注意事项    : 启动后需周期性调用DHT11_Process（间隔不大于2ms），约25ms后通过回调返回结果
+ */
+uint8_t DHT11_StartRead(DHT11_Handle *hdht);
+
+/**
+ * @函数名      : DHT11_StartReadBatch
+ * @描述        : 同时启动多个传感器的异步读取
+ * @参数        : handles - 传感器句柄数组
+ *                count - 句柄数量
+ * @返回值      : HAL_OK - 全部已启动
+ *                HAL_BUSY - 至少一个传感器上一次读取尚未完成（其余传感器照常启动）
+ * @注意事项    : 各传感器的起始信号背靠背发出，数据在同一个采集窗口内通过各自的EXTI线并行接收，
+ *                N个传感器只占用一次约25ms的采集时间
+ */
+uint8_t DHT11_StartReadBatch(DHT11_Handle *const *handles, uint8_t count);
+
+/**
+ * @函数名      : DHT11_Process
+ * @描述        : 推进所有已注册传感器的异步读取状态机
+ * @参数        : 无
+ * @返回值      : 无
+ */
+void DHT11_Process(void);
+
+/**
+ * @函数名      : DHT11_EXTI_Callback
+ * @描述        : 数据引脚下降沿中断处理，记录DWT时间戳
+ * @参数        : GPIO_Pin - 触发中断的引脚
+ * @返回值      : 无
+ * @注意事项    : 需在HAL_GPIO_EXTI_Callback中调用
+ */
+void DHT11_EXTI_Callback(uint16_t GPIO_Pin);
+
+/**
+ * @函数名      : DHT11_GetStats
+ * @描述        : 获取传感器的读取统计
+ * @参数        : hdht - 传感器句柄
+ * @返回值      : const DHT11_Stats* - 统计信息
+ */
+const DHT11_Stats *DHT11_GetStats(const DHT11_Handle *hdht);
 
 /**
  * @函数名      : DHT11_SetMode
  * @描述        : 设置DHT11数据引脚的GPIO模式
- * @参数        : mode - GPIO模式 (GPIO_MODE_INPUT/GPIO_MODE_OUTPUT_PP等)
+ * @参数        : hdht - 传感器句柄
+ *                mode - GPIO模式 (GPIO_MODE_INPUT/GPIO_MODE_OUTPUT_PP等)
  * @返回值      : 无
- * @注意        : 此函数在.c文件中定义为static，头文件中声明为外部函数
- *                需要修改为一致性，建议在.c文件中实现为非static
+ * @注意        : 数据引脚已由MX_GPIO_Init配置为带上拉的开漏输出，写1即释放总线并可直接读取电平，
+ *                读取过程中无需再切换模式，此函数仅供引脚被其他配置覆盖时恢复使用
  */
-void DHT11_SetMode(uint32_t mode);
+void DHT11_SetMode(DHT11_Handle *hdht, uint32_t mode);
 
 #endif
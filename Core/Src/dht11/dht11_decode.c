@@ -0,0 +1,58 @@
+/**
+ * @文件        : dht11_decode.c
+ * @描述        : DHT11单总线波形解码实现
+ */
+
+#include "dht11_decode.h"
+
+/* 时序容限(us) */
+#define RESPONSE_MIN_US 120 // 响应低+高电平，标称160us
+#define RESPONSE_MAX_US 200
+#define BIT_MIN_US 60		// 数据0标称76-78us
+#define BIT_THRESHOLD_US 100 // 大于此宽度判定为数据1
+#define BIT_MAX_US 160		// 数据1标称120us
+
+/**
+ * @函数名      : DHT11_DecodeEdges
+ * @描述        : 将下降沿时间戳序列解码为5字节原始数据
+ * @参数        : edges - 下降沿时间戳
+ *                count - 时间戳数量
+ *                ticks_per_us - 计数器每微秒的计数值
+ *                out - 输出的5字节数据
+ * @返回值      : DHT11_DecodeStatus - 解码结果
+ * @实现细节    :
+ *   1. 检查响应信号宽度(E1 - E0)
+ *   2. 依次计算40个位宽度，根据阈值判定0/1，超出容限视为干扰
+ *   3. 校验和 = 前四个字节之和的低8位
+ */
+DHT11_DecodeStatus DHT11_DecodeEdges(const uint32_t *edges, uint8_t count,
+									 uint32_t ticks_per_us, uint8_t out[5])
+{
+	uint8_t buffer[5] = {0};
+
+	if (count < DHT11_EDGE_COUNT || ticks_per_us == 0)
+		return DHT11_DECODE_TOO_FEW_EDGES;
+
+	const uint32_t response = edges[1] - edges[0]; // 无符号差值，允许计数器回绕
+	if (response < RESPONSE_MIN_US * ticks_per_us || response > RESPONSE_MAX_US * ticks_per_us)
+		return DHT11_DECODE_BAD_RESPONSE;
+
+	for (uint8_t i = 0; i < 40; i++)
+	{
+		const uint32_t width = edges[i + 2] - edges[i + 1];
+		if (width < BIT_MIN_US * ticks_per_us || width > BIT_MAX_US * ticks_per_us)
+			return DHT11_DECODE_BAD_BIT;
+
+		buffer[i / 8] <<= 1;
+		if (width > BIT_THRESHOLD_US * ticks_per_us)
+			buffer[i / 8] |= 1;
+	}
+
+	if (buffer[4] != (uint8_t)(buffer[0] + buffer[1] + buffer[2] + buffer[3]))
+		return DHT11_DECODE_CHECKSUM;
+
+	for (uint8_t i = 0; i < 5; i++)
+		out[i] = buffer[i];
+
+	return DHT11_DECODE_OK;
+}
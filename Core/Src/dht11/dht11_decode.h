@@ -0,0 +1,56 @@
+#ifndef DHT11_DECODE_H
+#define DHT11_DECODE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : dht11_decode.h
+ * @描述        : DHT11单总线波形解码（纯函数，不依赖HAL）
+ * @注意事项    : 输入为总线下降沿的时间戳序列（主机释放总线之后记录），
+ *                与时间戳来源无关，可在主机上用录制或合成的波形测试
+ *
+ *   下降沿序列：
+ *     E0          DHT11响应开始（拉低80us）
+ *     E1          第1位的前导低电平开始（E1 - E0 ≈ 160us）
+ *     E2 ... E41  第1-40位结束（第40位之后DHT11再拉低50us）
+ *   第i位的宽度 = E(i+1) - E(i)：数据0约76us（50+26），数据1约120us（50+70）
+ */
+
+#include <stdint.h>
+
+/* 一次完整传输的下降沿数量 */
+#define DHT11_EDGE_COUNT 42
+
+	/**
+	 * @枚举名      : DHT11_DecodeStatus
+	 * @描述        : 波形解码结果
+	 */
+	typedef enum
+	{
+		DHT11_DECODE_OK = 0,	   // 解码成功
+		DHT11_DECODE_TOO_FEW_EDGES, // 下降沿数量不足（无响应或传输中断）
+		DHT11_DECODE_BAD_RESPONSE, // 响应信号宽度异常
+		DHT11_DECODE_BAD_BIT,	   // 数据位宽度超出容限
+		DHT11_DECODE_CHECKSUM	   // 校验和错误
+	} DHT11_DecodeStatus;
+
+	/**
+	 * @函数名      : DHT11_DecodeEdges
+	 * @描述        : 将下降沿时间戳序列解码为5字节原始数据
+	 * @参数        : edges - 下降沿时间戳（计数器值，允许32位回绕）
+	 *                count - 时间戳数量，多于DHT11_EDGE_COUNT时只使用前DHT11_EDGE_COUNT个
+	 *                ticks_per_us - 计数器每微秒的计数值（DWT为SystemCoreClock/1000000）
+	 *                out - 输出的5字节数据（湿度整数、湿度小数、温度整数、温度小数、校验和）
+	 * @返回值      : DHT11_DecodeStatus - 解码结果，仅DHT11_DECODE_OK时out有效
+	 */
+	DHT11_DecodeStatus DHT11_DecodeEdges(const uint32_t *edges, uint8_t count,
+										 uint32_t ticks_per_us, uint8_t out[5]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DHT11_DECODE_H */
@@ -0,0 +1,159 @@
+/**
+ * @文件        : fmt.c
+ * @描述        : 无浮点、无可变参数的文本格式化实现
+ * @注意事项    : 整数转换逐位除以10，由编译器优化为乘法和移位，M3上每位约十个周期
+ */
+
+#include "fmt.h"
+
+/**
+ * @函数名      : Fmt_Init
+ * @描述        : 绑定缓冲区并清空
+ * @参数        : f - 格式化缓冲区
+ *                buf - 字符缓冲区
+ *                size - 缓冲区大小，必须大于0
+ * @返回值      : 无
+ */
+void Fmt_Init(Fmt_Buffer *f, char *buf, uint16_t size)
+{
+	f->buf = buf;
+	f->size = size;
+	f->len = 0;
+	f->overflow = 0;
+	buf[0] = '\0';
+}
+
+/**
+ * @函数名      : Fmt_Char
+ * @描述        : 追加单个字符，缓冲区已满时置位overflow
+ * @参数        : f - 格式化缓冲区
+ *                c - 字符
+ * @返回值      : 无
+ */
+void Fmt_Char(Fmt_Buffer *f, char c)
+{
+	if (f->len + 1U < f->size)
+	{
+		f->buf[f->len++] = c;
+		f->buf[f->len] = '\0';
+	}
+	else
+	{
+		f->overflow = 1;
+	}
+}
+
+/**
+ * @函数名      : Fmt_Str
+ * @描述        : 追加以'\0'结尾的字符串，放不下的部分截断并置位overflow
+ * @参数        : f - 格式化缓冲区
+ *                s - 字符串
+ * @返回值      : 无
+ */
+void Fmt_Str(Fmt_Buffer *f, const char *s)
+{
+	while (*s != '\0')
+	{
+		if (f->len + 1U >= f->size)
+		{
+			f->overflow = 1;
+			break;
+		}
+		f->buf[f->len++] = *s++;
+	}
+	f->buf[f->len] = '\0';
+}
+
+/**
+ * @函数名      : put_digits
+ * @描述        : 追加无符号整数，至少输出min_digits位（不足补0）
+ */
+static void put_digits(Fmt_Buffer *f, uint32_t value, uint8_t min_digits)
+{
+	char tmp[10];
+	uint8_t n = 0;
+
+	do
+	{
+		tmp[n++] = (char)('0' + value % 10U);
+		value /= 10U;
+	} while (value != 0 || n < min_digits);
+
+	while (n > 0)
+		Fmt_Char(f, tmp[--n]);
+}
+
+/**
+ * @函数名      : Fmt_U32
+ * @描述        : 追加十进制无符号整数
+ * @参数        : f - 格式化缓冲区
+ *                value - 数值
+ * @返回值      : 无
+ */
+void Fmt_U32(Fmt_Buffer *f, uint32_t value)
+{
+	put_digits(f, value, 1);
+}
+
+/**
+ * @函数名      : Fmt_I32
+ * @描述        : 追加十进制有符号整数
+ * @参数        : f - 格式化缓冲区
+ *                value - 数值
+ * @返回值      : 无
+ * @实现细节    : 取绝对值时先转为无符号再求补，INT32_MIN不溢出
+ */
+void Fmt_I32(Fmt_Buffer *f, int32_t value)
+{
+	if (value < 0)
+	{
+		Fmt_Char(f, '-');
+		put_digits(f, 0U - (uint32_t)value, 1);
+	}
+	else
+	{
+		put_digits(f, (uint32_t)value, 1);
+	}
+}
+
+/**
+ * @函数名      : Fmt_Fixed
+ * @描述        : 追加定点小数
+ * @参数        : f - 格式化缓冲区
+ *                value - 放大10^decimals倍后的整数
+ *                decimals - 小数位数(0-9)，超过9时按9处理
+ * @返回值      : 无
+ * @实现细节    : 整数部分与小数部分分别输出，小数部分按decimals位补0，如-5与2位小数输出"-0.05"
+ */
+void Fmt_Fixed(Fmt_Buffer *f, int32_t value, uint8_t decimals)
+{
+	static const uint32_t pow10[10] = {1U, 10U, 100U, 1000U, 10000U, 100000U,
+									   1000000U, 10000000U, 100000000U, 1000000000U};
+	uint32_t magnitude = (uint32_t)value;
+
+	if (decimals > 9)
+		decimals = 9;
+	if (value < 0)
+	{
+		Fmt_Char(f, '-');
+		magnitude = 0U - (uint32_t)value;
+	}
+
+	put_digits(f, magnitude / pow10[decimals], 1);
+	if (decimals > 0)
+	{
+		Fmt_Char(f, '.');
+		put_digits(f, magnitude % pow10[decimals], decimals);
+	}
+}
+
+/**
+ * @函数名      : Fmt_Len
+ * @描述        : 获取已写入的字符数
+ * @参数        : f - 格式化缓冲区
+ * @返回值      : uint16_t - 字符数（不含'\0'）
+ */
+uint16_t Fmt_Len(const Fmt_Buffer *f)
+{
+	return f->len;
+}
@@ -0,0 +1,92 @@
+#ifndef FMT_H
+#define FMT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : fmt.h
+ * @描述        : 无浮点、无可变参数的文本格式化（纯函数，不依赖HAL）
+ * @注意事项    : 向调用者提供的缓冲区逐项追加，不使用堆；
+ *                小数以定点整数传入（如温度25.3℃传入253和1位小数），不链接浮点printf
+ *                缓冲区不足时截断并置位overflow，内容始终以'\0'结尾
+ */
+
+#include <stdint.h>
+
+	/**
+	 * @结构体名    : Fmt_Buffer
+	 * @描述        : 格式化输出缓冲区
+	 */
+	typedef struct
+	{
+		char *buf;		  // 调用者提供的缓冲区
+		uint16_t size;	  // 缓冲区大小（含结尾'\0'）
+		uint16_t len;	  // 已写入的字符数（不含'\0'）
+		uint8_t overflow; // 是否发生过截断
+	} Fmt_Buffer;
+
+	/**
+	 * @函数名      : Fmt_Init
+	 * @描述        : 绑定缓冲区并清空
+	 * @参数        : f - 格式化缓冲区
+	 *                buf - 字符缓冲区
+	 *                size - 缓冲区大小，必须大于0
+	 * @返回值      : 无
+	 */
+	void Fmt_Init(Fmt_Buffer *f, char *buf, uint16_t size);
+
+	/**
+	 * @函数名      : Fmt_Str
+	 * @描述        : 追加以'\0'结尾的字符串
+	 * @参数        : f - 格式化缓冲区
+	 *                s - 字符串
+	 * @返回值      : 无
+	 */
+	void Fmt_Str(Fmt_Buffer *f, const char *s);
+
+	/**
+	 * @函数名      : Fmt_Char
+	 * @描述        : 追加单个字符
+	 * @参数        : f - 格式化缓冲区
+	 *                c - 字符
+	 * @返回值      : 无
+	 */
+	void Fmt_Char(Fmt_Buffer *f, char c);
+
+	/**
+	 * @函数名      : Fmt_U32 / Fmt_I32
+	 * @描述        : 追加十进制无符号/有符号整数
+	 * @参数        : f - 格式化缓冲区
+	 *                value - 数值
+	 * @返回值      : 无
+	 */
+	void Fmt_U32(Fmt_Buffer *f, uint32_t value);
+	void Fmt_I32(Fmt_Buffer *f, int32_t value);
+
+	/**
+	 * @函数名      : Fmt_Fixed
+	 * @描述        : 追加定点小数
+	 * @参数        : f - 格式化缓冲区
+	 *                value - 放大10^decimals倍后的整数，如253与1位小数输出"25.3"
+	 *                decimals - 小数位数(0-9)
+	 * @返回值      : 无
+	 * @注意事项    : 负数输出负号，如-5与1位小数输出"-0.5"
+	 */
+	void Fmt_Fixed(Fmt_Buffer *f, int32_t value, uint8_t decimals);
+
+	/**
+	 * @函数名      : Fmt_Len
+	 * @描述        : 获取已写入的字符数
+	 * @参数        : f - 格式化缓冲区
+	 * @返回值      : uint16_t - 字符数（不含'\0'），可直接作为发送长度
+	 */
+	uint16_t Fmt_Len(const Fmt_Buffer *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMT_H */
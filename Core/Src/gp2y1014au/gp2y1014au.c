@@ -5,27 +5,31 @@
 
 static ADC_HandleTypeDef *hadc_dust = NULL;
 static TIM_HandleTypeDef *htim_pwm = NULL;
-static uint32_t pwm_channel = TIM_CHANNEL_4; // 默认使用通道4
+static uint32_t pwm_channel = TIM_CHANNEL_4;	 // 默认使用通道4
+static uint32_t trigger_channel = TIM_CHANNEL_1; // 产生ADC触发的比较通道，不输出到引脚
 
-// GP2Y1014AU规格参数
+// GP2Y1014AU规格参数（定时器计数频率1MHz，单位us）
 #define LED_PULSE_WIDTH 320 // LED脉冲宽度(0.32ms)
 #define SAMPLING_TIME 280	// 采样时间(0.28ms)
-#define DELTA_TIME 40		// 脉冲后延时(0.04ms)
-#define SLEEP_TIME 9680		// 睡眠时间(9.68ms)
 #define CYCLE_TIME 10000	// 总周期(10ms)
 
 // ADC采样参数
-#define NUM_SAMPLES 5		 // 采样次数
-#define FIRST_SAMPLE_DELAY 2 // 第一次采样前延时(ms)
+#define DUST_ADC_CHANNEL ADC_CHANNEL_12 // PC2
+#define FILTER_LEN 16					// 滤波窗口长度，100Hz采样下为160ms
+#define FILTER_TRIM (FILTER_LEN / 4)	// 排序后两端各去除的样本数
 
-// 简单延时函数，使用HAL_Delay替代微秒级延时
-static void delay_ms(uint16_t ms)
-{
-	HAL_Delay(ms);
-}
+/* 由ADC转换完成中断写入的采样环形缓冲区 */
+static volatile uint16_t samples[FILTER_LEN];
+static volatile uint8_t sample_index = 0;
+static volatile uint32_t sample_count = 0;
 
-void GP2Y1014AU_Init(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim)
+HAL_StatusTypeDef GP2Y1014AU_Init(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim)
 {
+	TIM_OC_InitTypeDef sConfigOC = {0};
+	TIM_MasterConfigTypeDef sMasterConfig = {0};
+	ADC_ChannelConfTypeDef sConfig = {0};
+	HAL_StatusTypeDef status;
+
 	hadc_dust = hadc;
 	htim_pwm = htim;
 
@@ -33,70 +37,111 @@ void GP2Y1014AU_Init(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim)
 	if (htim->Instance == TIM3)
 	{
 		pwm_channel = TIM_CHANNEL_4;
+		trigger_channel = TIM_CHANNEL_1;
 	}
 
-	// 启动PWM (初始状态LED关闭)
-	__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, 0);
-	HAL_TIM_PWM_Start(htim_pwm, pwm_channel);
+	// 1. 定时器周期设为10ms，LED在每个周期开始时点亮320us
+	__HAL_TIM_SET_AUTORELOAD(htim_pwm, CYCLE_TIME - 1);
+	__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, LED_PULSE_WIDTH);
+
+	// 2. 触发通道使用PWM2模式，计数到280us时OC1REF变为有效，经TRGO启动ADC转换
+	sConfigOC.OCMode = TIM_OCMODE_PWM2;
+	sConfigOC.Pulse = SAMPLING_TIME;
+	sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+	status = HAL_TIM_PWM_ConfigChannel(htim_pwm, &sConfigOC, trigger_channel);
+	if (status != HAL_OK)
+		return status;
+
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC1REF;
+	sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	status = HAL_TIMEx_MasterConfigSynchronization(htim_pwm, &sMasterConfig);
+	if (status != HAL_OK)
+		return status;
+
+	// 3. ADC改为TIM3_TRGO外部触发的单次转换
+	hadc_dust->Init.ScanConvMode = ADC_SCAN_DISABLE;
+	hadc_dust->Init.ContinuousConvMode = DISABLE;
+	hadc_dust->Init.DiscontinuousConvMode = DISABLE;
+	hadc_dust->Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T3_TRGO;
+	hadc_dust->Init.NbrOfConversion = 1;
+	status = HAL_ADC_Init(hadc_dust);
+	if (status != HAL_OK)
+		return status;
+
+	sConfig.Channel = DUST_ADC_CHANNEL;
+	sConfig.Rank = ADC_REGULAR_RANK_1;
+	sConfig.SamplingTime = ADC_SAMPLETIME_28CYCLES_5; // 2.4us，相对0.28ms采样点可忽略
+	status = HAL_ADC_ConfigChannel(hadc_dust, &sConfig);
+	if (status != HAL_OK)
+		return status;
+
+	status = HAL_ADCEx_Calibration_Start(hadc_dust);
+	if (status != HAL_OK)
+		return status;
+
+	// 4. 先使能ADC等待触发，再启动定时器
+	status = HAL_ADC_Start_IT(hadc_dust);
+	if (status != HAL_OK)
+		return status;
+
+	return HAL_TIM_PWM_Start(htim_pwm, pwm_channel);
 }
 
-static uint16_t read_adc_value(void)
+void GP2Y1014AU_ADC_Callback(ADC_HandleTypeDef *hadc)
 {
-	HAL_ADC_Start(hadc_dust);
-	HAL_ADC_PollForConversion(hadc_dust, 50); // 50ms超时
-	uint16_t value = HAL_ADC_GetValue(hadc_dust);
-	return value;
+	if (hadc != hadc_dust)
+		return;
+
+	samples[sample_index] = (uint16_t)HAL_ADC_GetValue(hadc);
+	sample_index = (sample_index + 1) % FILTER_LEN;
+	sample_count++;
 }
 
-float GP2Y1014AU_ReadDustDensity(void)
+// 对最近的采样做排序，去除两端各FILTER_TRIM个值后取平均
+static uint16_t filtered_adc_value(void)
 {
-	uint32_t adc_sum = 0;
-	uint16_t adc_values[NUM_SAMPLES];
-	uint16_t adc_value;
+	uint16_t window[FILTER_LEN];
+	uint8_t count = sample_count < FILTER_LEN ? (uint8_t)sample_count : FILTER_LEN;
 
-	// 多次采样取平均值
-	for (uint8_t i = 0; i < NUM_SAMPLES; i++)
+	if (count == 0)
 	{
-		// 1. 打开LED (拉低IR LED引脚)
-		__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, LED_PULSE_WIDTH);
-
-		// 2. 等待粉尘稳定
-		HAL_Delay(FIRST_SAMPLE_DELAY);
-
-		// 3. 读取ADC值
-		adc_values[i] = read_adc_value();
-
-		// 4. 关闭LED
-		__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, 0);
+		return 0;
+	}
 
-		// 5. 等待下一个周期
-		HAL_Delay(10);
+	// 复制窗口，中断只会改写单个元素，无需关中断
+	for (uint8_t i = 0; i < count; i++)
+	{
+		window[i] = samples[i];
 	}
 
-	// 对采样值进行排序(简单冒泡排序)
-	for (uint8_t i = 0; i < NUM_SAMPLES - 1; i++)
+	// 插入排序
+	for (uint8_t i = 1; i < count; i++)
 	{
-		for (uint8_t j = 0; j < NUM_SAMPLES - i - 1; j++)
+		uint16_t value = window[i];
+		uint8_t j = i;
+		while (j > 0 && window[j - 1] > value)
 		{
-			if (adc_values[j] > adc_values[j + 1])
-			{
-				uint16_t temp = adc_values[j];
-				adc_values[j] = adc_values[j + 1];
-				adc_values[j + 1] = temp;
-			}
+			window[j] = window[j - 1];
+			j--;
 		}
+		window[j] = value;
 	}
 
 	// 去除最高值和最低值，取中间值的平均
-	for (uint8_t i = 1; i < NUM_SAMPLES - 1; i++)
+	uint8_t trim = count == FILTER_LEN ? FILTER_TRIM : 0;
+	uint32_t adc_sum = 0;
+	for (uint8_t i = trim; i < count - trim; i++)
 	{
-		adc_sum += adc_values[i];
+		adc_sum += window[i];
 	}
 
-	adc_value = adc_sum / (NUM_SAMPLES - 2);
+	return (uint16_t)(adc_sum / (count - 2 * trim));
+}
 
-	// 电压换算 (12位ADC, 3.3V参考电压)
-	float voltage = (float)adc_value * 3.3f / 4096.0f;
+float GP2Y1014AU_ReadDustDensity(void)
+{
+	float voltage = GP2Y1014AU_ReadVoltage();
 
 	// 按照数据手册计算粉尘浓度
 	// 如果电压低于0.5V，认为传感器未检测到灰尘
@@ -123,27 +168,46 @@ float GP2Y1014AU_ReadDustDensity(void)
 	return dust_density;
 }
 
-// 读取原始ADC值，用于校准
-uint16_t GP2Y1014AU_ReadRawValue(void)
+// 定点版本：density = (V - 0.5) * 8.5，以0.1μg/m³为单位即 (mV - 500) * 85 / 1000
+// 直接由ADC值计算，避免先换算mV带来的截断误差
+uint16_t GP2Y1014AU_ReadDustDensityX10(void)
 {
-	// 打开LED
-	__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, LED_PULSE_WIDTH);
+	const uint32_t scaled = (uint32_t)filtered_adc_value() * 3300U; // mV * 4096
+	const uint32_t offset = 500U * 4096U;
 
-	// 等待粉尘稳定
-	HAL_Delay(FIRST_SAMPLE_DELAY);
-
-	// 读取ADC值
-	uint16_t adc_value = read_adc_value();
+	if (scaled <= offset)
+	{
+		return 0;
+	}
 
-	// 关闭LED
-	__HAL_TIM_SET_COMPARE(htim_pwm, pwm_channel, 0);
+	uint32_t density_x10 = ((scaled - offset) * 85U + 4096U * 500U) / (4096U * 1000U);
+	if (density_x10 > 10000U)
+	{
+		density_x10 = 10000U;
+	}
+	return (uint16_t)density_x10;
+}
 
-	return adc_value;
+// 读取最近一次采样的原始ADC值，用于校准
+uint16_t GP2Y1014AU_ReadRawValue(void)
+{
+	return samples[(sample_index + FILTER_LEN - 1) % FILTER_LEN];
 }
 
-// 获取原始电压值
+// 获取滤波后的电压值 (12位ADC, 3.3V参考电压)
 float GP2Y1014AU_ReadVoltage(void)
 {
-	uint16_t adc_value = GP2Y1014AU_ReadRawValue();
+	uint16_t adc_value = filtered_adc_value();
 	return (float)adc_value * 3.3f / 4096.0f;
 }
+
+// 获取滤波后的电压值(mV)，舍去不足1mV的部分
+uint16_t GP2Y1014AU_ReadVoltageMv(void)
+{
+	return (uint16_t)((uint32_t)filtered_adc_value() * 3300U / 4096U);
+}
+
+uint32_t GP2Y1014AU_GetSampleCount(void)
+{
+	return sample_count;
+}
@@ -4,28 +4,56 @@
 #include "stm32f1xx_hal.h"
 
 /**
- * @brief 初始化GP2Y1014AU灰尘传感器
- * @param hadc ADC句柄指针，用于读取传感器输出
- * @param htim 定时器句柄指针，用于控制LED
+ * @brief 初始化GP2Y1014AU灰尘传感器，启动硬件定时采样
+ * @param hadc ADC句柄指针，用于读取传感器输出（须为可由TIM3_TRGO触发的ADC1/ADC2）
+ * @param htim 定时器句柄指针，用于控制LED（计数频率须为1MHz）
+ * @return HAL_OK - 启动成功; 其他 - 定时器或ADC配置失败
+ * @note 定时器周期10ms：通道4输出320us的LED脉冲，通道1在280us处经TRGO触发ADC转换，
+ *       转换结果由ADC中断写入滤波窗口，全程不占用CPU等待
  */
-void GP2Y1014AU_Init(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef GP2Y1014AU_Init(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim);
+
+/**
+ * @brief ADC转换完成处理，保存一次采样
+ * @param hadc 触发回调的ADC句柄
+ * @note 需在HAL_ADC_ConvCpltCallback中调用
+ */
+void GP2Y1014AU_ADC_Callback(ADC_HandleTypeDef *hadc);
 
 /**
  * @brief 读取PM2.5粉尘浓度
- * @return 粉尘浓度值，单位μg/m³
+ * @return 粉尘浓度值，单位μg/m³，由最近16次采样（160ms）滤波得到
  */
 float GP2Y1014AU_ReadDustDensity(void);
 
 /**
- * @brief 读取传感器原始ADC值，用于校准
+ * @brief 读取PM2.5粉尘浓度（定点）
+ * @return 粉尘浓度值，单位0.1μg/m³，计算与GP2Y1014AU_ReadDustDensity相同但不使用浮点运算
+ */
+uint16_t GP2Y1014AU_ReadDustDensityX10(void);
+
+/**
+ * @brief 读取最近一次采样的原始ADC值，用于校准
  * @return ADC原始值(0-4095)
  */
 uint16_t GP2Y1014AU_ReadRawValue(void);
 
 /**
  * @brief 读取传感器输出电压值
- * @return 电压值，单位V
+ * @return 滤波后的电压值，单位V
  */
 float GP2Y1014AU_ReadVoltage(void);
 
-#endif
\ No newline at end of file
+/**
+ * @brief 读取传感器输出电压值（定点）
+ * @return 滤波后的电压值，单位mV
+ */
+uint16_t GP2Y1014AU_ReadVoltageMv(void);
+
+/**
+ * @brief 获取累计采样次数，正常工作时每秒增加100
+ * @return 采样次数
+ */
+uint32_t GP2Y1014AU_GetSampleCount(void);
+
+#endif
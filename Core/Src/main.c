@@ -30,6 +30,11 @@
 #include "mq4/mq4.h"
 #include "sgp30/sgp30.h"
 #include "gp2y1014au/gp2y1014au.h"
+#include "adc_acq/adc_acq.h"
+#include "nvstore/nvstore.h"
+#include "scheduler/scheduler.h"
+#include "telemetry/telemetry.h"
+#include "fmt/fmt.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -39,6 +44,22 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+/* 各任务的调度参数：周期 / 首次偏移 / 截止时间 (ms) */
+#define TASK_MQ4_CALIB_PERIOD 200 // MQ4校准推进
+#define TASK_DHT11_PERIOD 2000	  // DHT11两次读取间隔不得小于1s
+#define TASK_DHT11_OFFSET 0
+#define TASK_DHT11_DEADLINE 100
+#define TASK_DHT11_POLL_PERIOD 2 // DHT11异步读取状态机推进
+#define TASK_MQ4_PERIOD 1000
+#define TASK_MQ4_OFFSET 100
+#define TASK_SGP30_PERIOD 1000 // SGP30动态基线补偿要求严格1Hz测量
+#define TASK_SGP30_OFFSET 200
+#define TASK_SGP30_DEADLINE 100
+#define TASK_SGP30_POLL_PERIOD 5 // SGP30命令队列推进
+#define TASK_DUST_PERIOD 1000
+#define TASK_DUST_OFFSET 300
+#define TASK_REPORT_PERIOD 1000
+#define TASK_REPORT_OFFSET 900 // 在各传感器采样完成后上报
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -49,13 +70,34 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-
+/* 各传感器最新数据，由采样任务写入、上报任务读取 */
+static DHT11_Handle dht11_zone1; // DHT11传感器1（PC1，DHT11_DATA）
+static DHT11_Handle dht11_zone2; // DHT11传感器2（PE3，DHT11_DATA2），作为上报的主传感器
+static DHT11_Data sensor_data;	// DHT11温湿度数据（传感器2）
+static DHT11_Data zone1_data;	// 传感器1温湿度数据，仅输出到调试串口
+static uint32_t methane_x10 = 0; // 甲烷浓度(0.1ppm)
+static SGP30_DATA sgp30_data;	// CO2和TVOC浓度
+static uint16_t density_x10 = 0; // PM2.5浓度(0.1ug/m^3)
+static uint16_t voltage_mv = 0;	 // 粉尘传感器输出电压(mV)
+static uint8_t dht11_ok = 0;	// 最近一次DHT11读取是否成功（传感器2）
+static uint8_t zone1_ok = 0;	// 最近一次传感器1读取是否成功
+static uint8_t sgp30_ok = 0;	// 最近一次SGP30读取是否成功
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-
+static void Task_MQ4_Calibrate(void);
+static void Task_DHT11(void);
+static void Task_DHT11_Poll(void);
+static void DHT11_ReadDone(DHT11_Handle *hdht, uint8_t status, const DHT11_Data *data);
+static void Task_MQ4(void);
+static void Task_SGP30(void);
+static void Task_SGP30_Poll(void);
+static void Task_Dust(void);
+static void Task_Report(void);
+static void Add_Task(const char *name, Scheduler_TaskFn fn, uint32_t period_ms, uint32_t offset_ms,
+                     uint32_t deadline_ms);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -72,6 +114,283 @@ void Enable_DWT(void)
   DWT->CYCCNT = 0;                                // 复位循环计数器
   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;            // 启用循环计数器
 }
+
+/**
+ * @函数名      : Task_MQ4_Calibrate
+ * @描述        : MQ4校准任务，推进非阻塞校准过程，R0可用前每秒输出一次进度
+ * @实现细节    : R0可用后（校准完成或从Flash加载）仍持续调用，由驱动在后台周期性重新校准
+ */
+static void Task_MQ4_Calibrate(void)
+{
+  // 执行校准过程（非阻塞）
+  MQ4_Calibrate();
+
+  if (MQ4_GetCalibStatus() == MQ4_CALIB_DONE)
+    return;
+
+  // 每秒发送一次校准状态信息
+  static uint32_t last_msg = 0;
+  if (HAL_GetTick() - last_msg > 1000)
+  {
+    char buf[60];
+    Fmt_Buffer msg;
+    Fmt_Init(&msg, buf, sizeof(buf));
+    Fmt_Str(&msg, "[MQ4] Calibrating... ");
+    Fmt_U32(&msg, MQ4_GetSampleCount()); // 已采样次数
+    Fmt_Char(&msg, '/');
+    Fmt_U32(&msg, MQ4_GetCalibrationTotal()); // 总采样次数
+    Fmt_Str(&msg, " samples, Remain: ");
+    Fmt_U32(&msg, MQ4_GetRemainingTime()); // 剩余校准时间
+    Fmt_Str(&msg, "s\r\n");
+    UART_TxEnqueue(&huart1, (uint8_t *)buf, Fmt_Len(&msg));
+    last_msg = HAL_GetTick();
+  }
+}
+
+/**
+ * @函数名      : Task_DHT11
+ * @描述        : 同时启动两个DHT11的异步读取，结果在DHT11_ReadDone中返回
+ * @实现细节    : 两路起始信号背靠背发出，共用一个约25ms的采集窗口
+ */
+static void Task_DHT11(void)
+{
+  static DHT11_Handle *const zones[] = {&dht11_zone1, &dht11_zone2};
+  DHT11_StartReadBatch(zones, sizeof(zones) / sizeof(zones[0]));
+}
+
+/**
+ * @函数名      : Task_DHT11_Poll
+ * @描述        : 推进DHT11异步读取，空闲时立即返回
+ */
+static void Task_DHT11_Poll(void)
+{
+  DHT11_Process();
+}
+
+/**
+ * @函数名      : DHT11_ReadDone
+ * @描述        : DHT11异步读取完成回调，按传感器保存数据或输出错误信息
+ */
+static void DHT11_ReadDone(DHT11_Handle *hdht, uint8_t status, const DHT11_Data *data)
+{
+  const uint8_t ok = (status == HAL_OK);
+
+  if (hdht == &dht11_zone1)
+  {
+    zone1_ok = ok;
+    if (ok)
+      zone1_data = *data;
+  }
+  else
+  {
+    dht11_ok = ok;
+    if (ok)
+    {
+      sensor_data = *data;
+      // 主传感器的温湿度用于SGP30湿度补偿
+      sgp30_set_humidity(data->temperature * 10 + (data->temperature_dec < 10 ? data->temperature_dec : 9),
+                         data->humidity * 10 + (data->humidity_dec < 10 ? data->humidity_dec : 9));
+    }
+  }
+
+  if (!ok)
+  {
+    // 发送读取错误消息
+    UART_TxEnqueueStr(&huart1, hdht == &dht11_zone1 ? "DHT11 Zone1 Read Error!\r\n"
+                                                    : "DHT11 Zone2 Read Error!\r\n");
+  }
+}
+
+/**
+ * @函数名      : Task_MQ4
+ * @描述        : 读取MQ4甲烷气体浓度（校准完成前跳过）
+ * @实现细节    : Q16定点结果四舍五入为0.1ppm，全程不使用浮点运算
+ */
+static void Task_MQ4(void)
+{
+  if (MQ4_GetCalibStatus() == MQ4_CALIB_DONE)
+    methane_x10 = (uint32_t)(((uint64_t)MQ4_ReadPPM_Q16() * 10U + 32768U) >> 16);
+}
+
+/**
+ * @函数名      : Task_SGP30
+ * @描述        : 取回上一秒的SGP30测量结果并发起本秒的测量
+ * @实现细节    : 测量命令严格按1Hz发出，结果由SGP30轮询任务在约12ms后收取，本任务不等待
+ */
+static void Task_SGP30(void)
+{
+  const uint8_t status = sgp30_read(&sgp30_data);
+  if (status == HAL_OK)
+  {
+    sgp30_ok = 1;
+  }
+  else if (status == HAL_ERROR)
+  {
+    sgp30_ok = 0;
+    UART_TxEnqueueStr(&huart1, "SGP30 Read Error!\r\n");
+  }
+
+  sgp30_measure();
+}
+
+/**
+ * @函数名      : Task_SGP30_Poll
+ * @描述        : 推进SGP30命令队列，空闲时立即返回
+ */
+static void Task_SGP30_Poll(void)
+{
+  sgp30_process();
+}
+
+/**
+ * @函数名      : Task_Dust
+ * @描述        : 读取GP2Y1014AU粉尘浓度并输出调试信息
+ */
+static void Task_Dust(void)
+{
+  density_x10 = GP2Y1014AU_ReadDustDensityX10();
+  voltage_mv = GP2Y1014AU_ReadVoltageMv();
+
+  // 输出传感器电压值，便于调试
+  char dust_debug[50];
+  Fmt_Buffer msg;
+  Fmt_Init(&msg, dust_debug, sizeof(dust_debug));
+  Fmt_Str(&msg, "Dust Sensor: V=");
+  Fmt_Fixed(&msg, (voltage_mv + 5) / 10, 2);
+  Fmt_Str(&msg, "V, PM2.5=");
+  Fmt_Fixed(&msg, density_x10, 1);
+  Fmt_Str(&msg, " ug/m^3\r\n");
+  UART_TxEnqueue(&huart1, (uint8_t *)dust_debug, Fmt_Len(&msg));
+}
+
+#if TELEMETRY_UART_FORMAT == TELEMETRY_FORMAT_BINARY
+/**
+ * @函数名      : Build_TelemetrySample
+ * @描述        : 将各传感器最新数据转换为定点遥测采样，并标记有效字段
+ */
+static void Build_TelemetrySample(Telemetry_Sample *sample)
+{
+  const uint8_t hum_dec = sensor_data.humidity_dec < 10 ? sensor_data.humidity_dec : 9;
+  const uint8_t temp_dec = sensor_data.temperature_dec < 10 ? sensor_data.temperature_dec : 9;
+
+  sample->humidity_x10 = sensor_data.humidity * 10 + hum_dec;
+  sample->temperature_x10 = sensor_data.temperature * 10 + temp_dec;
+  sample->methane_x10 = methane_x10;
+  sample->tvoc_ppb = sgp30_data.tvoc_ppb;
+  sample->co2_eq_ppm = sgp30_data.co2_eq_ppm;
+  sample->pm25_x10 = density_x10;
+
+  sample->valid = TELEMETRY_VALID_PM25;
+  if (dht11_ok)
+    sample->valid |= TELEMETRY_VALID_HUMIDITY | TELEMETRY_VALID_TEMPERATURE;
+  if (MQ4_GetCalibStatus() == MQ4_CALIB_DONE)
+    sample->valid |= TELEMETRY_VALID_METHANE;
+  if (sgp30_ok)
+    sample->valid |= TELEMETRY_VALID_TVOC | TELEMETRY_VALID_CO2;
+}
+#endif
+
+/**
+ * @函数名      : Task_Report
+ * @描述        : 汇总各传感器最新数据并上报（MQ4校准完成前不上报）
+ * @实现细节    : 调试串口始终输出文本行；发往ESP8266的数据格式由TELEMETRY_UART_FORMAT选择
+ */
+static void Task_Report(void)
+{
+  if (MQ4_GetCalibStatus() != MQ4_CALIB_DONE)
+    return;
+
+  char report[150];
+  Fmt_Buffer line;
+  Fmt_Init(&line, report, sizeof(report));
+  Fmt_Str(&line, "Humidity: ");
+  Fmt_U32(&line, sensor_data.humidity);
+  Fmt_Char(&line, '.');
+  Fmt_U32(&line, sensor_data.humidity_dec);
+  Fmt_Str(&line, "%, Temperature: ");
+  Fmt_U32(&line, sensor_data.temperature);
+  Fmt_Char(&line, '.');
+  Fmt_U32(&line, sensor_data.temperature_dec);
+  Fmt_Str(&line, " C, Methane: ");
+  Fmt_Fixed(&line, (int32_t)methane_x10, 1);
+  Fmt_Str(&line, " ppm, TVOC: ");
+  Fmt_U32(&line, sgp30_data.tvoc_ppb);
+  Fmt_Str(&line, " ppb, CO2eq: ");
+  Fmt_U32(&line, sgp30_data.co2_eq_ppm);
+  Fmt_Str(&line, " ppm, Dust(PM2.5): ");
+  Fmt_Fixed(&line, density_x10, 1);
+  Fmt_Str(&line, " ug/m^3\n");
+  const uint16_t report_len = Fmt_Len(&line);
+  // 在发送数据前打印内容到调试串口（USART1），入队后立即返回，由DMA在后台发送
+  UART_TxEnqueueStr(&huart1, "[STM32] Sending: ");
+  UART_TxEnqueue(&huart1, (uint8_t *)report, report_len);
+  UART_TxEnqueueStr(&huart1, "\n"); // 换行
+
+  // 传感器1仅输出到调试串口，附带读取统计
+  const DHT11_Stats *zone1_stats = DHT11_GetStats(&dht11_zone1);
+  char zone1[112];
+  Fmt_Buffer msg;
+  Fmt_Init(&msg, zone1, sizeof(zone1));
+  Fmt_Str(&msg, "[DHT11] Zone1: ");
+  Fmt_Str(&msg, zone1_ok ? "OK " : "ERR ");
+  Fmt_U32(&msg, zone1_data.humidity);
+  Fmt_Char(&msg, '.');
+  Fmt_U32(&msg, zone1_data.humidity_dec);
+  Fmt_Str(&msg, "%, ");
+  Fmt_U32(&msg, zone1_data.temperature);
+  Fmt_Char(&msg, '.');
+  Fmt_U32(&msg, zone1_data.temperature_dec);
+  Fmt_Str(&msg, " C, reads ");
+  Fmt_U32(&msg, zone1_stats->reads);
+  Fmt_Str(&msg, ", errors ");
+  Fmt_U32(&msg, zone1_stats->timeouts + zone1_stats->decode_errors + zone1_stats->range_errors);
+  Fmt_Str(&msg, ", latency ");
+  Fmt_U32(&msg, zone1_stats->last_latency_ms);
+  Fmt_Char(&msg, '/');
+  Fmt_U32(&msg, zone1_stats->max_latency_ms);
+  Fmt_Str(&msg, " ms\r\n");
+  UART_TxEnqueue(&huart1, (uint8_t *)zone1, Fmt_Len(&msg));
+
+  // 由内部参考电压和温度传感器得到的供电电压与芯片温度
+  char adc_info[48];
+  Fmt_Init(&msg, adc_info, sizeof(adc_info));
+  Fmt_Str(&msg, "[ADC] VDDA: ");
+  Fmt_U32(&msg, ADC_Acq_GetVddMv());
+  Fmt_Str(&msg, " mV, Chip: ");
+  Fmt_Fixed(&msg, ADC_Acq_GetTempX10(), 1);
+  Fmt_Str(&msg, " C\r\n");
+  UART_TxEnqueue(&huart1, (uint8_t *)adc_info, Fmt_Len(&msg));
+
+  // 发送到ESP8266
+#if TELEMETRY_UART_FORMAT == TELEMETRY_FORMAT_BINARY
+  static uint16_t report_seq = 0; // 遥测帧序号
+  Telemetry_Sample sample;
+  uint8_t frame[TELEMETRY_FRAME_SIZE];
+  Build_TelemetrySample(&sample);
+  uint8_t frame_len = Telemetry_EncodeFrame(&sample, report_seq++, HAL_GetTick(), frame);
+  UART_TxEnqueue(&huart4, frame, frame_len);
+#else
+  UART_TxEnqueue(&huart4, (uint8_t *)report, report_len);
+  UART_TxEnqueueStr(&huart4, "\n"); // 仅发送\n
+#endif
+}
+/**
+ * @函数名      : Add_Task
+ * @描述        : 注册周期任务，失败时在调试串口（USART1）报告任务名
+ * @参数        : 同Scheduler_AddTask
+ * @返回值      : 无
+ * @注意事项    : 任务表已满时该任务不会运行，对应传感器停止更新，须增大SCHEDULER_MAX_TASKS
+ */
+static void Add_Task(const char *name, Scheduler_TaskFn fn, uint32_t period_ms, uint32_t offset_ms,
+                     uint32_t deadline_ms)
+{
+  if (Scheduler_AddTask(name, fn, period_ms, offset_ms, deadline_ms) < 0)
+  {
+    UART_TxEnqueueStr(&huart1, "[SCHED] Failed to register task: ");
+    UART_TxEnqueueStr(&huart1, name);
+    UART_TxEnqueueStr(&huart1, "\r\n");
+  }
+}
 /* USER CODE END 0 */
 
 /**
@@ -111,28 +430,52 @@ int main(void)
   /* USER CODE BEGIN 2 */
   /* 初始化传感器 */
   // 初始化DHT11温湿度传感器
-  DHT11_Init(DHT11_DATA2_GPIO_Port, DHT11_DATA2_Pin);
-  char uart_buf[50];      // 定义UART发送缓冲区
-  DHT11_Data sensor_data; // 定义DHT11数据结构体
+  DHT11_Init(&dht11_zone1, DHT11_DATA_GPIO_Port, DHT11_DATA_Pin);
+  DHT11_Init(&dht11_zone2, DHT11_DATA2_GPIO_Port, DHT11_DATA2_Pin);
+  DHT11_SetCallback(&dht11_zone1, DHT11_ReadDone);
+  DHT11_SetCallback(&dht11_zone2, DHT11_ReadDone);
+
+  // 启动ADC1连续扫描采集（MQ4、内部温度/参考电压），各驱动读取其最新结果
+  if (ADC_Acq_Start(&hadc1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  // 挂载Flash参数区，保存MQ4校准结果等
+  NVStore_Init(&NVStore_InternalFlash);
 
-  // 初始化MQ4甲烷气体传感器
-  MQ4_Init(&hadc1);              // 传递ADC句柄
-  MQ4_CalibState mq4_calib_stat; // 校准状态跟踪变量
+  // 初始化MQ4甲烷气体传感器，Flash中有R0时无需等待校准
+  MQ4_Init();
+  if (MQ4_IsWarmStart())
+  {
+    UART_TxEnqueueStr(&huart1, "[MQ4] R0 restored from flash, recalibrating in background\r\n");
+  }
 
   // 初始化SGP30气体传感器
   sgp30_init(&hi2c2);
-  SGP30_DATA sgp30_data;
   // 报告初始化完成
-  HAL_UART_Transmit(&huart1, (uint8_t *)"SGP30 Initialization, wait for the warm-up...\r\n", 47, 100);
+  UART_TxEnqueueStr(&huart1, "SGP30 Initialization, wait for the warm-up...\r\n");
 
   // 粉尘传感器初始化
-  GP2Y1014AU_Init(&hadc1, &htim3);
+  // TIM3产生10ms周期的LED脉冲，并在280us处触发ADC2采样
+  if (GP2Y1014AU_Init(&hadc2, &htim3) != HAL_OK)
+  {
+    Error_Handler();
+  }
 
   // 发送粉尘传感器初始化完成消息
-  HAL_UART_Transmit(&huart1, (uint8_t *)"GP2Y1014AU Dust Sensor Initialization Complete\r\n", 48, 100);
-
-  // 报告数据
-  char report[150];
+  UART_TxEnqueueStr(&huart1, "GP2Y1014AU Dust Sensor Initialization Complete\r\n");
+
+  /* 注册周期任务，以SysTick毫秒节拍为时间基准 */
+  Scheduler_Init(HAL_GetTick);
+  Add_Task("mq4_calib", Task_MQ4_Calibrate, TASK_MQ4_CALIB_PERIOD, 0, 0);
+  Add_Task("dht11", Task_DHT11, TASK_DHT11_PERIOD, TASK_DHT11_OFFSET, TASK_DHT11_DEADLINE);
+  Add_Task("dht11_poll", Task_DHT11_Poll, TASK_DHT11_POLL_PERIOD, 0, 0);
+  Add_Task("mq4", Task_MQ4, TASK_MQ4_PERIOD, TASK_MQ4_OFFSET, 0);
+  Add_Task("sgp30", Task_SGP30, TASK_SGP30_PERIOD, TASK_SGP30_OFFSET, TASK_SGP30_DEADLINE);
+  Add_Task("sgp30_poll", Task_SGP30_Poll, TASK_SGP30_POLL_PERIOD, 0, 0);
+  Add_Task("dust", Task_Dust, TASK_DUST_PERIOD, TASK_DUST_OFFSET, 0);
+  Add_Task("report", Task_Report, TASK_REPORT_PERIOD, TASK_REPORT_OFFSET, 0);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -142,80 +485,11 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-
-    /* MQ4传感器校准处理 */
-    mq4_calib_stat = MQ4_GetCalibStatus();
-    if (mq4_calib_stat != MQ4_CALIB_DONE)
+    // 依次执行到期任务；无到期任务时休眠，等待下一个SysTick中断唤醒
+    if (!Scheduler_Dispatch())
     {
-      // 执行校准过程（非阻塞）
-      MQ4_Calibrate();
-
-      // 每秒发送一次校准状态信息
-      static uint32_t last_msg = 0;
-      if (HAL_GetTick() - last_msg > 1000)
-      {
-        char buf[60];
-        int len = snprintf(buf, sizeof(buf),
-                           "[MQ4] Calibrating... %d/%d samples, Remain: %ds\r\n",
-                           MQ4_GetSampleCount(),      // 已采样次数
-                           MQ4_GetCalibrationTotal(), // 总采样次数
-                           MQ4_GetRemainingTime());   // 剩余校准时间
-        // 确保使用实际长度而非strlen
-        HAL_UART_Transmit(&huart1, (uint8_t *)buf, len, 100);
-        last_msg = HAL_GetTick();
-      }
-      HAL_Delay(200);
-      continue; // 跳过传感器数据采集，继续校准
+      __WFI();
     }
-
-    /* 传感器数据采集与发送 */
-    // 1. 读取DHT11温湿度数据
-    if (DHT11_Read(&sensor_data) != HAL_OK)
-    {
-      // 发送读取错误消息
-      const char *err_msg = "DHT11 Read Error!\r\n";
-      HAL_UART_Transmit(&huart1, (uint8_t *)err_msg, 20, 300);
-    }
-
-    // 2. 读取MQ4甲烷气体浓度数据
-    float ppm = MQ4_ReadPPM();
-
-    // 3. 读取SGP30二氧化碳和TVOC浓度
-    if (sgp30_read(&sgp30_data) != HAL_OK)
-    {
-      // 添加错误处理
-      HAL_UART_Transmit(&huart1, (uint8_t *)"SGP30 Read Error!\r\n", 19, 100);
-    }
-
-    // 4. 读取GP2Y1014AU读取PM2.5
-    float density = GP2Y1014AU_ReadDustDensity();
-    float voltage = GP2Y1014AU_ReadVoltage();
-
-    // 输出传感器电压值，便于调试
-    char dust_debug[50];
-    int debug_len = snprintf(dust_debug, sizeof(dust_debug), "Dust Sensor: V=%.2fV, PM2.5=%.1f ug/m^3\r\n",
-                             voltage, density);
-    HAL_UART_Transmit(&huart1, (uint8_t *)dust_debug, debug_len, 100);
-
-    // 发送所有数据
-    int report_len = snprintf(report, sizeof(report),
-                              "Humidity: %d.%d%%, Temperature: %d.%d C, Methane: %.1f ppm, TVOC: %u ppb, CO2eq: %u ppm, Dust(PM2.5): %.1f ug/m^3\n",
-                              sensor_data.humidity, sensor_data.humidity_dec,
-                              sensor_data.temperature, sensor_data.temperature_dec,
-                              ppm, sgp30_data.tvoc_ppb, sgp30_data.co2_eq_ppm,
-                              density);
-    // 单次UART传输所有数据
-    // 在发送数据前打印内容到调试串口（USART1）
-    HAL_UART_Transmit(&huart1, (uint8_t *)"[STM32] Sending: ", 15, 100);
-    HAL_UART_Transmit(&huart1, (uint8_t *)report, report_len, 100);
-    HAL_UART_Transmit(&huart1, (uint8_t *)"\n", 1, 100); // 换行
-
-    // 发送到ESP8266
-    HAL_UART_Transmit(&huart4, (uint8_t *)report, report_len, 100);
-    HAL_UART_Transmit(&huart4, (uint8_t *)"\n", 1, 100); // 仅发送\n
-
-    // 延时2秒再次读取，避免频繁读取传感器
-    HAL_Delay(1000);
   }
   /* USER CODE END 3 */
 }
@@ -266,7 +540,66 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+ * @brief  EXTI line detection callback.
+ * @param  GPIO_Pin: Specifies the pin connected to the EXTI line.
+ * @retval None
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  DHT11_EXTI_Callback(GPIO_Pin);
+}
 
+/**
+ * @brief  Regular conversion half DMA transfer callback.
+ * @param  hadc: ADC handle
+ * @retval None
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  ADC_Acq_DMA_Callback(hadc, 0);
+}
+
+/**
+ * @brief  Regular conversion complete callback.
+ * @param  hadc: ADC handle
+ * @retval None
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  ADC_Acq_DMA_Callback(hadc, 1);
+  GP2Y1014AU_ADC_Callback(hadc);
+}
+
+/**
+ * @brief  Master Tx Transfer completed callback.
+ * @param  hi2c: I2C handle
+ * @retval None
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  sgp30_i2c_event(hi2c, SGP30_I2C_TX_DONE);
+}
+
+/**
+ * @brief  Master Rx Transfer completed callback.
+ * @param  hi2c: I2C handle
+ * @retval None
+ */
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  sgp30_i2c_event(hi2c, SGP30_I2C_RX_DONE);
+}
+
+/**
+ * @brief  I2C error callback.
+ * @param  hi2c: I2C handle
+ * @retval None
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  sgp30_i2c_event(hi2c, SGP30_I2C_ERROR);
+}
 /* USER CODE END 4 */
 
 /**
@@ -3,19 +3,81 @@
  * @描述        : MQ4甲烷气体传感器驱动实现
  * @注意事项    : MQ4传感器需要预热和校准后才能提供准确读数
  *                校准需要在干净空气中进行，总时间约300秒
+ *                校准得到的R0保存在Flash中（nvstore），上电后直接加载即可上报，
+ *                之后在后台周期性重新校准，按权重融合到R0并回写Flash
+ *                浓度换算全程使用定点运算（Cortex-M3无FPU），不调用pow/log10
  */
 
 #include "mq4.h"
 #include "math.h"
 #include "main.h"
+#include "adc_acq/adc_acq.h"
+#include "nvstore/nvstore.h"
 #include <stdint.h> // 添加标准整数类型头文件
 
 /**
  * 模块私有变量定义
  */
-static ADC_HandleTypeDef *hadc_mq4 = NULL; // ADC句柄
 static float R0 = 10.0f;				   // 默认校准电阻值（单位KΩ）
 static const float RL = 10.0f;			   // 负载电阻值（单位KΩ）
+static uint8_t r0_valid = 0;			   // R0是否可用（已校准或从Flash加载）
+static uint8_t warm_start = 0;			   // R0是否从Flash加载
+
+/* 后台重新校准参数 */
+#define MQ4_RECAL_INTERVAL_MS (6UL * 3600UL * 1000UL) // 两次重新校准的间隔(6小时)
+#define MQ4_RECAL_WEIGHT_SHIFT 2					  // 新测量值的融合权重为1/4
+#define MQ4_SAVE_THRESHOLD 0.01f					  // R0变化超过1%才回写Flash
+#define MQ4_R0_MIN 0.5f								  // 合理的R0范围(KΩ)，超出视为无效
+#define MQ4_R0_MAX 200.0f
+
+/* 特性曲线：log10(Rs/R0) = a * log10(ppm) + b，由MQ4数据手册曲线拟合 */
+#define MQ4_CURVE_A (-0.65)
+#define MQ4_CURVE_B 0.74
+
+/*
+ * 定点换算（Q16，即低16位为小数）
+ * 由分压关系 Rs = RL * (FS - adc) / adc，曲线可改写为
+ *   log2(ppm) = log2(K) + S * (t + log2(R0 / RL))，t = log2(adc) - log2(FS - adc)
+ * 其中 S = -1/a，log2(K) = -b/a * log2(10)
+ * 以t为横轴建立分段线性查找表，R0变化时重建，读数时只需两次定点log2、一次查表插值和一次定点exp2
+ */
+#define Q16_ONE 65536
+#define MQ4_SLOPE_Q16 ((int32_t)(-65536.0 / MQ4_CURVE_A + 0.5))
+#define MQ4_LOG2K_Q16 ((int32_t)(-MQ4_CURVE_B / MQ4_CURVE_A * 3.321928094887362 * 65536.0 + 0.5))
+/*
+ * 查表横轴范围：1 <= adc <= FS-1时|t| < log2(FS) = 12 + ADC_ACQ_OVERSAMPLE_BITS，两端各留1.0余量，
+ * 横轴每1.0一个节点（默认过采样2位时为[-15, 15]共31个节点）
+ */
+#define MQ4_CURVE_T_MIN (-(13 + ADC_ACQ_OVERSAMPLE_BITS))
+#define MQ4_CURVE_POINTS (2 * (13 + ADC_ACQ_OVERSAMPLE_BITS) + 1)
+#define MQ4_PPM_LOG2_MAX (16 * Q16_ONE) // 结果上限2^16 ppm，超出量程时饱和
+
+/* log2(1 + i/32)与2^(i/32)，Q16 */
+static const int32_t log2_table[33] = {
+	0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+	27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904, 47705,
+	49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047, 65536};
+static const uint32_t exp2_table[33] = {
+	65536, 66971, 68438, 69936, 71468, 73032, 74632, 76266, 77936, 79642, 81386,
+	83169, 84990, 86851, 88752, 90696, 92682, 94711, 96785, 98905, 101070, 103283,
+	105545, 107856, 110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263, 131072};
+
+static int32_t curve[MQ4_CURVE_POINTS]; // 各节点的log2(ppm)，Q16，随R0重建
+
+/**
+ * Flash中保存的校准记录
+ */
+typedef struct
+{
+	uint32_t r0_q16;	  // R0(KΩ)，Q16.16定点
+	uint32_t calib_count; // 累计完成的校准次数
+	uint32_t operating_s; // 保存时的累计运行时间(s)，仅供诊断：只在保存时更新，
+						  // 且没有RTC无法得知断电时长，不能据此判断R0的新旧
+} MQ4_StoredCalib;
+
+static MQ4_StoredCalib stored = {0}; // 最近一次加载或保存的记录
+static float saved_r0 = 0.0f;		  // Flash中的R0，用于判断是否需要回写
+static uint32_t boot_operating_s = 0; // 上电时加载的记录中的累计运行时间(s)
 
 /**
  * 校准相关变量结构
@@ -26,19 +88,105 @@ static struct
 	uint16_t sample_count;	   // 已采样次数计数
 	float sum_adc;			   // ADC采样值累加和
 	MQ4_CalibState state;	   // 校准状态
+	uint32_t done_time;		   // 上次校准完成的时间戳
 } calibration = {0};
 
+/**
+ * @函数名      : log2_q16
+ * @描述        : 定点log2
+ * @参数        : x - 正整数
+ * @返回值      : int32_t - log2(x)，Q16
+ * @实现细节    : 整数部分为最高位序号；尾数取其后5位查表，再用后续11位线性插值，误差小于2e-4
+ */
+static int32_t log2_q16(uint32_t x)
+{
+	const uint32_t msb = 31U - __CLZ(x);
+	const uint32_t m = x << (31U - msb); // 归一化到[2^31, 2^32)
+	const uint32_t idx = (m >> 26) & 0x1FU;
+	const uint32_t frac = (m >> 15) & 0x7FFU;
+	const int32_t lo = log2_table[idx];
+
+	return (int32_t)(msb << 16) + lo + (((log2_table[idx + 1] - lo) * (int32_t)frac) >> 11);
+}
+
+/**
+ * @函数名      : exp2_q16
+ * @描述        : 定点2^y
+ * @参数        : y - 指数，Q16，须小于MQ4_PPM_LOG2_MAX
+ * @返回值      : uint32_t - 2^y，Q16；过小时为0
+ */
+static uint32_t exp2_q16(int32_t y)
+{
+	const int32_t ipart = y >> 16; // 向负无穷取整
+	const uint32_t f = (uint32_t)y & 0xFFFFU;
+	const uint32_t idx = f >> 11;
+	const uint32_t lo = exp2_table[idx];
+	const uint32_t m = lo + (((exp2_table[idx + 1] - lo) * (f & 0x7FFU)) >> 11);
+
+	if (ipart >= 0)
+		return m << ipart;
+	return ipart > -17 ? m >> -ipart : 0;
+}
+
+/**
+ * @函数名      : build_curve
+ * @描述        : 按当前R0重建特性曲线查找表
+ * @注意事项    : R0每次变化（加载、首次校准、后台重新校准）后调用
+ */
+static void build_curve(void)
+{
+	const int32_t r0_offset = log2_q16((uint32_t)(R0 * Q16_ONE)) - log2_q16((uint32_t)(RL * Q16_ONE));
+
+	for (int32_t i = 0; i < MQ4_CURVE_POINTS; i++)
+	{
+		const int64_t t = (int64_t)(MQ4_CURVE_T_MIN + i) * Q16_ONE + r0_offset;
+		curve[i] = MQ4_LOG2K_Q16 + (int32_t)((t * MQ4_SLOPE_Q16) >> 16);
+	}
+}
+
+/**
+ * @函数名      : save_r0
+ * @描述        : 将R0写入Flash
+ * @注意事项    : 擦写Flash时CPU会停顿，仅在校准完成且R0变化明显时调用
+ */
+static void save_r0(void)
+{
+	stored.r0_q16 = (uint32_t)(R0 * 65536.0f);
+	stored.calib_count++;
+	stored.operating_s = boot_operating_s + HAL_GetTick() / 1000;
+	if (NVStore_Write(NVSTORE_KEY_MQ4_R0, &stored, sizeof(stored)) == HAL_OK)
+		saved_r0 = R0;
+}
+
 /**
  * @函数名      : MQ4_Init
  * @描述        : 初始化MQ4甲烷传感器
- * @参数        : hadc - MQ4传感器连接的ADC句柄指针
+ * @参数        : 无
  * @返回值      : 无
- * @实现细节    : 保存ADC句柄并初始化校准状态
+ * @实现细节    : 初始化校准状态，并尝试从Flash加载R0（热启动）
+ *                加载成功后立即可读取浓度，校准转为后台执行
  */
-void MQ4_Init(ADC_HandleTypeDef *hadc)
+void MQ4_Init(void)
 {
-	hadc_mq4 = hadc;
 	calibration.state = MQ4_CALIB_IDLE;
+	r0_valid = 0;
+	warm_start = 0;
+
+	if (NVStore_Read(NVSTORE_KEY_MQ4_R0, &stored, sizeof(stored)) == HAL_OK)
+	{
+		const float r0 = stored.r0_q16 / 65536.0f;
+		if (r0 >= MQ4_R0_MIN && r0 <= MQ4_R0_MAX)
+		{
+			R0 = r0;
+			saved_r0 = r0;
+			r0_valid = 1;
+			warm_start = 1;
+			boot_operating_s = stored.operating_s;
+			build_curve();
+		}
+	}
+	if (!warm_start)
+		stored = (MQ4_StoredCalib){0};
 }
 
 /**
@@ -46,24 +194,46 @@ void MQ4_Init(ADC_HandleTypeDef *hadc)
  * @描述        : 获取当前校准状态
  * @参数        : 无
  * @返回值      : MQ4_CalibState - 当前校准状态
+ * @实现细节    : R0可用后（包括从Flash加载）始终返回MQ4_CALIB_DONE，后台重新校准不影响读数
  */
 MQ4_CalibState MQ4_GetCalibStatus(void)
 {
-	return calibration.state;
+	return r0_valid ? MQ4_CALIB_DONE : calibration.state;
+}
+
+/**
+ * @函数名      : MQ4_IsWarmStart
+ * @描述        : 判断本次上电的R0是否从Flash加载
+ * @参数        : 无
+ * @返回值      : uint8_t - 1: 已从Flash加载; 0: 需要完整校准
+ */
+uint8_t MQ4_IsWarmStart(void)
+{
+	return warm_start;
+}
+
+/**
+ * @函数名      : MQ4_GetR0
+ * @描述        : 获取当前使用的R0
+ * @参数        : 无
+ * @返回值      : float - R0(KΩ)
+ */
+float MQ4_GetR0(void)
+{
+	return R0;
 }
 
 /**
  * @函数名      : read_adc
  * @描述        : 读取MQ4传感器ADC值的内部函数
  * @参数        : 无
- * @返回值      : uint32_t - ADC原始读数
+ * @返回值      : uint32_t - ADC读数（0至ADC_ACQ_FULL_SCALE）
  * @注意事项    : 此函数为模块内部使用，不对外暴露
+ *                直接读取采集引擎的最新过采样结果，不启动转换
  */
 static uint32_t read_adc(void)
 {
-	HAL_ADC_Start(hadc_mq4);
-	HAL_ADC_PollForConversion(hadc_mq4, 100); // 等待转换完成，超时100ms
-	return HAL_ADC_GetValue(hadc_mq4);
+	return ADC_Acq_Get(ADC_ACQ_CH_MQ4);
 }
 
 /**
@@ -75,7 +245,9 @@ static uint32_t read_adc(void)
  *   1. 根据校准状态执行不同操作
  *   2. 在IDLE状态初始化校准参数
  *   3. 在RUNNING状态每6秒采集一次样本，50个样本后完成校准
- *   4. 在DONE状态不执行任何操作
+ *      首次校准直接采用测量值；已有R0时按1/4权重融合，减小环境波动的影响
+ *      R0变化超过1%时回写Flash
+ *   4. 在DONE状态等待MQ4_RECAL_INTERVAL_MS后开始下一轮后台校准
  */
 void MQ4_Calibrate(void)
 {
@@ -103,45 +275,81 @@ void MQ4_Calibrate(void)
 			if (calibration.sample_count >= MQ4_GetCalibrationTotal())
 			{
 				// 计算平均电压和R0电阻值
-				float Vrl = (calibration.sum_adc / temp) * 3.3f / 4095.0f;
-				R0 = (3.3f - Vrl) * RL / Vrl; // 基于分压电路计算R0
+				float Vrl = (calibration.sum_adc / temp) * 3.3f / ADC_ACQ_FULL_SCALE;
+				float measured = (3.3f - Vrl) * RL / Vrl; // 基于分压电路计算R0
+
+				if (Vrl > 0.0f && measured >= MQ4_R0_MIN && measured <= MQ4_R0_MAX)
+				{
+					if (r0_valid)
+						R0 += (measured - R0) / (1 << MQ4_RECAL_WEIGHT_SHIFT);
+					else
+						R0 = measured;
+					r0_valid = 1;
+					build_curve();
+
+					if (saved_r0 == 0.0f || fabsf(R0 - saved_r0) > saved_r0 * MQ4_SAVE_THRESHOLD)
+						save_r0();
+				}
+				calibration.done_time = HAL_GetTick();
 				calibration.state = MQ4_CALIB_DONE;
 			}
 		}
 		break;
 
 	case MQ4_CALIB_DONE:
-		// 校准完成，无需操作
+		// 等待下一轮后台校准；测量结果无效时（R0仍不可用）立即重新校准
+		if (!r0_valid || HAL_GetTick() - calibration.done_time >= MQ4_RECAL_INTERVAL_MS)
+			calibration.state = MQ4_CALIB_IDLE;
 		break;
 	}
 }
 
+/**
+ * @函数名      : MQ4_ReadPPM_Q16
+ * @描述        : 读取甲烷气体浓度（定点）
+ * @参数        : 无
+ * @返回值      : uint32_t - 甲烷浓度(PPM)，Q16；超出量程时饱和为0xFFFFFFFF
+ * @实现细节    :
+ *   1. 由ADC读数计算t = log2(adc) - log2(FS - adc)，即log2(Rs/RL)的相反数，R0已包含在查找表中
+ *   2. 在特性曲线查找表中线性插值得到log2(ppm)
+ *   3. 定点exp2得到浓度
+ *   ADC为0（Rs无穷大）时浓度为0，满量程（Rs为0）时饱和
+ */
+uint32_t MQ4_ReadPPM_Q16(void)
+{
+	const uint32_t adc_val = read_adc();
+
+	if (adc_val == 0)
+		return 0;
+	if (adc_val >= ADC_ACQ_FULL_SCALE)
+		return UINT32_MAX;
+
+	const int32_t t = log2_q16(adc_val) - log2_q16(ADC_ACQ_FULL_SCALE - adc_val);
+	// 横轴范围由ADC_ACQ_FULL_SCALE导出，保证 0 < pos < (MQ4_CURVE_POINTS-1)*Q16_ONE
+	const int32_t pos = t - MQ4_CURVE_T_MIN * Q16_ONE;
+	const int32_t i = pos >> 16;
+	const int32_t frac = pos & 0xFFFF;
+	const int32_t y = curve[i] + (int32_t)(((int64_t)(curve[i + 1] - curve[i]) * frac) >> 16);
+
+	if (y >= MQ4_PPM_LOG2_MAX)
+		return UINT32_MAX;
+	return exp2_q16(y);
+}
+
 /**
  * @函数名      : MQ4_ReadPPM
  * @描述        : 读取甲烷气体浓度
  * @参数        : 无
  * @返回值      : float - 甲烷浓度(PPM)，校准未完成时返回-1.0
- * @实现细节    :
- *   1. 检查校准状态，未完成则返回-1.0
- *   2. 读取ADC值并转换为电压
- *   3. 计算传感器电阻Rs
- *   4. 基于Rs/R0比值和MQ4特性曲线公式计算PPM值
+ * @实现细节    : 由MQ4_ReadPPM_Q16换算，只有一次整数到浮点的转换
  */
 float MQ4_ReadPPM(void)
 {
 	// 校准未完成则返回错误值
-	if (calibration.state != MQ4_CALIB_DONE)
+	if (!r0_valid)
 		return -1.0f;
 
-	// 读取ADC值并转换为电压和电阻
-	const uint32_t adc_val = read_adc();
-	const float Vrl = adc_val * 3.3f / 4095.0f; // 电压值 (基于3.3V参考电压和12位ADC)
-	const float Rs = (3.3f - Vrl) * RL / Vrl;	// 传感器电阻值
-
-	// 根据MQ-4特性曲线拟合的公式计算PPM值
-	// 公式基于log-log特性曲线: log(ppm) = (log(Rs/R0) - b) / a
-	// 其中a = -0.32, b = 0.48 (根据MQ4数据手册曲线拟合得到)
-	return pow(10.0f, (log10(Rs / R0) - 0.74f) / (-0.65f));
+	return MQ4_ReadPPM_Q16() / (float)Q16_ONE;
 }
 
 /**
@@ -25,18 +25,20 @@ extern "C"
 	/**
 	 * @函数名      : MQ4_Init
 	 * @描述        : 初始化MQ4甲烷传感器
-	 * @参数        : hadc - MQ4传感器连接的ADC句柄指针
+	 * @参数        : 无
 	 * @返回值      : 无
 	 * @注意事项    : 使用前必须调用此函数进行初始化
+	 *                传感器电压取自ADC采集引擎（adc_acq）的最新过采样结果，须先调用ADC_Acq_Start
+	 *                R0从nvstore加载，须先调用NVStore_Init
 	 */
-	void MQ4_Init(ADC_HandleTypeDef *hadc);
+	void MQ4_Init(void);
 
 	/**
 	 * @函数名      : MQ4_Calibrate
 	 * @描述        : 执行MQ4传感器校准（非阻塞方式）
 	 * @参数        : 无
 	 * @返回值      : 无
-	 * @注意事项    : 需要在主循环中重复调用，直至校准完成
+	 * @注意事项    : 需要在主循环中持续调用：校准完成后每6小时在后台重新校准一次
 	 *                总校准时间约为300秒(5分钟)
 	 */
 	void MQ4_Calibrate(void);
@@ -50,14 +52,40 @@ extern "C"
 	 */
 	float MQ4_ReadPPM(void);
 
+	/**
+	 * @函数名      : MQ4_ReadPPM_Q16
+	 * @描述        : 读取甲烷气体浓度（定点，不使用浮点运算）
+	 * @参数        : 无
+	 * @返回值      : uint32_t - 甲烷浓度(PPM)，Q16（低16位为小数）；超出量程时饱和为0xFFFFFFFF
+	 * @注意事项    : 只有在校准完成后读数才有效，调用前应检查MQ4_GetCalibStatus
+	 */
+	uint32_t MQ4_ReadPPM_Q16(void);
+
 	/**
 	 * @函数名      : MQ4_GetCalibStatus
 	 * @描述        : 获取当前校准状态
 	 * @参数        : 无
 	 * @返回值      : MQ4_CalibState - 当前校准状态
+	 * @注意事项    : R0可用后（包括从Flash加载）始终返回MQ4_CALIB_DONE
 	 */
 	MQ4_CalibState MQ4_GetCalibStatus(void);
 
+	/**
+	 * @函数名      : MQ4_IsWarmStart
+	 * @描述        : 判断本次上电的R0是否从Flash加载
+	 * @参数        : 无
+	 * @返回值      : uint8_t - 1: 已从Flash加载; 0: 需要完整校准
+	 */
+	uint8_t MQ4_IsWarmStart(void);
+
+	/**
+	 * @函数名      : MQ4_GetR0
+	 * @描述        : 获取当前使用的R0
+	 * @参数        : 无
+	 * @返回值      : float - R0(KΩ)
+	 */
+	float MQ4_GetR0(void);
+
 	/**
 	 * @函数名      : MQ4_GetSampleCount
 	 * @描述        : 获取当前已采集的校准样本数
@@ -0,0 +1,324 @@
+/**
+ * @文件        : nvstore.c
+ * @描述        : 基于片内Flash的小型键值存储实现
+ * @注意事项    : 布局说明见nvstore.h
+ */
+
+#include "nvstore.h"
+#include "crc/crc.h"
+#include <string.h>
+
+/* 页标识与布局 */
+#define NVSTORE_PAGE_MAGIC 0x3153564EU // "NVS1"
+#define PAGE_HEADER_SIZE 8
+#define RECORD_HEADER_SIZE 4
+#define KEY_ERASED 0xFF
+#define RECORD_SIZE(len) (RECORD_HEADER_SIZE + (((uint32_t)(len) + 3U) & ~3U))
+
+/* 目标板Flash存储区：STM32F103ZC共256KB，使用最后两页 */
+#define INTERNAL_FLASH_BASE 0x0803F000U
+#define INTERNAL_FLASH_PAGE_SIZE 0x800U
+
+/* 私有变量 */
+static const NVStore_FlashOps *flash = NULL;
+static uint8_t active_page = 0;	   // 当前页(0/1)
+static uint32_t generation = 0;	   // 当前页序号
+static uint32_t write_offset = 0; // 当前页内下一条记录的偏移
+
+static uint32_t page_base(uint8_t page)
+{
+	return (uint32_t)page * flash->page_size;
+}
+
+/**
+ * @函数名      : read_page_header
+ * @描述        : 读取页标识，返回页是否有效并输出页序号
+ */
+static uint8_t read_page_header(uint8_t page, uint32_t *gen)
+{
+	uint8_t header[PAGE_HEADER_SIZE];
+	flash->read(page_base(page), header, sizeof(header));
+
+	const uint32_t magic = header[0] | header[1] << 8 | header[2] << 16 | (uint32_t)header[3] << 24;
+	*gen = header[4] | header[5] << 8 | header[6] << 16 | (uint32_t)header[7] << 24;
+	return magic == NVSTORE_PAGE_MAGIC;
+}
+
+/**
+ * @函数名      : write_page_header
+ * @描述        : 写入页标识，须在页内记录全部写完后调用
+ */
+static HAL_StatusTypeDef write_page_header(uint8_t page, uint32_t gen)
+{
+	const uint8_t header[PAGE_HEADER_SIZE] = {
+		(uint8_t)NVSTORE_PAGE_MAGIC, (uint8_t)(NVSTORE_PAGE_MAGIC >> 8),
+		(uint8_t)(NVSTORE_PAGE_MAGIC >> 16), (uint8_t)(NVSTORE_PAGE_MAGIC >> 24),
+		(uint8_t)gen, (uint8_t)(gen >> 8), (uint8_t)(gen >> 16), (uint8_t)(gen >> 24)};
+	return flash->program(page_base(page), header, sizeof(header));
+}
+
+/**
+ * @函数名      : read_record
+ * @描述        : 读取页内offset处的记录
+ * @参数        : offset - 页内偏移，返回时指向下一条记录
+ * @返回值      : 1 - 记录有效(CRC正确); 0 - 记录损坏; -1 - 记录区结束
+ */
+static int8_t read_record(uint8_t page, uint32_t *offset, uint8_t *key, uint8_t *data, uint8_t *len)
+{
+	uint8_t header[RECORD_HEADER_SIZE];
+
+	if (*offset + RECORD_HEADER_SIZE > flash->page_size)
+		return -1;
+
+	flash->read(page_base(page) + *offset, header, sizeof(header));
+	if (header[0] == KEY_ERASED)
+		return -1;
+	if (header[1] > NVSTORE_MAX_DATA || *offset + RECORD_SIZE(header[1]) > flash->page_size)
+	{
+		// 长度字段损坏，无法定位后续记录，视为记录区结束
+		*offset = flash->page_size;
+		return 0;
+	}
+
+	*key = header[0];
+	*len = header[1];
+	flash->read(page_base(page) + *offset + RECORD_HEADER_SIZE, data, *len);
+	*offset += RECORD_SIZE(*len);
+
+	const uint16_t crc = CRC16_CCITT_Update(CRC16_CCITT(header, 2), data, *len);
+	return crc == (uint16_t)(header[2] | header[3] << 8);
+}
+
+/**
+ * @函数名      : find_latest
+ * @描述        : 在当前页中查找键的最新有效记录
+ * @返回值      : 1 - 找到; 0 - 未找到
+ */
+static uint8_t find_latest(uint8_t key, uint8_t *data, uint8_t *len)
+{
+	uint8_t rec_key, rec_len, rec_data[NVSTORE_MAX_DATA];
+	uint32_t offset = PAGE_HEADER_SIZE;
+	uint8_t found = 0;
+	int8_t result;
+
+	while ((result = read_record(active_page, &offset, &rec_key, rec_data, &rec_len)) >= 0)
+	{
+		if (result == 1 && rec_key == key)
+		{
+			memcpy(data, rec_data, rec_len);
+			*len = rec_len;
+			found = 1;
+		}
+	}
+	return found;
+}
+
+/**
+ * @函数名      : append_record
+ * @描述        : 在页内offset处写入一条记录，先写记录头再写数据
+ */
+static HAL_StatusTypeDef append_record(uint8_t page, uint32_t offset, uint8_t key, const uint8_t *data, uint8_t len)
+{
+	uint8_t header[RECORD_HEADER_SIZE] = {key, len, 0, 0};
+	uint8_t body[NVSTORE_MAX_DATA + 3];
+	const uint32_t body_len = RECORD_SIZE(len) - RECORD_HEADER_SIZE;
+	HAL_StatusTypeDef status;
+
+	const uint16_t crc = CRC16_CCITT_Update(CRC16_CCITT(header, 2), data, len);
+	header[2] = (uint8_t)crc;
+	header[3] = (uint8_t)(crc >> 8);
+
+	memset(body, 0xFF, body_len);
+	memcpy(body, data, len);
+
+	status = flash->program(page_base(page) + offset, header, sizeof(header));
+	if (status != HAL_OK || body_len == 0)
+		return status;
+	return flash->program(page_base(page) + offset + RECORD_HEADER_SIZE, body, body_len);
+}
+
+/**
+ * @函数名      : compact
+ * @描述        : 将当前页各键的最新记录整理到另一页并切换
+ * @实现细节    : 新页的页标识最后写入，整理中途掉电时新页无效，原页数据保持不变
+ */
+static HAL_StatusTypeDef compact(void)
+{
+	const uint8_t target = active_page ^ 1U;
+	uint8_t seen[32] = {0}; // 已整理的键(位图)
+	uint8_t rec_key, rec_len, rec_data[NVSTORE_MAX_DATA];
+	uint32_t offset = PAGE_HEADER_SIZE;
+	uint32_t target_offset = PAGE_HEADER_SIZE;
+	HAL_StatusTypeDef status;
+	int8_t result;
+
+	status = flash->erase(page_base(target));
+	if (status != HAL_OK)
+		return status;
+
+	while ((result = read_record(active_page, &offset, &rec_key, rec_data, &rec_len)) >= 0)
+	{
+		if (result != 1 || (seen[rec_key >> 3] & (1U << (rec_key & 7U))))
+			continue;
+		seen[rec_key >> 3] |= 1U << (rec_key & 7U);
+
+		find_latest(rec_key, rec_data, &rec_len);
+		status = append_record(target, target_offset, rec_key, rec_data, rec_len);
+		if (status != HAL_OK)
+			return status;
+		target_offset += RECORD_SIZE(rec_len);
+	}
+
+	status = write_page_header(target, generation + 1);
+	if (status != HAL_OK)
+		return status;
+
+	active_page = target;
+	generation++;
+	write_offset = target_offset;
+	return HAL_OK;
+}
+
+/**
+ * @函数名      : NVStore_Init
+ * @描述        : 挂载存储区，确定当前页和写入位置
+ * @参数        : ops - Flash访问接口
+ * @返回值      : HAL_OK - 成功; HAL_ERROR - 格式化失败
+ * @实现细节    :
+ *   1. 读取两页的页标识，均有效时取序号较大（按回绕比较）的一页
+ *   2. 均无效时擦除第一页并写入页标识
+ *   3. 扫描当前页的记录区，定位第一个未写入的位置
+ */
+HAL_StatusTypeDef NVStore_Init(const NVStore_FlashOps *ops)
+{
+	uint32_t gen0, gen1;
+	uint8_t rec_key, rec_len, rec_data[NVSTORE_MAX_DATA];
+
+	flash = ops;
+	const uint8_t valid0 = read_page_header(0, &gen0);
+	const uint8_t valid1 = read_page_header(1, &gen1);
+
+	if (valid0 && (!valid1 || (int32_t)(gen0 - gen1) > 0))
+	{
+		active_page = 0;
+		generation = gen0;
+	}
+	else if (valid1)
+	{
+		active_page = 1;
+		generation = gen1;
+	}
+	else
+	{
+		active_page = 0;
+		generation = 1;
+		if (flash->erase(page_base(0)) != HAL_OK || write_page_header(0, generation) != HAL_OK)
+			return HAL_ERROR;
+	}
+
+	write_offset = PAGE_HEADER_SIZE;
+	while (read_record(active_page, &write_offset, &rec_key, rec_data, &rec_len) >= 0)
+	{
+	}
+	return HAL_OK;
+}
+
+/**
+ * @函数名      : NVStore_Read
+ * @描述        : 读取键的最新记录
+ * @参数        : key - 键
+ *                data - 输出缓冲区
+ *                len - 期望的数据长度
+ * @返回值      : HAL_OK - 成功; HAL_ERROR - 无记录或长度不符
+ */
+HAL_StatusTypeDef NVStore_Read(uint8_t key, void *data, uint8_t len)
+{
+	uint8_t rec_data[NVSTORE_MAX_DATA];
+	uint8_t rec_len = 0;
+
+	if (flash == NULL || !find_latest(key, rec_data, &rec_len) || rec_len != len)
+		return HAL_ERROR;
+
+	memcpy(data, rec_data, len);
+	return HAL_OK;
+}
+
+/**
+ * @函数名      : NVStore_Write
+ * @描述        : 写入键的新记录
+ * @参数        : key - 键
+ *                data - 数据
+ *                len - 数据长度
+ * @返回值      : HAL_OK - 成功或内容未变化; HAL_ERROR - 参数错误或Flash操作失败
+ * @实现细节    : 内容与最新记录相同时不写入；当前页剩余空间不足时先整理到另一页
+ */
+HAL_StatusTypeDef NVStore_Write(uint8_t key, const void *data, uint8_t len)
+{
+	uint8_t rec_data[NVSTORE_MAX_DATA];
+	uint8_t rec_len;
+	HAL_StatusTypeDef status;
+
+	if (flash == NULL || key == KEY_ERASED || len > NVSTORE_MAX_DATA)
+		return HAL_ERROR;
+
+	if (find_latest(key, rec_data, &rec_len) && rec_len == len && memcmp(rec_data, data, len) == 0)
+		return HAL_OK;
+
+	if (write_offset + RECORD_SIZE(len) > flash->page_size)
+	{
+		status = compact();
+		if (status != HAL_OK)
+			return status;
+		if (write_offset + RECORD_SIZE(len) > flash->page_size)
+			return HAL_ERROR;
+	}
+
+	status = append_record(active_page, write_offset, key, (const uint8_t *)data, len);
+	// 失败时同样跳过该位置，半写入的记录在读取时因CRC错误被忽略
+	write_offset += RECORD_SIZE(len);
+	return status;
+}
+
+/* 目标板Flash访问接口 ---------------------------------------------------------*/
+
+static HAL_StatusTypeDef internal_erase(uint32_t offset)
+{
+	FLASH_EraseInitTypeDef erase = {0};
+	uint32_t page_error = 0;
+	HAL_StatusTypeDef status;
+
+	erase.TypeErase = FLASH_TYPEERASE_PAGES;
+	erase.PageAddress = INTERNAL_FLASH_BASE + offset;
+	erase.NbPages = 1;
+
+	HAL_FLASH_Unlock();
+	status = HAL_FLASHEx_Erase(&erase, &page_error);
+	HAL_FLASH_Lock();
+	return status;
+}
+
+static HAL_StatusTypeDef internal_program(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+
+	HAL_FLASH_Unlock();
+	for (uint32_t i = 0; i + 1 < len && status == HAL_OK; i += 2)
+	{
+		const uint16_t halfword = data[i] | data[i + 1] << 8;
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, INTERNAL_FLASH_BASE + offset + i, halfword);
+	}
+	HAL_FLASH_Lock();
+	return status;
+}
+
+static void internal_read(uint32_t offset, uint8_t *data, uint32_t len)
+{
+	memcpy(data, (const void *)(uintptr_t)(INTERNAL_FLASH_BASE + offset), len);
+}
+
+const NVStore_FlashOps NVStore_InternalFlash = {
+	INTERNAL_FLASH_PAGE_SIZE,
+	internal_erase,
+	internal_program,
+	internal_read,
+};
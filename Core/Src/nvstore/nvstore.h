@@ -0,0 +1,89 @@
+#ifndef NVSTORE_H
+#define NVSTORE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : nvstore.h
+ * @描述        : 基于片内Flash的小型键值存储（掉电保存校准数据等）
+ * @注意事项    : 使用Flash末尾的两页轮换存储，每条记录以追加方式写入当前页，
+ *                同一键的后写记录覆盖先写记录；当前页写满时把各键的最新记录
+ *                整理到另一页再切换，擦除次数分摊到每页约一百余次写入
+ *                Flash操作通过NVStore_FlashOps注入，主机端可替换为内存模拟的Flash
+ *
+ *   页布局：
+ *     偏移0   4字节  页标识 NVSTORE_PAGE_MAGIC（整理完成后最后写入）
+ *     偏移4   4字节  页序号（每次整理加1，序号大的页为当前页）
+ *     偏移8   起     记录区
+ *   记录布局（4字节对齐）：
+ *     0   1字节  键（0xFF表示未写入，扫描到此结束）
+ *     1   1字节  数据长度
+ *     2   2字节  CRC16（覆盖键、长度和数据）
+ *     4   N字节  数据，补齐到4字节
+ *   写入时先写记录头再写数据，写入中途掉电的记录CRC校验失败，读取时跳过
+ */
+
+#include "stm32f1xx_hal.h"
+
+/* 记录键 */
+#define NVSTORE_KEY_MQ4_R0 0x01		   // MQ4校准电阻
+#define NVSTORE_KEY_SGP30_BASELINE 0x02 // SGP30基线
+
+/* 单条记录的最大数据长度 */
+#define NVSTORE_MAX_DATA 32
+
+	/**
+	 * @结构体名    : NVStore_FlashOps
+	 * @描述        : 存储区的Flash访问接口
+	 * @注意事项    : 地址为存储区内的偏移，按页大小对齐的偏移为各页起始；
+	 *                program按半字写入，len为偶数，目标区域须为擦除状态
+	 */
+	typedef struct
+	{
+		uint32_t page_size; // 页大小（字节）
+		HAL_StatusTypeDef (*erase)(uint32_t offset);
+		HAL_StatusTypeDef (*program)(uint32_t offset, const uint8_t *data, uint32_t len);
+		void (*read)(uint32_t offset, uint8_t *data, uint32_t len);
+	} NVStore_FlashOps;
+
+	/* 目标板实现：0x0803F000起的最后两页(2KB/页) */
+	extern const NVStore_FlashOps NVStore_InternalFlash;
+
+	/**
+	 * @函数名      : NVStore_Init
+	 * @描述        : 挂载存储区，确定当前页和写入位置
+	 * @参数        : ops - Flash访问接口
+	 * @返回值      : HAL_OK - 成功; HAL_ERROR - 两页均无效且格式化失败
+	 * @注意事项    : 两页均无有效页标识时（首次使用或数据损坏）格式化第一页
+	 */
+	HAL_StatusTypeDef NVStore_Init(const NVStore_FlashOps *ops);
+
+	/**
+	 * @函数名      : NVStore_Read
+	 * @描述        : 读取键的最新记录
+	 * @参数        : key - 键
+	 *                data - 输出缓冲区
+	 *                len - 期望的数据长度
+	 * @返回值      : HAL_OK - 成功; HAL_ERROR - 无记录或长度不符
+	 */
+	HAL_StatusTypeDef NVStore_Read(uint8_t key, void *data, uint8_t len);
+
+	/**
+	 * @函数名      : NVStore_Write
+	 * @描述        : 写入键的新记录
+	 * @参数        : key - 键（不可为0xFF）
+	 *                data - 数据
+	 *                len - 数据长度（不超过NVSTORE_MAX_DATA）
+	 * @返回值      : HAL_OK - 成功或内容未变化; HAL_ERROR - 参数错误或Flash操作失败
+	 * @注意事项    : 擦写Flash期间CPU停顿（擦除一页约20ms），只应在低频的后台任务中调用
+	 */
+	HAL_StatusTypeDef NVStore_Write(uint8_t key, const void *data, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVSTORE_H */
@@ -0,0 +1,173 @@
+/**
+ * @文件        : scheduler.c
+ * @描述        : 基于系统节拍的协作式任务调度器实现
+ * @注意事项    : 时间比较均使用有符号差值，可正确处理32位毫秒计数器回绕（约49.7天）
+ */
+
+#include "scheduler.h"
+#include <stddef.h>
+
+/* 私有变量 */
+static Scheduler_Task tasks[SCHEDULER_MAX_TASKS]; // 静态任务表
+static uint8_t task_count = 0;					  // 已注册任务数量
+static Scheduler_TickFn get_tick = NULL;		  // 毫秒节拍源
+
+/**
+ * @函数名      : time_reached
+ * @描述        : 判断时刻now是否已到达或超过时刻t（回绕安全）
+ */
+static inline uint8_t time_reached(uint32_t now, uint32_t t)
+{
+	return (int32_t)(now - t) >= 0;
+}
+
+/**
+ * @函数名      : Scheduler_Init
+ * @描述        : 初始化调度器，清空任务表
+ * @参数        : tick - 毫秒节拍源
+ * @返回值      : 无
+ */
+void Scheduler_Init(Scheduler_TickFn tick)
+{
+	get_tick = tick;
+	task_count = 0;
+	for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++)
+	{
+		tasks[i] = (Scheduler_Task){0};
+	}
+}
+
+/**
+ * @函数名      : Scheduler_AddTask
+ * @描述        : 注册周期任务
+ * @参数        : name - 任务名称
+ *                fn - 任务函数
+ *                period_ms - 执行周期(ms)
+ *                offset_ms - 首次释放偏移(ms)
+ *                deadline_ms - 相对截止时间(ms)，0表示等于周期
+ * @返回值      : int8_t - 任务编号，失败返回-1
+ */
+int8_t Scheduler_AddTask(const char *name, Scheduler_TaskFn fn,
+						 uint32_t period_ms, uint32_t offset_ms, uint32_t deadline_ms)
+{
+	if (get_tick == NULL || fn == NULL || period_ms == 0 || task_count >= SCHEDULER_MAX_TASKS)
+		return -1;
+
+	Scheduler_Task *t = &tasks[task_count];
+	*t = (Scheduler_Task){0};
+	t->name = name;
+	t->fn = fn;
+	t->period_ms = period_ms;
+	t->deadline_ms = (deadline_ms == 0) ? period_ms : deadline_ms;
+	t->next_release = get_tick() + offset_ms;
+
+	return (int8_t)task_count++;
+}
+
+/**
+ * @函数名      : Scheduler_Dispatch
+ * @描述        : 执行一个已到期的任务
+ * @参数        : 无
+ * @返回值      : uint8_t - 1表示执行了任务，0表示没有到期任务
+ * @实现细节    :
+ *   1. 在所有已到期任务中选择绝对截止时间最早的任务（EDF）
+ *   2. 下一次释放时刻按周期累加，而非基于实际执行时刻，避免周期漂移
+ *   3. 若任务滞后超过一个周期，只保留最早错过的一次释放，其余整周期丢弃并重新对齐；
+ *      保留的释放已经到期，会与当前周期的释放背靠背执行，即严重滞后后至多补跑一次
+ */
+uint8_t Scheduler_Dispatch(void)
+{
+	const uint32_t now = get_tick();
+	Scheduler_Task *ready = NULL;
+
+	for (uint8_t i = 0; i < task_count; i++)
+	{
+		Scheduler_Task *t = &tasks[i];
+		if (!time_reached(now, t->next_release))
+			continue;
+
+		if (ready == NULL ||
+			(int32_t)((t->next_release + t->deadline_ms) - (ready->next_release + ready->deadline_ms)) < 0)
+		{
+			ready = t;
+		}
+	}
+
+	if (ready == NULL)
+		return 0;
+
+	const uint32_t release = ready->next_release;
+	const uint32_t latency = now - release;
+
+	ready->fn();
+
+	const uint32_t end = get_tick();
+	const uint32_t exec = end - now;
+
+	ready->run_count++;
+	if (latency > ready->max_latency_ms)
+		ready->max_latency_ms = latency;
+	if (exec > ready->max_exec_ms)
+		ready->max_exec_ms = exec;
+	if (!time_reached(release + ready->deadline_ms, end))
+		ready->deadline_misses++;
+
+	// 计算下一次释放时刻：保留最早错过的一次（立即补跑），跳过其后已经错过的整周期
+	ready->next_release = release + ready->period_ms;
+	while (time_reached(end, ready->next_release + ready->period_ms))
+	{
+		ready->next_release += ready->period_ms;
+		ready->skipped++;
+	}
+
+	return 1;
+}
+
+/**
+ * @函数名      : Scheduler_TimeToNextRelease
+ * @描述        : 获取距离最近一次任务释放的剩余时间
+ * @参数        : 无
+ * @返回值      : uint32_t - 剩余毫秒数，已有到期任务或无任务时返回0
+ */
+uint32_t Scheduler_TimeToNextRelease(void)
+{
+	if (task_count == 0)
+		return 0;
+
+	const uint32_t now = get_tick();
+	uint32_t min_wait = UINT32_MAX;
+
+	for (uint8_t i = 0; i < task_count; i++)
+	{
+		if (time_reached(now, tasks[i].next_release))
+			return 0;
+
+		const uint32_t wait = tasks[i].next_release - now;
+		if (wait < min_wait)
+			min_wait = wait;
+	}
+
+	return min_wait;
+}
+
+/**
+ * @函数名      : Scheduler_GetTask
+ * @描述        : 获取任务控制块（只读）
+ * @参数        : id - 任务编号
+ * @返回值      : const Scheduler_Task* - 任务控制块，编号无效时返回NULL
+ */
+const Scheduler_Task *Scheduler_GetTask(uint8_t id)
+{
+	return (id < task_count) ? &tasks[id] : NULL;
+}
+
+/**
+ * @函数名      : Scheduler_GetTaskCount
+ * @描述        : 获取已注册的任务数量
+ * @参数        : 无
+ * @返回值      : uint8_t - 任务数量
+ */
+uint8_t Scheduler_GetTaskCount(void)
+{
+	return task_count;
+}
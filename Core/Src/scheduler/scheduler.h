@@ -0,0 +1,106 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : scheduler.h
+ * @描述        : 基于系统节拍的协作式任务调度器
+ * @注意事项    : 任务表为固定大小的静态数组，不使用堆
+ *                任务函数在主循环上下文中执行，必须尽快返回，不可长时间阻塞
+ *                时间基准通过函数指针注入，目标板使用HAL_GetTick（SysTick），
+ *                主机端可传入模拟时钟以验证周期和抖动
+ */
+
+#include <stdint.h>
+
+/* 任务表容量 */
+#define SCHEDULER_MAX_TASKS 12
+
+	/**
+	 * @类型名      : Scheduler_TaskFn / Scheduler_TickFn
+	 * @描述        : 任务函数与毫秒节拍源的函数指针类型
+	 */
+	typedef void (*Scheduler_TaskFn)(void);
+	typedef uint32_t (*Scheduler_TickFn)(void);
+
+	/**
+	 * @结构体名    : Scheduler_Task
+	 * @描述        : 任务控制块，包含调度参数和运行统计
+	 */
+	typedef struct
+	{
+		const char *name;		  // 任务名称（仅用于调试）
+		Scheduler_TaskFn fn;	  // 任务函数
+		uint32_t period_ms;		  // 执行周期(ms)
+		uint32_t deadline_ms;	  // 相对释放时刻的截止时间(ms)
+		uint32_t next_release;	  // 下一次释放时刻(ms)
+		uint32_t run_count;		  // 已执行次数
+		uint32_t max_latency_ms;  // 最大启动延迟（实际开始时刻 - 释放时刻）
+		uint32_t max_exec_ms;	  // 最大执行时间
+		uint32_t deadline_misses; // 超过截止时间完成的次数
+		uint32_t skipped;		  // 因严重滞后被跳过的释放次数
+	} Scheduler_Task;
+
+	/**
+	 * @函数名      : Scheduler_Init
+	 * @描述        : 初始化调度器，清空任务表
+	 * @参数        : tick - 毫秒节拍源（目标板传入HAL_GetTick）
+	 * @返回值      : 无
+	 */
+	void Scheduler_Init(Scheduler_TickFn tick);
+
+	/**
+	 * @函数名      : Scheduler_AddTask
+	 * @描述        : 注册周期任务
+	 * @参数        : name - 任务名称
+	 *                fn - 任务函数
+	 *                period_ms - 执行周期(ms)，必须大于0
+	 *                offset_ms - 首次释放相对当前时刻的偏移(ms)，用于错开任务
+	 *                deadline_ms - 相对释放时刻的截止时间(ms)，0表示等于周期
+	 * @返回值      : int8_t - 任务编号，任务表已满或参数非法时返回-1
+	 */
+	int8_t Scheduler_AddTask(const char *name, Scheduler_TaskFn fn,
+							 uint32_t period_ms, uint32_t offset_ms, uint32_t deadline_ms);
+
+	/**
+	 * @函数名      : Scheduler_Dispatch
+	 * @描述        : 执行一个已到期的任务
+	 * @参数        : 无
+	 * @返回值      : uint8_t - 1表示执行了任务，0表示当前没有到期任务
+	 * @注意事项    : 多个任务同时到期时，按绝对截止时间最早者优先执行
+	 */
+	uint8_t Scheduler_Dispatch(void);
+
+	/**
+	 * @函数名      : Scheduler_TimeToNextRelease
+	 * @描述        : 获取距离最近一次任务释放的剩余时间
+	 * @参数        : 无
+	 * @返回值      : uint32_t - 剩余毫秒数，已有到期任务时返回0
+	 */
+	uint32_t Scheduler_TimeToNextRelease(void);
+
+	/**
+	 * @函数名      : Scheduler_GetTask
+	 * @描述        : 获取任务控制块（只读），用于查看运行统计
+	 * @参数        : id - 任务编号
+	 * @返回值      : const Scheduler_Task* - 任务控制块，编号无效时返回NULL
+	 */
+	const Scheduler_Task *Scheduler_GetTask(uint8_t id);
+
+	/**
+	 * @函数名      : Scheduler_GetTaskCount
+	 * @描述        : 获取已注册的任务数量
+	 * @参数        : 无
+	 * @返回值      : uint8_t - 任务数量
+	 */
+	uint8_t Scheduler_GetTaskCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULER_H */
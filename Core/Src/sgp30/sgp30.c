@@ -1,103 +1,338 @@
 #include "sgp30.h"
-#include "i2c.h"
+#include "nvstore/nvstore.h"
+#include "crc/crc.h"
 #include <stdint.h> // 添加标准整数类型头文件
-// extern I2C_HandleTypeDef hi2c2;
-extern UART_HandleTypeDef huart1;
 
-// 定义SGP30初始化函数，发送初始化命令
-void sgp30_init(I2C_HandleTypeDef *hi2c2)
+// 命令执行时间(ms)，取数据手册最大值
+#define SGP30_INIT_MS 10
+#define SGP30_MEASURE_MS 12
+#define SGP30_BASELINE_MS 10
+#define SGP30_HUMIDITY_MS 10
+#define SGP30_I2C_TIMEOUT_MS 20 // 单次I2C传输超时
+
+// 基线保存策略：未恢复基线时须先运行12小时，之后每小时保存一次
+#define SGP30_BASELINE_FIRST_SAVE_MS (12UL * 3600UL * 1000UL)
+#define SGP30_BASELINE_SAVE_MS (3600UL * 1000UL)
+
+#define SGP30_QUEUE_SIZE 8
+
+// 命令类型
+typedef enum
 {
-	uint8_t cmd[2] = {0x20, 0x03}; // 初始化命令为0x2003
-	HAL_StatusTypeDef status;
+	OP_INIT,
+	OP_MEASURE,
+	OP_GET_BASELINE,
+	OP_SET_BASELINE,
+	OP_SET_HUMIDITY
+} sgp30_op;
 
-	status = HAL_I2C_Master_Transmit(hi2c2, SGP30_ADDR << 1, cmd, 2, 100); // 发送初始化命令
-	if (status != HAL_OK)
+// 队列中的一条命令
+typedef struct
+{
+	uint8_t op;
+	uint8_t tx[8];	  // 命令字及参数（参数每个字后附CRC）
+	uint8_t tx_len;
+	uint8_t rx_len;	  // 需读取的字节数，0表示无返回数据
+	uint8_t delay_ms; // 发送后等待的执行时间
+} sgp30_cmd;
+
+// 传输状态，TX/RX由I2C中断推进
+typedef enum
+{
+	STATE_IDLE,
+	STATE_TX,
+	STATE_WAIT,
+	STATE_RX,
+	STATE_DONE,
+	STATE_ERROR
+} sgp30_state;
+
+// Flash中保存的基线，顺序与get_iaq_baseline返回顺序一致
+typedef struct
+{
+	uint16_t co2_eq;
+	uint16_t tvoc;
+} sgp30_baseline;
+
+static I2C_HandleTypeDef *hi2c_sgp30 = NULL;
+static sgp30_cmd queue[SGP30_QUEUE_SIZE];
+static uint8_t queue_head = 0, queue_tail = 0;
+static sgp30_cmd current;
+static volatile uint8_t state = STATE_IDLE;
+static uint32_t state_tick = 0;
+static uint8_t rx_buf[6];
+
+static SGP30_DATA last_result;
+static uint8_t result_status = HAL_BUSY;
+static uint32_t start_tick = 0;		  // 初始化时刻，用于基线保存策略
+static uint32_t last_baseline_save = 0; // 上次读取基线的时刻
+static uint8_t baseline_restored = 0;
+static uint16_t last_humidity = 0xFFFF; // 上次设置的绝对湿度，0xFFFF表示未设置
+
+// 0-50℃饱和水汽密度，单位g/m^3，8.8定点（Magnus公式）
+static const uint16_t saturation_density[51] = {
+	1241, 1329, 1423, 1522, 1627, 1739, 1857, 1982, 2114, 2254,
+	2402, 2558, 2724, 2898, 3082, 3276, 3481, 3696, 3923, 4163,
+	4414, 4679, 4957, 5250, 5557, 5880, 6219, 6574, 6947, 7338,
+	7748, 8177, 8626, 9097, 9589, 10105, 10643, 11206, 11795, 12410,
+	13052, 13722, 14421, 15150, 15911, 16704, 17530, 18391, 19288, 20221,
+	21193};
+
+// 将命令放入队列，参数按SGP30格式每个字附加CRC
+static uint8_t enqueue(uint8_t op, uint16_t cmd, const uint16_t *args, uint8_t nargs,
+					   uint8_t rx_len, uint8_t delay_ms)
+{
+	uint8_t next = (queue_head + 1) % SGP30_QUEUE_SIZE;
+	if (next == queue_tail)
 	{
-		// 初始化失败，发送错误信息
-		char *err_msg = "SGP30 Initialize Error!\r\n";
-		HAL_UART_Transmit(&huart1, (uint8_t *)err_msg, 26, 100);
-		return;
+		return HAL_BUSY;
+	}
+
+	sgp30_cmd *c = &queue[queue_head];
+	c->op = op;
+	c->tx[0] = cmd >> 8;
+	c->tx[1] = cmd & 0xFF;
+	c->tx_len = 2;
+	for (uint8_t i = 0; i < nargs; i++)
+	{
+		CRC8_PackWord(&c->tx[c->tx_len], args[i]);
+		c->tx_len += CRC8_WORD_SIZE;
 	}
+	c->rx_len = rx_len;
+	c->delay_ms = delay_ms;
 
-	HAL_Delay(20); // 等待初始化完成（数据手册建议）
+	queue_head = next;
+	return HAL_OK;
 }
 
-// 定义SGP30读取数据函数，返回CO2和TVOC的值
-uint8_t sgp30_read(SGP30_DATA *result)
+// 处理已完成的命令
+static void complete(uint8_t ok)
 {
-	uint8_t cmd[2] = {0x20, 0x08}; // 读取命令为0x2008
-	uint8_t data[6];			   // 存储返回的6个字节数据
-	uint8_t crc;				   // 存储CRC校验值
-	HAL_StatusTypeDef status;
+	uint16_t words[2];
 
-	// 初始化结果为0，防止读取失败时返回随机值
-	// result->co2_eq_ppm = 0;
-	// result->tvoc_ppb = 0;
+	// 返回的数据字一次校验完毕
+	ok = ok && CRC8_VerifyWords(rx_buf, current.rx_len / CRC8_WORD_SIZE, words);
 
-	// 发送读取命令
-	status = HAL_I2C_Master_Transmit(&hi2c2, SGP30_ADDR << 1, cmd, 2, 100);
-	if (status != HAL_OK)
+	switch (current.op)
 	{
-		return HAL_ERROR;
+	case OP_MEASURE:
+		// 返回数据依次为CO2当量和TVOC
+		if (ok)
+		{
+			last_result.co2_eq_ppm = words[0];
+			last_result.tvoc_ppb = words[1];
+			result_status = HAL_OK;
+		}
+		else
+		{
+			result_status = HAL_ERROR;
+		}
+		break;
+
+	case OP_GET_BASELINE:
+		if (ok)
+		{
+			sgp30_baseline baseline = {words[0], words[1]};
+			NVStore_Write(NVSTORE_KEY_SGP30_BASELINE, &baseline, sizeof(baseline));
+		}
+		break;
+
+	case OP_SET_HUMIDITY:
+		if (!ok)
+		{
+			last_humidity = 0xFFFF; // 设置失败，下次重新发送
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+// 定义SGP30初始化函数，发送初始化命令并恢复基线
+void sgp30_init(I2C_HandleTypeDef *hi2c)
+{
+	sgp30_baseline baseline;
+
+	hi2c_sgp30 = hi2c;
+	queue_head = queue_tail = 0;
+	state = STATE_IDLE;
+	result_status = HAL_BUSY;
+	start_tick = HAL_GetTick();
+	last_baseline_save = start_tick;
+	baseline_restored = 0;
+	last_humidity = 0xFFFF;
+
+	enqueue(OP_INIT, 0x2003, NULL, 0, 0, SGP30_INIT_MS); // 初始化命令为0x2003
+
+	// set_iaq_baseline的参数顺序与get_iaq_baseline相反：先TVOC后CO2当量
+	if (NVStore_Read(NVSTORE_KEY_SGP30_BASELINE, &baseline, sizeof(baseline)) == HAL_OK)
+	{
+		const uint16_t args[2] = {baseline.tvoc, baseline.co2_eq};
+		enqueue(OP_SET_BASELINE, 0x201E, args, 2, 0, SGP30_BASELINE_MS);
+		baseline_restored = 1;
 	}
+}
 
-	HAL_Delay(25); // 等待测量完成（数据手册建议）
+// 发起一次测量，并按保存策略读取基线
+uint8_t sgp30_measure(void)
+{
+	const uint32_t now = HAL_GetTick();
+	const uint32_t first_save = baseline_restored ? SGP30_BASELINE_SAVE_MS : SGP30_BASELINE_FIRST_SAVE_MS;
 
-	// 接收6个字节数据
-	status = HAL_I2C_Master_Receive(&hi2c2, SGP30_ADDR << 1 | 0x01, data, 6, 100);
+	uint8_t status = enqueue(OP_MEASURE, 0x2008, NULL, 0, 6, SGP30_MEASURE_MS); // 测量命令为0x2008
 	if (status != HAL_OK)
 	{
-		return HAL_ERROR;
+		return status;
+	}
+
+	if (now - start_tick >= first_save && now - last_baseline_save >= SGP30_BASELINE_SAVE_MS)
+	{
+		if (enqueue(OP_GET_BASELINE, 0x2015, NULL, 0, 6, SGP30_BASELINE_MS) == HAL_OK)
+		{
+			last_baseline_save = now;
+		}
+	}
+	return HAL_OK;
+}
+
+// 取出最近一次完成的测量结果
+uint8_t sgp30_read(SGP30_DATA *result)
+{
+	uint8_t status = result_status;
+
+	if (status == HAL_OK)
+	{
+		*result = last_result;
 	}
+	result_status = HAL_BUSY;
+	return status;
+}
 
-	// 验证CO2数据的CRC校验
-	crc = sgp30_crc(data, 2); // 计算前两个字节的CRC校验值
-	if (crc == data[2])
-	{												   // 如果和第三个字节相同，说明CO2数据有效
-		result->co2_eq_ppm = (data[0] << 8) | data[1]; // 将前两个字节合并为CO2值
+// 设置湿度补偿，参数为DHT11的温度和相对湿度
+void sgp30_set_humidity(int16_t temperature_x10, uint16_t humidity_x10)
+{
+	// 温度限制在表格范围内，按0.1℃线性插值
+	if (temperature_x10 < 0)
+	{
+		temperature_x10 = 0;
 	}
-	else
+	else if (temperature_x10 > 500)
 	{
-		// CRC校验失败，返回错误
-		return HAL_ERROR;
+		temperature_x10 = 500;
+	}
+	const uint8_t index = temperature_x10 / 10;
+	const uint8_t frac = temperature_x10 % 10;
+	uint32_t density = saturation_density[index];
+	if (frac)
+	{
+		density += (saturation_density[index + 1] - density) * frac / 10;
 	}
 
-	// 验证TVOC数据的CRC校验
-	crc = sgp30_crc(data + 3, 2); // 计算第四和第五个字节的CRC校验值
-	if (crc == data[5])
-	{												 // 如果和第六个字节相同，说明TVOC数据有效
-		result->tvoc_ppb = (data[3] << 8) | data[4]; // 将第四和第五个字节合并为TVOC值
+	// 绝对湿度 = 饱和水汽密度 * 相对湿度
+	if (humidity_x10 > 1000)
+	{
+		humidity_x10 = 1000;
 	}
-	else
+	const uint16_t absolute = (uint16_t)(density * humidity_x10 / 1000);
+	if (absolute == last_humidity)
 	{
-		// CRC校验失败，返回错误
-		return HAL_ERROR;
+		return;
 	}
 
-	return HAL_OK; // 返回结果
+	// 绝对湿度为0会关闭补偿，最小取1/256 g/m^3
+	const uint16_t arg = absolute ? absolute : 1;
+	if (enqueue(OP_SET_HUMIDITY, 0x2061, &arg, 1, 0, SGP30_HUMIDITY_MS) == HAL_OK)
+	{
+		last_humidity = absolute;
+	}
 }
 
-// 定义SGP30计算CRC校验值的函数，使用多项式x8 + x5 + x4 + x0
-uint8_t sgp30_crc(uint8_t *data, uint8_t len)
+// 推进命令队列
+void sgp30_process(void)
 {
-	uint8_t crc = 0xFF; // 初始值为0xFF
-	uint8_t bit;		// 存储位掩码
-
-	for (uint8_t i = 0; i < len; i++)
-	{					// 遍历每个字节
-		crc ^= data[i]; // 异或当前字节
-		for (bit = 8; bit > 0; bit--)
-		{ // 遍历每个位
-			if (crc & 0x80)
-			{ // 如果最高位为1，就左移并异或0x31
-				crc = (crc << 1) ^ 0x31;
-			}
-			else
-			{ // 否则，就左移
-				crc = (crc << 1);
-			}
+	const uint32_t now = HAL_GetTick();
+
+	switch (state)
+	{
+	case STATE_IDLE:
+		if (queue_tail == queue_head || hi2c_sgp30 == NULL)
+		{
+			break;
 		}
+		current = queue[queue_tail];
+		queue_tail = (queue_tail + 1) % SGP30_QUEUE_SIZE;
+
+		state_tick = now;
+		state = STATE_TX;
+		if (HAL_I2C_Master_Transmit_IT(hi2c_sgp30, SGP30_ADDR << 1, current.tx, current.tx_len) != HAL_OK)
+		{
+			state = STATE_ERROR;
+		}
+		break;
+
+	case STATE_WAIT:
+		// 等待传感器执行命令
+		if (now - state_tick < current.delay_ms)
+		{
+			break;
+		}
+		if (current.rx_len == 0)
+		{
+			complete(1);
+			state = STATE_IDLE;
+			break;
+		}
+		state_tick = now;
+		state = STATE_RX;
+		if (HAL_I2C_Master_Receive_IT(hi2c_sgp30, SGP30_ADDR << 1 | 0x01, rx_buf, current.rx_len) != HAL_OK)
+		{
+			state = STATE_ERROR;
+		}
+		break;
+
+	case STATE_TX:
+	case STATE_RX:
+		// 传输超时：中止传输并重新初始化I2C，避免总线锁死
+		if (now - state_tick >= SGP30_I2C_TIMEOUT_MS)
+		{
+			HAL_I2C_DeInit(hi2c_sgp30);
+			HAL_I2C_Init(hi2c_sgp30);
+			state = STATE_ERROR;
+		}
+		break;
+
+	case STATE_DONE:
+		complete(1);
+		state = STATE_IDLE;
+		break;
+
+	case STATE_ERROR:
+		complete(0);
+		state = STATE_IDLE;
+		break;
+	}
+}
+
+// I2C中断回调
+void sgp30_i2c_event(I2C_HandleTypeDef *hi2c, uint8_t event)
+{
+	if (hi2c != hi2c_sgp30)
+	{
+		return;
 	}
 
-	return crc; // 返回CRC校验值
-}
\ No newline at end of file
+	if (event == SGP30_I2C_ERROR)
+	{
+		state = STATE_ERROR;
+	}
+	else if (event == SGP30_I2C_TX_DONE && state == STATE_TX)
+	{
+		state_tick = HAL_GetTick();
+		state = STATE_WAIT;
+	}
+	else if (event == SGP30_I2C_RX_DONE && state == STATE_RX)
+	{
+		state = STATE_DONE;
+	}
+}
@@ -1,6 +1,14 @@
 #ifndef SGP30_H
 #define SGP30_H
 
+/**
+ * @文件        : sgp30.h
+ * @描述        : SGP30气体传感器驱动头文件
+ * @注意事项    : 驱动为非阻塞方式：命令放入队列，由sgp30_process按命令执行时间推进，
+ *                I2C收发使用中断方式，调用方不等待传感器测量
+ *                IAQ算法要求严格按1Hz调用sgp30_measure，否则动态基线补偿会失准
+ */
+
 #include "stm32f1xx_hal.h"
 #include <stdint.h>
 
@@ -14,29 +22,69 @@ typedef struct
 	uint16_t tvoc_ppb;	 // TVOC浓度，单位ppb
 } SGP30_DATA;
 
+// I2C中断事件，由HAL的I2C回调传入sgp30_i2c_event
+#define SGP30_I2C_TX_DONE 0
+#define SGP30_I2C_RX_DONE 1
+#define SGP30_I2C_ERROR 2
+
 /**
  * @函数名      : sgp30_init
- * @描述        : 初始化SGP30气体传感器
- * @参数        : hi2c2 - I2C句柄指针
+ * @描述        : 初始化SGP30气体传感器（非阻塞）
+ * @参数        : hi2c - I2C句柄指针
  * @返回值      : 无
+ * @注意事项    : 将init_air_quality命令放入队列，Flash中保存有基线时随后恢复基线；
+ *                I2C须已使能事件和错误中断，基线读写依赖nvstore，须先调用NVStore_Init
  */
-void sgp30_init(I2C_HandleTypeDef *hi2c2);
+void sgp30_init(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @函数名      : sgp30_measure
+ * @描述        : 发起一次IAQ测量（非阻塞）
+ * @参数        : 无
+ * @返回值      : HAL_OK - 已放入队列; HAL_BUSY - 队列已满
+ * @注意事项    : 须以1Hz周期调用；测量结果在下一次调用sgp30_read时取得
+ *                需要保存基线时，此函数同时将读取基线命令放入队列
+ */
+uint8_t sgp30_measure(void);
 
 /**
  * @函数名      : sgp30_read
- * @描述        : 读取SGP30气体传感器数据
+ * @描述        : 获取最近一次完成的测量结果（非阻塞）
  * @参数        : result - 存储气体浓度的结构体指针
- * @返回值      : HAL_OK - 读取成功; HAL_ERROR - 读取失败
+ * @返回值      : HAL_OK - 有新的有效结果; HAL_BUSY - 上次调用后没有完成新的测量;
+ *                HAL_ERROR - 最近一次测量I2C通信失败或CRC校验失败
  */
 uint8_t sgp30_read(SGP30_DATA *result);
 
 /**
- * @函数名      : sgp30_crc
- * @描述        : 计算SGP30数据的CRC-8校验值
- * @参数        : data - 需要计算校验的数据
- *                len - 数据长度
- * @返回值      : uint8_t - CRC校验值
+ * @函数名      : sgp30_set_humidity
+ * @描述        : 根据温湿度设置湿度补偿（非阻塞）
+ * @参数        : temperature_x10 - 温度，单位0.1℃
+ *                humidity_x10 - 相对湿度，单位0.1%RH
+ * @返回值      : 无
+ * @实现细节    : 由温度查饱和水汽密度表并线性插值，乘以相对湿度得到绝对湿度(g/m^3，8.8定点)，
+ *                与上次设置的值不同时才放入队列
+ */
+void sgp30_set_humidity(int16_t temperature_x10, uint16_t humidity_x10);
+
+/**
+ * @函数名      : sgp30_process
+ * @描述        : 推进命令队列，处理已完成的命令
+ * @参数        : 无
+ * @返回值      : 无
+ * @注意事项    : 需周期性调用（间隔不大于5ms），基线回写Flash在此函数中进行
+ */
+void sgp30_process(void);
+
+/**
+ * @函数名      : sgp30_i2c_event
+ * @描述        : I2C传输完成或出错时的处理
+ * @参数        : hi2c - 触发回调的I2C句柄
+ *                event - SGP30_I2C_TX_DONE / SGP30_I2C_RX_DONE / SGP30_I2C_ERROR
+ * @返回值      : 无
+ * @注意事项    : 需在HAL_I2C_MasterTxCpltCallback、HAL_I2C_MasterRxCpltCallback和
+ *                HAL_I2C_ErrorCallback中调用
  */
-uint8_t sgp30_crc(uint8_t *data, uint8_t len);
+void sgp30_i2c_event(I2C_HandleTypeDef *hi2c, uint8_t event);
 
-#endif
\ No newline at end of file
+#endif
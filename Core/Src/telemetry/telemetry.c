@@ -0,0 +1,59 @@
+/**
+ * @文件        : telemetry.c
+ * @描述        : 二进制遥测帧编码实现
+ * @注意事项    : 帧布局见telemetry.h
+ */
+
+#include "telemetry.h"
+#include "crc/crc.h"
+
+/* 小端写入辅助函数 */
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+	return p + 4;
+}
+
+/**
+ * @函数名      : Telemetry_EncodeFrame
+ * @描述        : 将一次采样编码为二进制遥测帧
+ * @参数        : sample - 采样数据
+ *                seq - 帧序号
+ *                timestamp_ms - 时间戳
+ *                out - 输出缓冲区
+ * @返回值      : uint8_t - 写入的字节数
+ */
+uint8_t Telemetry_EncodeFrame(const Telemetry_Sample *sample, uint16_t seq,
+							  uint32_t timestamp_ms, uint8_t *out)
+{
+	uint8_t *p = out;
+
+	*p++ = TELEMETRY_SYNC0;
+	*p++ = TELEMETRY_SYNC1;
+	*p++ = TELEMETRY_VERSION;
+	*p++ = TELEMETRY_FRAME_SIZE;
+	p = put_u16(p, seq);
+	p = put_u32(p, TELEMETRY_DEVICE_ID);
+	p = put_u32(p, timestamp_ms);
+	*p++ = sample->valid;
+	*p++ = 0;
+	p = put_u16(p, sample->humidity_x10);
+	p = put_u16(p, (uint16_t)sample->temperature_x10);
+	p = put_u32(p, sample->methane_x10);
+	p = put_u16(p, sample->tvoc_ppb);
+	p = put_u16(p, sample->co2_eq_ppm);
+	p = put_u16(p, sample->pm25_x10);
+	p = put_u16(p, CRC16_CCITT(out, (uint32_t)(p - out)));
+
+	return (uint8_t)(p - out);
+}
@@ -0,0 +1,93 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : telemetry.h
+ * @描述        : 传感器数据二进制遥测帧的定义与编码
+ * @注意事项    : 帧为固定长度、小端字节序，逐字节序列化，不依赖结构体对齐
+ *                固件、ESP8266转发程序和服务端解析共用此布局，修改时须同步更新
+ *                WebClient/WebClient.ino 与 webserver 中的 TelemetryFrame.java
+ *
+ *   偏移  长度  字段
+ *   0     2     同步字 0xA5 0x5A
+ *   2     1     协议版本 (TELEMETRY_VERSION)
+ *   3     1     帧总长度 (TELEMETRY_FRAME_SIZE)
+ *   4     2     序号（每帧递增，回绕）
+ *   6     4     设备ID（0表示未设置，由转发端补充）
+ *   10    4     时间戳（上电后毫秒数）
+ *   14    1     字段有效位 (TELEMETRY_VALID_*)
+ *   15    1     保留，填0
+ *   16    2     湿度        uint16  0.1 %RH
+ *   18    2     温度        int16   0.1 ℃
+ *   20    4     甲烷        uint32  0.1 ppm
+ *   24    2     TVOC        uint16  ppb
+ *   26    2     CO2当量     uint16  ppm
+ *   28    2     PM2.5       uint16  0.1 ug/m^3
+ *   30    2     CRC16-CCITT（多项式0x1021，初值0xFFFF，覆盖偏移0-29）
+ */
+
+#include <stdint.h>
+
+/* 帧格式常量 */
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_FRAME_SIZE 32
+
+/* 字段有效位 */
+#define TELEMETRY_VALID_HUMIDITY (1U << 0)
+#define TELEMETRY_VALID_TEMPERATURE (1U << 1)
+#define TELEMETRY_VALID_METHANE (1U << 2)
+#define TELEMETRY_VALID_TVOC (1U << 3)
+#define TELEMETRY_VALID_CO2 (1U << 4)
+#define TELEMETRY_VALID_PM25 (1U << 5)
+
+/* 上报格式选择：发往ESP8266的数据使用二进制帧或兼容的文本行 */
+#define TELEMETRY_FORMAT_TEXT 0
+#define TELEMETRY_FORMAT_BINARY 1
+#ifndef TELEMETRY_UART_FORMAT
+#define TELEMETRY_UART_FORMAT TELEMETRY_FORMAT_BINARY
+#endif
+
+/* 本机设备ID，0表示由ESP8266转发时补充 */
+#ifndef TELEMETRY_DEVICE_ID
+#define TELEMETRY_DEVICE_ID 0
+#endif
+
+	/**
+	 * @结构体名    : Telemetry_Sample
+	 * @描述        : 一次上报的定点传感器数据
+	 */
+	typedef struct
+	{
+		uint16_t humidity_x10;	  // 湿度，0.1 %RH
+		int16_t temperature_x10;  // 温度，0.1 ℃
+		uint32_t methane_x10;	  // 甲烷浓度，0.1 ppm
+		uint16_t tvoc_ppb;		  // TVOC浓度，ppb
+		uint16_t co2_eq_ppm;	  // CO2当量浓度，ppm
+		uint16_t pm25_x10;		  // PM2.5浓度，0.1 ug/m^3
+		uint8_t valid;			  // 字段有效位
+	} Telemetry_Sample;
+
+	/**
+	 * @函数名      : Telemetry_EncodeFrame
+	 * @描述        : 将一次采样编码为二进制遥测帧
+	 * @参数        : sample - 采样数据
+	 *                seq - 帧序号
+	 *                timestamp_ms - 时间戳（上电后毫秒数）
+	 *                out - 输出缓冲区，长度至少TELEMETRY_FRAME_SIZE
+	 * @返回值      : uint8_t - 写入的字节数(TELEMETRY_FRAME_SIZE)
+	 */
+	uint8_t Telemetry_EncodeFrame(const Telemetry_Sample *sample, uint16_t seq,
+								  uint32_t timestamp_ms, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H */
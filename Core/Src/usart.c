@@ -21,7 +21,56 @@
 #include "usart.h"
 
 /* USER CODE BEGIN 0 */
+#include <string.h>
 
+DMA_HandleTypeDef hdma_uart4_tx;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+/**
+ * 串口发送环形缓冲区（单生产者/单消费者）
+ * head只由主循环写入，tail和dma_len只由发送完成中断写入，
+ * 二者均为自由递增的计数，取模后作为缓冲区下标
+ */
+typedef struct
+{
+  UART_HandleTypeDef *huart;
+  uint8_t buf[UART_TX_BUF_SIZE];
+  volatile uint16_t head;    // 写入位置（生产者）
+  volatile uint16_t tail;    // 已发送位置（消费者）
+  volatile uint16_t dma_len; // 正在DMA发送的字节数，0表示空闲
+  UART_TxStats stats;
+} UART_TxRing;
+
+static UART_TxRing tx_ring_uart4 = {.huart = &huart4};
+static UART_TxRing tx_ring_usart1 = {.huart = &huart1};
+
+static UART_TxRing *UART_TxFindRing(UART_HandleTypeDef *huart)
+{
+  if (huart == &huart1)
+    return &tx_ring_usart1;
+  if (huart == &huart4)
+    return &tx_ring_uart4;
+  return NULL;
+}
+
+/* 启动下一段连续数据的DMA发送，调用方须保证通道空闲且不被中断打断 */
+static void UART_TxStartNext(UART_TxRing *ring)
+{
+  const uint16_t pending = (uint16_t)(ring->head - ring->tail);
+  if (pending == 0)
+    return;
+
+  const uint16_t offset = ring->tail & (UART_TX_BUF_SIZE - 1U);
+  uint16_t chunk = UART_TX_BUF_SIZE - offset; // 到缓冲区末尾的连续空间
+  if (chunk > pending)
+    chunk = pending;
+
+  ring->dma_len = chunk;
+  if (HAL_UART_Transmit_DMA(ring->huart, &ring->buf[offset], chunk) != HAL_OK)
+  {
+    ring->dma_len = 0; // 稍后由下一次入队重新触发
+  }
+}
 /* USER CODE END 0 */
 
 UART_HandleTypeDef huart4;
@@ -113,7 +162,29 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
   /* USER CODE BEGIN UART4_MspInit 1 */
-
+    /* UART4 DMA Init */
+    /* UART4_TX Init */
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    hdma_uart4_tx.Instance = DMA2_Channel5;
+    hdma_uart4_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_uart4_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_uart4_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_uart4_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_uart4_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_uart4_tx.Init.Mode = DMA_NORMAL;
+    hdma_uart4_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_uart4_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(uartHandle,hdmatx,hdma_uart4_tx);
+
+    /* DMA2_Channel4_5_IRQn and UART4 interrupt Init */
+    HAL_NVIC_SetPriority(DMA2_Channel4_5_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Channel4_5_IRQn);
+    HAL_NVIC_SetPriority(UART4_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(UART4_IRQn);
   /* USER CODE END UART4_MspInit 1 */
   }
   else if(uartHandle->Instance==USART1)
@@ -140,7 +211,29 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
   /* USER CODE BEGIN USART1_MspInit 1 */
-
+    /* USART1 DMA Init */
+    /* USART1_TX Init */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hdma_usart1_tx.Instance = DMA1_Channel4;
+    hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart1_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(uartHandle,hdmatx,hdma_usart1_tx);
+
+    /* DMA1_Channel4_IRQn and USART1 interrupt Init */
+    HAL_NVIC_SetPriority(DMA1_Channel4_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
   /* USER CODE END USART1_MspInit 1 */
   }
 }
@@ -163,7 +256,9 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOC, GPIO_PIN_10|GPIO_PIN_11);
 
   /* USER CODE BEGIN UART4_MspDeInit 1 */
-
+    /* UART4 DMA DeInit */
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(UART4_IRQn);
   /* USER CODE END UART4_MspDeInit 1 */
   }
   else if(uartHandle->Instance==USART1)
@@ -181,11 +276,125 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOA, GPIO_PIN_9|GPIO_PIN_10);
 
   /* USER CODE BEGIN USART1_MspDeInit 1 */
-
+    /* USART1 DMA DeInit */
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(USART1_IRQn);
   /* USER CODE END USART1_MspDeInit 1 */
   }
 }
 
 /* USER CODE BEGIN 1 */
+/**
+ * @函数名      : UART_TxEnqueue
+ * @描述        : 将数据写入串口发送环形缓冲区并立即返回，由DMA在后台发送
+ * @参数        : huart - 串口句柄
+ *                data - 待发送数据
+ *                len - 数据长度
+ * @返回值      : HAL_OK / HAL_BUSY（空间不足，整条丢弃） / HAL_ERROR
+ * @实现细节    :
+ *   1. 空间不足时丢弃整条消息而不是截断，保证接收端看到的每一行都是完整的
+ *   2. 先复制数据再发布head，发送中断只会看到已完整写入的数据
+ *   3. 仅在检查并启动DMA时短暂关中断，避免与发送完成中断同时启动DMA
+ */
+HAL_StatusTypeDef UART_TxEnqueue(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+  UART_TxRing *ring = UART_TxFindRing(huart);
+  if (ring == NULL)
+    return HAL_ERROR;
+  if (len == 0)
+    return HAL_OK;
+
+  const uint16_t head = ring->head;
+  const uint16_t used = (uint16_t)(head - ring->tail);
+  if (len > UART_TX_BUF_SIZE - used)
+  {
+    ring->stats.overflow_count++;
+    ring->stats.dropped_bytes += len;
+    return HAL_BUSY;
+  }
+
+  // 分两段复制，处理缓冲区末尾回绕
+  const uint16_t offset = head & (UART_TX_BUF_SIZE - 1U);
+  uint16_t first = UART_TX_BUF_SIZE - offset;
+  if (first > len)
+    first = len;
+  memcpy(&ring->buf[offset], data, first);
+  memcpy(&ring->buf[0], data + first, len - first);
+
+  __DMB();
+  ring->head = head + len;
+
+  if (used + len > ring->stats.high_water)
+    ring->stats.high_water = used + len;
 
+  // 通道空闲时启动DMA
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (ring->dma_len == 0)
+    UART_TxStartNext(ring);
+  __set_PRIMASK(primask);
+
+  return HAL_OK;
+}
+
+/**
+ * @函数名      : UART_TxEnqueueStr
+ * @描述        : 将以'\0'结尾的字符串写入串口发送缓冲区
+ */
+HAL_StatusTypeDef UART_TxEnqueueStr(UART_HandleTypeDef *huart, const char *str)
+{
+  return UART_TxEnqueue(huart, (const uint8_t *)str, (uint16_t)strlen(str));
+}
+
+/**
+ * @函数名      : UART_TxPending
+ * @描述        : 获取发送缓冲区中尚未发送完成的字节数
+ */
+uint16_t UART_TxPending(UART_HandleTypeDef *huart)
+{
+  UART_TxRing *ring = UART_TxFindRing(huart);
+  return (ring != NULL) ? (uint16_t)(ring->head - ring->tail) : 0;
+}
+
+/**
+ * @函数名      : UART_TxGetStats
+ * @描述        : 获取发送通道的统计计数
+ */
+const UART_TxStats *UART_TxGetStats(UART_HandleTypeDef *huart)
+{
+  UART_TxRing *ring = UART_TxFindRing(huart);
+  return (ring != NULL) ? &ring->stats : NULL;
+}
+
+/**
+ * @函数名      : HAL_UART_TxCpltCallback
+ * @描述        : 串口发送完成（TC）中断回调，释放已发送数据并启动下一段
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  UART_TxRing *ring = UART_TxFindRing(huart);
+  if (ring == NULL)
+    return;
+
+  ring->tail += ring->dma_len;
+  ring->stats.bytes_sent += ring->dma_len;
+  ring->dma_len = 0;
+  UART_TxStartNext(ring);
+}
+
+/**
+ * @函数名      : HAL_UART_ErrorCallback
+ * @描述        : 串口错误回调，丢弃出错的一段数据并继续发送后续数据
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  UART_TxRing *ring = UART_TxFindRing(huart);
+  if (ring == NULL || ring->dma_len == 0)
+    return;
+
+  ring->tail += ring->dma_len;
+  ring->stats.dropped_bytes += ring->dma_len;
+  ring->dma_len = 0;
+  UART_TxStartNext(ring);
+}
 /* USER CODE END 1 */
@@ -0,0 +1,87 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/**
+ * @文件        : Arduino.h
+ * @描述        : 主机端ESP8266 Arduino核心的最小替身，用于编译并测试WebClient.ino
+ * @注意事项    : 只实现草图用到的接口：虚拟毫秒时钟、Serial、String和ESP.random；
+ *                时间只在delay()（及测试调用Mock_Advance）时前进，期间到期的Wi-Fi事件
+ *                在其中分发，与SDK在yield时执行事件回调一致
+ */
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+
+/* 虚拟时钟 -------------------------------------------------------------------*/
+unsigned long millis();
+void delay(unsigned long ms);
+
+/**
+ * @函数名      : Mock_Advance
+ * @描述        : 将虚拟时钟推进ms毫秒，按时间顺序分发期间到期的Wi-Fi事件
+ */
+void Mock_Advance(unsigned long ms);
+
+/* String ---------------------------------------------------------------------*/
+class String {
+public:
+  String(const char* s = "") : s_(s) {}
+  String(const std::string& s) : s_(s) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(unsigned v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  size_t length() const { return s_.size(); }
+  String operator+(const String& o) const { return String(s_ + o.s_); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s_); }
+
+private:
+  std::string s_;
+};
+
+/* Serial ---------------------------------------------------------------------*/
+
+/**
+ * @类名        : MockSerial
+ * @描述        : 调试/数据串口：接收端由测试注入字节，发送端的输出保存在out中
+ */
+class MockSerial {
+public:
+  std::deque<uint8_t> rx;   // 等待草图读取的字节
+  std::string out;          // 草图输出的调试文本
+
+  void setRxBufferSize(size_t size) { (void)size; }
+  void begin(unsigned long baud) { (void)baud; }
+  int available() { return (int)rx.size(); }
+  size_t readBytes(uint8_t* buf, size_t len);
+
+  size_t write(const uint8_t* data, size_t len);
+  size_t write(const char* data, size_t len) { return write((const uint8_t*)data, len); }
+  size_t print(const char* s) { return write(s, strlen(s)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t println(const char* s = "") { return print(s) + print("\n"); }
+  size_t println(const String& s) { return println(s.c_str()); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  /* 注入接收数据 */
+  void inject(const uint8_t* data, size_t len) { rx.insert(rx.end(), data, data + len); }
+};
+
+extern MockSerial Serial;
+
+/* ESP ------------------------------------------------------------------------*/
+class MockEsp {
+public:
+  uint32_t random();
+};
+
+extern MockEsp ESP;
+
+#endif /* ARDUINO_H */
@@ -0,0 +1,83 @@
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+/**
+ * @文件        : ESP8266WiFi.h
+ * @描述        : ESP8266WiFi站点模式的主机端模型
+ * @注意事项    : 连接过程按测试设置的接入点行为在虚拟时钟上推进：
+ *                WiFi.begin后先产生若干次Disconnected事件（SDK在认证/关联失败时的行为），
+ *                接入点可用时随后产生GotIP事件并进入WL_CONNECTED；不可用时每秒产生一次Disconnected
+ *                WiFi.disconnect()及Mock_WiFiDrop()断开时同样产生Disconnected事件
+ */
+
+#include "Arduino.h"
+#include <functional>
+#include <memory>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+} WiFiMode_t;
+
+struct WiFiEventStationModeGotIP {};
+struct WiFiEventStationModeDisconnected {};
+
+/* 与SDK相同，事件处理器在句柄释放时注销 */
+typedef std::shared_ptr<void> WiFiEventHandler;
+
+class IPAddress {
+public:
+  String toString() const { return String("192.168.4.2"); }
+};
+
+/**
+ * @结构体名    : Mock_AccessPoint
+ * @描述        : 接入点行为，由测试设置
+ */
+struct Mock_AccessPoint {
+  bool available = true;          // 接入点是否可连接
+  unsigned connect_ms = 3000;     // WiFi.begin到获取IP的时间
+  unsigned failures_before_ip = 0; // 获取IP之前产生的Disconnected事件数，在connect_ms内均匀分布
+};
+
+class ESP8266WiFiClass {
+public:
+  void persistent(bool enable) { (void)enable; }
+  bool mode(WiFiMode_t m) { (void)m; return true; }
+  bool setAutoReconnect(bool enable) { (void)enable; return true; }
+  WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> fn);
+  WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected&)> fn);
+  void macAddress(uint8_t* mac);
+  wl_status_t begin(const char* ssid, const char* password);
+  wl_status_t status();
+  bool disconnect(bool wifioff = false);
+  IPAddress localIP() { return IPAddress(); }
+};
+
+extern ESP8266WiFiClass WiFi;
+
+/* 测试控制 -------------------------------------------------------------------*/
+extern Mock_AccessPoint Mock_AP;
+
+/**
+ * @函数名      : Mock_WiFiDrop
+ * @描述        : 模拟已建立的连接断开（接入点消失），产生Disconnected事件
+ */
+void Mock_WiFiDrop();
+
+/**
+ * @函数名      : Mock_WiFiGotIpEvents / Mock_WiFiDisconnectedEvents
+ * @描述        : 获取已分发的GotIP/Disconnected事件数
+ */
+unsigned Mock_WiFiGotIpEvents();
+unsigned Mock_WiFiDisconnectedEvents();
+
+#endif /* ESP8266WIFI_H */
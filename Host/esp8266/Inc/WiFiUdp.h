@@ -0,0 +1,34 @@
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+/**
+ * @文件        : WiFiUdp.h
+ * @描述        : WiFiUDP的主机端模型
+ * @注意事项    : 发出的报文保存在Mock_UdpSent中；Wi-Fi未连接时endPacket失败；
+ *                服务器发来的报文由测试放入Mock_UdpInbound
+ */
+
+#include "ESP8266WiFi.h"
+#include <vector>
+
+typedef std::vector<uint8_t> Mock_Datagram;
+
+extern std::vector<Mock_Datagram> Mock_UdpSent;
+extern std::deque<Mock_Datagram> Mock_UdpInbound;
+
+class WiFiUDP {
+public:
+  uint8_t begin(uint16_t port) { (void)port; return 1; }
+  int beginPacket(const char* host, uint16_t port);
+  size_t write(const uint8_t* data, size_t len);
+  int endPacket();
+  int parsePacket();
+  int read(uint8_t* buf, size_t len);
+
+private:
+  Mock_Datagram tx_;
+  Mock_Datagram rx_;
+  bool open_ = false;
+};
+
+#endif /* WIFIUDP_H */
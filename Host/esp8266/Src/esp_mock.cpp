@@ -0,0 +1,224 @@
+/**
+ * @文件        : esp_mock.cpp
+ * @描述        : Arduino核心、ESP8266WiFi与WiFiUDP主机端模型的实现
+ * @注意事项    : 行为约定见各头文件
+ */
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "WiFiUdp.h"
+#include <algorithm>
+
+MockSerial Serial;
+MockEsp ESP;
+ESP8266WiFiClass WiFi;
+Mock_AccessPoint Mock_AP;
+std::vector<Mock_Datagram> Mock_UdpSent;
+std::deque<Mock_Datagram> Mock_UdpInbound;
+
+/* 私有变量 */
+static unsigned long now_ms = 0;
+static uint32_t rng_state = 0x1234567U;
+
+enum MockEventType { EVENT_GOT_IP, EVENT_DISCONNECTED, EVENT_RETRY };
+
+struct MockEvent {
+  unsigned long when;
+  MockEventType type;
+};
+
+static std::vector<MockEvent> events;
+static std::function<void(const WiFiEventStationModeGotIP&)> got_ip_fn;
+static std::function<void(const WiFiEventStationModeDisconnected&)> disconnected_fn;
+static wl_status_t wifi_status = WL_IDLE_STATUS;
+static bool attempting = false;
+static unsigned got_ip_events = 0;
+static unsigned disconnected_events = 0;
+
+/* 虚拟时钟 -------------------------------------------------------------------*/
+
+unsigned long millis() {
+  return now_ms;
+}
+
+void delay(unsigned long ms) {
+  Mock_Advance(ms);
+}
+
+/**
+ * @函数名      : schedule_attempt
+ * @描述        : 安排一次连接尝试的后续事件：先是若干次失败，接入点可用时最后获取IP，
+ *                不可用时每秒失败一次并重新检查接入点
+ */
+static void schedule_attempt(unsigned long start) {
+  if (!Mock_AP.available) {
+    events.push_back({start + 1000, EVENT_RETRY});
+    return;
+  }
+  for (unsigned k = 1; k <= Mock_AP.failures_before_ip; k++) {
+    events.push_back({start + Mock_AP.connect_ms * k / (Mock_AP.failures_before_ip + 1), EVENT_DISCONNECTED});
+  }
+  events.push_back({start + Mock_AP.connect_ms, EVENT_GOT_IP});
+}
+
+static void dispatch(const MockEvent& e) {
+  switch (e.type) {
+    case EVENT_GOT_IP:
+      wifi_status = WL_CONNECTED;
+      attempting = false;
+      got_ip_events++;
+      if (got_ip_fn) got_ip_fn(WiFiEventStationModeGotIP());
+      break;
+    case EVENT_RETRY:
+      disconnected_events++;
+      if (disconnected_fn) disconnected_fn(WiFiEventStationModeDisconnected());
+      if (attempting) schedule_attempt(e.when);
+      break;
+    case EVENT_DISCONNECTED:
+      disconnected_events++;
+      if (disconnected_fn) disconnected_fn(WiFiEventStationModeDisconnected());
+      break;
+  }
+}
+
+void Mock_Advance(unsigned long ms) {
+  const unsigned long target = now_ms + ms;
+
+  for (;;) {
+    auto next = std::min_element(events.begin(), events.end(),
+                                 [](const MockEvent& a, const MockEvent& b) { return a.when < b.when; });
+    if (next == events.end() || next->when > target) break;
+    const MockEvent e = *next;
+    events.erase(next);
+    if (e.when > now_ms) now_ms = e.when;
+    dispatch(e);
+  }
+  now_ms = target;
+}
+
+/* Serial / ESP ---------------------------------------------------------------*/
+
+size_t MockSerial::readBytes(uint8_t* buf, size_t len) {
+  size_t n = 0;
+  while (n < len && !rx.empty()) {
+    buf[n++] = rx.front();
+    rx.pop_front();
+  }
+  return n;
+}
+
+size_t MockSerial::write(const uint8_t* data, size_t len) {
+  out.append((const char*)data, len);
+  return len;
+}
+
+size_t MockSerial::printf(const char* fmt, ...) {
+  char buf[512];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  return print(buf);
+}
+
+uint32_t MockEsp::random() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/* ESP8266WiFi ----------------------------------------------------------------*/
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> fn) {
+  got_ip_fn = fn;
+  return std::make_shared<int>(0);
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(
+    std::function<void(const WiFiEventStationModeDisconnected&)> fn) {
+  disconnected_fn = fn;
+  return std::make_shared<int>(0);
+}
+
+void ESP8266WiFiClass::macAddress(uint8_t* mac) {
+  static const uint8_t addr[6] = {0x5C, 0xCF, 0x7F, 0x12, 0x34, 0x56};
+  memcpy(mac, addr, sizeof(addr));
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char* ssid, const char* password) {
+  (void)ssid;
+  (void)password;
+  events.clear();
+  wifi_status = WL_DISCONNECTED;
+  attempting = true;
+  schedule_attempt(now_ms);
+  return wifi_status;
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  return wifi_status;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifioff) {
+  (void)wifioff;
+  const bool was_active = attempting || wifi_status == WL_CONNECTED;
+  events.clear();
+  attempting = false;
+  wifi_status = WL_DISCONNECTED;
+  if (was_active) events.push_back({now_ms, EVENT_DISCONNECTED});
+  return true;
+}
+
+void Mock_WiFiDrop() {
+  if (wifi_status != WL_CONNECTED) return;
+  wifi_status = WL_DISCONNECTED;
+  events.push_back({now_ms, EVENT_DISCONNECTED});
+}
+
+unsigned Mock_WiFiGotIpEvents() {
+  return got_ip_events;
+}
+
+unsigned Mock_WiFiDisconnectedEvents() {
+  return disconnected_events;
+}
+
+/* WiFiUDP --------------------------------------------------------------------*/
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+  (void)host;
+  (void)port;
+  tx_.clear();
+  open_ = true;
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* data, size_t len) {
+  if (!open_) return 0;
+  tx_.insert(tx_.end(), data, data + len);
+  return len;
+}
+
+int WiFiUDP::endPacket() {
+  if (!open_) return 0;
+  open_ = false;
+  if (wifi_status != WL_CONNECTED) return 0;
+  Mock_UdpSent.push_back(tx_);
+  return 1;
+}
+
+int WiFiUDP::parsePacket() {
+  if (Mock_UdpInbound.empty()) return 0;
+  rx_ = Mock_UdpInbound.front();
+  Mock_UdpInbound.pop_front();
+  return (int)rx_.size();
+}
+
+int WiFiUDP::read(uint8_t* buf, size_t len) {
+  const size_t n = std::min(len, rx_.size());
+  memcpy(buf, rx_.data(), n);
+  rx_.erase(rx_.begin(), rx_.begin() + n);
+  return (int)n;
+}
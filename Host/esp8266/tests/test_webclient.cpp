@@ -0,0 +1,261 @@
+/**
+ * @文件        : test_webclient.cpp
+ * @描述        : ESP8266转发程序（WebClient.ino）的主机端测试
+ * @注意事项    : 草图原样编译进本文件，与Arduino/ESP8266WiFi/WiFiUDP的主机端模型链接；
+ *                串口输入由测试注入，每次loop()推进10ms虚拟时间，发往服务器的报文从Mock_UdpSent取出
+ */
+
+#include "test.h"
+#include "WebClient.ino"
+#include <set>
+#include <vector>
+
+static uint32_t rng_state = 0xC0FFEEU;
+
+/* xorshift32，固定种子使失败可复现 */
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/* 逐位CRC16-CCITT，与固件telemetry.c相同 */
+static uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)(data[i] << 8);
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* 按telemetry.h的布局生成一帧，序号为seq，测量值随机 */
+static std::vector<uint8_t> make_frame(uint16_t seq) {
+  std::vector<uint8_t> f(FRAME_SIZE);
+  f[0] = FRAME_SYNC0;
+  f[1] = FRAME_SYNC1;
+  f[2] = FRAME_VERSION;
+  f[3] = FRAME_SIZE;
+  f[4] = (uint8_t)seq;
+  f[5] = (uint8_t)(seq >> 8);
+  f[6] = 0x78;  // 设备ID已设置，转发时不改写
+  f[7] = 0x56;
+  f[8] = 0x34;
+  f[9] = 0x12;
+  for (size_t i = 10; i < FRAME_SIZE - 2; i++) {
+    f[i] = (uint8_t)rng();
+  }
+  const uint16_t crc = crc16(f.data(), FRAME_SIZE - 2);
+  f[FRAME_SIZE - 2] = (uint8_t)crc;
+  f[FRAME_SIZE - 1] = (uint8_t)(crc >> 8);
+  return f;
+}
+
+/* 以每次loop()最多chunk字节的速度把数据送入串口，最后再运行一会儿使合并发送超时 */
+static void feed(const std::vector<uint8_t>& data, size_t chunk = 48) {
+  for (size_t i = 0; i < data.size(); i += chunk) {
+    Serial.inject(data.data() + i, std::min(chunk, data.size() - i));
+    loop();
+  }
+  for (int i = 0; i < COALESCE_TIMEOUT / 10 + 10; i++) {
+    loop();
+  }
+  Serial.out.clear();
+}
+
+/**
+ * @结构体名    : Received
+ * @描述        : 服务器收到的内容：记录报文中各帧的序号，以及文本报文
+ */
+struct Received {
+  std::vector<uint16_t> seqs;
+  std::vector<std::string> lines;
+};
+
+static Received collect() {
+  Received r;
+  for (const Mock_Datagram& d : Mock_UdpSent) {
+    if (d.size() >= LOG_HEADER_SIZE && d[0] == 'S' && d[1] == 'F') {
+      for (uint8_t i = 0; i < d[6]; i++) {
+        const uint8_t* frame = &d[LOG_HEADER_SIZE + i * LOG_RECORD_SIZE + 8];
+        CHECK(crc16(frame, FRAME_SIZE - 2) == (frame[FRAME_SIZE - 2] | frame[FRAME_SIZE - 1] << 8),
+              "forwarded frame with bad CRC");
+        r.seqs.push_back((uint16_t)(frame[4] | frame[5] << 8));
+      }
+    } else {
+      r.lines.emplace_back(d.begin(), d.end());
+    }
+  }
+  Mock_UdpSent.clear();
+  return r;
+}
+
+/* 启动草图并等待Wi-Fi连接 */
+static void start_link() {
+  setup();
+  for (int i = 0; i < 1000 && linkState != LINK_UP; i++) {
+    loop();
+  }
+  CHECK(linkState == LINK_UP, "link not up after 10s");
+  Mock_UdpSent.clear();
+}
+
+static bool is_ascii_line(const std::string& s) {
+  for (unsigned char c : s) {
+    if (c < 0x20 || c > 0x7E) return false;
+  }
+  return true;
+}
+
+/* 背靠背的帧，第victim帧丢失或改写一个字节：只有该帧丢失，之后的帧全部恢复，不产生文本报文 */
+static void check_damaged_frame(bool drop, size_t pos) {
+  const unsigned frames = 12;
+  const unsigned victim = 5;
+  std::vector<uint8_t> stream;
+
+  for (unsigned seq = 0; seq < frames; seq++) {
+    std::vector<uint8_t> f = make_frame((uint16_t)seq);
+    if (seq == victim) {
+      if (drop) {
+        f.erase(f.begin() + pos);
+      } else {
+        f[pos] ^= (uint8_t)(1U << (rng() % 8));
+      }
+    }
+    stream.insert(stream.end(), f.begin(), f.end());
+  }
+  feed(stream);
+
+  const Received r = collect();
+  std::vector<uint16_t> expected;
+  for (unsigned seq = 0; seq < frames; seq++) {
+    if (seq != victim) expected.push_back((uint16_t)seq);
+  }
+  CHECK(r.seqs == expected, "%s byte %zu: %zu of %zu frames forwarded", drop ? "dropped" : "corrupted", pos,
+        r.seqs.size(), expected.size());
+  CHECK(r.lines.empty(), "%s byte %zu: %zu text datagrams from frame data", drop ? "dropped" : "corrupted", pos,
+        r.lines.size());
+}
+
+/* 丢失或改写帧中任一位置的一个字节 */
+static void test_single_byte_errors() {
+  for (size_t pos = 0; pos < FRAME_SIZE; pos++) {
+    check_damaged_frame(true, pos);
+    check_damaged_frame(false, pos);
+  }
+}
+
+/*
+ * 长时间运行中随机丢失字节：每个丢失只影响所在的一帧，服务器收到的恰好是未受影响的帧，
+ * 且帧数据不会作为文本报文转发
+ */
+static void test_random_drops() {
+  const unsigned frames = 3000;
+  std::vector<uint8_t> stream;
+  std::set<uint16_t> damaged;
+
+  for (unsigned seq = 0; seq < frames; seq++) {
+    const std::vector<uint8_t> f = make_frame((uint16_t)seq);
+    for (uint8_t b : f) {
+      if (rng() % 1000 == 0) {
+        damaged.insert((uint16_t)seq);
+        continue;
+      }
+      stream.push_back(b);
+    }
+  }
+  feed(stream);
+
+  const Received r = collect();
+  std::vector<uint16_t> expected;
+  for (unsigned seq = 0; seq < frames; seq++) {
+    if (!damaged.count((uint16_t)seq)) expected.push_back((uint16_t)seq);
+  }
+  CHECK(r.seqs == expected, "%zu of %zu undamaged frames forwarded", r.seqs.size(), expected.size());
+  CHECK(r.lines.empty(), "%zu text datagrams from frame data", r.lines.size());
+  printf("random drops: %zu frames damaged, %zu forwarded, %u counted bad\n", damaged.size(), r.seqs.size(),
+         framesBad);
+}
+
+/* 文本行与帧混合：完整的ASCII行照常转发，含非ASCII字节或被帧打断的行丢弃 */
+static void test_text_lines() {
+  const std::string line1 = "Humidity: 45.0%, Temperature: 23.5 C, Methane: 2.1 ppm, TVOC: 12 ppb, "
+                            "CO2eq: 400 ppm, Dust(PM2.5): 8.0 ug/m^3";
+  const std::string line2 = "Humidity: 46.0%, Temperature: 23.4 C, Methane: 2.0 ppm, TVOC: 10 ppb, "
+                            "CO2eq: 410 ppm, Dust(PM2.5): 7.5 ug/m^3";
+  std::vector<uint8_t> stream;
+  auto append = [&stream](const std::string& s) { stream.insert(stream.end(), s.begin(), s.end()); };
+  auto append_frame = [&stream](uint16_t seq) {
+    const std::vector<uint8_t> f = make_frame(seq);
+    stream.insert(stream.end(), f.begin(), f.end());
+  };
+
+  append("  " + line1 + "\r\n");
+  append_frame(100);
+  append("Humidity: 4\xC3\xA9.0%\n");   // 非ASCII字节
+  append("Humidity: 47.0%, Temper");   // 换行丢失，被下一帧打断
+  append_frame(101);
+  append("\n" + line2 + "\n");
+  append_frame(102);
+  feed(stream);
+
+  const Received r = collect();
+  CHECK(r.seqs == std::vector<uint16_t>({100, 101, 102}), "%zu frames forwarded", r.seqs.size());
+  CHECK(r.lines.size() == 2 && r.lines[0] == line1 && r.lines[1] == line2, "%zu text lines forwarded",
+        r.lines.size());
+  for (const std::string& line : r.lines) {
+    CHECK(is_ascii_line(line), "non-ASCII line forwarded");
+  }
+}
+
+/* 运行seconds秒的主循环 */
+static void run_for(unsigned seconds) {
+  for (unsigned i = 0; i < seconds * 100; i++) {
+    loop();
+  }
+}
+
+/*
+ * 连接过程中SDK先报告几次Disconnected（认证/关联重试）再获取IP：
+ * 进入LINK_UP后不应把这些旧事件当作断线，连接保持且不再重连
+ */
+static void test_disconnected_while_connecting() {
+  Mock_AP.failures_before_ip = 3;
+  const unsigned disconnectedBefore = Mock_WiFiDisconnectedEvents();
+  start_link();
+  CHECK(Mock_WiFiDisconnectedEvents() - disconnectedBefore == 3, "%u Disconnected events while connecting",
+        Mock_WiFiDisconnectedEvents() - disconnectedBefore);
+
+  const uint32_t attempts = connectAttempts;
+  const unsigned gotIp = Mock_WiFiGotIpEvents();
+  run_for(10);
+  CHECK(linkState == LINK_UP, "link dropped after connecting (state %d)", (int)linkState);
+  CHECK(connectAttempts == attempts, "%u extra connection attempts", connectAttempts - attempts);
+  CHECK(Mock_WiFiGotIpEvents() == gotIp, "%u extra GotIP events", Mock_WiFiGotIpEvents() - gotIp);
+  CHECK(reconnectCount == 0, "%u reconnects counted", reconnectCount);
+
+  // 真正的断线仍被发现：重连过程中同样有Disconnected事件，重连成功后保持连接
+  Mock_WiFiDrop();
+  run_for(1);
+  CHECK(linkState != LINK_UP, "drop not detected");
+  run_for(15);
+  CHECK(linkState == LINK_UP, "link not restored after drop (state %d)", (int)linkState);
+  CHECK(connectAttempts == attempts + 1, "%u connection attempts after one drop", connectAttempts - attempts);
+  run_for(10);
+  CHECK(linkState == LINK_UP && reconnectCount == 1, "link state %d, %u reconnects", (int)linkState,
+        reconnectCount);
+
+  Mock_AP.failures_before_ip = 0;
+  Mock_UdpSent.clear();
+}
+
+int main() {
+  test_disconnected_while_connecting();
+  test_text_lines();
+  test_single_byte_errors();
+  test_random_drops();
+  return TEST_EXIT();
+}
@@ -0,0 +1,256 @@
+#ifndef SIM_H
+#define SIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : sim.h
+ * @描述        : 主机端模拟器接口：虚拟时钟、中断分发和各外设/传感器模型
+ * @注意事项    : 时间以72MHz CPU周期计，固件只能通过HAL调用感知时间：
+ *                每次HAL调用消耗固定的虚拟周期（SIM_COST_*），固件自身的计算不计时，
+ *                因此测得的延迟反映的是外设等待、Flash擦写停顿等建模过的开销
+ *                外设事件（DMA半/全传输、ADC转换、I2C/UART传输完成、GPIO边沿）由
+ *                Sim_Timer在指定时刻触发，回调在“中断上下文”中执行：
+ *                中断之间不嵌套；PRIMASK置位期间到期的事件推迟到开中断后执行
+ *                __WFI()将时间直接推进到下一个事件或下一个SysTick毫秒边界
+ */
+
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+
+/* 虚拟时钟 */
+#define SIM_CPU_HZ 72000000U
+#define SIM_US(us) ((uint64_t)(us) * (SIM_CPU_HZ / 1000000U))
+#define SIM_MS(ms) ((uint64_t)(ms) * (SIM_CPU_HZ / 1000U))
+
+/* HAL调用的虚拟开销（CPU周期），量级参考F103上-O2编译的HAL实现 */
+#define SIM_COST_TICK 12	  // HAL_GetTick
+#define SIM_COST_DWT 2		  // 读DWT->CYCCNT
+#define SIM_COST_GPIO 16	  // HAL_GPIO_ReadPin/WritePin
+#define SIM_COST_HAL_CALL 200 // 其余HAL函数（启动传输、读写寄存器等）
+
+/* Flash擦写停顿（STM32F103数据手册典型值） */
+#define SIM_FLASH_ERASE_US 20000
+#define SIM_FLASH_PROGRAM_US 52
+
+	/* 模拟定时器 -----------------------------------------------------------------*/
+	typedef void (*Sim_TimerFn)(void *arg);
+
+	/**
+	 * @结构体名    : Sim_Timer
+	 * @描述        : 单次触发的虚拟定时器，外设模型用它安排下一次中断
+	 * @注意事项    : 须先用Sim_TimerInit注册（静态分配，最多SIM_MAX_TIMERS个）
+	 */
+	typedef struct
+	{
+		const char *name;
+		Sim_TimerFn fn;
+		void *arg;
+		uint64_t when;	// 触发时刻（周期）
+		uint8_t active; // 是否已安排
+	} Sim_Timer;
+
+#define SIM_MAX_TIMERS 32
+
+	/**
+	 * @函数名      : Sim_TimerInit / Sim_TimerStart / Sim_TimerStop
+	 * @描述        : 注册定时器 / 安排在绝对时刻when触发（覆盖原安排） / 取消
+	 * @注意事项    : when不晚于当前时刻时，在下一次消耗周期或WFI时立即触发
+	 */
+	void Sim_TimerInit(Sim_Timer *t, const char *name, Sim_TimerFn fn, void *arg);
+	void Sim_TimerStart(Sim_Timer *t, uint64_t when);
+	void Sim_TimerStop(Sim_Timer *t);
+
+	/**
+	 * @函数名      : Sim_Now
+	 * @描述        : 当前虚拟时间（CPU周期）
+	 */
+	uint64_t Sim_Now(void);
+
+	/**
+	 * @函数名      : Sim_Charge
+	 * @描述        : 消耗虚拟CPU周期，期间到期的事件按时间顺序分发
+	 */
+	void Sim_Charge(uint32_t cycles);
+
+	/**
+	 * @函数名      : Sim_Run
+	 * @描述        : 设置结束时刻和结束处理函数
+	 * @参数        : end - 结束时刻（周期）
+	 *                on_end - 主循环上下文中到达结束时刻时调用，应输出结果并退出进程
+	 */
+	void Sim_Run(uint64_t end, void (*on_end)(void));
+
+	/**
+	 * @结构体名    : Sim_LoopStats
+	 * @描述        : 主循环统计：两次WFI之间的连续忙碌时间即主循环的最坏响应延迟
+	 */
+	typedef struct
+	{
+		uint64_t startup_cycles; // 从复位到第一次WFI的初始化时间
+		uint64_t wakeups;	   // WFI唤醒次数
+		uint64_t busy_cycles;  // 非WFI时间合计
+		uint64_t max_busy;	   // 最长连续忙碌时间（周期）
+		uint64_t max_busy_at;  // 最长忙碌段的结束时刻
+		uint64_t isr_count;	   // 分发的中断数
+		uint64_t max_isr_late; // 中断相对触发时刻的最大延后（关中断或其他中断占用）
+	} Sim_LoopStats;
+
+	const Sim_LoopStats *Sim_GetLoopStats(void);
+
+	/* GPIO与DHT11模型 ------------------------------------------------------------*/
+
+	/**
+	 * @函数名      : Sim_GpioParse
+	 * @描述        : 解析"PC1"形式的引脚名
+	 * @返回值      : 0 - 成功; -1 - 格式错误
+	 */
+	int Sim_GpioParse(const char *name, GPIO_TypeDef **port, uint16_t *pin);
+
+	/**
+	 * @函数名      : Sim_GpioDrive
+	 * @描述        : 外部器件拉低或释放引脚（开漏线与）
+	 * @参数        : low - 1拉低，0释放（由上拉拉高）
+	 * @注意事项    : 电平变化时按EXTI配置产生下降/上升沿中断
+	 */
+	void Sim_GpioDrive(GPIO_TypeDef *port, uint16_t pin, uint8_t low);
+
+	/**
+	 * @结构体名    : Sim_Segment
+	 * @描述        : 波形段：外部驱动电平及持续时间
+	 */
+	typedef struct
+	{
+		uint8_t level;	 // 0拉低，1释放
+		uint32_t dur_us; // 持续时间(us)
+	} Sim_Segment;
+
+#define SIM_WAVE_MAX_SEGMENTS 96
+
+	/**
+	 * @函数名      : Sim_GpioPlay
+	 * @描述        : 从当前时刻起在引脚上播放脚本波形，结束后释放引脚
+	 * @返回值      : 0 - 成功; -1 - 播放器已满或波形过长
+	 * @注意事项    : 同一引脚上的新波形替换正在播放的波形
+	 */
+	int Sim_GpioPlay(GPIO_TypeDef *port, uint16_t pin, const Sim_Segment *seg, uint16_t count);
+
+	/* DHT11模型故障类型 */
+#define SIM_DHT11_OK 0		 // 正常应答
+#define SIM_DHT11_SILENT 1	 // 不应答
+#define SIM_DHT11_CHECKSUM 2 // 校验和错误
+#define SIM_DHT11_TRUNCATE 3 // 只发送前20位后停止
+
+	/**
+	 * @函数名      : Sim_Dht11_Set
+	 * @描述        : 在引脚上挂接（首次调用时）DHT11模型并设置读数和故障
+	 * @参数        : humidity/temperature - 整数与小数部分
+	 *                fault - SIM_DHT11_*
+	 * @实现细节    : 主机拉低不少于18ms后释放，模型在30us后按手册时序应答：
+	 *                80us低+80us高，40位数据（50us低+26us/70us高），最后50us低后释放
+	 */
+	int Sim_Dht11_Set(GPIO_TypeDef *port, uint16_t pin, uint8_t hum, uint8_t hum_dec,
+					  uint8_t temp, uint8_t temp_dec, uint8_t fault);
+
+	/**
+	 * @函数名      : Sim_Dht11_Report
+	 * @描述        : 输出各DHT11模型的应答统计
+	 */
+	void Sim_Dht11_Report(FILE *out);
+
+	/* ADC与TIM3模型 --------------------------------------------------------------*/
+
+	/**
+	 * @函数名      : Sim_AdcSetInput
+	 * @描述        : 设置ADC通道的输入电压
+	 * @参数        : channel - ADC通道号（0-17，16为温度传感器，17为内部参考电压）
+	 *                mv - 电压(mV)
+	 *                noise_mv - 均匀分布噪声幅度(mV)，由固定种子的伪随机数产生
+	 * @注意事项    : 通道12（粉尘）仅在TIM3通道4的LED脉冲期间输出该电压，其余时刻为0
+	 */
+	void Sim_AdcSetInput(uint8_t channel, uint16_t mv, uint16_t noise_mv);
+
+	/**
+	 * @函数名      : Sim_Seed
+	 * @描述        : 设置噪声伪随机数种子
+	 */
+	void Sim_Seed(uint32_t seed);
+
+	void Sim_Adc_Report(FILE *out);
+
+	/* I2C与SGP30模型 -------------------------------------------------------------*/
+#define SIM_SGP30_OK 0		// 正常
+#define SIM_SGP30_NACK 1	// 地址不应答
+#define SIM_SGP30_BADCRC 2	// 返回数据的CRC错误
+#define SIM_SGP30_STALL 3	// 总线挂死，传输不结束
+
+	/**
+	 * @函数名      : Sim_Sgp30_Set
+	 * @描述        : 设置SGP30模型的测量值和故障
+	 * @注意事项    : init_air_quality后15s内测量值固定为400ppm/0ppb，与实物一致
+	 */
+	void Sim_Sgp30_Set(uint16_t co2_eq, uint16_t tvoc, uint8_t fault);
+	void Sim_Sgp30_Report(FILE *out);
+
+	/* UART捕获 -------------------------------------------------------------------*/
+
+	/**
+	 * @函数名      : Sim_UartCapture
+	 * @描述        : 将串口发出的数据写入文件
+	 * @参数        : instance - USART1或UART4
+	 *                out - 输出文件，NULL表示丢弃
+	 */
+	void Sim_UartCapture(USART_TypeDef *instance, FILE *out);
+
+	/**
+	 * @结构体名    : Sim_UartStats
+	 * @描述        : 串口发送统计；上报帧以0xA5 0x5A同步字或换行符（文本格式）计数
+	 */
+	typedef struct
+	{
+		uint64_t bytes;
+		uint32_t transfers;
+		uint32_t frames;
+		uint64_t last_frame;   // 最近一帧的开始时刻（周期）
+		uint64_t min_interval; // 相邻两帧的最小/最大间隔（周期）
+		uint64_t max_interval;
+		uint64_t sum_interval;
+	} Sim_UartStats;
+
+	const Sim_UartStats *Sim_UartGetStats(USART_TypeDef *instance);
+
+	/* Flash ---------------------------------------------------------------------*/
+
+	/**
+	 * @函数名      : Sim_FlashInit
+	 * @描述        : 在主机进程的0x08000000处映射256KB模拟Flash
+	 * @参数        : image - 镜像文件，存在时加载，Sim_FlashSave时写回；NULL表示不持久化
+	 * @返回值      : 0 - 成功; -1 - 映射失败
+	 * @注意事项    : 固件的nvstore直接按绝对地址读取Flash，因此须映射在原地址
+	 */
+	int Sim_FlashInit(const char *image);
+	void Sim_FlashSave(void);
+	void Sim_Flash_Report(FILE *out);
+
+	/* 传感器轨迹 -----------------------------------------------------------------*/
+
+	/**
+	 * @函数名      : Sim_TraceLoad
+	 * @描述        : 加载传感器轨迹文件，按时间安排各条指令
+	 * @返回值      : 0 - 成功; -1 - 文件或格式错误（已输出错误位置）
+	 * @注意事项    : 每行格式为“时刻(ms) 设备 参数...”，#开始注释，时刻须不减：
+	 *                  dht11 PC1 45 0 23 5 [ok|silent|checksum|truncate]
+	 *                  adc 10 900 [noise]
+	 *                  sgp30 450 20 [ok|nack|badcrc|stall]
+	 *                  wave PC3 0:100 1:50 ...    （电平:微秒）
+	 */
+	int Sim_TraceLoad(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_H */
@@ -0,0 +1,745 @@
+#ifndef STM32F1XX_HAL_H
+#define STM32F1XX_HAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @文件        : stm32f1xx_hal.h（主机模拟）
+ * @描述        : 主机端模拟HAL，替代Drivers/STM32F1xx_HAL_Driver供固件源码在Linux上编译运行
+ * @注意事项    : 只实现固件用到的类型、宏和函数，名称与取值范围保持与官方HAL一致；
+ *                外设寄存器为普通内存，行为由Host/sim/Src中的外设模型实现
+ *                所有HAL调用按SIM_COST_*消耗虚拟CPU周期，时间推进与中断分发见sim.h
+ *                头文件搜索路径中须排在Core/Inc之前，使固件包含本文件而非官方HAL
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 编译器与内核相关 -----------------------------------------------------------*/
+#define __IO volatile
+#define __weak __attribute__((weak))
+#define UNUSED(x) ((void)(x))
+
+	typedef enum
+	{
+		RESET = 0U,
+		SET = !RESET
+	} FlagStatus,
+		ITStatus;
+
+	typedef enum
+	{
+		DISABLE = 0U,
+		ENABLE = !DISABLE
+	} FunctionalState;
+
+	typedef enum
+	{
+		HAL_OK = 0x00U,
+		HAL_ERROR = 0x01U,
+		HAL_BUSY = 0x02U,
+		HAL_TIMEOUT = 0x03U
+	} HAL_StatusTypeDef;
+
+	typedef enum
+	{
+		HAL_UNLOCKED = 0x00U,
+		HAL_LOCKED = 0x01U
+	} HAL_LockTypeDef;
+
+	/* 中断号，取值与STM32F103（大容量）一致 */
+	typedef enum
+	{
+		SysTick_IRQn = -1,
+		EXTI0_IRQn = 6,
+		EXTI1_IRQn = 7,
+		EXTI2_IRQn = 8,
+		EXTI3_IRQn = 9,
+		EXTI4_IRQn = 10,
+		DMA1_Channel1_IRQn = 11,
+		DMA1_Channel4_IRQn = 14,
+		ADC1_2_IRQn = 18,
+		EXTI9_5_IRQn = 23,
+		TIM3_IRQn = 29,
+		I2C2_EV_IRQn = 33,
+		I2C2_ER_IRQn = 34,
+		USART1_IRQn = 37,
+		EXTI15_10_IRQn = 40,
+		UART4_IRQn = 52,
+		DMA2_Channel4_5_IRQn = 59
+	} IRQn_Type;
+
+	extern uint32_t SystemCoreClock;
+
+	/* 内核调试单元：DWT->CYCCNT由虚拟时钟换算，每次访问消耗SIM_COST_DWT个周期 */
+	typedef struct
+	{
+		__IO uint32_t CTRL;
+		__IO uint32_t CYCCNT;
+	} DWT_Type;
+
+	typedef struct
+	{
+		__IO uint32_t DHCSR;
+		__IO uint32_t DCRSR;
+		__IO uint32_t DCRDR;
+		__IO uint32_t DEMCR;
+	} CoreDebug_Type;
+
+	DWT_Type *Sim_Dwt(void);
+	extern CoreDebug_Type Sim_CoreDebug;
+
+#define DWT (Sim_Dwt())
+#define CoreDebug (&Sim_CoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+	/* PRIMASK与WFI：关中断期间到期的模拟中断推迟到开中断后执行 */
+	uint32_t Sim_GetPrimask(void);
+	void Sim_SetPrimask(uint32_t primask);
+	void Sim_Wfi(void);
+
+#define __get_PRIMASK() Sim_GetPrimask()
+#define __set_PRIMASK(x) Sim_SetPrimask(x)
+#define __disable_irq() Sim_SetPrimask(1U)
+#define __enable_irq() Sim_SetPrimask(0U)
+#define __WFI() Sim_Wfi()
+#define __DMB() __sync_synchronize()
+#define __CLZ(x) ((uint8_t)((x) ? __builtin_clz(x) : 32))
+#define __DSB() __sync_synchronize()
+#define __ISB() __sync_synchronize()
+#define __NOP() ((void)0)
+
+	/* GPIO ----------------------------------------------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t CRL;
+		__IO uint32_t CRH;
+		__IO uint32_t IDR;
+		__IO uint32_t ODR;
+		__IO uint32_t BSRR;
+		__IO uint32_t BRR;
+		__IO uint32_t LCKR;
+	} GPIO_TypeDef;
+
+	typedef struct
+	{
+		uint32_t Pin;
+		uint32_t Mode;
+		uint32_t Pull;
+		uint32_t Speed;
+	} GPIO_InitTypeDef;
+
+	typedef enum
+	{
+		GPIO_PIN_RESET = 0U,
+		GPIO_PIN_SET
+	} GPIO_PinState;
+
+#define SIM_GPIO_PORTS 7
+	extern GPIO_TypeDef Sim_GpioPorts[SIM_GPIO_PORTS];
+
+#define GPIOA (&Sim_GpioPorts[0])
+#define GPIOB (&Sim_GpioPorts[1])
+#define GPIOC (&Sim_GpioPorts[2])
+#define GPIOD (&Sim_GpioPorts[3])
+#define GPIOE (&Sim_GpioPorts[4])
+#define GPIOF (&Sim_GpioPorts[5])
+#define GPIOG (&Sim_GpioPorts[6])
+#define GPIO_GET_INDEX(__GPIOx__) ((uint32_t)((__GPIOx__) - Sim_GpioPorts))
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+#define GPIO_PIN_All ((uint16_t)0xFFFF)
+
+#define GPIO_MODE_INPUT 0x00000000U
+#define GPIO_MODE_OUTPUT_PP 0x00000001U
+#define GPIO_MODE_OUTPUT_OD 0x00000011U
+#define GPIO_MODE_AF_PP 0x00000002U
+#define GPIO_MODE_AF_OD 0x00000012U
+#define GPIO_MODE_AF_INPUT GPIO_MODE_INPUT
+#define GPIO_MODE_ANALOG 0x00000003U
+#define GPIO_MODE_IT_RISING 0x10110000U
+#define GPIO_MODE_IT_FALLING 0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+
+#define GPIO_NOPULL 0x00000000U
+#define GPIO_PULLUP 0x00000001U
+#define GPIO_PULLDOWN 0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW 0x00000002U
+#define GPIO_SPEED_FREQ_MEDIUM 0x00000001U
+#define GPIO_SPEED_FREQ_HIGH 0x00000003U
+
+	/* EXTI与AFIO */
+	typedef struct
+	{
+		__IO uint32_t IMR;
+		__IO uint32_t EMR;
+		__IO uint32_t RTSR;
+		__IO uint32_t FTSR;
+		__IO uint32_t SWIER;
+		__IO uint32_t PR;
+	} EXTI_TypeDef;
+
+	typedef struct
+	{
+		__IO uint32_t EVCR;
+		__IO uint32_t MAPR;
+		__IO uint32_t EXTICR[4];
+		uint32_t RESERVED0;
+		__IO uint32_t MAPR2;
+	} AFIO_TypeDef;
+
+	extern EXTI_TypeDef Sim_Exti;
+	extern AFIO_TypeDef Sim_Afio;
+
+#define EXTI (&Sim_Exti)
+#define AFIO (&Sim_Afio)
+/* 硬件上写1清除挂起位，模拟寄存器直接清零对应位 */
+#define __HAL_GPIO_EXTI_CLEAR_IT(__EXTI_LINE__) (EXTI->PR &= ~(uint32_t)(__EXTI_LINE__))
+#define __HAL_GPIO_EXTI_GET_IT(__EXTI_LINE__) (EXTI->PR & (__EXTI_LINE__))
+
+	void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+	void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+	GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+	void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+	void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+	void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+	void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+	/* RCC（时钟配置只做记录，虚拟时钟固定为72MHz） ------------------------------*/
+	typedef struct
+	{
+		uint32_t PLLState;
+		uint32_t PLLSource;
+		uint32_t PLLMUL;
+	} RCC_PLLInitTypeDef;
+
+	typedef struct
+	{
+		uint32_t OscillatorType;
+		uint32_t HSEState;
+		uint32_t HSEPredivValue;
+		uint32_t LSEState;
+		uint32_t HSIState;
+		uint32_t HSICalibrationValue;
+		uint32_t LSIState;
+		RCC_PLLInitTypeDef PLL;
+	} RCC_OscInitTypeDef;
+
+	typedef struct
+	{
+		uint32_t ClockType;
+		uint32_t SYSCLKSource;
+		uint32_t AHBCLKDivider;
+		uint32_t APB1CLKDivider;
+		uint32_t APB2CLKDivider;
+	} RCC_ClkInitTypeDef;
+
+	typedef struct
+	{
+		uint32_t PeriphClockSelection;
+		uint32_t RTCClockSelection;
+		uint32_t AdcClockSelection;
+		uint32_t UsbClockSelection;
+	} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSE 0x00000001U
+#define RCC_OSCILLATORTYPE_HSI 0x00000002U
+#define RCC_HSE_ON 0x00010000U
+#define RCC_HSE_PREDIV_DIV1 0x00000000U
+#define RCC_HSI_ON 0x00000001U
+#define RCC_PLL_ON 0x00000002U
+#define RCC_PLLSOURCE_HSE 0x00010000U
+#define RCC_PLL_MUL9 0x001C0000U
+#define RCC_CLOCKTYPE_SYSCLK 0x00000001U
+#define RCC_CLOCKTYPE_HCLK 0x00000002U
+#define RCC_CLOCKTYPE_PCLK1 0x00000004U
+#define RCC_CLOCKTYPE_PCLK2 0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK 0x00000002U
+#define RCC_SYSCLK_DIV1 0x00000000U
+#define RCC_HCLK_DIV1 0x00000000U
+#define RCC_HCLK_DIV2 0x00000400U
+#define RCC_PERIPHCLK_ADC 0x00000002U
+#define RCC_ADCPCLK2_DIV6 0x00008000U
+#define FLASH_LATENCY_2 0x00000002U
+
+#define SIM_CLK_NOP() \
+	do                \
+	{                 \
+	} while (0)
+#define __HAL_RCC_AFIO_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_PWR_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_GPIOA_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_GPIOB_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_GPIOC_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_GPIOD_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_GPIOE_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_DMA1_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_DMA2_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_ADC1_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_ADC1_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_RCC_ADC2_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_ADC2_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_RCC_TIM3_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_TIM3_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_RCC_I2C2_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_I2C2_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_RCC_UART4_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_UART4_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_RCC_USART1_CLK_ENABLE() SIM_CLK_NOP()
+#define __HAL_RCC_USART1_CLK_DISABLE() SIM_CLK_NOP()
+#define __HAL_AFIO_REMAP_SWJ_NOJTAG() SIM_CLK_NOP()
+
+	HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+	HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+	HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+
+	/* 系统 -----------------------------------------------------------------------*/
+	HAL_StatusTypeDef HAL_Init(void);
+	void HAL_MspInit(void);
+	uint32_t HAL_GetTick(void);
+	void HAL_Delay(uint32_t Delay);
+	void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+	void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+	void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+	/* DMA（只用于关联句柄，传输由各外设模型完成） -------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t CCR;
+		__IO uint32_t CNDTR;
+		__IO uint32_t CPAR;
+		__IO uint32_t CMAR;
+	} DMA_Channel_TypeDef;
+
+	typedef struct
+	{
+		uint32_t Direction;
+		uint32_t PeriphInc;
+		uint32_t MemInc;
+		uint32_t PeriphDataAlignment;
+		uint32_t MemDataAlignment;
+		uint32_t Mode;
+		uint32_t Priority;
+	} DMA_InitTypeDef;
+
+	typedef enum
+	{
+		HAL_DMA_STATE_RESET = 0x00U,
+		HAL_DMA_STATE_READY = 0x01U,
+		HAL_DMA_STATE_BUSY = 0x02U
+	} HAL_DMA_StateTypeDef;
+
+	typedef struct
+	{
+		DMA_Channel_TypeDef *Instance;
+		DMA_InitTypeDef Init;
+		HAL_LockTypeDef Lock;
+		__IO HAL_DMA_StateTypeDef State;
+		void *Parent;
+		__IO uint32_t ErrorCode;
+	} DMA_HandleTypeDef;
+
+	extern DMA_Channel_TypeDef Sim_DmaChannels[12];
+
+#define DMA1_Channel1 (&Sim_DmaChannels[0])
+#define DMA1_Channel4 (&Sim_DmaChannels[3])
+#define DMA2_Channel5 (&Sim_DmaChannels[11])
+
+#define DMA_PERIPH_TO_MEMORY 0x00000000U
+#define DMA_MEMORY_TO_PERIPH 0x00000010U
+#define DMA_PINC_DISABLE 0x00000000U
+#define DMA_MINC_ENABLE 0x00000080U
+#define DMA_PDATAALIGN_BYTE 0x00000000U
+#define DMA_PDATAALIGN_HALFWORD 0x00000100U
+#define DMA_MDATAALIGN_BYTE 0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00000400U
+#define DMA_NORMAL 0x00000000U
+#define DMA_CIRCULAR 0x00000020U
+#define DMA_PRIORITY_LOW 0x00000000U
+#define DMA_PRIORITY_HIGH 0x00002000U
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+	do                                                                \
+	{                                                                 \
+		(__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);          \
+		(__DMA_HANDLE__).Parent = (__HANDLE__);                       \
+	} while (0U)
+
+	HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+	HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+
+	/* ADC -----------------------------------------------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t SR;
+		__IO uint32_t CR1;
+		__IO uint32_t CR2;
+		__IO uint32_t SMPR1;
+		__IO uint32_t SMPR2;
+		__IO uint32_t SQR1;
+		__IO uint32_t SQR2;
+		__IO uint32_t SQR3;
+		__IO uint32_t DR;
+	} ADC_TypeDef;
+
+	typedef struct
+	{
+		uint32_t DataAlign;
+		uint32_t ScanConvMode;
+		FunctionalState ContinuousConvMode;
+		uint32_t NbrOfConversion;
+		FunctionalState DiscontinuousConvMode;
+		uint32_t NbrOfDiscConversion;
+		uint32_t ExternalTrigConv;
+	} ADC_InitTypeDef;
+
+	typedef struct
+	{
+		uint32_t Channel;
+		uint32_t Rank;
+		uint32_t SamplingTime;
+	} ADC_ChannelConfTypeDef;
+
+	typedef struct
+	{
+		ADC_TypeDef *Instance;
+		ADC_InitTypeDef Init;
+		DMA_HandleTypeDef *DMA_Handle;
+		HAL_LockTypeDef Lock;
+		__IO uint32_t State;
+		__IO uint32_t ErrorCode;
+	} ADC_HandleTypeDef;
+
+	extern ADC_TypeDef Sim_AdcRegs[2];
+
+#define ADC1 (&Sim_AdcRegs[0])
+#define ADC2 (&Sim_AdcRegs[1])
+
+#define HAL_ADC_STATE_RESET 0x00000000U
+#define HAL_ADC_STATE_READY 0x00000001U
+#define HAL_ADC_STATE_REG_BUSY 0x00000100U
+
+#define ADC_SCAN_DISABLE 0x00000000U
+#define ADC_SCAN_ENABLE 0x00000100U
+#define ADC_DATAALIGN_RIGHT 0x00000000U
+#define ADC_SOFTWARE_START 0x000E0000U
+#define ADC_EXTERNALTRIGCONV_T3_TRGO 0x00080000U
+
+#define ADC_CHANNEL_0 0x00000000U
+#define ADC_CHANNEL_1 0x00000001U
+#define ADC_CHANNEL_2 0x00000002U
+#define ADC_CHANNEL_3 0x00000003U
+#define ADC_CHANNEL_4 0x00000004U
+#define ADC_CHANNEL_5 0x00000005U
+#define ADC_CHANNEL_6 0x00000006U
+#define ADC_CHANNEL_7 0x00000007U
+#define ADC_CHANNEL_8 0x00000008U
+#define ADC_CHANNEL_9 0x00000009U
+#define ADC_CHANNEL_10 0x0000000AU
+#define ADC_CHANNEL_11 0x0000000BU
+#define ADC_CHANNEL_12 0x0000000CU
+#define ADC_CHANNEL_13 0x0000000DU
+#define ADC_CHANNEL_14 0x0000000EU
+#define ADC_CHANNEL_15 0x0000000FU
+#define ADC_CHANNEL_16 0x00000010U
+#define ADC_CHANNEL_17 0x00000011U
+#define ADC_CHANNEL_TEMPSENSOR ADC_CHANNEL_16
+#define ADC_CHANNEL_VREFINT ADC_CHANNEL_17
+
+#define ADC_REGULAR_RANK_1 0x00000001U
+#define ADC_REGULAR_RANK_2 0x00000002U
+#define ADC_REGULAR_RANK_3 0x00000003U
+#define ADC_REGULAR_RANK_4 0x00000004U
+
+#define ADC_SAMPLETIME_1CYCLE_5 0x00000000U
+#define ADC_SAMPLETIME_7CYCLES_5 0x00000001U
+#define ADC_SAMPLETIME_13CYCLES_5 0x00000002U
+#define ADC_SAMPLETIME_28CYCLES_5 0x00000003U
+#define ADC_SAMPLETIME_41CYCLES_5 0x00000004U
+#define ADC_SAMPLETIME_55CYCLES_5 0x00000005U
+#define ADC_SAMPLETIME_71CYCLES_5 0x00000006U
+#define ADC_SAMPLETIME_239CYCLES_5 0x00000007U
+
+	HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+	HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+	HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc);
+	HAL_StatusTypeDef HAL_ADC_Start_IT(ADC_HandleTypeDef *hadc);
+	HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+	HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+	uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc);
+	void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc);
+	void HAL_ADC_MspDeInit(ADC_HandleTypeDef *hadc);
+	void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+	void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+
+	/* TIM -----------------------------------------------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t CR1;
+		__IO uint32_t CR2;
+		__IO uint32_t SMCR;
+		__IO uint32_t DIER;
+		__IO uint32_t SR;
+		__IO uint32_t EGR;
+		__IO uint32_t CCMR1;
+		__IO uint32_t CCMR2;
+		__IO uint32_t CCER;
+		__IO uint32_t CNT;
+		__IO uint32_t PSC;
+		__IO uint32_t ARR;
+		__IO uint32_t RCR;
+		__IO uint32_t CCR1;
+		__IO uint32_t CCR2;
+		__IO uint32_t CCR3;
+		__IO uint32_t CCR4;
+	} TIM_TypeDef;
+
+	typedef struct
+	{
+		uint32_t Prescaler;
+		uint32_t CounterMode;
+		uint32_t Period;
+		uint32_t ClockDivision;
+		uint32_t RepetitionCounter;
+		uint32_t AutoReloadPreload;
+	} TIM_Base_InitTypeDef;
+
+	typedef struct
+	{
+		uint32_t OCMode;
+		uint32_t Pulse;
+		uint32_t OCPolarity;
+		uint32_t OCNPolarity;
+		uint32_t OCFastMode;
+		uint32_t OCIdleState;
+		uint32_t OCNIdleState;
+	} TIM_OC_InitTypeDef;
+
+	typedef struct
+	{
+		uint32_t MasterOutputTrigger;
+		uint32_t MasterSlaveMode;
+	} TIM_MasterConfigTypeDef;
+
+	typedef struct
+	{
+		TIM_TypeDef *Instance;
+		TIM_Base_InitTypeDef Init;
+		HAL_LockTypeDef Lock;
+		__IO uint32_t State;
+	} TIM_HandleTypeDef;
+
+	extern TIM_TypeDef Sim_Tim3;
+
+#define TIM3 (&Sim_Tim3)
+
+#define TIM_COUNTERMODE_UP 0x00000000U
+#define TIM_CLOCKDIVISION_DIV1 0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE 0x00000000U
+#define TIM_TRGO_RESET 0x00000000U
+#define TIM_TRGO_OC1REF 0x00000040U
+#define TIM_MASTERSLAVEMODE_DISABLE 0x00000000U
+#define TIM_OCMODE_PWM1 0x00000060U
+#define TIM_OCMODE_PWM2 0x00000070U
+#define TIM_OCPOLARITY_HIGH 0x00000000U
+#define TIM_OCFAST_DISABLE 0x00000000U
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CHANNEL_2 0x00000004U
+#define TIM_CHANNEL_3 0x00000008U
+#define TIM_CHANNEL_4 0x0000000CU
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+	(*(__IO uint32_t *)(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)) = (__COMPARE__))
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+	do                                                        \
+	{                                                         \
+		(__HANDLE__)->Instance->ARR = (__AUTORELOAD__);       \
+		(__HANDLE__)->Init.Period = (__AUTORELOAD__);         \
+	} while (0)
+
+	HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+	HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel);
+	HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+	HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig);
+	void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim);
+	void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef *htim);
+
+	/* I2C -----------------------------------------------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t CR1;
+		__IO uint32_t CR2;
+		__IO uint32_t OAR1;
+		__IO uint32_t OAR2;
+		__IO uint32_t DR;
+		__IO uint32_t SR1;
+		__IO uint32_t SR2;
+		__IO uint32_t CCR;
+		__IO uint32_t TRISE;
+	} I2C_TypeDef;
+
+	typedef struct
+	{
+		uint32_t ClockSpeed;
+		uint32_t DutyCycle;
+		uint32_t OwnAddress1;
+		uint32_t AddressingMode;
+		uint32_t DualAddressMode;
+		uint32_t OwnAddress2;
+		uint32_t GeneralCallMode;
+		uint32_t NoStretchMode;
+	} I2C_InitTypeDef;
+
+	typedef enum
+	{
+		HAL_I2C_STATE_RESET = 0x00U,
+		HAL_I2C_STATE_READY = 0x20U,
+		HAL_I2C_STATE_BUSY_TX = 0x21U,
+		HAL_I2C_STATE_BUSY_RX = 0x22U
+	} HAL_I2C_StateTypeDef;
+
+	typedef struct
+	{
+		I2C_TypeDef *Instance;
+		I2C_InitTypeDef Init;
+		uint8_t *pBuffPtr;
+		uint16_t XferSize;
+		HAL_LockTypeDef Lock;
+		__IO HAL_I2C_StateTypeDef State;
+		__IO uint32_t ErrorCode;
+		__IO uint32_t Devaddress;
+	} I2C_HandleTypeDef;
+
+	extern I2C_TypeDef Sim_I2c2;
+
+#define I2C2 (&Sim_I2c2)
+
+#define I2C_DUTYCYCLE_2 0x00000000U
+#define I2C_ADDRESSINGMODE_7BIT 0x00004000U
+#define I2C_DUALADDRESS_DISABLE 0x00000000U
+#define I2C_GENERALCALL_DISABLE 0x00000000U
+#define I2C_NOSTRETCH_DISABLE 0x00000000U
+#define HAL_I2C_ERROR_NONE 0x00000000U
+#define HAL_I2C_ERROR_AF 0x00000004U
+#define HAL_I2C_ERROR_TIMEOUT 0x00000020U
+
+	HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+	HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+	HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+	HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+	void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c);
+	void HAL_I2C_MspDeInit(I2C_HandleTypeDef *hi2c);
+	void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+	void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+	void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+	/* UART ----------------------------------------------------------------------*/
+	typedef struct
+	{
+		__IO uint32_t SR;
+		__IO uint32_t DR;
+		__IO uint32_t BRR;
+		__IO uint32_t CR1;
+		__IO uint32_t CR2;
+		__IO uint32_t CR3;
+		__IO uint32_t GTPR;
+	} USART_TypeDef;
+
+	typedef struct
+	{
+		uint32_t BaudRate;
+		uint32_t WordLength;
+		uint32_t StopBits;
+		uint32_t Parity;
+		uint32_t Mode;
+		uint32_t HwFlowCtl;
+		uint32_t OverSampling;
+	} UART_InitTypeDef;
+
+	typedef enum
+	{
+		HAL_UART_STATE_RESET = 0x00U,
+		HAL_UART_STATE_READY = 0x20U,
+		HAL_UART_STATE_BUSY_TX = 0x21U
+	} HAL_UART_StateTypeDef;
+
+	typedef struct
+	{
+		USART_TypeDef *Instance;
+		UART_InitTypeDef Init;
+		const uint8_t *pTxBuffPtr;
+		uint16_t TxXferSize;
+		__IO uint16_t TxXferCount;
+		DMA_HandleTypeDef *hdmatx;
+		DMA_HandleTypeDef *hdmarx;
+		HAL_LockTypeDef Lock;
+		__IO HAL_UART_StateTypeDef gState;
+		__IO HAL_UART_StateTypeDef RxState;
+		__IO uint32_t ErrorCode;
+	} UART_HandleTypeDef;
+
+	extern USART_TypeDef Sim_Usart1;
+	extern USART_TypeDef Sim_Uart4;
+
+#define USART1 (&Sim_Usart1)
+#define UART4 (&Sim_Uart4)
+
+#define UART_WORDLENGTH_8B 0x00000000U
+#define UART_STOPBITS_1 0x00000000U
+#define UART_PARITY_NONE 0x00000000U
+#define UART_MODE_TX_RX 0x0000000CU
+#define UART_HWCONTROL_NONE 0x00000000U
+#define UART_OVERSAMPLING_16 0x00000000U
+
+	HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+	HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+	void HAL_UART_MspInit(UART_HandleTypeDef *huart);
+	void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
+	void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+	void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+	/* FLASH（片内Flash映射到主机进程的0x08000000，见sim_flash.c） -------------*/
+	typedef struct
+	{
+		uint32_t TypeErase;
+		uint32_t Banks;
+		uint32_t PageAddress;
+		uint32_t NbPages;
+	} FLASH_EraseInitTypeDef;
+
+#define FLASH_BASE 0x08000000UL
+#define FLASH_TYPEERASE_PAGES 0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD 0x02U
+#define FLASH_BANK_1 1U
+
+	HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+	HAL_StatusTypeDef HAL_FLASH_Lock(void);
+	HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+	HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32F1XX_HAL_H */
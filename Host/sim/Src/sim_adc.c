@@ -0,0 +1,408 @@
+/**
+ * @文件        : sim_adc.c
+ * @描述        : ADC1/ADC2与TIM3模型
+ * @注意事项    : ADC时钟按72MHz/6=12MHz计算转换时间（采样周期+12.5个ADC周期）
+ *                ADC1的DMA循环模式按半缓冲/全缓冲分块填充并触发对应回调；
+ *                ADC2外部触发来自TIM3_TRGO（OC1REF），粉尘通道仅在TIM3通道4输出有效时有电压
+ */
+
+#include "sim.h"
+
+ADC_TypeDef Sim_AdcRegs[2];
+TIM_TypeDef Sim_Tim3;
+
+#define ADC_CPU_CYCLES_PER_2ADC 12U // 两个ADC周期对应的CPU周期（ADC预分频6）
+#define ADC_CHANNELS 18
+#define ADC_VDDA_MV 3300U
+#define DUST_CHANNEL ADC_CHANNEL_12
+
+/* 采样时间（半个ADC周期为单位），与ADC_SAMPLETIME_*取值对应 */
+static const uint16_t sample_half_cycles[8] = {3, 15, 27, 57, 83, 111, 143, 479};
+
+typedef struct
+{
+	ADC_HandleTypeDef *hadc;
+	uint8_t rank_channel[16];
+	uint8_t busy;
+	uint16_t *dma_buf;
+	uint32_t dma_len;
+	uint8_t dma_half; // 正在填充的半区
+	uint8_t armed;	  // 已启动，等待外部触发
+	Sim_Timer timer;
+	uint32_t conversions;
+	uint32_t blocks;
+	uint32_t dark_samples; // LED未点亮时采样的次数（仅粉尘通道）
+} Sim_Adc;
+
+static Sim_Adc adcs[2];
+static uint16_t input_mv[ADC_CHANNELS] = {[ADC_CHANNEL_16] = 1430, [ADC_CHANNEL_17] = 1200};
+static uint16_t noise_mv[ADC_CHANNELS];
+static uint8_t sample_time[2][ADC_CHANNELS];
+static uint32_t rng_state = 1;
+
+/* TIM3 */
+static struct
+{
+	uint8_t running;
+	uint32_t oc_mode[4];
+	uint64_t period_start;
+	Sim_Timer timer;
+	uint32_t periods;
+} tim3;
+
+static uint8_t adc_index(const ADC_HandleTypeDef *hadc)
+{
+	return hadc->Instance == ADC2 ? 1 : 0;
+}
+
+static uint32_t rng_next(void)
+{
+	rng_state = rng_state * 1664525U + 1013904223U;
+	return rng_state >> 8;
+}
+
+/**
+ * @函数名      : conversion_cycles
+ * @描述        : 单次转换耗时（CPU周期）
+ */
+static uint32_t conversion_cycles(uint8_t adc, uint8_t channel)
+{
+	return (sample_half_cycles[sample_time[adc][channel]] + 25U) * ADC_CPU_CYCLES_PER_2ADC / 2U;
+}
+
+/**
+ * @函数名      : tim3_output_active
+ * @描述        : 计算TIM3通道在计数值cnt处的输出是否有效
+ */
+static uint8_t tim3_output_active(uint8_t ch, uint32_t cnt)
+{
+	const uint32_t ccr = (&TIM3->CCR1)[ch];
+	if (tim3.oc_mode[ch] == TIM_OCMODE_PWM2)
+		return cnt >= ccr;
+	return cnt < ccr;
+}
+
+/**
+ * @函数名      : sample
+ * @描述        : 对通道采样一次，返回12位结果
+ */
+static uint16_t sample(uint8_t channel)
+{
+	int32_t mv = input_mv[channel];
+
+	if (channel == DUST_CHANNEL)
+	{
+		// 粉尘传感器输出只在LED点亮期间有效
+		const uint32_t psc = TIM3->PSC + 1U;
+		const uint32_t cnt = (uint32_t)((Sim_Now() - tim3.period_start) / psc);
+		if (!tim3.running || !(TIM3->CCER & (1U << 12)) || !tim3_output_active(3, cnt))
+		{
+			adcs[1].dark_samples++;
+			mv = 0;
+		}
+	}
+	if (noise_mv[channel])
+		mv += (int32_t)(rng_next() % (2U * noise_mv[channel] + 1U)) - noise_mv[channel];
+
+	int32_t code = mv * 4096 / (int32_t)ADC_VDDA_MV;
+	if (code < 0)
+		code = 0;
+	else if (code > 4095)
+		code = 4095;
+	return (uint16_t)code;
+}
+
+/**
+ * @函数名      : half_cycles
+ * @描述        : 填满DMA缓冲区的一个半区所需的时间
+ */
+static uint64_t half_cycles(Sim_Adc *a)
+{
+	const uint8_t idx = (uint8_t)(a - adcs);
+	const uint32_t nconv = a->hadc->Init.NbrOfConversion ? a->hadc->Init.NbrOfConversion : 1U;
+	uint64_t cycles = 0;
+
+	for (uint32_t i = 0; i < a->dma_len / 2U; i++)
+		cycles += conversion_cycles(idx, a->rank_channel[i % nconv]);
+	return cycles;
+}
+
+/**
+ * @函数名      : adc_event
+ * @描述        : ADC模型事件：DMA半区填满，或单次转换完成
+ */
+static void adc_event(void *arg)
+{
+	Sim_Adc *a = arg;
+	ADC_HandleTypeDef *hadc = a->hadc;
+
+	if (a->dma_buf != NULL)
+	{
+		const uint32_t nconv = hadc->Init.NbrOfConversion ? hadc->Init.NbrOfConversion : 1U;
+		const uint32_t half = a->dma_len / 2U;
+		const uint32_t first = a->dma_half ? half : 0U;
+
+		for (uint32_t i = first; i < first + half; i++)
+			a->dma_buf[i] = sample(a->rank_channel[i % nconv]);
+		a->conversions += half;
+		a->blocks++;
+
+		if (a->dma_half == 0)
+		{
+			a->dma_half = 1;
+			Sim_TimerStart(&a->timer, Sim_Now() + half_cycles(a));
+			HAL_ADC_ConvHalfCpltCallback(hadc);
+			return;
+		}
+
+		a->dma_half = 0;
+		if (hadc->DMA_Handle->Init.Mode == DMA_CIRCULAR)
+		{
+			Sim_TimerStart(&a->timer, Sim_Now() + half_cycles(a));
+		}
+		else
+		{
+			a->dma_buf = NULL;
+			a->busy = 0;
+		}
+		HAL_ADC_ConvCpltCallback(hadc);
+		return;
+	}
+
+	// 单次转换：结果在采样开始时刻确定，转换结束后写入DR
+	a->conversions++;
+	if (hadc->Init.ExternalTrigConv == ADC_SOFTWARE_START)
+		a->busy = 0;
+	Sim_Charge(SIM_COST_HAL_CALL); // HAL_ADC_IRQHandler
+	HAL_ADC_ConvCpltCallback(hadc);
+}
+
+/**
+ * @函数名      : start_single
+ * @描述        : 开始一次单次转换
+ */
+static void start_single(Sim_Adc *a)
+{
+	const uint8_t idx = (uint8_t)(a - adcs);
+	const uint8_t channel = a->rank_channel[0];
+
+	a->hadc->Instance->DR = sample(channel);
+	Sim_TimerStart(&a->timer, Sim_Now() + conversion_cycles(idx, channel));
+}
+
+/**
+ * @函数名      : tim3_event
+ * @描述        : TIM3计数到CCR1，OC1REF上升沿产生TRGO
+ */
+static void tim3_event(void *arg)
+{
+	UNUSED(arg);
+	const uint64_t psc = TIM3->PSC + 1U;
+	const uint64_t period = psc * (TIM3->ARR + 1U);
+
+	if ((TIM3->CR2 & 0x70U) == TIM_TRGO_OC1REF && adcs[1].armed &&
+		adcs[1].hadc->Init.ExternalTrigConv == ADC_EXTERNALTRIGCONV_T3_TRGO)
+	{
+		start_single(&adcs[1]);
+	}
+
+	tim3.periods++;
+	tim3.period_start += period;
+	Sim_TimerStart(&tim3.timer, tim3.period_start + psc * TIM3->CCR1);
+}
+
+void Sim_AdcSetInput(uint8_t channel, uint16_t mv, uint16_t noise)
+{
+	if (channel >= ADC_CHANNELS)
+		return;
+	input_mv[channel] = mv;
+	noise_mv[channel] = noise;
+}
+
+void Sim_Seed(uint32_t seed)
+{
+	rng_state = seed ? seed : 1U;
+}
+
+void Sim_Adc_Report(FILE *out)
+{
+	fprintf(out, "adc1   conversions %u, DMA half-blocks %u\n", adcs[0].conversions, adcs[0].blocks);
+	fprintf(out, "adc2   conversions %u (TIM3 periods %u), samples outside LED pulse %u\n",
+			adcs[1].conversions, tim3.periods, adcs[1].dark_samples);
+}
+
+/* HAL ADC --------------------------------------------------------------------*/
+
+__weak void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc)
+{
+	UNUSED(hadc);
+}
+
+__weak void HAL_ADC_MspDeInit(ADC_HandleTypeDef *hadc)
+{
+	UNUSED(hadc);
+}
+
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	UNUSED(hadc);
+}
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	UNUSED(hadc);
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+	if (hadc == NULL || (hadc->Instance != ADC1 && hadc->Instance != ADC2))
+		return HAL_ERROR;
+
+	Sim_Adc *a = &adcs[adc_index(hadc)];
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (a->busy)
+		return HAL_BUSY;
+
+	if (hadc->State == HAL_ADC_STATE_RESET)
+		HAL_ADC_MspInit(hadc);
+
+	a->hadc = hadc;
+	Sim_TimerInit(&a->timer, hadc->Instance == ADC1 ? "adc1" : "adc2", adc_event, a);
+	hadc->State = HAL_ADC_STATE_READY;
+	hadc->ErrorCode = 0;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+	if (sConfig->Channel >= ADC_CHANNELS || sConfig->Rank < 1 || sConfig->Rank > 16 || sConfig->SamplingTime > 7)
+		return HAL_ERROR;
+
+	const uint8_t idx = adc_index(hadc);
+	Sim_Charge(SIM_COST_HAL_CALL);
+	adcs[idx].rank_channel[sConfig->Rank - 1] = (uint8_t)sConfig->Channel;
+	sample_time[idx][sConfig->Channel] = (uint8_t)sConfig->SamplingTime;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+	if (adcs[adc_index(hadc)].busy)
+		return HAL_ERROR;
+
+	Sim_Charge(SIM_COST_HAL_CALL + 83U * 6U); // 校准约83个ADC周期
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_IT(ADC_HandleTypeDef *hadc)
+{
+	Sim_Adc *a = &adcs[adc_index(hadc)];
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (a->busy || a->hadc != hadc)
+		return HAL_BUSY;
+
+	a->busy = 1;
+	a->dma_buf = NULL;
+	hadc->State = HAL_ADC_STATE_REG_BUSY;
+	if (hadc->Init.ExternalTrigConv == ADC_SOFTWARE_START)
+		start_single(a);
+	else
+		a->armed = 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+	Sim_Adc *a = &adcs[adc_index(hadc)];
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (hadc->Instance != ADC1 || hadc->DMA_Handle == NULL || Length < 2)
+		return HAL_ERROR;
+	if (a->busy || a->hadc != hadc)
+		return HAL_BUSY;
+
+	a->busy = 1;
+	a->dma_buf = (uint16_t *)pData; // DMA按半字传输
+	a->dma_len = Length;
+	a->dma_half = 0;
+	hadc->State = HAL_ADC_STATE_REG_BUSY;
+	Sim_TimerStart(&a->timer, Sim_Now() + half_cycles(a));
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+	Sim_Adc *a = &adcs[adc_index(hadc)];
+
+	Sim_TimerStop(&a->timer);
+	a->busy = 0;
+	a->dma_buf = NULL;
+	hadc->State = HAL_ADC_STATE_READY;
+	return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc)
+{
+	Sim_Charge(SIM_COST_GPIO);
+	return hadc->Instance->DR;
+}
+
+/* HAL TIM --------------------------------------------------------------------*/
+
+__weak void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim)
+{
+	UNUSED(htim);
+}
+
+__weak void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef *htim)
+{
+	UNUSED(htim);
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+	if (htim == NULL || htim->Instance != TIM3)
+		return HAL_ERROR;
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (htim->State == 0)
+		HAL_TIM_PWM_MspInit(htim);
+	TIM3->PSC = htim->Init.Prescaler;
+	TIM3->ARR = htim->Init.Period;
+	Sim_TimerInit(&tim3.timer, "tim3", tim3_event, NULL);
+	htim->State = 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel)
+{
+	if (Channel > TIM_CHANNEL_4)
+		return HAL_ERROR;
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	tim3.oc_mode[Channel >> 2] = sConfig->OCMode;
+	__HAL_TIM_SET_COMPARE(htim, Channel, sConfig->Pulse);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig)
+{
+	Sim_Charge(SIM_COST_HAL_CALL);
+	htim->Instance->CR2 = sMasterConfig->MasterOutputTrigger;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+	Sim_Charge(SIM_COST_HAL_CALL);
+	htim->Instance->CCER |= 1U << (Channel & 0x0CU); // CCxE位于第0/4/8/12位
+	if (!tim3.running)
+	{
+		tim3.running = 1;
+		tim3.period_start = Sim_Now();
+		htim->Instance->CR1 |= 1U;
+		Sim_TimerStart(&tim3.timer, tim3.period_start + (uint64_t)(TIM3->PSC + 1U) * TIM3->CCR1);
+	}
+	return HAL_OK;
+}
@@ -0,0 +1,292 @@
+/**
+ * @文件        : sim_core.c
+ * @描述        : 虚拟时钟、模拟定时器与中断分发，以及HAL系统/RCC/NVIC/DMA部分
+ * @注意事项    : 分发规则见sim.h
+ */
+
+#include "sim.h"
+
+uint32_t SystemCoreClock = SIM_CPU_HZ;
+CoreDebug_Type Sim_CoreDebug;
+DMA_Channel_TypeDef Sim_DmaChannels[12];
+
+/* 私有变量 */
+static uint64_t now = 0;
+static uint64_t end_time = UINT64_MAX;
+static void (*end_handler)(void) = NULL;
+static Sim_Timer *timers[SIM_MAX_TIMERS];
+static uint8_t timer_count = 0;
+static uint8_t in_isr = 0;
+static uint32_t primask = 0;
+static uint64_t busy_since = 0; // 最近一次离开WFI的时刻
+static Sim_LoopStats loop_stats;
+
+static DWT_Type dwt;
+static uint32_t dwt_published = 0; // 上次读出的CYCCNT，用于识别固件写入
+static uint64_t dwt_base = 0;	   // CYCCNT为0的时刻
+
+/**
+ * @函数名      : earliest_due
+ * @描述        : 查找触发时刻不晚于limit的最早定时器
+ */
+static Sim_Timer *earliest_due(uint64_t limit)
+{
+	Sim_Timer *best = NULL;
+
+	for (uint8_t i = 0; i < timer_count; i++)
+	{
+		Sim_Timer *t = timers[i];
+		if (t->active && t->when <= limit && (best == NULL || t->when < best->when))
+			best = t;
+	}
+	return best;
+}
+
+/**
+ * @函数名      : advance_to
+ * @描述        : 将时间推进到target，按时间顺序分发期间到期的定时器
+ * @实现细节    : 中断上下文或关中断时只推进时间，到期的事件留待返回主循环/开中断后分发；
+ *                中断回调本身调用HAL消耗的周期使时间继续前进
+ */
+static void advance_to(uint64_t target)
+{
+	while (!in_isr && !primask)
+	{
+		Sim_Timer *t = earliest_due(target > now ? target : now);
+		if (t == NULL)
+			break;
+
+		if (t->when > now)
+			now = t->when;
+		else if (now - t->when > loop_stats.max_isr_late)
+			loop_stats.max_isr_late = now - t->when;
+
+		t->active = 0;
+		in_isr = 1;
+		loop_stats.isr_count++;
+		t->fn(t->arg);
+		in_isr = 0;
+	}
+
+	if (now < target)
+		now = target;
+}
+
+/**
+ * @函数名      : check_end
+ * @描述        : 在主循环上下文中检查是否到达结束时刻
+ * @参数        : grace - 允许超过结束时刻的周期数；WFI处为0，其他位置留出余量，
+ *                使结束尽量发生在主循环空闲时，同时保证不进入WFI的固件也能结束
+ */
+static void check_end(uint64_t grace)
+{
+	if (in_isr || end_handler == NULL || now < end_time || now - end_time < grace)
+		return;
+
+	void (*handler)(void) = end_handler;
+	end_handler = NULL;
+	handler();
+}
+
+void Sim_TimerInit(Sim_Timer *t, const char *name, Sim_TimerFn fn, void *arg)
+{
+	t->name = name;
+	t->fn = fn;
+	t->arg = arg;
+	t->active = 0;
+
+	for (uint8_t i = 0; i < timer_count; i++)
+	{
+		if (timers[i] == t)
+			return;
+	}
+	if (timer_count < SIM_MAX_TIMERS)
+	{
+		timers[timer_count++] = t;
+	}
+	else
+	{
+		fprintf(stderr, "sim: too many timers (%s)\n", name);
+	}
+}
+
+void Sim_TimerStart(Sim_Timer *t, uint64_t when)
+{
+	t->when = when;
+	t->active = 1;
+}
+
+void Sim_TimerStop(Sim_Timer *t)
+{
+	t->active = 0;
+}
+
+uint64_t Sim_Now(void)
+{
+	return now;
+}
+
+void Sim_Charge(uint32_t cycles)
+{
+	advance_to(now + cycles);
+}
+
+void Sim_Run(uint64_t end, void (*on_end)(void))
+{
+	end_time = end;
+	end_handler = on_end;
+}
+
+const Sim_LoopStats *Sim_GetLoopStats(void)
+{
+	return &loop_stats;
+}
+
+/**
+ * @函数名      : Sim_Wfi
+ * @描述        : 休眠到下一个事件或下一个SysTick毫秒边界
+ * @实现细节    : 记录自上次唤醒以来的连续忙碌时间，作为主循环响应延迟的统计；
+ *                第一次进入WFI之前为初始化阶段，单独记录
+ */
+void Sim_Wfi(void)
+{
+	const uint64_t busy = now - busy_since;
+	loop_stats.busy_cycles += busy;
+	if (loop_stats.wakeups == 0 && loop_stats.startup_cycles == 0)
+		loop_stats.startup_cycles = now;
+	else if (busy > loop_stats.max_busy)
+	{
+		loop_stats.max_busy = busy;
+		loop_stats.max_busy_at = now;
+	}
+
+	check_end(0);
+
+	uint64_t wake = (now / SIM_MS(1) + 1) * SIM_MS(1);
+	Sim_Timer *t = earliest_due(wake);
+	if (t != NULL && t->when > now)
+		wake = t->when;
+	advance_to(wake);
+
+	loop_stats.wakeups++;
+	busy_since = now;
+}
+
+uint32_t Sim_GetPrimask(void)
+{
+	return primask;
+}
+
+void Sim_SetPrimask(uint32_t value)
+{
+	primask = value & 1U;
+	if (!primask)
+		advance_to(now); // 分发关中断期间到期的事件
+}
+
+/**
+ * @函数名      : Sim_Dwt
+ * @描述        : 返回DWT寄存器，CYCCNT按虚拟时钟刷新
+ * @实现细节    : CYCCNT与上次读出值不同说明固件写入过，以写入值重新确定计数起点
+ */
+DWT_Type *Sim_Dwt(void)
+{
+	Sim_Charge(SIM_COST_DWT);
+
+	if (dwt.CYCCNT != dwt_published)
+		dwt_base = now - dwt.CYCCNT;
+	dwt.CYCCNT = (dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) ? (uint32_t)(now - dwt_base) : dwt.CYCCNT;
+	dwt_published = dwt.CYCCNT;
+	return &dwt;
+}
+
+/* HAL系统函数 -----------------------------------------------------------------*/
+
+__weak void HAL_MspInit(void)
+{
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+	HAL_MspInit();
+	return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	Sim_Charge(SIM_COST_TICK);
+	check_end(SIM_MS(1000));
+	return (uint32_t)(now / SIM_MS(1));
+}
+
+/**
+ * @函数名      : HAL_Delay
+ * @描述        : 阻塞延时，与官方实现一样至少等待Delay+1个节拍
+ */
+void HAL_Delay(uint32_t Delay)
+{
+	const uint32_t start = HAL_GetTick();
+	uint32_t wait = Delay;
+
+	if (wait < UINT32_MAX)
+		wait++;
+	advance_to((uint64_t)start * SIM_MS(1) + (uint64_t)wait * SIM_MS(1));
+	check_end(SIM_MS(1000));
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+	UNUSED(IRQn);
+	UNUSED(PreemptPriority);
+	UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	UNUSED(IRQn);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+	UNUSED(IRQn);
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+	UNUSED(RCC_OscInitStruct);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+	UNUSED(RCC_ClkInitStruct);
+	UNUSED(FLatency);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+	UNUSED(PeriphClkInit);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+	if (hdma == NULL || hdma->Instance == NULL)
+		return HAL_ERROR;
+
+	hdma->Instance->CCR = hdma->Init.Direction | hdma->Init.Mode | hdma->Init.MemInc |
+						  hdma->Init.PeriphDataAlignment | hdma->Init.MemDataAlignment | hdma->Init.Priority;
+	hdma->State = HAL_DMA_STATE_READY;
+	hdma->ErrorCode = 0;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+	if (hdma == NULL)
+		return HAL_ERROR;
+
+	hdma->State = HAL_DMA_STATE_RESET;
+	return HAL_OK;
+}
@@ -0,0 +1,150 @@
+/**
+ * @文件        : sim_flash.c
+ * @描述        : 片内Flash模型：256KB映射在主机进程的0x08000000，实现HAL_FLASH接口
+ * @注意事项    : 与F103一致：擦除以2KB页为单位，擦除后为0xFF；只能对已擦除的半字编程
+ *                （写0除外），否则返回错误；擦除和编程期间CPU停顿，按SIM_FLASH_*计入虚拟时间
+ */
+
+#include "sim.h"
+#include <string.h>
+#include <sys/mman.h>
+
+#define FLASH_SIZE 0x40000U
+#define FLASH_PAGE_SIZE 0x800U
+
+static uint8_t *flash = NULL;
+static const char *image_path = NULL;
+static uint8_t locked = 1;
+
+static struct
+{
+	uint32_t erases;
+	uint32_t programs;
+	uint32_t errors;
+	uint64_t stall_cycles;
+	uint64_t max_stall; // 单次HAL调用内的最长停顿
+} stats;
+
+int Sim_FlashInit(const char *image)
+{
+	flash = mmap((void *)FLASH_BASE, FLASH_SIZE, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (flash == MAP_FAILED || flash != (uint8_t *)FLASH_BASE)
+	{
+		fprintf(stderr, "sim: cannot map flash at 0x%08lX\n", FLASH_BASE);
+		flash = NULL;
+		return -1;
+	}
+	memset(flash, 0xFF, FLASH_SIZE);
+
+	image_path = image;
+	if (image != NULL)
+	{
+		FILE *f = fopen(image, "rb");
+		if (f != NULL)
+		{
+			if (fread(flash, 1, FLASH_SIZE, f) != FLASH_SIZE)
+				fprintf(stderr, "sim: flash image %s is short, rest left erased\n", image);
+			fclose(f);
+		}
+	}
+	return 0;
+}
+
+void Sim_FlashSave(void)
+{
+	if (flash == NULL || image_path == NULL)
+		return;
+
+	FILE *f = fopen(image_path, "wb");
+	if (f == NULL || fwrite(flash, 1, FLASH_SIZE, f) != FLASH_SIZE)
+		fprintf(stderr, "sim: cannot write flash image %s\n", image_path);
+	if (f != NULL)
+		fclose(f);
+}
+
+void Sim_Flash_Report(FILE *out)
+{
+	fprintf(out, "flash  page erases %u, halfword programs %u, errors %u, stall total %.1f ms, max %.1f ms\n",
+			stats.erases, stats.programs, stats.errors,
+			stats.stall_cycles / (double)SIM_MS(1), stats.max_stall / (double)SIM_MS(1));
+}
+
+static void stall(uint64_t cycles)
+{
+	stats.stall_cycles += cycles;
+	if (cycles > stats.max_stall)
+		stats.max_stall = cycles;
+	while (cycles > UINT32_MAX)
+	{
+		Sim_Charge(UINT32_MAX);
+		cycles -= UINT32_MAX;
+	}
+	Sim_Charge((uint32_t)cycles);
+}
+
+/* HAL FLASH ------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	locked = 0;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	locked = 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+	const uint8_t halfwords = TypeProgram == FLASH_TYPEPROGRAM_WORD ? 2 : 1;
+
+	if (flash == NULL || locked || (Address & 1U) || Address < FLASH_BASE ||
+		Address + 2U * halfwords > FLASH_BASE + FLASH_SIZE)
+	{
+		stats.errors++;
+		return HAL_ERROR;
+	}
+
+	for (uint8_t i = 0; i < halfwords; i++)
+	{
+		uint8_t *cell = flash + (Address - FLASH_BASE) + 2U * i;
+		const uint16_t value = (uint16_t)(Data >> (16U * i));
+		const uint16_t current = (uint16_t)(cell[0] | cell[1] << 8);
+
+		stall(SIM_US(SIM_FLASH_PROGRAM_US));
+		if (current != 0xFFFF && value != 0)
+		{
+			stats.errors++; // PGERR：目标半字未擦除
+			return HAL_ERROR;
+		}
+		cell[0] = (uint8_t)value;
+		cell[1] = (uint8_t)(value >> 8);
+		stats.programs++;
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+	const uint32_t start = pEraseInit->PageAddress;
+	*PageError = 0xFFFFFFFFU;
+
+	if (flash == NULL || locked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES ||
+		start < FLASH_BASE || (start - FLASH_BASE) % FLASH_PAGE_SIZE != 0 ||
+		start + pEraseInit->NbPages * FLASH_PAGE_SIZE > FLASH_BASE + FLASH_SIZE)
+	{
+		stats.errors++;
+		return HAL_ERROR;
+	}
+
+	for (uint32_t i = 0; i < pEraseInit->NbPages; i++)
+	{
+		stall(SIM_US(SIM_FLASH_ERASE_US));
+		memset(flash + (start - FLASH_BASE) + i * FLASH_PAGE_SIZE, 0xFF, FLASH_PAGE_SIZE);
+		stats.erases++;
+	}
+	return HAL_OK;
+}
@@ -0,0 +1,433 @@
+/**
+ * @文件        : sim_gpio.c
+ * @描述        : GPIO/EXTI模型、脚本波形播放器和DHT11单总线传感器模型
+ * @注意事项    : 引脚电平按开漏线与计算：推挽输出取ODR；开漏输出为ODR与外部驱动相与；
+ *                输入模式由上拉决定，外部拉低时为低
+ *                EXTI按AFIO->EXTICR的端口映射检测边沿，挂起后经模拟定时器在中断上下文中分发
+ */
+
+#include "sim.h"
+#include <ctype.h>
+#include <stdlib.h>
+
+GPIO_TypeDef Sim_GpioPorts[SIM_GPIO_PORTS];
+EXTI_TypeDef Sim_Exti;
+AFIO_TypeDef Sim_Afio;
+
+/* 引脚状态 */
+static uint32_t pin_mode[SIM_GPIO_PORTS][16];
+static uint16_t ext_low[SIM_GPIO_PORTS];	// 外部器件拉低的引脚
+static uint16_t last_level[SIM_GPIO_PORTS]; // 上次计算的电平，用于检测边沿
+static uint8_t levels_valid = 0;
+static Sim_Timer exti_timer;
+
+/* 波形播放器 */
+#define SIM_MAX_PLAYERS 8
+
+typedef struct
+{
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	Sim_Segment seg[SIM_WAVE_MAX_SEGMENTS];
+	uint16_t count;
+	uint16_t index;
+	Sim_Timer timer;
+} Sim_Player;
+
+static Sim_Player players[SIM_MAX_PLAYERS];
+
+/* DHT11模型 */
+#define SIM_MAX_DHT11 4
+#define DHT11_MIN_START_US 18000 // 主机起始信号最短低电平时间
+#define DHT11_RESPONSE_US 30	 // 主机释放后到应答的时间（手册20-40us）
+
+typedef struct
+{
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	uint8_t data[4]; // 湿度整数/小数、温度整数/小数
+	uint8_t fault;
+	uint8_t host_low;  // 主机正在拉低总线
+	uint64_t low_since; // 主机开始拉低的时刻
+	uint32_t starts;	// 有效起始信号次数
+	uint32_t short_starts; // 低电平不足18ms被忽略的起始信号
+	uint32_t responses;	// 完整应答次数
+} Sim_Dht11;
+
+static Sim_Dht11 dht11s[SIM_MAX_DHT11];
+static uint8_t dht11_count = 0;
+
+static uint8_t port_index(const GPIO_TypeDef *port)
+{
+	return (uint8_t)GPIO_GET_INDEX(port);
+}
+
+static uint8_t pin_number(uint16_t pin)
+{
+	uint8_t n = 0;
+	while (n < 15 && !(pin & (1U << n)))
+		n++;
+	return n;
+}
+
+/**
+ * @函数名      : compute_level
+ * @描述        : 按引脚模式计算端口各引脚的实际电平
+ */
+static uint16_t compute_level(uint8_t p)
+{
+	const uint16_t odr = (uint16_t)Sim_GpioPorts[p].ODR;
+	uint16_t level = 0;
+
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		const uint16_t bit = 1U << n;
+		const uint8_t released = !(ext_low[p] & bit);
+		uint8_t high;
+
+		switch (pin_mode[p][n] & 0x13U)
+		{
+		case GPIO_MODE_OUTPUT_PP:
+		case GPIO_MODE_AF_PP:
+			high = (odr & bit) != 0;
+			break;
+		case GPIO_MODE_OUTPUT_OD:
+		case GPIO_MODE_AF_OD:
+			high = (odr & bit) && released;
+			break;
+		default:
+			high = released;
+			break;
+		}
+		if (high)
+			level |= bit;
+	}
+	return level;
+}
+
+/**
+ * @函数名      : exti_irq
+ * @描述        : EXTI中断：对挂起且未屏蔽的各线调用HAL_GPIO_EXTI_IRQHandler
+ */
+static void exti_irq(void *arg)
+{
+	UNUSED(arg);
+	const uint32_t pending = EXTI->PR & EXTI->IMR;
+
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		if (pending & (1U << n))
+			HAL_GPIO_EXTI_IRQHandler((uint16_t)(1U << n));
+	}
+}
+
+/**
+ * @函数名      : update_port
+ * @描述        : 重新计算端口电平，对映射到EXTI的引脚检测边沿并挂起中断
+ */
+static void update_port(uint8_t p)
+{
+	if (!levels_valid)
+	{
+		for (uint8_t i = 0; i < SIM_GPIO_PORTS; i++)
+			last_level[i] = compute_level(i);
+		Sim_TimerInit(&exti_timer, "exti", exti_irq, NULL);
+		levels_valid = 1;
+	}
+
+	const uint16_t level = compute_level(p);
+	const uint16_t changed = level ^ last_level[p];
+	last_level[p] = level;
+	Sim_GpioPorts[p].IDR = level;
+
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		const uint16_t bit = 1U << n;
+		if (!(changed & bit))
+			continue;
+		if (((AFIO->EXTICR[n >> 2] >> (4U * (n & 3U))) & 0x0FU) != p)
+			continue;
+
+		const uint8_t rising = (level & bit) != 0;
+		if ((rising && (EXTI->RTSR & bit)) || (!rising && (EXTI->FTSR & bit)))
+		{
+			EXTI->PR |= bit;
+			if (EXTI->IMR & bit)
+				Sim_TimerStart(&exti_timer, Sim_Now());
+		}
+	}
+}
+
+/* DHT11模型 -------------------------------------------------------------------*/
+
+static Sim_Dht11 *find_dht11(const GPIO_TypeDef *port, uint16_t pin)
+{
+	for (uint8_t i = 0; i < dht11_count; i++)
+	{
+		if (dht11s[i].port == port && dht11s[i].pin == pin)
+			return &dht11s[i];
+	}
+	return NULL;
+}
+
+/**
+ * @函数名      : dht11_respond
+ * @描述        : 按当前读数生成应答波形并开始播放
+ */
+static void dht11_respond(Sim_Dht11 *d)
+{
+	Sim_Segment wave[SIM_WAVE_MAX_SEGMENTS];
+	uint16_t n = 0;
+	uint8_t bytes[5];
+
+	for (uint8_t i = 0; i < 4; i++)
+		bytes[i] = d->data[i];
+	bytes[4] = (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+	if (d->fault == SIM_DHT11_CHECKSUM)
+		bytes[4]++;
+
+	const uint8_t bits = d->fault == SIM_DHT11_TRUNCATE ? 20 : 40;
+
+	wave[n++] = (Sim_Segment){1, DHT11_RESPONSE_US};
+	wave[n++] = (Sim_Segment){0, 80};
+	wave[n++] = (Sim_Segment){1, 80};
+	for (uint8_t i = 0; i < bits; i++)
+	{
+		const uint8_t one = (bytes[i / 8] >> (7 - i % 8)) & 1U;
+		wave[n++] = (Sim_Segment){0, 50};
+		wave[n++] = (Sim_Segment){1, one ? 70 : 26};
+	}
+	if (bits == 40)
+	{
+		wave[n++] = (Sim_Segment){0, 50};
+		d->responses++;
+	}
+
+	Sim_GpioPlay(d->port, d->pin, wave, n);
+}
+
+/**
+ * @函数名      : dht11_host_write
+ * @描述        : 跟踪主机对数据线的驱动，识别起始信号
+ */
+static void dht11_host_write(GPIO_TypeDef *port, uint16_t pin, uint8_t high)
+{
+	Sim_Dht11 *d = find_dht11(port, pin);
+	if (d == NULL)
+		return;
+
+	if (!high && !d->host_low)
+	{
+		d->host_low = 1;
+		d->low_since = Sim_Now();
+	}
+	else if (high && d->host_low)
+	{
+		d->host_low = 0;
+		if (Sim_Now() - d->low_since < SIM_US(DHT11_MIN_START_US))
+		{
+			d->short_starts++;
+			return;
+		}
+		d->starts++;
+		if (d->fault != SIM_DHT11_SILENT)
+			dht11_respond(d);
+	}
+}
+
+int Sim_Dht11_Set(GPIO_TypeDef *port, uint16_t pin, uint8_t hum, uint8_t hum_dec,
+				  uint8_t temp, uint8_t temp_dec, uint8_t fault)
+{
+	Sim_Dht11 *d = find_dht11(port, pin);
+
+	if (d == NULL)
+	{
+		if (dht11_count >= SIM_MAX_DHT11)
+			return -1;
+		d = &dht11s[dht11_count++];
+		*d = (Sim_Dht11){0};
+		d->port = port;
+		d->pin = pin;
+	}
+
+	d->data[0] = hum;
+	d->data[1] = hum_dec;
+	d->data[2] = temp;
+	d->data[3] = temp_dec;
+	d->fault = fault;
+	return 0;
+}
+
+void Sim_Dht11_Report(FILE *out)
+{
+	for (uint8_t i = 0; i < dht11_count; i++)
+	{
+		const Sim_Dht11 *d = &dht11s[i];
+		fprintf(out, "dht11  P%c%u: start signals %u (too short %u), full responses %u\n",
+				'A' + port_index(d->port), pin_number(d->pin), d->starts, d->short_starts, d->responses);
+	}
+}
+
+/* 波形播放器 ------------------------------------------------------------------*/
+
+static void player_step(void *arg)
+{
+	Sim_Player *pl = arg;
+
+	pl->index++;
+	if (pl->index >= pl->count)
+	{
+		Sim_GpioDrive(pl->port, pl->pin, 0);
+		pl->port = NULL;
+		return;
+	}
+	Sim_GpioDrive(pl->port, pl->pin, pl->seg[pl->index].level == 0);
+	Sim_TimerStart(&pl->timer, Sim_Now() + SIM_US(pl->seg[pl->index].dur_us));
+}
+
+int Sim_GpioPlay(GPIO_TypeDef *port, uint16_t pin, const Sim_Segment *seg, uint16_t count)
+{
+	Sim_Player *pl = NULL;
+
+	if (count == 0 || count > SIM_WAVE_MAX_SEGMENTS)
+		return -1;
+
+	for (uint8_t i = 0; i < SIM_MAX_PLAYERS && pl == NULL; i++)
+	{
+		if (players[i].port == port && players[i].pin == pin)
+			pl = &players[i];
+	}
+	for (uint8_t i = 0; i < SIM_MAX_PLAYERS && pl == NULL; i++)
+	{
+		if (players[i].port == NULL)
+			pl = &players[i];
+	}
+	if (pl == NULL)
+		return -1;
+
+	Sim_TimerInit(&pl->timer, "wave", player_step, pl);
+	pl->port = port;
+	pl->pin = pin;
+	pl->count = count;
+	pl->index = 0;
+	for (uint16_t i = 0; i < count; i++)
+		pl->seg[i] = seg[i];
+
+	Sim_GpioDrive(port, pin, seg[0].level == 0);
+	Sim_TimerStart(&pl->timer, Sim_Now() + SIM_US(seg[0].dur_us));
+	return 0;
+}
+
+/* 公共接口 --------------------------------------------------------------------*/
+
+int Sim_GpioParse(const char *name, GPIO_TypeDef **port, uint16_t *pin)
+{
+	char *end;
+
+	if (name[0] != 'P' || name[1] < 'A' || name[1] >= 'A' + SIM_GPIO_PORTS || !isdigit((unsigned char)name[2]))
+		return -1;
+
+	const long n = strtol(name + 2, &end, 10);
+	if (*end != '\0' || n > 15)
+		return -1;
+
+	*port = &Sim_GpioPorts[name[1] - 'A'];
+	*pin = (uint16_t)(1U << n);
+	return 0;
+}
+
+void Sim_GpioDrive(GPIO_TypeDef *port, uint16_t pin, uint8_t low)
+{
+	const uint8_t p = port_index(port);
+
+	if (low)
+		ext_low[p] |= pin;
+	else
+		ext_low[p] &= (uint16_t)~pin;
+	update_port(p);
+}
+
+/* HAL GPIO --------------------------------------------------------------------*/
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	const uint8_t p = port_index(GPIOx);
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		const uint32_t bit = 1U << n;
+		if (!(GPIO_Init->Pin & bit))
+			continue;
+
+		pin_mode[p][n] = GPIO_Init->Mode;
+		if (GPIO_Init->Mode & 0x10000000U)
+		{
+			// 中断模式：映射EXTI线并设置触发边沿
+			AFIO->EXTICR[n >> 2] &= ~(0x0FU << (4U * (n & 3U)));
+			AFIO->EXTICR[n >> 2] |= (uint32_t)p << (4U * (n & 3U));
+			if (GPIO_Init->Mode & 0x00100000U)
+				EXTI->RTSR |= bit;
+			if (GPIO_Init->Mode & 0x00200000U)
+				EXTI->FTSR |= bit;
+			EXTI->IMR |= bit;
+		}
+	}
+	update_port(p);
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+	const uint8_t p = port_index(GPIOx);
+
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		if (GPIO_Pin & (1U << n))
+			pin_mode[p][n] = GPIO_MODE_INPUT;
+	}
+	update_port(p);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	Sim_Charge(SIM_COST_GPIO);
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (PinState != GPIO_PIN_RESET)
+		GPIOx->ODR |= GPIO_Pin;
+	else
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+	update_port(port_index(GPIOx));
+
+	for (uint8_t n = 0; n < 16; n++)
+	{
+		if (GPIO_Pin & (1U << n))
+			dht11_host_write(GPIOx, (uint16_t)(1U << n), PinState != GPIO_PIN_RESET);
+	}
+	Sim_Charge(SIM_COST_GPIO);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	const uint32_t odr = GPIOx->ODR;
+	HAL_GPIO_WritePin(GPIOx, GPIO_Pin & ~odr, GPIO_PIN_SET);
+	HAL_GPIO_WritePin(GPIOx, GPIO_Pin & odr, GPIO_PIN_RESET);
+}
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin)
+{
+	Sim_Charge(SIM_COST_GPIO);
+	if (EXTI->PR & GPIO_Pin)
+	{
+		__HAL_GPIO_EXTI_CLEAR_IT(GPIO_Pin);
+		HAL_GPIO_EXTI_Callback(GPIO_Pin);
+	}
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	UNUSED(GPIO_Pin);
+}
@@ -0,0 +1,333 @@
+/**
+ * @文件        : sim_i2c.c
+ * @描述        : I2C中断方式收发模型与SGP30器件模型
+ * @注意事项    : 传输时间按(字节数+1)*9位/时钟频率计算，结束时在中断上下文中调用
+ *                HAL_I2C_MasterTxCpltCallback/MasterRxCpltCallback，地址不应答时调用
+ *                HAL_I2C_ErrorCallback（ErrorCode为HAL_I2C_ERROR_AF）
+ *                SGP30模型在命令执行期间不应答读操作，与实物行为一致；
+ *                CRC由本文件独立实现，不依赖固件的crc模块
+ */
+
+#include "sim.h"
+#include <string.h>
+
+I2C_TypeDef Sim_I2c2;
+
+#define SGP30_ADDR 0x58
+#define SGP30_WARMUP_MS 15000 // init_air_quality后固定输出400/0的时间
+
+/* I2C传输 */
+static struct
+{
+	I2C_HandleTypeDef *hi2c;
+	uint8_t reading;
+	uint8_t addr;
+	uint8_t *rx;
+	uint8_t tx[16];
+	uint16_t len;
+	Sim_Timer timer;
+	uint32_t transfers;
+	uint32_t nacks;
+	uint32_t stalls;
+} bus;
+
+/* SGP30模型 */
+static struct
+{
+	uint16_t co2_eq;
+	uint16_t tvoc;
+	uint8_t fault;
+	uint8_t initialized;
+	uint64_t init_time;
+	uint64_t busy_until; // 命令执行结束时刻
+	uint8_t response[6];
+	uint8_t response_len;
+	uint16_t baseline[2]; // CO2当量、TVOC
+	uint16_t humidity;
+	uint64_t last_measure;
+	uint32_t measures;
+	uint64_t min_interval;
+	uint64_t max_interval;
+	uint32_t baseline_reads;
+	uint32_t baseline_writes;
+	uint32_t humidity_writes;
+	uint32_t crc_errors; // 主机发送的参数CRC错误次数
+	uint32_t inits;
+} sgp = {.co2_eq = 400, .baseline = {0x8A3C, 0x8E10}};
+
+static uint8_t crc8(const uint8_t *data, uint8_t len)
+{
+	uint8_t crc = 0xFF;
+
+	for (uint8_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t b = 0; b < 8; b++)
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+/**
+ * @函数名      : sgp30_respond
+ * @描述        : 准备两个数据字的返回数据，命令执行exec_ms后可读
+ */
+static void sgp30_respond(uint16_t w0, uint16_t w1, uint32_t exec_ms)
+{
+	const uint16_t words[2] = {w0, w1};
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		sgp.response[i * 3] = (uint8_t)(words[i] >> 8);
+		sgp.response[i * 3 + 1] = (uint8_t)words[i];
+		sgp.response[i * 3 + 2] = crc8(&sgp.response[i * 3], 2);
+	}
+	if (sgp.fault == SIM_SGP30_BADCRC)
+		sgp.response[2] ^= 0x5A;
+	sgp.response_len = 6;
+	sgp.busy_until = Sim_Now() + SIM_MS(exec_ms);
+}
+
+/**
+ * @函数名      : sgp30_write
+ * @描述        : 处理主机写入的命令
+ * @返回值      : 1 - 应答; 0 - 不应答
+ */
+static uint8_t sgp30_write(const uint8_t *data, uint16_t len)
+{
+	uint16_t args[2] = {0};
+	uint8_t nargs = 0;
+
+	if (Sim_Now() < sgp.busy_until || len < 2)
+		return 0;
+
+	const uint16_t cmd = (uint16_t)(data[0] << 8 | data[1]);
+	for (uint16_t i = 2; i + 3 <= len && nargs < 2; i += 3)
+	{
+		if (crc8(&data[i], 2) != data[i + 2])
+		{
+			sgp.crc_errors++;
+			return 0;
+		}
+		args[nargs++] = (uint16_t)(data[i] << 8 | data[i + 1]);
+	}
+
+	sgp.response_len = 0;
+	switch (cmd)
+	{
+	case 0x2003: // init_air_quality
+		sgp.initialized = 1;
+		sgp.init_time = Sim_Now();
+		sgp.inits++;
+		sgp.busy_until = Sim_Now() + SIM_MS(10);
+		break;
+
+	case 0x2008: // measure_air_quality
+	{
+		const uint64_t now = Sim_Now();
+		if (sgp.measures > 0)
+		{
+			const uint64_t interval = now - sgp.last_measure;
+			if (sgp.min_interval == 0 || interval < sgp.min_interval)
+				sgp.min_interval = interval;
+			if (interval > sgp.max_interval)
+				sgp.max_interval = interval;
+		}
+		sgp.last_measure = now;
+		sgp.measures++;
+
+		if (!sgp.initialized || now - sgp.init_time < SIM_MS(SGP30_WARMUP_MS))
+			sgp30_respond(400, 0, 12);
+		else
+			sgp30_respond(sgp.co2_eq, sgp.tvoc, 12);
+		break;
+	}
+
+	case 0x2015: // get_iaq_baseline
+		sgp.baseline_reads++;
+		sgp30_respond(sgp.baseline[0], sgp.baseline[1], 10);
+		break;
+
+	case 0x201E: // set_iaq_baseline，参数顺序为TVOC、CO2当量
+		if (nargs != 2)
+			return 0;
+		sgp.baseline[1] = args[0];
+		sgp.baseline[0] = args[1];
+		sgp.baseline_writes++;
+		sgp.busy_until = Sim_Now() + SIM_MS(10);
+		break;
+
+	case 0x2061: // set_absolute_humidity
+		if (nargs != 1)
+			return 0;
+		sgp.humidity = args[0];
+		sgp.humidity_writes++;
+		sgp.busy_until = Sim_Now() + SIM_MS(10);
+		break;
+
+	default:
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @函数名      : sgp30_read
+ * @描述        : 主机读取返回数据
+ * @返回值      : 1 - 应答; 0 - 命令执行中或无数据，不应答
+ */
+static uint8_t sgp30_read(uint8_t *data, uint16_t len)
+{
+	if (Sim_Now() < sgp.busy_until || sgp.response_len == 0 || len > sgp.response_len)
+		return 0;
+
+	memcpy(data, sgp.response, len);
+	sgp.response_len = 0;
+	return 1;
+}
+
+/**
+ * @函数名      : bus_event
+ * @描述        : 传输结束：交给器件模型处理并调用HAL回调
+ */
+static void bus_event(void *arg)
+{
+	UNUSED(arg);
+	I2C_HandleTypeDef *hi2c = bus.hi2c;
+	uint8_t ack = 0;
+
+	if (bus.addr == SGP30_ADDR && sgp.fault != SIM_SGP30_NACK)
+		ack = bus.reading ? sgp30_read(bus.rx, bus.len) : sgp30_write(bus.tx, bus.len);
+
+	hi2c->State = HAL_I2C_STATE_READY;
+	Sim_Charge(SIM_COST_HAL_CALL); // HAL_I2C_EV_IRQHandler
+	if (!ack)
+	{
+		bus.nacks++;
+		hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+		HAL_I2C_ErrorCallback(hi2c);
+	}
+	else if (bus.reading)
+	{
+		HAL_I2C_MasterRxCpltCallback(hi2c);
+	}
+	else
+	{
+		HAL_I2C_MasterTxCpltCallback(hi2c);
+	}
+}
+
+/**
+ * @函数名      : bus_start
+ * @描述        : 开始一次传输，地址不应答时在地址字节后结束
+ */
+static HAL_StatusTypeDef bus_start(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t len, uint8_t reading)
+{
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (hi2c->State != HAL_I2C_STATE_READY)
+		return HAL_BUSY;
+
+	bus.hi2c = hi2c;
+	bus.addr = (uint8_t)(DevAddress >> 1);
+	bus.len = len;
+	bus.reading = reading;
+	bus.transfers++;
+	hi2c->State = reading ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+	if (sgp.fault == SIM_SGP30_STALL)
+	{
+		bus.stalls++;
+		return HAL_OK; // 总线挂死，传输不结束
+	}
+
+	const uint16_t bytes = (bus.addr == SGP30_ADDR && sgp.fault != SIM_SGP30_NACK) ? len + 1U : 1U;
+	const uint32_t clock = hi2c->Init.ClockSpeed ? hi2c->Init.ClockSpeed : 100000U;
+	Sim_TimerStart(&bus.timer, Sim_Now() + (uint64_t)bytes * 9U * SIM_CPU_HZ / clock);
+	return HAL_OK;
+}
+
+void Sim_Sgp30_Set(uint16_t co2_eq, uint16_t tvoc, uint8_t fault)
+{
+	sgp.co2_eq = co2_eq;
+	sgp.tvoc = tvoc;
+	sgp.fault = fault;
+}
+
+void Sim_Sgp30_Report(FILE *out)
+{
+	fprintf(out, "i2c    transfers %u, NACK %u, stalled %u\n", bus.transfers, bus.nacks, bus.stalls);
+	fprintf(out, "sgp30  init %u, measure %u (interval min/max %.3f/%.3f ms), baseline get/set %u/%u, "
+				 "humidity %u (last 0x%04X), bad arg CRC %u\n",
+			sgp.inits, sgp.measures, sgp.min_interval / (double)SIM_MS(1), sgp.max_interval / (double)SIM_MS(1),
+			sgp.baseline_reads, sgp.baseline_writes, sgp.humidity_writes, sgp.humidity, sgp.crc_errors);
+}
+
+/* HAL I2C --------------------------------------------------------------------*/
+
+__weak void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c)
+{
+	UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MspDeInit(I2C_HandleTypeDef *hi2c)
+{
+	UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	UNUSED(hi2c);
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c == NULL || hi2c->Instance != I2C2)
+		return HAL_ERROR;
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (hi2c->State == HAL_I2C_STATE_RESET)
+		HAL_I2C_MspInit(hi2c);
+	Sim_TimerInit(&bus.timer, "i2c2", bus_event, NULL);
+	hi2c->State = HAL_I2C_STATE_READY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+	Sim_Charge(SIM_COST_HAL_CALL);
+	Sim_TimerStop(&bus.timer); // 中止进行中的传输
+	HAL_I2C_MspDeInit(hi2c);
+	hi2c->State = HAL_I2C_STATE_RESET;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	if (Size > sizeof(bus.tx))
+		return HAL_ERROR;
+
+	const HAL_StatusTypeDef status = bus_start(hi2c, DevAddress, Size, 0);
+	if (status == HAL_OK)
+		memcpy(bus.tx, pData, Size);
+	return status;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	const HAL_StatusTypeDef status = bus_start(hi2c, DevAddress, Size, 1);
+	if (status == HAL_OK)
+		bus.rx = pData;
+	return status;
+}
@@ -0,0 +1,224 @@
+/**
+ * @文件        : sim_main.c
+ * @描述        : 模拟器入口：解析命令行、加载轨迹和Flash镜像，运行固件main()并输出统计
+ * @注意事项    : 固件的main.c以-Dmain=firmware_main编译，原样运行其初始化和主循环；
+ *                到达结束时刻后在主循环上下文中输出报告并退出进程
+ *                退出码：0 - 通过; 1 - 检查项未通过; 2 - 参数错误或固件卡死（进入Error_Handler等）
+ */
+
+#include "sim.h"
+#include "usart.h"
+#include "scheduler/scheduler.h"
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int firmware_main(void);
+
+static struct
+{
+	const char *trace;
+	const char *flash;
+	const char *uart1;
+	const char *uart4;
+	uint32_t seconds;
+	uint32_t seed;
+	uint32_t max_latency_ms; // 主循环最坏响应延迟上限，0表示不检查
+	uint32_t min_reports;	 // UART4上报帧数下限，0表示不检查
+	uint32_t wall_timeout_s; // 主机实际运行时间上限
+} opt = {.seconds = 60, .seed = 1, .wall_timeout_s = 120};
+
+static FILE *uart_files[2];
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+			"usage: %s [options]\n"
+			"  -t, --trace FILE        sensor trace\n"
+			"  -d, --duration SEC      simulated run time (default 60)\n"
+			"  --flash FILE            flash image, loaded if present and written back on exit\n"
+			"  --uart1 FILE|-          capture debug UART output\n"
+			"  --uart4 FILE|-          capture ESP8266 UART output\n"
+			"  --seed N                ADC noise seed (default 1)\n"
+			"  --max-latency MS        fail if the main loop is ever busy longer than MS\n"
+			"  --min-reports N         fail if fewer than N telemetry frames are sent\n"
+			"  --wall-timeout SEC      abort if the host run takes longer (default 120)\n",
+			prog);
+	exit(2);
+}
+
+static uint32_t parse_u32(const char *prog, const char *arg)
+{
+	char *end;
+
+	if (arg == NULL)
+		usage(prog);
+	const unsigned long v = strtoul(arg, &end, 10);
+	if (*end != '\0' || v > UINT32_MAX)
+		usage(prog);
+	return (uint32_t)v;
+}
+
+static void parse_args(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char *a = argv[i];
+		const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp(a, "-t") == 0 || strcmp(a, "--trace") == 0)
+			opt.trace = v;
+		else if (strcmp(a, "-d") == 0 || strcmp(a, "--duration") == 0)
+			opt.seconds = parse_u32(argv[0], v);
+		else if (strcmp(a, "--flash") == 0)
+			opt.flash = v;
+		else if (strcmp(a, "--uart1") == 0)
+			opt.uart1 = v;
+		else if (strcmp(a, "--uart4") == 0)
+			opt.uart4 = v;
+		else if (strcmp(a, "--seed") == 0)
+			opt.seed = parse_u32(argv[0], v);
+		else if (strcmp(a, "--max-latency") == 0)
+			opt.max_latency_ms = parse_u32(argv[0], v);
+		else if (strcmp(a, "--min-reports") == 0)
+			opt.min_reports = parse_u32(argv[0], v);
+		else if (strcmp(a, "--wall-timeout") == 0)
+			opt.wall_timeout_s = parse_u32(argv[0], v);
+		else
+			usage(argv[0]);
+
+		if (v == NULL)
+			usage(argv[0]);
+		i++;
+	}
+}
+
+static FILE *open_capture(const char *path)
+{
+	if (path == NULL)
+		return NULL;
+	if (strcmp(path, "-") == 0)
+		return stdout;
+
+	FILE *f = fopen(path, "wb");
+	if (f == NULL)
+	{
+		fprintf(stderr, "sim: cannot open %s\n", path);
+		exit(2);
+	}
+	return f;
+}
+
+static void on_wall_timeout(int sig)
+{
+	UNUSED(sig);
+	static const char msg[] = "sim: wall-clock timeout, firmware hang (Error_Handler or busy loop without HAL calls)\n";
+	(void)!write(STDERR_FILENO, msg, sizeof(msg) - 1);
+	_exit(2);
+}
+
+static double cycles_to_ms(uint64_t cycles)
+{
+	return cycles / (double)SIM_MS(1);
+}
+
+/**
+ * @函数名      : report_tasks
+ * @描述        : 输出调度器各任务的运行统计
+ */
+static void report_tasks(FILE *out)
+{
+	fprintf(out, "%-12s %8s %8s %8s %8s %8s\n", "task", "runs", "lat(ms)", "exec(ms)", "missed", "skipped");
+	for (uint8_t i = 0; i < Scheduler_GetTaskCount(); i++)
+	{
+		const Scheduler_Task *t = Scheduler_GetTask(i);
+		fprintf(out, "%-12s %8lu %8lu %8lu %8lu %8lu\n", t->name, (unsigned long)t->run_count,
+				(unsigned long)t->max_latency_ms, (unsigned long)t->max_exec_ms,
+				(unsigned long)t->deadline_misses, (unsigned long)t->skipped);
+	}
+}
+
+static void report_uart(FILE *out, const char *name, UART_HandleTypeDef *huart)
+{
+	const Sim_UartStats *s = Sim_UartGetStats(huart->Instance);
+	const UART_TxStats *tx = UART_TxGetStats(huart);
+
+	fprintf(out, "%-6s bytes %llu in %u DMA transfers, frames %u", name,
+			(unsigned long long)s->bytes, s->transfers, s->frames);
+	if (s->frames > 1)
+		fprintf(out, " (interval min/avg/max %.3f/%.3f/%.3f ms)", cycles_to_ms(s->min_interval),
+				cycles_to_ms(s->sum_interval) / (s->frames - 1), cycles_to_ms(s->max_interval));
+	if (tx != NULL)
+		fprintf(out, ", ring high water %u, overflows %lu", tx->high_water, (unsigned long)tx->overflow_count);
+	fputc('\n', out);
+}
+
+/**
+ * @函数名      : finish
+ * @描述        : 到达结束时刻：输出报告、执行检查、写回Flash镜像并退出
+ */
+static void finish(void)
+{
+	FILE *out = stderr;
+	const Sim_LoopStats *loop = Sim_GetLoopStats();
+	const Sim_UartStats *reports = Sim_UartGetStats(UART4);
+	int failed = 0;
+
+	for (int i = 0; i < 2; i++)
+		if (uart_files[i] != NULL)
+			fflush(uart_files[i]);
+
+	fprintf(out, "\n=== simulated %lu s ===\n", (unsigned long)opt.seconds);
+	report_tasks(out);
+	fprintf(out, "init   %.3f ms until the first WFI\n", cycles_to_ms(loop->startup_cycles));
+	fprintf(out, "loop   wakeups %llu, busy %.2f%%, longest busy span %.3f ms at t=%.3f s\n",
+			(unsigned long long)loop->wakeups, 100.0 * loop->busy_cycles / (double)Sim_Now(),
+			cycles_to_ms(loop->max_busy), loop->max_busy_at / (double)SIM_CPU_HZ);
+	fprintf(out, "irq    dispatched %llu, max late %.3f us\n", (unsigned long long)loop->isr_count,
+			loop->max_isr_late / (double)SIM_US(1));
+	report_uart(out, "usart1", &huart1);
+	report_uart(out, "uart4", &huart4);
+	Sim_Dht11_Report(out);
+	Sim_Adc_Report(out);
+	Sim_Sgp30_Report(out);
+	Sim_Flash_Report(out);
+
+	if (opt.max_latency_ms && loop->max_busy > SIM_MS(opt.max_latency_ms))
+	{
+		fprintf(out, "FAIL: main loop busy for %.3f ms > %lu ms\n", cycles_to_ms(loop->max_busy),
+				(unsigned long)opt.max_latency_ms);
+		failed = 1;
+	}
+	if (reports->frames < opt.min_reports)
+	{
+		fprintf(out, "FAIL: %u telemetry frames < %lu\n", reports->frames, (unsigned long)opt.min_reports);
+		failed = 1;
+	}
+
+	Sim_FlashSave();
+	fprintf(out, "%s\n", failed ? "FAILED" : "PASSED");
+	exit(failed);
+}
+
+int main(int argc, char **argv)
+{
+	parse_args(argc, argv);
+
+	Sim_Seed(opt.seed);
+	if (Sim_FlashInit(opt.flash) != 0)
+		return 2;
+	if (opt.trace != NULL && Sim_TraceLoad(opt.trace) != 0)
+		return 2;
+	uart_files[0] = open_capture(opt.uart1);
+	uart_files[1] = open_capture(opt.uart4);
+	Sim_UartCapture(USART1, uart_files[0]);
+	Sim_UartCapture(UART4, uart_files[1]);
+
+	signal(SIGALRM, on_wall_timeout);
+	alarm(opt.wall_timeout_s);
+
+	Sim_Run(SIM_MS((uint64_t)opt.seconds * 1000U), finish);
+	firmware_main();
+	return 2; // 固件主循环不应返回
+}
@@ -0,0 +1,233 @@
+/**
+ * @文件        : sim_trace.c
+ * @描述        : 传感器轨迹文件：按虚拟时间改变各模型的输入和故障
+ * @注意事项    : 整个文件在启动时解析进内存，用一个Sim_Timer依次应用到期的条目；
+ *                条目在中断上下文中应用，因此可以与固件的采样任意交错
+ */
+
+#include "sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAX_ENTRIES 512
+
+typedef enum
+{
+	TRACE_DHT11,
+	TRACE_ADC,
+	TRACE_SGP30,
+	TRACE_WAVE,
+} Trace_Kind;
+
+typedef struct
+{
+	uint64_t when;
+	Trace_Kind kind;
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	uint16_t value[5];
+	uint8_t fault;
+	uint16_t segments;
+	Sim_Segment *wave;
+} Trace_Entry;
+
+static Trace_Entry entries[TRACE_MAX_ENTRIES];
+static uint16_t entry_count = 0;
+static uint16_t next_entry = 0;
+static Sim_Timer trace_timer;
+
+/**
+ * @函数名      : parse_fault
+ * @描述        : 将故障名映射为编号
+ * @返回值      : 0 - 成功; -1 - 未知名称
+ */
+static int parse_fault(const char *name, const char *const *names, uint8_t count, uint8_t *fault)
+{
+	if (name == NULL)
+	{
+		*fault = 0;
+		return 0;
+	}
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (strcmp(name, names[i]) == 0)
+		{
+			*fault = i;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @函数名      : parse_numbers
+ * @描述        : 依次解析n个无符号整数参数
+ * @返回值      : 0 - 成功; -1 - 缺少参数或格式错误
+ */
+static int parse_numbers(uint16_t *out, uint8_t n)
+{
+	for (uint8_t i = 0; i < n; i++)
+	{
+		const char *tok = strtok(NULL, " \t");
+		char *end;
+		if (tok == NULL)
+			return -1;
+		const unsigned long v = strtoul(tok, &end, 10);
+		if (*end != '\0' || v > 0xFFFF)
+			return -1;
+		out[i] = (uint16_t)v;
+	}
+	return 0;
+}
+
+/**
+ * @函数名      : parse_line
+ * @描述        : 解析一行轨迹（已去掉注释），空行返回1
+ * @返回值      : 1 - 空行; 0 - 成功; -1 - 格式错误
+ */
+static int parse_line(char *line, Trace_Entry *e)
+{
+	static const char *const dht11_faults[] = {"ok", "silent", "checksum", "truncate"};
+	static const char *const sgp30_faults[] = {"ok", "nack", "badcrc", "stall"};
+	char *tok = strtok(line, " \t\r\n");
+	char *end;
+
+	if (tok == NULL)
+		return 1;
+	const unsigned long long ms = strtoull(tok, &end, 10);
+	if (*end != '\0')
+		return -1;
+	e->when = SIM_MS(ms);
+
+	const char *dev = strtok(NULL, " \t\r\n");
+	if (dev == NULL)
+		return -1;
+
+	if (strcmp(dev, "dht11") == 0)
+	{
+		e->kind = TRACE_DHT11;
+		const char *pin = strtok(NULL, " \t");
+		if (pin == NULL || Sim_GpioParse(pin, &e->port, &e->pin) != 0 || parse_numbers(e->value, 4) != 0)
+			return -1;
+		return parse_fault(strtok(NULL, " \t"), dht11_faults, 4, &e->fault);
+	}
+	if (strcmp(dev, "adc") == 0)
+	{
+		e->kind = TRACE_ADC;
+		if (parse_numbers(e->value, 2) != 0 || e->value[0] > 17)
+			return -1;
+		if (parse_numbers(&e->value[2], 1) != 0)
+			e->value[2] = 0;
+		return 0;
+	}
+	if (strcmp(dev, "sgp30") == 0)
+	{
+		e->kind = TRACE_SGP30;
+		if (parse_numbers(e->value, 2) != 0)
+			return -1;
+		return parse_fault(strtok(NULL, " \t"), sgp30_faults, 4, &e->fault);
+	}
+	if (strcmp(dev, "wave") == 0)
+	{
+		Sim_Segment seg[SIM_WAVE_MAX_SEGMENTS];
+		e->kind = TRACE_WAVE;
+		const char *pin = strtok(NULL, " \t");
+		if (pin == NULL || Sim_GpioParse(pin, &e->port, &e->pin) != 0)
+			return -1;
+		e->segments = 0;
+		for (tok = strtok(NULL, " \t"); tok != NULL; tok = strtok(NULL, " \t"))
+		{
+			if (e->segments >= SIM_WAVE_MAX_SEGMENTS || (tok[0] != '0' && tok[0] != '1') || tok[1] != ':')
+				return -1;
+			seg[e->segments].level = (uint8_t)(tok[0] - '0');
+			seg[e->segments].dur_us = (uint32_t)strtoul(&tok[2], &end, 10);
+			if (*end != '\0')
+				return -1;
+			e->segments++;
+		}
+		if (e->segments == 0)
+			return -1;
+		e->wave = malloc(e->segments * sizeof(Sim_Segment));
+		if (e->wave == NULL)
+			return -1;
+		memcpy(e->wave, seg, e->segments * sizeof(Sim_Segment));
+		return 0;
+	}
+	return -1;
+}
+
+/**
+ * @函数名      : apply
+ * @描述        : 应用一条轨迹条目
+ */
+static void apply(const Trace_Entry *e)
+{
+	switch (e->kind)
+	{
+	case TRACE_DHT11:
+		Sim_Dht11_Set(e->port, e->pin, (uint8_t)e->value[0], (uint8_t)e->value[1],
+					  (uint8_t)e->value[2], (uint8_t)e->value[3], e->fault);
+		break;
+	case TRACE_ADC:
+		Sim_AdcSetInput((uint8_t)e->value[0], e->value[1], e->value[2]);
+		break;
+	case TRACE_SGP30:
+		Sim_Sgp30_Set(e->value[0], e->value[1], e->fault);
+		break;
+	case TRACE_WAVE:
+		Sim_GpioPlay(e->port, e->pin, e->wave, e->segments);
+		break;
+	}
+}
+
+static void trace_event(void *arg)
+{
+	UNUSED(arg);
+
+	while (next_entry < entry_count && entries[next_entry].when <= Sim_Now())
+		apply(&entries[next_entry++]);
+	if (next_entry < entry_count)
+		Sim_TimerStart(&trace_timer, entries[next_entry].when);
+}
+
+int Sim_TraceLoad(const char *path)
+{
+	char line[512];
+	unsigned lineno = 0;
+	FILE *f = fopen(path, "r");
+
+	if (f == NULL)
+	{
+		fprintf(stderr, "sim: cannot open trace %s\n", path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		lineno++;
+		line[strcspn(line, "#\r\n")] = '\0';
+
+		Trace_Entry e = {0};
+		const int r = parse_line(line, &e);
+		if (r == 1)
+			continue;
+		if (r != 0 || entry_count >= TRACE_MAX_ENTRIES ||
+			(entry_count > 0 && e.when < entries[entry_count - 1].when))
+		{
+			fprintf(stderr, "%s:%u: invalid trace line\n", path, lineno);
+			fclose(f);
+			return -1;
+		}
+		entries[entry_count++] = e;
+	}
+	fclose(f);
+
+	/* 时刻为0的条目在固件启动前生效，使初始化时就能读到设定的输入 */
+	while (next_entry < entry_count && entries[next_entry].when == 0)
+		apply(&entries[next_entry++]);
+
+	Sim_TimerInit(&trace_timer, "trace", trace_event, NULL);
+	if (next_entry < entry_count)
+		Sim_TimerStart(&trace_timer, entries[next_entry].when);
+	return 0;
+}
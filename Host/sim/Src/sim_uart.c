@@ -0,0 +1,165 @@
+/**
+ * @文件        : sim_uart.c
+ * @描述        : UART DMA发送模型与输出捕获
+ * @注意事项    : 每字节按10位（8N1）计算发送时间，传输结束后在中断上下文中调用
+ *                HAL_UART_TxCpltCallback；发出的数据按发送开始时刻写入捕获文件并统计帧间隔
+ */
+
+#include "sim.h"
+
+USART_TypeDef Sim_Usart1;
+USART_TypeDef Sim_Uart4;
+
+#define FRAME_SYNC0 0xA5
+#define FRAME_SYNC1 0x5A
+
+typedef struct
+{
+	USART_TypeDef *instance;
+	UART_HandleTypeDef *huart;
+	FILE *out;
+	Sim_Timer timer;
+	uint8_t prev;		 // 上一个字节，用于识别同步字
+	uint8_t line_start; // 下一个字节是否为文本行首
+	uint8_t binary;		 // 首字节为同步字时按二进制帧计数，否则按文本行计数
+	Sim_UartStats stats;
+} Sim_Uart;
+
+static Sim_Uart uarts[2] = {
+	{.instance = &Sim_Usart1, .line_start = 1},
+	{.instance = &Sim_Uart4, .line_start = 1},
+};
+
+static Sim_Uart *find_uart(const USART_TypeDef *instance)
+{
+	return instance == &Sim_Uart4 ? &uarts[1] : &uarts[0];
+}
+
+/**
+ * @函数名      : frame_start
+ * @描述        : 记录一帧的开始时刻并更新帧间隔统计
+ */
+static void frame_start(Sim_Uart *u, uint64_t t)
+{
+	Sim_UartStats *s = &u->stats;
+
+	if (s->frames > 0)
+	{
+		const uint64_t interval = t - s->last_frame;
+		if (s->min_interval == 0 || interval < s->min_interval)
+			s->min_interval = interval;
+		if (interval > s->max_interval)
+			s->max_interval = interval;
+		s->sum_interval += interval;
+	}
+	s->frames++;
+	s->last_frame = t;
+}
+
+/**
+ * @函数名      : capture
+ * @描述        : 写入捕获文件并识别帧边界
+ * @实现细节    : 按发出的第一个字节判断格式：二进制遥测帧以0xA5 0x5A开头，
+ *                文本格式以非空行的行首计为一帧
+ */
+static void capture(Sim_Uart *u, const uint8_t *data, uint16_t len)
+{
+	const uint64_t t = Sim_Now();
+
+	if (u->out != NULL)
+		fwrite(data, 1, len, u->out);
+
+	if (u->stats.bytes == 0)
+		u->binary = (data[0] == FRAME_SYNC0);
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		const uint8_t c = data[i];
+		if (u->binary ? (u->prev == FRAME_SYNC0 && c == FRAME_SYNC1)
+					  : (u->line_start && c != '\n' && c != '\r'))
+			frame_start(u, t);
+		u->line_start = (c == '\n');
+		u->prev = c;
+	}
+	u->stats.bytes += len;
+	u->stats.transfers++;
+}
+
+static void uart_event(void *arg)
+{
+	Sim_Uart *u = arg;
+	UART_HandleTypeDef *huart = u->huart;
+
+	huart->gState = HAL_UART_STATE_READY;
+	huart->TxXferCount = 0;
+	Sim_Charge(SIM_COST_HAL_CALL); // DMA中断与HAL_UART_IRQHandler
+	HAL_UART_TxCpltCallback(huart);
+}
+
+void Sim_UartCapture(USART_TypeDef *instance, FILE *out)
+{
+	find_uart(instance)->out = out;
+}
+
+const Sim_UartStats *Sim_UartGetStats(USART_TypeDef *instance)
+{
+	return &find_uart(instance)->stats;
+}
+
+/* HAL UART -------------------------------------------------------------------*/
+
+__weak void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+	UNUSED(huart);
+}
+
+__weak void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
+{
+	UNUSED(huart);
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+	UNUSED(huart);
+}
+
+__weak void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	UNUSED(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+	if (huart == NULL || (huart->Instance != USART1 && huart->Instance != UART4) || huart->Init.BaudRate == 0)
+		return HAL_ERROR;
+
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (huart->gState == HAL_UART_STATE_RESET)
+		HAL_UART_MspInit(huart);
+
+	Sim_Uart *u = find_uart(huart->Instance);
+	u->huart = huart;
+	Sim_TimerInit(&u->timer, huart->Instance == UART4 ? "uart4" : "usart1", uart_event, u);
+	huart->gState = HAL_UART_STATE_READY;
+	huart->RxState = HAL_UART_STATE_READY;
+	huart->ErrorCode = 0;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+	Sim_Charge(SIM_COST_HAL_CALL);
+	if (huart->gState != HAL_UART_STATE_READY)
+		return HAL_BUSY;
+	if (pData == NULL || Size == 0 || huart->hdmatx == NULL)
+		return HAL_ERROR;
+
+	Sim_Uart *u = find_uart(huart->Instance);
+	huart->gState = HAL_UART_STATE_BUSY_TX;
+	huart->pTxBuffPtr = pData;
+	huart->TxXferSize = Size;
+	huart->TxXferCount = Size;
+	capture(u, pData, Size);
+	Sim_TimerStart(&u->timer, Sim_Now() + (uint64_t)Size * 10U * SIM_CPU_HZ / huart->Init.BaudRate);
+	return HAL_OK;
+}
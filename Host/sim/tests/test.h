@@ -0,0 +1,53 @@
+#ifndef TEST_H
+#define TEST_H
+
+/**
+ * @文件        : test.h
+ * @描述        : 主机端单元测试与基准测试的公共宏
+ * @注意事项    : 每个测试程序只链接被测模块，独立编译运行；
+ *                CHECK失败时输出位置和说明并继续，main末尾以TEST_EXIT()返回：
+ *                0 - 全部通过; 1 - 有检查项失败
+ *                基准测试用主机单调时钟计时，只用于比较同一主机上不同实现的相对快慢，
+ *                不代表目标板上的周期数
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static unsigned test_checks;
+static unsigned test_failures;
+
+/* 基准测试的结果累加到这里，防止被测调用被优化掉 */
+static volatile uint32_t test_sink;
+
+#define CHECK(cond, ...) \
+	do \
+	{ \
+		test_checks++; \
+		if (!(cond)) \
+		{ \
+			test_failures++; \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+			fprintf(stderr, __VA_ARGS__); \
+			fputc('\n', stderr); \
+		} \
+	} while (0)
+
+#define TEST_EXIT() \
+	(printf("%s: %u checks, %u failed\n", __FILE__, test_checks, test_failures), \
+	 test_failures != 0)
+
+/**
+ * @函数名      : test_now_ns
+ * @描述        : 主机单调时钟(ns)
+ */
+static inline uint64_t test_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* TEST_H */
@@ -0,0 +1,176 @@
+/**
+ * @文件        : test_crc.c
+ * @描述        : 查表法CRC的正确性测试与基准测试
+ * @注意事项    : 以逐位算法（原sgp30_crc的实现）为参考，检查手册给出的校验值、
+ *                全部2字节数据字和随机长度数据，并比较两种实现的耗时
+ */
+
+#include "test.h"
+#include "crc/crc.h"
+#include <string.h>
+
+#define BENCH_ROUNDS 2000000
+
+/* 逐位CRC8，多项式0x31，初值0xFF */
+static uint8_t crc8_bitwise(const uint8_t *data, uint16_t len)
+{
+	uint8_t crc = 0xFF;
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+/* 逐位CRC16-CCITT，多项式0x1021，初值0xFFFF */
+static uint16_t crc16_bitwise(const uint8_t *data, uint32_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (uint32_t i = 0; i < len; i++)
+	{
+		crc ^= (uint16_t)(data[i] << 8);
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	return crc;
+}
+
+/* 手册和标准给出的校验值 */
+static void test_known_values(void)
+{
+	const uint8_t beef[2] = {0xBE, 0xEF};
+	const uint8_t *check = (const uint8_t *)"123456789";
+
+	CHECK(CRC8_Sensirion(beef, 2) == 0x92, "CRC8(BEEF) = %02X", CRC8_Sensirion(beef, 2));
+	CHECK(crc8_bitwise(beef, 2) == 0x92, "bitwise CRC8(BEEF) = %02X", crc8_bitwise(beef, 2));
+	CHECK(CRC16_CCITT(check, 9) == 0x29B1, "CRC16(123456789) = %04X", CRC16_CCITT(check, 9));
+	CHECK(crc16_bitwise(check, 9) == 0x29B1, "bitwise CRC16(123456789) = %04X", crc16_bitwise(check, 9));
+	CHECK(CRC8_Sensirion(beef, 0) == CRC8_SENSIRION_INIT, "empty CRC8");
+	CHECK(CRC16_CCITT(check, 0) == CRC16_CCITT_INIT, "empty CRC16");
+}
+
+/* 全部2字节数据字与随机长度数据，查表结果与逐位结果一致 */
+static void test_against_bitwise(void)
+{
+	unsigned crc8_diff = 0;
+	unsigned crc16_diff = 0;
+	uint8_t buf[300];
+	uint32_t seed = 1;
+
+	for (uint32_t w = 0; w <= 0xFFFF; w++)
+	{
+		const uint8_t word[2] = {(uint8_t)(w >> 8), (uint8_t)w};
+		crc8_diff += CRC8_Sensirion(word, 2) != crc8_bitwise(word, 2);
+		crc16_diff += CRC16_CCITT(word, 2) != crc16_bitwise(word, 2);
+	}
+
+	for (uint32_t round = 0; round < 2000; round++)
+	{
+		const uint16_t len = (uint16_t)(round % sizeof(buf));
+		for (uint16_t i = 0; i < len; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			buf[i] = (uint8_t)(seed >> 16);
+		}
+		crc8_diff += CRC8_Sensirion(buf, len) != crc8_bitwise(buf, len);
+		crc16_diff += CRC16_CCITT(buf, len) != crc16_bitwise(buf, len);
+
+		// 分段计算与整段一致
+		const uint32_t split = len / 3;
+		const uint16_t part = CRC16_CCITT_Update(CRC16_CCITT_INIT, buf, split);
+		crc16_diff += CRC16_CCITT_Update(part, buf + split, len - split) != crc16_bitwise(buf, len);
+	}
+
+	CHECK(crc8_diff == 0, "%u CRC8 mismatches", crc8_diff);
+	CHECK(crc16_diff == 0, "%u CRC16 mismatches", crc16_diff);
+}
+
+/* 多字响应的批量校验：全部正确时输出各字，任一字的任一位出错时失败 */
+static void test_verify_words(void)
+{
+	static const uint16_t words[4] = {0xBEEF, 0x0000, 0xFFFF, 0x1234};
+	uint8_t resp[4 * CRC8_WORD_SIZE];
+	uint16_t out[4] = {0};
+
+	for (uint8_t i = 0; i < 4; i++)
+		CRC8_PackWord(&resp[i * CRC8_WORD_SIZE], words[i]);
+	CHECK(resp[2] == 0x92, "packed CRC %02X", resp[2]);
+	CHECK(CRC8_VerifyWords(resp, 4, out) == 1, "valid response rejected");
+	CHECK(memcmp(out, words, sizeof(words)) == 0, "words %04X %04X %04X %04X", out[0], out[1], out[2], out[3]);
+	CHECK(CRC8_VerifyWords(resp, 4, NULL) == 1, "valid response rejected without output");
+	CHECK(CRC8_VerifyWords(resp, 0, NULL) == 1, "empty response rejected");
+
+	unsigned missed = 0;
+	for (uint8_t bit = 0; bit < sizeof(resp) * 8; bit++)
+	{
+		resp[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+		missed += CRC8_VerifyWords(resp, 4, NULL) != 0;
+		resp[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+	}
+	CHECK(missed == 0, "%u single-bit errors not detected", missed);
+}
+
+/*
+ * 基准测试：SGP30每次测量读取2个数据字，逐字计算CRC8；遥测帧对30字节计算CRC16
+ */
+static void bench(void)
+{
+	uint8_t resp[2 * CRC8_WORD_SIZE];
+	uint8_t frame[30];
+	uint32_t acc = 0;
+
+	CRC8_PackWord(&resp[0], 400);
+	CRC8_PackWord(&resp[3], 0);
+	for (uint8_t i = 0; i < sizeof(frame); i++)
+		frame[i] = (uint8_t)(i * 37U);
+
+	uint64_t t0 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		resp[0] = (uint8_t)i;
+		resp[3] = (uint8_t)(i >> 8);
+		acc += crc8_bitwise(&resp[0], 2) == resp[2];
+		acc += crc8_bitwise(&resp[3], 2) == resp[5];
+	}
+	uint64_t t1 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		resp[0] = (uint8_t)i;
+		resp[3] = (uint8_t)(i >> 8);
+		acc += CRC8_VerifyWords(resp, 2, NULL);
+	}
+	uint64_t t2 = test_now_ns();
+	printf("CRC8  2 words:  bitwise %6.1f ns, table batch %6.1f ns, %.1fx\n",
+		   (double)(t1 - t0) / BENCH_ROUNDS, (double)(t2 - t1) / BENCH_ROUNDS, (double)(t1 - t0) / (t2 - t1));
+
+	t0 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		frame[0] = (uint8_t)i;
+		acc += crc16_bitwise(frame, sizeof(frame));
+	}
+	t1 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		frame[0] = (uint8_t)i;
+		acc += CRC16_CCITT(frame, sizeof(frame));
+	}
+	t2 = test_now_ns();
+	printf("CRC16 30 bytes: bitwise %6.1f ns, table       %6.1f ns, %.1fx\n",
+		   (double)(t1 - t0) / BENCH_ROUNDS, (double)(t2 - t1) / BENCH_ROUNDS, (double)(t1 - t0) / (t2 - t1));
+
+	test_sink = acc;
+}
+
+int main(void)
+{
+	test_known_values();
+	test_against_bitwise();
+	test_verify_words();
+	bench();
+	return TEST_EXIT();
+}
@@ -0,0 +1,238 @@
+/**
+ * @文件        : test_dht11_decode.c
+ * @描述        : DHT11波形解码的单元测试与模糊测试
+ * @注意事项    : 合成波形按手册时序（应答80us低+80us高，数据位50us低+26us/70us高）生成，
+ *                覆盖时序抖动、不同计数器频率和32位计数器回绕；
+ *                随机波形与测试内独立实现的参考解码器逐一比较结果和输出
+ */
+
+#include "test.h"
+#include "dht11/dht11_decode.h"
+#include <string.h>
+
+#define FUZZ_ROUNDS 200000
+
+static uint32_t rng_state = 0x12345678U;
+
+/* xorshift32，固定种子使失败可复现 */
+static uint32_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static int32_t rng_range(int32_t lo, int32_t hi)
+{
+	return lo + (int32_t)(rng() % (uint32_t)(hi - lo + 1));
+}
+
+/**
+ * @函数名      : synth
+ * @描述        : 按手册时序合成5字节数据的下降沿序列
+ * @参数        : jitter_us - 每个宽度叠加的随机偏差上限(us)
+ */
+static void synth(uint32_t edges[DHT11_EDGE_COUNT], const uint8_t data[5], uint32_t base,
+				  uint32_t ticks_per_us, int32_t jitter_us)
+{
+	uint32_t t = base;
+
+	edges[0] = t;
+	t += (uint32_t)(160 + rng_range(-jitter_us, jitter_us)) * ticks_per_us;
+	edges[1] = t;
+	for (uint8_t i = 0; i < 40; i++)
+	{
+		const uint8_t bit = (data[i / 8] >> (7 - i % 8)) & 1U;
+		t += (uint32_t)((bit ? 120 : 77) + rng_range(-jitter_us, jitter_us)) * ticks_per_us;
+		edges[i + 2] = t;
+	}
+}
+
+static void random_frame(uint8_t data[5])
+{
+	for (uint8_t i = 0; i < 4; i++)
+		data[i] = (uint8_t)rng();
+	data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+}
+
+/**
+ * @函数名      : reference_decode
+ * @描述        : 参考解码器：按位宽(us)直接判定，与被测实现独立
+ */
+static DHT11_DecodeStatus reference_decode(const uint32_t *edges, uint8_t count, uint32_t ticks_per_us,
+										   uint8_t out[5])
+{
+	if (count < DHT11_EDGE_COUNT || ticks_per_us == 0)
+		return DHT11_DECODE_TOO_FEW_EDGES;
+
+	const double response_us = (double)(uint32_t)(edges[1] - edges[0]) / ticks_per_us;
+	if (response_us < 120 || response_us > 200)
+		return DHT11_DECODE_BAD_RESPONSE;
+
+	memset(out, 0, 5);
+	for (int i = 0; i < 40; i++)
+	{
+		const double width_us = (double)(uint32_t)(edges[i + 2] - edges[i + 1]) / ticks_per_us;
+		if (width_us < 60 || width_us > 160)
+			return DHT11_DECODE_BAD_BIT;
+		if (width_us > 100)
+			out[i / 8] |= (uint8_t)(0x80U >> (i % 8));
+	}
+	return out[4] == (uint8_t)(out[0] + out[1] + out[2] + out[3]) ? DHT11_DECODE_OK : DHT11_DECODE_CHECKSUM;
+}
+
+/* 手册时序下的完整帧，含不同计数器频率和回绕 */
+static void test_nominal(void)
+{
+	static const uint32_t ticks[] = {1, 8, 72};
+	static const uint32_t bases[] = {0, 0x7FFFFFF0U, 0xFFFFF000U};
+	const uint8_t data[5] = {45, 0, 25, 3, 73};
+	uint32_t edges[DHT11_EDGE_COUNT];
+	uint8_t out[5];
+
+	for (uint8_t t = 0; t < 3; t++)
+	{
+		for (uint8_t b = 0; b < 3; b++)
+		{
+			synth(edges, data, bases[b], ticks[t], 0);
+			memset(out, 0, sizeof(out));
+			CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, ticks[t], out) == DHT11_DECODE_OK,
+				  "ticks %u base %08x", ticks[t], bases[b]);
+			CHECK(memcmp(out, data, 5) == 0, "ticks %u base %08x: %u.%u %u.%u", ticks[t], bases[b],
+				  out[0], out[1], out[2], out[3]);
+		}
+	}
+}
+
+/* 各类错误：边沿不足、应答异常、位宽越界、校验和错误，多余的边沿被忽略 */
+static void test_errors(void)
+{
+	const uint8_t data[5] = {60, 0, 21, 7, 88};
+	uint32_t edges[DHT11_EDGE_COUNT + 4];
+	uint8_t out[5];
+
+	synth(edges, data, 1000, 72, 0);
+	for (uint8_t i = 0; i < 4; i++)
+		edges[DHT11_EDGE_COUNT + i] = edges[DHT11_EDGE_COUNT - 1] + (i + 1) * 7U;
+	CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT + 4, 72, out) == DHT11_DECODE_OK, "extra edges");
+
+	CHECK(DHT11_DecodeEdges(edges, 0, 72, out) == DHT11_DECODE_TOO_FEW_EDGES, "no edges");
+	CHECK(DHT11_DecodeEdges(edges, 21, 72, out) == DHT11_DECODE_TOO_FEW_EDGES, "truncated");
+	CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, 0, out) == DHT11_DECODE_TOO_FEW_EDGES, "zero clock");
+
+	synth(edges, data, 1000, 72, 0);
+	edges[0] = edges[1] - 90 * 72;
+	CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, 72, out) == DHT11_DECODE_BAD_RESPONSE, "short response");
+
+	// 位宽越界：第10位拉长100us，无论原来是0还是1都超过上限
+	synth(edges, data, 1000, 72, 0);
+	for (uint8_t i = 11; i < DHT11_EDGE_COUNT; i++)
+		edges[i] += 100 * 72;
+	CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, 72, out) == DHT11_DECODE_BAD_BIT, "long bit");
+
+	// 任一数据位翻转都会破坏校验和
+	for (uint8_t bit = 0; bit < 40; bit++)
+	{
+		uint8_t flipped[5];
+		memcpy(flipped, data, 5);
+		flipped[bit / 8] ^= (uint8_t)(0x80U >> (bit % 8));
+		synth(edges, flipped, 1000, 72, 0);
+		memset(out, 0xEE, sizeof(out));
+		CHECK(DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, 72, out) == DHT11_DECODE_CHECKSUM, "bit %u", bit);
+		CHECK(out[0] == 0xEE && out[4] == 0xEE, "output written on checksum error");
+	}
+}
+
+/* 容限内的随机抖动不影响结果 */
+static void test_jitter(void)
+{
+	uint32_t edges[DHT11_EDGE_COUNT];
+	uint8_t data[5];
+	uint8_t out[5];
+	unsigned failed = 0;
+
+	for (uint32_t round = 0; round < 20000; round++)
+	{
+		random_frame(data);
+		const uint32_t ticks_per_us = (uint32_t)rng_range(1, 72);
+		synth(edges, data, rng(), ticks_per_us, 15);
+		if (DHT11_DecodeEdges(edges, DHT11_EDGE_COUNT, ticks_per_us, out) != DHT11_DECODE_OK ||
+			memcmp(out, data, 5) != 0)
+			failed++;
+	}
+	CHECK(failed == 0, "%u of 20000 jittered frames not decoded", failed);
+}
+
+/*
+ * 模糊测试：随机宽度（部分落在有效范围内，以覆盖各个分支）、随机边沿数量和计数器频率，
+ * 结果须与参考解码器一致，出错时不得修改输出
+ */
+static void test_fuzz(void)
+{
+	uint32_t edges[DHT11_EDGE_COUNT];
+	unsigned mismatches = 0;
+	unsigned by_status[5] = {0};
+
+	for (uint32_t round = 0; round < FUZZ_ROUNDS; round++)
+	{
+		const uint32_t ticks_per_us = rng() % 4 == 0 ? rng() % 3 : (uint32_t)rng_range(1, 72);
+		const uint8_t count = rng() % 8 == 0 ? (uint8_t)(rng() % DHT11_EDGE_COUNT) : DHT11_EDGE_COUNT;
+		const uint32_t mode = rng() % 4;
+		uint32_t t = rng();
+
+		if (mode == 0)
+		{
+			// 完全随机的时间戳
+			for (uint8_t i = 0; i < DHT11_EDGE_COUNT; i++)
+				edges[i] = rng();
+		}
+		else
+		{
+			// 有效帧附近：每个宽度在容限边界两侧随机取值
+			uint8_t data[5];
+			random_frame(data);
+			if (mode == 1)
+				data[4] ^= (uint8_t)(1U << (rng() % 8));
+			const int32_t spread = mode == 3 ? 50 : 20;
+			edges[0] = t;
+			t += (uint32_t)(160 + rng_range(-spread, spread)) * ticks_per_us + rng() % (ticks_per_us + 1);
+			edges[1] = t;
+			for (uint8_t i = 0; i < 40; i++)
+			{
+				const uint8_t bit = (data[i / 8] >> (7 - i % 8)) & 1U;
+				t += (uint32_t)((bit ? 120 : 77) + rng_range(-spread, spread)) * ticks_per_us +
+					 rng() % (ticks_per_us + 1);
+				edges[i + 2] = t;
+			}
+		}
+
+		uint8_t out[5];
+		uint8_t expected[5];
+		memset(out, 0xEE, sizeof(out));
+		const DHT11_DecodeStatus status = DHT11_DecodeEdges(edges, count, ticks_per_us, out);
+		const DHT11_DecodeStatus reference = reference_decode(edges, count, ticks_per_us, expected);
+
+		by_status[status < 5 ? status : 0]++;
+		if (status != reference)
+			mismatches++;
+		else if (status == DHT11_DECODE_OK ? memcmp(out, expected, 5) != 0
+										   : memcmp(out, "\xEE\xEE\xEE\xEE\xEE", 5) != 0)
+			mismatches++;
+	}
+
+	CHECK(mismatches == 0, "%u of %u random waveforms differ from the reference", mismatches, FUZZ_ROUNDS);
+	for (uint8_t s = 0; s < 5; s++)
+		CHECK(by_status[s] > 0, "status %u never produced", s);
+	printf("fuzz: ok %u, too few %u, bad response %u, bad bit %u, checksum %u\n", by_status[0], by_status[1],
+		   by_status[2], by_status[3], by_status[4]);
+}
+
+int main(void)
+{
+	test_nominal();
+	test_errors();
+	test_jitter();
+	test_fuzz();
+	return TEST_EXIT();
+}
@@ -0,0 +1,239 @@
+/**
+ * @文件        : test_fmt.c
+ * @描述        : 定点格式化与snprintf的一致性测试和基准测试
+ * @注意事项    : 各函数的输出与snprintf逐字节比较，覆盖边界值、随机值和缓冲区截断；
+ *                基准测试格式化main.c的主报告行，与原来使用%.1f的snprintf比较耗时
+ */
+
+#include "test.h"
+#include "fmt/fmt.h"
+#include <string.h>
+
+#define RANDOM_ROUNDS 200000
+#define BENCH_ROUNDS 500000
+#define REPORT_SIZE 150 // 与main.c中report的大小相同
+
+static uint32_t rng_state = 0x2545F491U;
+
+/* xorshift32，固定种子使失败可复现 */
+static uint32_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+/* 随机数值：低位数值和接近类型边界的数值各占一部分 */
+static uint32_t random_value(void)
+{
+	switch (rng() % 4)
+	{
+	case 0:
+		return rng() % 1000U;
+	case 1:
+		return 0U - rng() % 1000U;
+	default:
+		return rng() >> (rng() % 32);
+	}
+}
+
+/* 参考实现：用整数格式串输出定点小数，负号与小数部分的补0与Fmt_Fixed的约定相同 */
+static int reference_fixed(char *buf, size_t size, int32_t value, uint8_t decimals)
+{
+	static const uint32_t pow10[10] = {1U, 10U, 100U, 1000U, 10000U, 100000U,
+									   1000000U, 10000000U, 100000000U, 1000000000U};
+	const uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+	const char *sign = value < 0 ? "-" : "";
+
+	if (decimals == 0)
+		return snprintf(buf, size, "%s%u", sign, magnitude);
+	return snprintf(buf, size, "%s%u.%0*u", sign, magnitude / pow10[decimals], decimals,
+					magnitude % pow10[decimals]);
+}
+
+/* 整数与定点小数：边界值和随机值 */
+static void test_numbers(void)
+{
+	static const int32_t edges[] = {0, 1, -1, 9, 10, -10, 99, 100, INT32_MAX, INT32_MIN, INT32_MIN + 1};
+	char buf[32];
+	char expected[32];
+	Fmt_Buffer f;
+	unsigned mismatches = 0;
+
+	for (uint32_t i = 0; i < sizeof(edges) / sizeof(edges[0]) + RANDOM_ROUNDS; i++)
+	{
+		const int32_t value = i < sizeof(edges) / sizeof(edges[0]) ? edges[i] : (int32_t)random_value();
+		const uint8_t decimals = (uint8_t)(i % 10);
+
+		Fmt_Init(&f, buf, sizeof(buf));
+		Fmt_U32(&f, (uint32_t)value);
+		snprintf(expected, sizeof(expected), "%u", (uint32_t)value);
+		mismatches += strcmp(buf, expected) != 0 || Fmt_Len(&f) != strlen(expected);
+
+		Fmt_Init(&f, buf, sizeof(buf));
+		Fmt_I32(&f, value);
+		snprintf(expected, sizeof(expected), "%d", value);
+		mismatches += strcmp(buf, expected) != 0 || Fmt_Len(&f) != strlen(expected);
+
+		Fmt_Init(&f, buf, sizeof(buf));
+		Fmt_Fixed(&f, value, decimals);
+		reference_fixed(expected, sizeof(expected), value, decimals);
+		if (strcmp(buf, expected) != 0 && mismatches++ == 0)
+			fprintf(stderr, "Fmt_Fixed(%d, %u) = \"%s\", expected \"%s\"\n", value, decimals, buf, expected);
+	}
+	CHECK(mismatches == 0, "%u outputs differ from snprintf", mismatches);
+
+	// 1位小数的数值与原来%.1f的输出一致
+	mismatches = 0;
+	for (int32_t x10 = -100000; x10 <= 100000; x10++)
+	{
+		Fmt_Init(&f, buf, sizeof(buf));
+		Fmt_Fixed(&f, x10, 1);
+		snprintf(expected, sizeof(expected), "%.1f", x10 / 10.0);
+		// %.1f把-0.0输出为"-0.0"，Fmt_Fixed的0没有符号
+		mismatches += strcmp(buf, expected) != 0 && x10 != 0;
+	}
+	CHECK(mismatches == 0, "%u values differ from %%.1f", mismatches);
+
+	Fmt_Init(&f, buf, sizeof(buf));
+	Fmt_Fixed(&f, 253, 12);
+	CHECK(strcmp(buf, "0.000000253") == 0, "decimals clamped to 9: \"%s\"", buf);
+}
+
+/* 截断：与snprintf相同地保留前size-1个字符，并置位overflow */
+static void test_truncation(void)
+{
+	char buf[24];
+	char expected[64];
+	Fmt_Buffer f;
+
+	for (uint16_t size = 1; size <= sizeof(buf); size++)
+	{
+		memset(buf, 0x55, sizeof(buf));
+		Fmt_Init(&f, buf, size);
+		Fmt_Str(&f, "PM2.5=");
+		Fmt_Fixed(&f, -1234, 2);
+		Fmt_Char(&f, ',');
+		Fmt_U32(&f, 4294967295U);
+		const int full = snprintf(expected, size, "PM2.5=%d.%02d,%u", -12, 34, 4294967295U);
+
+		CHECK(strcmp(buf, expected) == 0, "size %u: \"%s\", expected \"%s\"", size, buf, expected);
+		CHECK(f.overflow == (full >= size), "size %u: overflow %u", size, f.overflow);
+		CHECK(size == sizeof(buf) || (uint8_t)buf[size] == 0x55, "size %u: written past the buffer", size);
+	}
+}
+
+/* 主报告行的样本数据，与main.c中sensor_data/sgp30_data/methane_x10/density_x10对应 */
+typedef struct
+{
+	uint8_t humidity, humidity_dec, temperature, temperature_dec;
+	uint32_t methane_x10;
+	uint16_t tvoc_ppb, co2_eq_ppm;
+	int32_t density_x10;
+} Report;
+
+static uint16_t format_report(char *buf, uint16_t size, const Report *r)
+{
+	Fmt_Buffer line;
+
+	Fmt_Init(&line, buf, size);
+	Fmt_Str(&line, "Humidity: ");
+	Fmt_U32(&line, r->humidity);
+	Fmt_Char(&line, '.');
+	Fmt_U32(&line, r->humidity_dec);
+	Fmt_Str(&line, "%, Temperature: ");
+	Fmt_U32(&line, r->temperature);
+	Fmt_Char(&line, '.');
+	Fmt_U32(&line, r->temperature_dec);
+	Fmt_Str(&line, " C, Methane: ");
+	Fmt_Fixed(&line, (int32_t)r->methane_x10, 1);
+	Fmt_Str(&line, " ppm, TVOC: ");
+	Fmt_U32(&line, r->tvoc_ppb);
+	Fmt_Str(&line, " ppb, CO2eq: ");
+	Fmt_U32(&line, r->co2_eq_ppm);
+	Fmt_Str(&line, " ppm, Dust(PM2.5): ");
+	Fmt_Fixed(&line, r->density_x10, 1);
+	Fmt_Str(&line, " ug/m^3\n");
+	return Fmt_Len(&line);
+}
+
+/* 原main.c的实现：浮点变量经%.1f输出 */
+static int snprintf_report(char *buf, size_t size, const Report *r)
+{
+	const float methane_ppm = r->methane_x10 / 10.0f;
+	const float density = r->density_x10 / 10.0f;
+
+	return snprintf(buf, size,
+					"Humidity: %u.%u%%, Temperature: %u.%u C, Methane: %.1f ppm, TVOC: %u ppb, CO2eq: %u ppm, "
+					"Dust(PM2.5): %.1f ug/m^3\n",
+					r->humidity, r->humidity_dec, r->temperature, r->temperature_dec, methane_ppm, r->tvoc_ppb,
+					r->co2_eq_ppm, density);
+}
+
+static void random_report(Report *r)
+{
+	r->humidity = (uint8_t)(rng() % 100);
+	r->humidity_dec = (uint8_t)(rng() % 10);
+	r->temperature = (uint8_t)(rng() % 60);
+	r->temperature_dec = (uint8_t)(rng() % 10);
+	r->methane_x10 = rng() % 100000U;
+	r->tvoc_ppb = (uint16_t)(rng() % 60001U);
+	r->co2_eq_ppm = (uint16_t)(400 + rng() % 59601U);
+	r->density_x10 = (int32_t)(rng() % 5000U);
+}
+
+/* 主报告行与原snprintf输出逐字节一致 */
+static void test_report(void)
+{
+	char buf[REPORT_SIZE];
+	char expected[REPORT_SIZE];
+	Report r;
+	unsigned mismatches = 0;
+
+	for (uint32_t i = 0; i < 20000; i++)
+	{
+		random_report(&r);
+		const uint16_t len = format_report(buf, sizeof(buf), &r);
+		const int expected_len = snprintf_report(expected, sizeof(expected), &r);
+		if ((strcmp(buf, expected) != 0 || len != expected_len) && mismatches++ == 0)
+			fprintf(stderr, "report \"%s\", expected \"%s\"\n", buf, expected);
+	}
+	CHECK(mismatches == 0, "%u report lines differ from snprintf", mismatches);
+}
+
+/* 基准测试：格式化主报告行，数值每轮变化 */
+static void bench(void)
+{
+	char buf[REPORT_SIZE];
+	Report r;
+	uint32_t acc = 0;
+
+	random_report(&r);
+	const uint64_t t0 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		r.methane_x10 = i % 100000U;
+		acc += format_report(buf, sizeof(buf), &r);
+	}
+	const uint64_t t1 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		r.methane_x10 = i % 100000U;
+		acc += (uint32_t)snprintf_report(buf, sizeof(buf), &r);
+	}
+	const uint64_t t2 = test_now_ns();
+
+	printf("report line: fmt %6.1f ns, snprintf %6.1f ns, %.1fx\n", (double)(t1 - t0) / BENCH_ROUNDS,
+		   (double)(t2 - t1) / BENCH_ROUNDS, (double)(t2 - t1) / (t1 - t0));
+	test_sink = acc;
+}
+
+int main(void)
+{
+	test_numbers();
+	test_truncation();
+	test_report();
+	bench();
+	return TEST_EXIT();
+}
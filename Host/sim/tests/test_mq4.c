@@ -0,0 +1,174 @@
+/**
+ * @文件        : test_mq4.c
+ * @描述        : MQ4定点浓度换算与浮点参考公式的误差测试和基准测试
+ * @注意事项    : 对R0的合理范围内的一组取值，遍历全部ADC码值，比较MQ4_ReadPPM_Q16与
+ *                pow/log10参考公式（原MQ4_ReadPPM的实现）的相对误差，并检查饱和与边界
+ *                ADC满量程随ADC_ACQ_OVERSAMPLE_BITS变化，构建时对不同过采样位数各编译一次
+ *                R0通过nvstore桩函数以热启动方式加载，ADC读数由桩函数直接给出
+ */
+
+#include "test.h"
+#include "mq4/mq4.h"
+#include "adc_acq/adc_acq.h"
+#include "nvstore/nvstore.h"
+#include <math.h>
+#include <string.h>
+
+/* 相对误差上限：log2/exp2查表插值各约2e-4，经曲线斜率(1/0.65)放大，实测约4e-4 */
+#define MAX_REL_ERROR 1e-3
+/* 低于此浓度时Q16的量化误差占主导，改为检查绝对误差 */
+#define REL_ERROR_MIN_PPM 1.0
+#define MAX_ABS_ERROR_PPM 1e-3
+#define PPM_SATURATION 65536.0
+#define R0_STEPS 48
+#define BENCH_ROUNDS 2000000
+
+/* 桩函数 ----------------------------------------------------------------------*/
+static uint16_t adc_value;
+static uint32_t stored_r0_q16;
+
+uint32_t HAL_GetTick(void)
+{
+	return 0;
+}
+
+uint16_t ADC_Acq_Get(ADC_Acq_Channel ch)
+{
+	return adc_value;
+}
+
+HAL_StatusTypeDef NVStore_Read(uint8_t key, void *data, uint8_t len)
+{
+	// 记录格式与mq4.c中的MQ4_StoredCalib相同：r0_q16, calib_count, operating_s
+	const uint32_t record[3] = {stored_r0_q16, 1, 0};
+
+	if (key != NVSTORE_KEY_MQ4_R0 || len != sizeof(record))
+		return HAL_ERROR;
+	memcpy(data, record, sizeof(record));
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef NVStore_Write(uint8_t key, const void *data, uint8_t len)
+{
+	return HAL_OK;
+}
+
+/* 测试 ------------------------------------------------------------------------*/
+
+/* 原MQ4_ReadPPM的浮点公式：Rs = RL * (FS - adc) / adc，ppm = 10^((log10(Rs/R0) - 0.74) / -0.65) */
+static double reference_ppm(uint32_t adc, double r0)
+{
+	const double rs = 10.0 * (ADC_ACQ_FULL_SCALE - adc) / adc;
+	return pow(10.0, (log10(rs / r0) - 0.74) / -0.65);
+}
+
+static void load_r0(double r0)
+{
+	stored_r0_q16 = (uint32_t)(r0 * 65536.0);
+	MQ4_Init();
+}
+
+/* 遍历R0和全部ADC码值，统计误差 */
+static void test_accuracy(void)
+{
+	double worst_rel = 0;
+	double worst_abs = 0;
+	unsigned out_of_bounds = 0;
+	unsigned saturation_errors = 0;
+	uint32_t worst_adc = 0;
+	double worst_r0 = 0;
+
+	for (uint32_t step = 0; step < R0_STEPS; step++)
+	{
+		// 0.5KΩ到200KΩ按几何级数取值
+		load_r0(0.5 * pow(400.0, step / (R0_STEPS - 1.0)));
+		CHECK(MQ4_IsWarmStart() && MQ4_GetCalibStatus() == MQ4_CALIB_DONE, "R0 %.3f not loaded", MQ4_GetR0());
+		const double r0 = MQ4_GetR0();
+
+		adc_value = 0;
+		CHECK(MQ4_ReadPPM_Q16() == 0, "adc 0 at R0 %.3f", r0);
+		adc_value = ADC_ACQ_FULL_SCALE;
+		CHECK(MQ4_ReadPPM_Q16() == UINT32_MAX, "adc full scale at R0 %.3f", r0);
+
+		for (uint32_t adc = 1; adc < ADC_ACQ_FULL_SCALE; adc++)
+		{
+			adc_value = (uint16_t)adc;
+			const uint32_t q16 = MQ4_ReadPPM_Q16();
+			const double expected = reference_ppm(adc, r0);
+
+			// 饱和点附近允许误差范围内的任一结果
+			if (q16 == UINT32_MAX || expected >= PPM_SATURATION)
+			{
+				if ((q16 == UINT32_MAX) != (expected >= PPM_SATURATION) &&
+					fabs(expected / PPM_SATURATION - 1.0) > MAX_REL_ERROR)
+					saturation_errors++;
+				continue;
+			}
+
+			const double actual = q16 / 65536.0;
+			if (expected >= REL_ERROR_MIN_PPM)
+			{
+				const double rel = fabs(actual / expected - 1.0);
+				if (rel > worst_rel)
+				{
+					worst_rel = rel;
+					worst_adc = adc;
+					worst_r0 = r0;
+				}
+				out_of_bounds += rel > MAX_REL_ERROR;
+			}
+			else
+			{
+				const double abs_err = fabs(actual - expected);
+				if (abs_err > worst_abs)
+					worst_abs = abs_err;
+				out_of_bounds += abs_err > MAX_ABS_ERROR_PPM;
+			}
+		}
+	}
+
+	CHECK(out_of_bounds == 0, "%u conversions outside the error bounds", out_of_bounds);
+	CHECK(saturation_errors == 0, "%u conversions saturated incorrectly", saturation_errors);
+	printf("full scale %u, R0 %.1f-%.1f KOhm: max relative error %.2e (adc %u, R0 %.3f), "
+		   "max absolute error below %.0f ppm %.2e ppm\n",
+		   ADC_ACQ_FULL_SCALE, 0.5, 200.0, worst_rel, worst_adc, worst_r0, REL_ERROR_MIN_PPM, worst_abs);
+}
+
+/* 校准前读数无效 */
+static void test_uncalibrated(void)
+{
+	stored_r0_q16 = 0; // 超出合理范围，热启动失败
+	MQ4_Init();
+	CHECK(!MQ4_IsWarmStart() && MQ4_GetCalibStatus() != MQ4_CALIB_DONE, "invalid R0 accepted");
+	CHECK(MQ4_ReadPPM() == -1.0f, "reading before calibration %f", MQ4_ReadPPM());
+}
+
+/* 基准测试：定点换算与浮点参考公式每次换算的耗时 */
+static void bench(void)
+{
+	uint32_t acc = 0;
+
+	load_r0(10.0);
+	const uint64_t t0 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+	{
+		adc_value = (uint16_t)(1 + i % (ADC_ACQ_FULL_SCALE - 1));
+		acc += MQ4_ReadPPM_Q16();
+	}
+	const uint64_t t1 = test_now_ns();
+	for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+		acc += (uint32_t)reference_ppm(1 + i % (ADC_ACQ_FULL_SCALE - 1), 10.0);
+	const uint64_t t2 = test_now_ns();
+
+	printf("per conversion: fixed point %.1f ns, pow/log10 %.1f ns\n", (double)(t1 - t0) / BENCH_ROUNDS,
+		   (double)(t2 - t1) / BENCH_ROUNDS);
+	test_sink = acc;
+}
+
+int main(void)
+{
+	test_uncalibrated();
+	test_accuracy();
+	bench();
+	return TEST_EXIT();
+}
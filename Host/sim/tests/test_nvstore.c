@@ -0,0 +1,348 @@
+/**
+ * @文件        : test_nvstore.c
+ * @描述        : Flash键值存储在记录损坏、页标识损坏、掉电和多次整理下的测试
+ * @注意事项    : nvstore.c与模拟器的片内Flash模型（sim_flash.c）链接，使用目标板的NVStore_InternalFlash；
+ *                损坏直接改写映射在0x0803F000的存储区，掉电由包装NVStore_InternalFlash的访问接口模拟：
+ *                操作次数用完后擦写全部失败（半字编程逐个计数，可在记录中途断电），随后重新挂载即为重启
+ */
+
+#include "test.h"
+#include "sim.h"
+#include "nvstore/nvstore.h"
+#include <string.h>
+
+#define PAGE_SIZE 0x800U
+#define STORE ((uint8_t *)0x0803F000U) // 存储区两页
+#define PAGE_HEADER_SIZE 8
+#define RECORD_SIZE(len) (4U + (((uint32_t)(len) + 3U) & ~3U))
+#define KEYS 3
+
+static uint32_t rng_state = 0x2545F491U;
+
+/* xorshift32，固定种子使失败可复现 */
+static uint32_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+/* 掉电模拟：power_ops为剩余的擦除/半字编程次数，小于0表示不断电 */
+static int32_t power_ops = -1;
+static uint32_t ops_used;
+static uint32_t erases;
+
+static HAL_StatusTypeDef cut_erase(uint32_t offset)
+{
+	if (power_ops == 0)
+		return HAL_ERROR;
+	if (power_ops > 0)
+		power_ops--;
+	ops_used++;
+	erases++;
+	return NVStore_InternalFlash.erase(offset);
+}
+
+static HAL_StatusTypeDef cut_program(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+	uint32_t n = len / 2U;
+
+	if (power_ops >= 0 && n > (uint32_t)power_ops)
+		n = (uint32_t)power_ops;
+	if (power_ops > 0)
+		power_ops -= (int32_t)n;
+	ops_used += n;
+	if (n > 0 && NVStore_InternalFlash.program(offset, data, n * 2U) != HAL_OK)
+		return HAL_ERROR;
+	return n * 2U == len ? HAL_OK : HAL_ERROR;
+}
+
+static void cut_read(uint32_t offset, uint8_t *data, uint32_t len)
+{
+	NVStore_InternalFlash.read(offset, data, len);
+}
+
+static const NVStore_FlashOps cut_flash = {PAGE_SIZE, cut_erase, cut_program, cut_read};
+
+/* 各键最后一次成功写入的内容 */
+typedef struct
+{
+	uint8_t len; // 0表示未写入
+	uint8_t data[NVSTORE_MAX_DATA];
+} Expected;
+
+static Expected expected[KEYS];
+
+static uint8_t key_of(uint8_t i)
+{
+	return (uint8_t)(NVSTORE_KEY_MQ4_R0 + i);
+}
+
+/* 擦除存储区并挂载 */
+static void format(void)
+{
+	memset(STORE, 0xFF, 2U * PAGE_SIZE);
+	memset(expected, 0, sizeof(expected));
+	power_ops = -1;
+	erases = 0;
+	CHECK(NVStore_Init(&cut_flash) == HAL_OK, "init on erased flash failed");
+}
+
+/* 重启：以不断电的Flash重新挂载 */
+static void reboot(void)
+{
+	power_ops = -1;
+	CHECK(NVStore_Init(&cut_flash) == HAL_OK, "init failed");
+}
+
+/* 生成第version个版本的内容，不同版本内容不同 */
+static void make_value(Expected *v, uint8_t len, uint32_t version)
+{
+	v->len = len;
+	for (uint8_t i = 0; i < len; i++)
+		v->data[i] = (uint8_t)(version * 7U + i * 13U + len);
+}
+
+static HAL_StatusTypeDef write(uint8_t i, const Expected *v)
+{
+	const HAL_StatusTypeDef status = NVStore_Write(key_of(i), v->data, v->len);
+	if (status == HAL_OK)
+		expected[i] = *v;
+	return status;
+}
+
+static uint8_t matches(uint8_t i, const Expected *v)
+{
+	uint8_t data[NVSTORE_MAX_DATA];
+
+	if (v->len == 0)
+		return NVStore_Read(key_of(i), data, 4) != HAL_OK;
+	return NVStore_Read(key_of(i), data, v->len) == HAL_OK && memcmp(data, v->data, v->len) == 0;
+}
+
+/* 各键读出的内容均为最后一次成功写入的内容 */
+static void check_all(const char *when)
+{
+	for (uint8_t i = 0; i < KEYS; i++)
+		CHECK(matches(i, &expected[i]), "%s: key %u does not read back its last write", when, key_of(i));
+}
+
+/* 页序号较大的有效页 */
+static uint8_t newest_page(void)
+{
+	uint32_t gen[2];
+	for (uint8_t p = 0; p < 2; p++)
+		memcpy(&gen[p], STORE + p * PAGE_SIZE + 4, 4);
+	return (int32_t)(gen[1] - gen[0]) > 0;
+}
+
+/* 两页都没有页标识时格式化，之后照常读写 */
+static void test_invalid_magic(void)
+{
+	Expected v;
+
+	format();
+	check_all("erased flash");
+
+	// 写满一页以上，使两页都有页标识
+	for (uint32_t n = 0; erases < 2; n++)
+	{
+		make_value(&v, 12, n);
+		CHECK(write((uint8_t)(n % KEYS), &v) == HAL_OK, "write %u failed", n);
+	}
+	reboot();
+	check_all("two valid pages");
+
+	STORE[0] ^= 0x01;
+	STORE[PAGE_SIZE + 3] ^= 0x80;
+	reboot();
+	memset(expected, 0, sizeof(expected));
+	check_all("both magics corrupted");
+
+	make_value(&v, 4, 1000);
+	CHECK(write(0, &v) == HAL_OK, "write after reformat failed");
+	reboot();
+	check_all("reformatted store");
+}
+
+/* 最新记录的数据损坏或写到一半：CRC校验失败，读出前一条记录，之后的写入不受影响 */
+static void test_torn_record(void)
+{
+	Expected a, b, c;
+
+	make_value(&a, 8, 1);
+	make_value(&b, 8, 2);
+	make_value(&c, 8, 3);
+
+	// 改写已写入记录的一个数据位
+	format();
+	CHECK(write(0, &a) == HAL_OK, "write failed");
+	CHECK(write(0, &b) == HAL_OK, "write failed");
+	STORE[PAGE_HEADER_SIZE + RECORD_SIZE(8) + 4 + 5] ^= 0x10;
+	reboot();
+	expected[0] = a;
+	check_all("flipped data bit");
+	CHECK(write(0, &c) == HAL_OK, "write after corrupted record failed");
+	reboot();
+	check_all("write after corrupted record");
+
+	// 写入记录头或数据的中途断电
+	for (int32_t cut = 0; cut < (int32_t)RECORD_SIZE(8) / 2; cut++)
+	{
+		format();
+		CHECK(write(0, &a) == HAL_OK, "write failed");
+		power_ops = cut;
+		CHECK(write(0, &b) != HAL_OK, "cut after %d halfwords: write reported success", cut);
+		reboot();
+		check_all("torn record");
+		CHECK(write(0, &c) == HAL_OK, "cut after %d halfwords: next write failed", cut);
+		reboot();
+		check_all("write after torn record");
+	}
+}
+
+/*
+ * 记录的长度字节损坏：无法定位之后的记录，之前的记录照常读出，之后的记录丢失；
+ * 下一次写入把有效记录整理到另一页，此后存储区恢复正常
+ */
+static void test_corrupted_length(void)
+{
+	static const uint8_t bad_lengths[] = {0xEE, NVSTORE_MAX_DATA + 1, 4, 12, 0};
+	Expected a, b, c, d;
+
+	make_value(&a, 4, 1);
+	make_value(&b, 8, 2);
+	make_value(&c, 4, 3);
+	make_value(&d, 8, 4);
+
+	for (uint8_t n = 0; n < sizeof(bad_lengths); n++)
+	{
+		format();
+		CHECK(write(0, &a) == HAL_OK, "write failed");
+		CHECK(write(1, &b) == HAL_OK, "write failed");
+		CHECK(write(0, &c) == HAL_OK, "write failed");
+		STORE[PAGE_HEADER_SIZE + RECORD_SIZE(4) + 1] = bad_lengths[n];
+		reboot();
+
+		// 键0读出a或c（c位于损坏记录之后，长度可能恰好对齐），键1的记录已损坏
+		CHECK(matches(0, &a) || matches(0, &c), "length 0x%02X: key 0 reads neither written value", bad_lengths[n]);
+		expected[1].len = 0;
+		CHECK(matches(1, &expected[1]), "length 0x%02X: corrupted record read back", bad_lengths[n]);
+
+		CHECK(write(1, &d) == HAL_OK, "length 0x%02X: write after corruption failed", bad_lengths[n]);
+		CHECK(matches(1, &d), "length 0x%02X: write after corruption not read back", bad_lengths[n]);
+		CHECK(write(0, &c) == HAL_OK, "length 0x%02X: rewrite failed", bad_lengths[n]);
+		reboot();
+		check_all("after corrupted length");
+	}
+}
+
+/*
+ * 触发整理的写入在每一次擦除/半字编程之后断电：重启后未写入的键保持原值，
+ * 被写入的键为原值或新值；新页完整写入（含页标识）而原页尚未擦除时两页均有效，取序号大的新页
+ */
+static void test_interrupted_compaction(void)
+{
+	static uint8_t snapshot[2 * PAGE_SIZE];
+	Expected before[KEYS], v, next;
+	uint32_t total_ops;
+	uint32_t n;
+
+	format();
+	for (n = 0;; n++)
+	{
+		make_value(&v, 16, n);
+		if (write((uint8_t)(n % KEYS), &v) != HAL_OK)
+			break;
+		if (PAGE_HEADER_SIZE + (n + 2) * RECORD_SIZE(16) > PAGE_SIZE)
+			break;
+	}
+	CHECK(erases == 1, "page filled with %u erases", erases);
+	memcpy(snapshot, STORE, sizeof(snapshot));
+	memcpy(before, expected, sizeof(before));
+	const uint8_t old_page = newest_page();
+
+	// 不断电时完成整理所需的操作次数
+	make_value(&next, 16, 5000);
+	ops_used = 0;
+	CHECK(write(0, &next) == HAL_OK, "compacting write failed");
+	total_ops = ops_used;
+	CHECK(newest_page() != old_page, "write did not compact");
+	CHECK(total_ops > RECORD_SIZE(16) / 2 + 1, "compaction took only %u operations", total_ops);
+
+	for (int32_t cut = 0; cut <= (int32_t)total_ops; cut++)
+	{
+		memcpy(STORE, snapshot, sizeof(snapshot));
+		memcpy(expected, before, sizeof(expected));
+		reboot();
+		power_ops = cut;
+		const HAL_StatusTypeDef status = write(0, &next);
+		CHECK((status == HAL_OK) == (cut == (int32_t)total_ops), "cut after %d of %u operations: status %d", cut,
+			  total_ops, status);
+
+		reboot();
+		for (uint8_t i = 1; i < KEYS; i++)
+			CHECK(matches(i, &before[i]), "cut after %d operations: untouched key %u lost", cut, key_of(i));
+		CHECK(matches(0, &before[0]) || matches(0, &next), "cut after %d operations: key %u reads neither value",
+			  cut, key_of(0));
+
+		// 断电后存储区仍可写入
+		make_value(&v, 16, 6000 + (uint32_t)cut);
+		CHECK(write(2, &v) == HAL_OK, "cut after %d operations: next write failed", cut);
+		expected[0] = matches(0, &next) ? next : before[0];
+		reboot();
+		check_all("after interrupted compaction");
+	}
+
+	// 新页完成、原页保留：两页都有有效页标识，序号大的新页生效
+	memcpy(STORE, snapshot, sizeof(snapshot));
+	memcpy(expected, before, sizeof(expected));
+	reboot();
+	CHECK(write(0, &next) == HAL_OK, "compacting write failed");
+	CHECK(memcmp(STORE + old_page * PAGE_SIZE, snapshot + old_page * PAGE_SIZE, PAGE_SIZE) == 0,
+		  "old page modified by compaction");
+	reboot();
+	check_all("both pages valid");
+}
+
+/* 随机键和长度反复改写，经过多次整理后每个键仍读出最后一次写入的内容 */
+static void test_repeated_rewrites(void)
+{
+	Expected v;
+
+	format();
+	for (uint32_t n = 0; n < 3000; n++)
+	{
+		const uint8_t i = (uint8_t)(rng() % KEYS);
+		make_value(&v, (uint8_t)(1U + rng() % NVSTORE_MAX_DATA), n);
+		CHECK(write(i, &v) == HAL_OK, "write %u failed", n);
+		CHECK(matches(i, &v), "write %u not read back", n);
+		if (n % 97U == 0)
+		{
+			reboot();
+			check_all("periodic reboot");
+		}
+	}
+	reboot();
+	check_all("after rewrites");
+	CHECK(erases >= 20, "only %u page erases in 3000 writes", erases);
+
+	// 内容未变化的写入不占用Flash
+	const uint32_t used = ops_used;
+	CHECK(write(0, &expected[0]) == HAL_OK && ops_used == used, "unchanged value rewritten");
+	printf("repeated rewrites: %u page erases\n", erases);
+}
+
+int main(void)
+{
+	if (Sim_FlashInit(NULL) != 0)
+		return 1;
+
+	test_invalid_magic();
+	test_torn_record();
+	test_corrupted_length();
+	test_interrupted_compaction();
+	test_repeated_rewrites();
+	return TEST_EXIT();
+}
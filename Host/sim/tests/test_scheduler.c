@@ -0,0 +1,201 @@
+/**
+ * @文件        : test_scheduler.c
+ * @描述        : 调度器单元测试：以模拟时钟驱动，检查周期、启动抖动、EDF顺序、
+ *                滞后跳过和32位毫秒计数器回绕
+ * @注意事项    : 任务函数通过推进模拟时钟模拟执行时间，调度器本身不消耗时间
+ */
+
+#include "test.h"
+#include "scheduler/scheduler.h"
+#include <string.h>
+
+#define MAX_RUNS 2048
+
+static uint32_t fake_now; // 模拟毫秒时钟
+
+static uint32_t fake_tick(void)
+{
+	return fake_now;
+}
+
+/* 各任务的执行记录 */
+typedef struct
+{
+	uint32_t exec_ms;		   // 每次执行推进的时间
+	uint32_t starts[MAX_RUNS]; // 各次开始时刻
+	uint32_t runs;
+} TaskLog;
+
+static TaskLog logs[4];
+static char order[64]; // 执行顺序（任务序号'0'-'3'）
+static uint8_t order_len;
+
+static void record(uint8_t id)
+{
+	TaskLog *log = &logs[id];
+
+	if (log->runs < MAX_RUNS)
+		log->starts[log->runs] = fake_now;
+	log->runs++;
+	if (order_len + 1U < sizeof(order))
+		order[order_len++] = (char)('0' + id);
+	fake_now += log->exec_ms;
+}
+
+static void task0(void) { record(0); }
+static void task1(void) { record(1); }
+static void task2(void) { record(2); }
+static void task3(void) { record(3); }
+
+static void reset(uint32_t start)
+{
+	fake_now = start;
+	memset(logs, 0, sizeof(logs));
+	memset(order, 0, sizeof(order));
+	order_len = 0;
+	Scheduler_Init(fake_tick);
+}
+
+/**
+ * @函数名      : run_for
+ * @描述        : 按主循环的方式运行duration毫秒：有到期任务就执行，否则把时钟推进到下一次释放
+ */
+static void run_for(uint32_t duration)
+{
+	const uint32_t end = fake_now + duration;
+
+	while ((int32_t)(end - fake_now) > 0)
+	{
+		if (Scheduler_Dispatch())
+			continue;
+
+		uint32_t wait = Scheduler_TimeToNextRelease();
+		if (wait == 0 || (int32_t)(end - fake_now) < (int32_t)wait)
+			wait = end - fake_now;
+		fake_now += wait;
+	}
+}
+
+/* 任务不超时时，每次都在释放时刻准时启动，周期无漂移 */
+static void test_period(uint32_t start)
+{
+	reset(start);
+	CHECK(Scheduler_AddTask("fast", task0, 100, 0, 0) == 0, "add fast");
+	CHECK(Scheduler_AddTask("slow", task1, 1000, 250, 0) == 1, "add slow");
+
+	run_for(10000);
+
+	CHECK(logs[0].runs == 100, "fast ran %u times", logs[0].runs);
+	CHECK(logs[1].runs == 10, "slow ran %u times", logs[1].runs);
+	for (uint32_t i = 0; i < logs[0].runs; i++)
+		CHECK(logs[0].starts[i] == start + i * 100, "fast run %u at +%u", i, logs[0].starts[i] - start);
+	for (uint32_t i = 0; i < logs[1].runs; i++)
+		CHECK(logs[1].starts[i] == start + 250 + i * 1000, "slow run %u at +%u", i, logs[1].starts[i] - start);
+
+	const Scheduler_Task *fast = Scheduler_GetTask(0);
+	CHECK(fast->max_latency_ms == 0, "fast latency %u", fast->max_latency_ms);
+	CHECK(fast->deadline_misses == 0 && fast->skipped == 0, "fast misses %u skipped %u",
+		  fast->deadline_misses, fast->skipped);
+}
+
+/*
+ * 协作式调度不能抢占：快任务的启动抖动不超过其他任务的最长执行时间，
+ * 且释放时刻按周期累加，抖动不会累积成周期漂移
+ */
+static void test_jitter(void)
+{
+	reset(0);
+	logs[1].exec_ms = 8;
+	logs[2].exec_ms = 7;
+	Scheduler_AddTask("fast", task0, 10, 0, 0);
+	Scheduler_AddTask("block", task1, 1000, 5, 0);
+	Scheduler_AddTask("medium", task2, 250, 7, 0);
+
+	run_for(20000);
+
+	CHECK(logs[0].runs == 2000, "fast ran %u times", logs[0].runs);
+	uint32_t max_jitter = 0;
+	for (uint32_t i = 0; i < logs[0].runs && i < MAX_RUNS; i++)
+	{
+		const uint32_t jitter = logs[0].starts[i] - i * 10;
+		if (jitter > max_jitter)
+			max_jitter = jitter;
+	}
+	CHECK(max_jitter > 0 && max_jitter <= 8, "fast jitter %u ms", max_jitter);
+	CHECK(Scheduler_GetTask(0)->max_latency_ms == max_jitter, "latency stat %u vs %u",
+		  Scheduler_GetTask(0)->max_latency_ms, max_jitter);
+	CHECK(Scheduler_GetTask(0)->skipped == 0, "fast skipped %u", Scheduler_GetTask(0)->skipped);
+	CHECK(Scheduler_GetTask(0)->deadline_misses == 0, "fast misses %u", Scheduler_GetTask(0)->deadline_misses);
+	CHECK(logs[1].runs == 20, "block ran %u times", logs[1].runs);
+	CHECK(Scheduler_GetTask(1)->max_exec_ms == 8, "block exec %u", Scheduler_GetTask(1)->max_exec_ms);
+	CHECK(logs[2].runs == 80, "medium ran %u times", logs[2].runs);
+}
+
+/* 同时到期的任务按绝对截止时间从早到晚执行，与注册顺序无关 */
+static void test_edf_order(void)
+{
+	reset(0);
+	Scheduler_AddTask("d50", task0, 1000, 10, 50);
+	Scheduler_AddTask("d5", task1, 1000, 10, 5);
+	Scheduler_AddTask("d20", task2, 1000, 10, 20);
+	Scheduler_AddTask("late", task3, 1000, 0, 100); // 更早释放但截止时间最晚
+
+	fake_now = 10;
+	while (Scheduler_Dispatch())
+		;
+
+	CHECK(strcmp(order, "1203") == 0, "order %s", order);
+}
+
+/* 任务执行超过一个周期后丢弃错过的释放，不连续补跑 */
+static void test_overrun_skips(void)
+{
+	reset(0);
+	Scheduler_AddTask("victim", task0, 10, 0, 0);
+	Scheduler_AddTask("hog", task1, 1000, 100, 0);
+	logs[1].exec_ms = 55;
+
+	run_for(200);
+
+	const Scheduler_Task *victim = Scheduler_GetTask(0);
+	CHECK(victim->skipped == 3, "victim skipped %u", victim->skipped);
+	CHECK(victim->deadline_misses == 1, "victim misses %u", victim->deadline_misses);
+	CHECK(Scheduler_GetTask(1)->deadline_misses == 0, "hog misses %u", Scheduler_GetTask(1)->deadline_misses);
+
+	// 阻塞在155结束：补跑最早错过的110和当前周期的150，110之后的120-140被跳过，
+	// 之后回到原来的10ms网格
+	uint32_t after = 0;
+	while (after < logs[0].runs && logs[0].starts[after] < 155)
+		after++;
+	CHECK(after + 2 < logs[0].runs, "only %u runs", logs[0].runs);
+	CHECK(logs[0].starts[after] == 155 && logs[0].starts[after + 1] == 155 && logs[0].starts[after + 2] == 160,
+		  "runs after hog at %u, %u, %u", logs[0].starts[after], logs[0].starts[after + 1],
+		  logs[0].starts[after + 2]);
+}
+
+/* 参数检查和任务表容量 */
+static void test_add_task_limits(void)
+{
+	reset(0);
+	CHECK(Scheduler_AddTask("zero", task0, 0, 0, 0) == -1, "period 0 accepted");
+	CHECK(Scheduler_AddTask("null", NULL, 10, 0, 0) == -1, "NULL fn accepted");
+	for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; i++)
+		CHECK(Scheduler_AddTask("t", task0, 10, 0, 0) == (int8_t)i, "task %u rejected", i);
+	CHECK(Scheduler_AddTask("full", task0, 10, 0, 0) == -1, "table overflow accepted");
+	CHECK(Scheduler_GetTaskCount() == SCHEDULER_MAX_TASKS, "count %u", Scheduler_GetTaskCount());
+	CHECK(Scheduler_GetTask(SCHEDULER_MAX_TASKS) == NULL, "out of range task");
+
+	Scheduler_Init(NULL);
+	CHECK(Scheduler_AddTask("no clock", task0, 10, 0, 0) == -1, "accepted without tick source");
+}
+
+int main(void)
+{
+	test_period(0);
+	test_period(0xFFFFF000U); // 运行期间毫秒计数器回绕
+	test_jitter();
+	test_edf_order();
+	test_overrun_skips();
+	test_add_task_limits();
+	return TEST_EXIT();
+}
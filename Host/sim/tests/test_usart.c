@@ -0,0 +1,230 @@
+/**
+ * @文件        : test_usart.c
+ * @描述        : 串口非阻塞发送通道（环形缓冲区+DMA）的顺序与溢出测试
+ * @注意事项    : usart.c与模拟器的UART DMA模型（sim_uart.c）及虚拟时钟（sim_core.c）链接，
+ *                DMA按115200波特率的发送时间在虚拟时钟上完成；发出的字节捕获到临时文件，
+ *                与成功入队的消息按顺序拼接的结果逐字节比较
+ */
+
+#include "test.h"
+#include "sim.h"
+#include "usart.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RANDOM_MESSAGES 3000
+#define MAX_MESSAGE 160
+#define STREAM_MAX (RANDOM_MESSAGES * MAX_MESSAGE)
+
+/* 模拟器之外运行时没有主循环可以退出，直接记为失败 */
+void Error_Handler(void)
+{
+	CHECK(0, "Error_Handler called");
+}
+
+static uint32_t rng_state = 0x9E3779B9U;
+
+/* xorshift32，固定种子使失败可复现 */
+static uint32_t rng(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static FILE *capture;
+static uint8_t expected[STREAM_MAX];
+static uint32_t expected_len;
+static uint32_t bytes_sent_base; // 本项测试开始时的bytes_sent
+static uint32_t message_no;
+
+/* 生成一条消息：内容由消息编号和字节位置决定，错位、重复或丢失都会改变输出 */
+static void make_message(uint8_t *msg, uint16_t len)
+{
+	for (uint16_t i = 0; i < len; i++)
+		msg[i] = (uint8_t)(message_no * 31U + i);
+	message_no++;
+}
+
+/* 入队并记录成功入队的内容 */
+static HAL_StatusTypeDef enqueue(const uint8_t *msg, uint16_t len)
+{
+	const HAL_StatusTypeDef status = UART_TxEnqueue(&huart1, msg, len);
+	if (status == HAL_OK)
+	{
+		memcpy(&expected[expected_len], msg, len);
+		expected_len += len;
+	}
+	return status;
+}
+
+/* 推进虚拟时间直到发送缓冲区清空 */
+static void drain(void)
+{
+	for (uint32_t ms = 0; UART_TxPending(&huart1) != 0 && ms < 10000; ms++)
+		Sim_Charge((uint32_t)SIM_MS(1));
+	CHECK(UART_TxPending(&huart1) == 0, "%u bytes never sent", UART_TxPending(&huart1));
+}
+
+static void open_capture(void)
+{
+	capture = tmpfile();
+	if (capture == NULL)
+	{
+		perror("tmpfile");
+		exit(1);
+	}
+	Sim_UartCapture(USART1, capture);
+	expected_len = 0;
+	bytes_sent_base = UART_TxGetStats(&huart1)->bytes_sent;
+}
+
+/* 捕获文件的内容与成功入队的消息按顺序拼接的结果一致 */
+static void check_stream(const char *name)
+{
+	static uint8_t sent[STREAM_MAX];
+
+	fflush(capture);
+	const long size = ftell(capture);
+	rewind(capture);
+	const size_t n = fread(sent, 1, sizeof(sent), capture);
+	const uint32_t bytes_sent = UART_TxGetStats(&huart1)->bytes_sent - bytes_sent_base;
+
+	CHECK(size == (long)expected_len && n == expected_len, "%s: sent %ld bytes, expected %u", name, size,
+		  expected_len);
+	uint32_t first_diff = 0;
+	while (first_diff < n && first_diff < expected_len && sent[first_diff] == expected[first_diff])
+		first_diff++;
+	CHECK(first_diff == expected_len, "%s: stream differs at byte %u", name, first_diff);
+	CHECK(bytes_sent == expected_len, "%s: bytes_sent %u, expected %u", name, bytes_sent, expected_len);
+
+	// 下一项测试从空的捕获文件开始
+	fclose(capture);
+	open_capture();
+}
+
+/* 单条消息入队后立即由DMA发出 */
+static void test_single(void)
+{
+	static const char hello[] = "[STM32] hello\r\n";
+	UART_HandleTypeDef other = {0};
+
+	CHECK(UART_TxEnqueueStr(&huart1, hello) == HAL_OK, "enqueue rejected");
+	memcpy(expected, hello, sizeof(hello) - 1);
+	expected_len = sizeof(hello) - 1;
+	CHECK(huart1.gState == HAL_UART_STATE_BUSY_TX, "DMA not started");
+	CHECK(UART_TxEnqueue(&huart1, (const uint8_t *)hello, 0) == HAL_OK, "empty message rejected");
+	CHECK(UART_TxEnqueue(&other, (const uint8_t *)hello, 1) == HAL_ERROR, "unknown UART accepted");
+	drain();
+	check_stream("single");
+}
+
+/*
+ * DMA发送期间随机长度的消息背靠背入队，间隔随机：缓冲区多次回绕，部分消息因空间不足被丢弃，
+ * 发出的字节流须与成功入队的消息按序拼接一致，统计计数与丢弃的消息对应
+ */
+static void test_order_across_wrap(void)
+{
+	const UART_TxStats before = *UART_TxGetStats(&huart1);
+	uint8_t msg[MAX_MESSAGE];
+	uint32_t dropped = 0;
+	uint32_t dropped_bytes = 0;
+	uint32_t while_busy = 0;
+	uint16_t high_water = before.high_water;
+
+	for (uint32_t i = 0; i < RANDOM_MESSAGES; i++)
+	{
+		const uint16_t len = (uint16_t)(1 + rng() % MAX_MESSAGE);
+		const uint16_t used = UART_TxPending(&huart1);
+
+		make_message(msg, len);
+		while_busy += huart1.gState == HAL_UART_STATE_BUSY_TX;
+		if (enqueue(msg, len) == HAL_OK)
+		{
+			if (used + len > high_water)
+				high_water = (uint16_t)(used + len);
+		}
+		else
+		{
+			CHECK(used + len > UART_TX_BUF_SIZE, "message %u of %u bytes dropped with %u bytes used", i, len,
+				  used);
+			dropped++;
+			dropped_bytes += len;
+		}
+
+		// 平均间隔略短于一条消息的发送时间（每字节约87us，平均约7ms），缓冲区时满时空；
+		// 四分之一的消息紧接上一条入队
+		if (rng() % 4 != 0)
+			Sim_Charge((uint32_t)SIM_US(rng() % 16000));
+	}
+	drain();
+
+	const UART_TxStats *after = UART_TxGetStats(&huart1);
+	CHECK(while_busy > RANDOM_MESSAGES / 2, "only %u enqueues during an active DMA transfer", while_busy);
+	CHECK(dropped > 0 && dropped < RANDOM_MESSAGES / 2, "%u of %u messages dropped", dropped, RANDOM_MESSAGES);
+	CHECK(expected_len > 20 * UART_TX_BUF_SIZE, "only %u bytes sent, ring barely wrapped", expected_len);
+	CHECK(after->overflow_count - before.overflow_count == dropped, "overflow_count %u, expected %u",
+		  after->overflow_count - before.overflow_count, dropped);
+	CHECK(after->dropped_bytes - before.dropped_bytes == dropped_bytes, "dropped_bytes %u, expected %u",
+		  after->dropped_bytes - before.dropped_bytes, dropped_bytes);
+	CHECK(after->high_water == high_water, "high_water %u, expected %u", after->high_water, high_water);
+	printf("wrap: %u messages, %u enqueued during DMA, %u dropped, %u bytes sent (%u ring wraps)\n",
+		   RANDOM_MESSAGES, while_busy, dropped, expected_len, expected_len / UART_TX_BUF_SIZE);
+	check_stream("wrap");
+}
+
+/*
+ * 放不下的消息整条丢弃：DMA正在发送300字节时，缓冲区只剩212字节，
+ * 200字节的消息入队后13字节的消息被丢弃，之后恰好12字节的消息仍能入队
+ */
+static void test_overflow_drops_whole_message(void)
+{
+	uint8_t a[300], b[200], c[13], d[12], big[UART_TX_BUF_SIZE + 1];
+
+	make_message(a, sizeof(a));
+	make_message(b, sizeof(b));
+	make_message(c, sizeof(c));
+	make_message(d, sizeof(d));
+	make_message(big, sizeof(big));
+
+	const UART_TxStats before = *UART_TxGetStats(&huart1);
+	CHECK(UART_TxPending(&huart1) == 0, "ring not empty");
+
+	CHECK(enqueue(a, sizeof(a)) == HAL_OK, "a rejected");
+	CHECK(huart1.gState == HAL_UART_STATE_BUSY_TX, "DMA not started");
+	CHECK(enqueue(b, sizeof(b)) == HAL_OK, "b rejected");
+	CHECK(enqueue(c, sizeof(c)) == HAL_BUSY, "c accepted with 12 bytes free");
+	CHECK(UART_TxPending(&huart1) == 500, "pending %u after a dropped message", UART_TxPending(&huart1));
+	CHECK(enqueue(d, sizeof(d)) == HAL_OK, "d rejected although it fits exactly");
+	CHECK(UART_TxPending(&huart1) == UART_TX_BUF_SIZE, "pending %u", UART_TxPending(&huart1));
+
+	const UART_TxStats *s = UART_TxGetStats(&huart1);
+	CHECK(s->overflow_count == before.overflow_count + 1, "overflow_count +%u",
+		  s->overflow_count - before.overflow_count);
+	CHECK(s->dropped_bytes == before.dropped_bytes + sizeof(c), "dropped_bytes +%u",
+		  s->dropped_bytes - before.dropped_bytes);
+	CHECK(s->high_water == UART_TX_BUF_SIZE, "high_water %u", s->high_water);
+	drain();
+
+	// 比整个缓冲区还长的消息在空缓冲区上也整条丢弃
+	CHECK(enqueue(big, sizeof(big)) == HAL_BUSY, "message larger than the ring accepted");
+	CHECK(UART_TxPending(&huart1) == 0 && huart1.gState == HAL_UART_STATE_READY, "partial message queued");
+	CHECK(s->overflow_count == before.overflow_count + 2, "overflow_count +%u",
+		  s->overflow_count - before.overflow_count);
+	CHECK(s->dropped_bytes == before.dropped_bytes + sizeof(c) + sizeof(big), "dropped_bytes +%u",
+		  s->dropped_bytes - before.dropped_bytes);
+
+	check_stream("overflow");
+}
+
+int main(void)
+{
+	MX_USART1_UART_Init();
+	open_capture();
+
+	test_single();
+	test_order_across_wrap();
+	test_overflow_drops_whole_message();
+	return TEST_EXIT();
+}
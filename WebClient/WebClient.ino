@@ -11,16 +11,148 @@ const int targetPort = 9091;                 // 目标端口
 #define DEBUG_BAUDRATE   115200    // 调试串口波特率
 #define DATA_TIMEOUT     30000     // STM32数据接收超时（30秒）
 
+// ===== 二进制遥测帧（布局见 Core/Src/telemetry/telemetry.h） =====
+#define FRAME_SYNC0      0xA5
+#define FRAME_SYNC1      0x5A
+#define FRAME_VERSION    1
+#define FRAME_SIZE       32
+
+// ===== 存储转发日志 =====
+// 收到的每个二进制帧先按日志序号存入RAM环形日志，再发往服务器；Wi-Fi断开期间的记录
+// 保留为待补发，重连后限速补发，服务器也可按序号区间请求重发
+//
+// 发往服务器的记录报文（小端字节序），一个报文携带1至BATCH_MAX_RECORDS条记录：
+//   偏移  长度  字段
+//   0     2     'S' 'F'
+//   2     1     版本 (LOG_VERSION)
+//   3     1     标志 (LOG_FLAG_*)
+//   4     2     启动ID（每次上电随机，日志序号在同一启动ID内连续）
+//   6     1     记录条数
+//   7     1     保留，填0
+//   8     40*n  记录：日志序号(4)，在本机已存放的毫秒数(4)，遥测帧原文(32)
+// 服务器的补发请求：'S' 'Q'，启动ID(2)，起始序号(4)，条数(2)
+#define LOG_CAPACITY        256     // 环形日志容量（条），1Hz上报约保存4分钟
+#define LOG_VERSION         2
+#define LOG_FLAG_REPLAY     0x01    // 补发的记录
+#define LOG_HEADER_SIZE     8
+#define LOG_RECORD_SIZE     (8 + FRAME_SIZE)
+#define LOG_REQUEST_SIZE    10
+#define BATCH_MAX_RECORDS   8       // 单个报文最多携带的记录数（报文328字节）
+#define REPLAY_BURST        4       // 每次补发的最大条数，合并为一个报文
+#define REPLAY_INTERVAL     100     // 补发间隔（毫秒），约40条/秒，不挤占实时转发
+
+// ===== 实时转发合并 =====
+// 实时记录凑满COALESCE_RECORDS条或最早一条等待超过COALESCE_TIMEOUT毫秒后合并为一个报文发送；
+// COALESCE_RECORDS为1时每条记录立即单独发送。提高采样率或多设备时可增大以减少报文数
+#define COALESCE_RECORDS    1       // 1 ~ BATCH_MAX_RECORDS
+#define COALESCE_TIMEOUT    2000    // 毫秒
+
+#if COALESCE_RECORDS < 1 || COALESCE_RECORDS > BATCH_MAX_RECORDS || REPLAY_BURST > BATCH_MAX_RECORDS
+#error "COALESCE_RECORDS和REPLAY_BURST不能超过BATCH_MAX_RECORDS"
+#endif
+
+struct LogSlot {
+  uint32_t rxTime;                  // 收到时刻（millis）
+  bool pending;                     // 尚未成功发出
+  uint8_t frame[FRAME_SIZE];
+};
+
+LogSlot logSlots[LOG_CAPACITY];
+uint32_t logNext = 0;               // 下一条记录的日志序号
+uint32_t replayCursor = 0;          // 此序号之前没有待补发的记录
+uint32_t liveStart = 0;             // 等待合并发送的实时记录起始序号，至logNext为止
+unsigned long liveTime = 0;         // 最早一条等待合并的记录的收到时刻
+uint8_t batchBuf[LOG_HEADER_SIZE + BATCH_MAX_RECORDS * LOG_RECORD_SIZE];
+uint16_t bootId = 0;
+uint32_t deviceId = 0;              // 本机设备ID，取自MAC地址低4字节，STM32未设置设备ID时填入帧中
+
+// ===== 文本行接收 =====
+#define RX_CHUNK_SIZE       64      // 每次从串口批量读出的最大字节数
+#define LINE_BUFFER_SIZE    192     // 文本行最大长度（不含换行），超长的行被丢弃
+
+char lineBuf[LINE_BUFFER_SIZE];
+size_t lineLen = 0;
+bool lineOverflow = false;          // 当前行已超长，丢弃到下一个\n
+bool lineGarbled = false;           // 当前行混入了帧数据，丢弃到下一个\n
+uint32_t linesForwarded = 0;        // 已转发的文本行
+uint32_t linesDropped = 0;          // 因网络不可用丢弃的文本行
+uint32_t linesOversized = 0;        // 因超长丢弃的文本行
+uint32_t linesGarbled = 0;          // 含非ASCII字节或被帧打断而丢弃的文本行
+
+// ===== 二进制帧接收 =====
+// STM32背靠背发送帧，帧之间没有分隔符；任一字节丢失或出错时，在已缓冲的字节中查找下一个同步字重新对齐
+uint8_t frameBuf[FRAME_SIZE];
+size_t frameLen = 0;                // 已接收的帧字节数
+uint32_t framesBad = 0;             // 版本/长度或CRC不符而丢弃的帧
+
+// ===== Wi-Fi连接状态机 =====
+// 连接、断线和重试均由事件与millis计时驱动，loop()不会阻塞，断网期间串口照常接收并存入日志
+#define SERIAL_RX_BUFFER    1024    // 串口接收缓冲区，覆盖主循环最长停顿
+#define CONNECT_TIMEOUT     15000   // 单次连接尝试的超时（毫秒）
+#define BACKOFF_MIN         1000    // 首次重试等待（毫秒），之后每次失败加倍
+#define BACKOFF_MAX         30000   // 重试等待上限（毫秒）
+#define STATUS_INTERVAL     60000   // 状态统计输出间隔（毫秒）
+
+enum LinkState {
+  LINK_CONNECTING,                  // 已调用WiFi.begin，等待获取IP
+  LINK_UP,                          // 已连接
+  LINK_BACKOFF,                     // 等待下一次重试
+};
+
+LinkState linkState = LINK_BACKOFF;
+volatile bool linkGotIp = false;    // 事件回调置位，由serviceWiFi处理
+volatile bool linkLost = false;
+WiFiEventHandler gotIpHandler;
+WiFiEventHandler disconnectedHandler;
+unsigned long linkStateTime = 0;    // 进入当前状态的时刻
+unsigned long backoffDelay = 0;     // 当前的重试等待基数，每次失败加倍
+unsigned long backoffWait = 0;      // 本次重试等待（含抖动）
+bool everConnected = false;
+unsigned long linkDownTime = 0;     // 本次断线的开始时刻
+uint32_t reconnectCount = 0;        // 断线后重连成功的次数
+uint32_t connectAttempts = 0;       // WiFi.begin调用次数
+unsigned long downtimeTotal = 0;    // 累计断线时长（毫秒，不含启动时的首次连接）
+unsigned long downtimeMax = 0;      // 最长一次断线（毫秒）
+
 WiFiUDP udp;
 unsigned long lastDataTime = 0;
+unsigned long lastStatusTime = 0;
+unsigned long lastReplayTime = 0;
+
+// ===== 函数声明（Arduino IDE会自动生成，显式声明使草图也能作为普通C++编译，见Host/esp8266） =====
+void startWiFi();
+void beginConnect();
+void enterBackoff();
+void serviceWiFi();
+void printStatus();
+uint16_t frameCrc16(const uint8_t* data, size_t len);
+void stampDeviceId(uint8_t* frame);
+bool forwardPacket(const char* data, size_t len);
+bool sendLogRecords(const uint32_t* seqs, uint8_t count, uint8_t flags);
+void flushLive();
+void logFrame(const uint8_t* frame);
+void pollLive();
+void replayPending();
+void processServerRequests();
+bool framePrefixValid();
+void frameResync();
+bool handleFrameByte(uint8_t c);
+void handleLine();
+void processSTM32Data();
 
 void setup() {
+  Serial.setRxBufferSize(SERIAL_RX_BUFFER);
   Serial.begin(DEBUG_BAUDRATE);
   delay(1000);
   Serial.println("\n[ESP8266] 通信模块启动");
+  bootId = (uint16_t)ESP.random();
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  deviceId = (uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+  Serial.printf("设备ID: %08x\n", deviceId);
 
-  // 1. 连接Wi-Fi
-  connectWiFi();
+  // 1. 开始连接Wi-Fi，连接过程在loop()中推进
+  startWiFi();
 
   // 2. 初始化UDP
   udp.begin(0);
@@ -31,86 +163,466 @@ void loop() {
   // === 任务1：处理STM32数据 ===
   processSTM32Data();
 
-  // === 任务2：监控Wi-Fi连接 ===
-  checkWiFi();
+  // === 任务2：推进Wi-Fi连接状态机 ===
+  serviceWiFi();
 
+  // === 任务3：处理服务器的补发请求，发送合并的实时记录并限速补发 ===
+  processServerRequests();
+  pollLive();
+  replayPending();
+
+  printStatus();
   delay(10);
 }
 
 // ===== 功能函数 =====
 
 /**
- * 连接Wi-Fi网络
+ * 初始化Wi-Fi：注册连接事件并发起首次连接
+ * 自动重连由状态机接管，避免与SDK的重连相互干扰
+ */
+void startWiFi() {
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  gotIpHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP&) {
+    linkGotIp = true;
+  });
+  disconnectedHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected&) {
+    linkLost = true;
+  });
+
+  linkDownTime = millis();
+  beginConnect();
+}
+
+/**
+ * 发起一次连接尝试
  */
-void connectWiFi() {
-  Serial.print("正在连接Wi-Fi: " + String(ssid));
+void beginConnect() {
+  Serial.println("正在连接Wi-Fi: " + String(ssid));
+  linkGotIp = false;
+  linkLost = false;
+  connectAttempts++;
   WiFi.begin(ssid, password);
+  linkState = LINK_CONNECTING;
+  linkStateTime = millis();
+}
 
-  unsigned long startTime = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - startTime < 10000) {
-    delay(500);
-    Serial.print(".");
+/**
+ * 进入重试等待：等待时间按失败次数指数增长，并加入0~25%的随机抖动，避免多台设备同时重连
+ */
+void enterBackoff() {
+  backoffDelay = backoffDelay == 0 ? BACKOFF_MIN : backoffDelay * 2;
+  if (backoffDelay > BACKOFF_MAX) {
+    backoffDelay = BACKOFF_MAX;
   }
+  backoffWait = backoffDelay + ESP.random() % (backoffDelay / 4 + 1);
+  Serial.printf("Wi-Fi重试等待%lums\n", backoffWait);
+  linkState = LINK_BACKOFF;
+  linkStateTime = millis();
+}
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n连接成功! IP地址: " + WiFi.localIP().toString());
-  } else {
-    Serial.println("\n连接失败! 进入重试模式...");
-    while (1) {
-      delay(1000);
-      if (WiFi.status() == WL_CONNECTED) break;
-      Serial.print(".");
+/**
+ * 推进Wi-Fi连接状态机，每次调用只做检查，不等待
+ */
+void serviceWiFi() {
+  unsigned long now = millis();
+
+  switch (linkState) {
+    case LINK_CONNECTING:
+      if (linkGotIp && WiFi.status() == WL_CONNECTED) {
+        unsigned long down = now - linkDownTime;
+        if (everConnected) {
+          reconnectCount++;
+          downtimeTotal += down;
+          if (down > downtimeMax) downtimeMax = down;
+        }
+        everConnected = true;
+        Serial.println("连接成功! IP地址: " + WiFi.localIP().toString() + " 断线" + String(down) + "ms");
+        backoffDelay = 0;
+        // 连接过程中SDK的认证/关联重试也会产生Disconnected事件，进入LINK_UP时清除，之后的事件才表示断线
+        linkGotIp = false;
+        linkLost = false;
+        linkState = LINK_UP;
+        linkStateTime = now;
+      } else if (now - linkStateTime > CONNECT_TIMEOUT) {
+        Serial.println("连接超时");
+        WiFi.disconnect();
+        enterBackoff();
+      }
+      break;
+
+    case LINK_UP:
+      if (linkLost || WiFi.status() != WL_CONNECTED) {
+        Serial.println("\nWi-Fi断开，数据暂存日志，稍后重连...");
+        linkDownTime = now;
+        enterBackoff();
+      }
+      break;
+
+    case LINK_BACKOFF:
+      if (now - linkStateTime >= backoffWait) {
+        beginConnect();
+      }
+      break;
+  }
+}
+
+/**
+ * 定期输出连接、日志和文本行统计
+ */
+void printStatus() {
+  if (millis() - lastStatusTime < STATUS_INTERVAL) {
+    return;
+  }
+  lastStatusTime = millis();
+
+  unsigned long down = linkState == LINK_UP ? 0 : millis() - linkDownTime;
+  Serial.printf("[状态] Wi-Fi %s，重连%u次，尝试%u次，累计断线%lums，最长%lums，当前断线%lums\n",
+                linkState == LINK_UP ? "已连接" : "未连接", reconnectCount, connectAttempts,
+                downtimeTotal, downtimeMax, down);
+  Serial.printf("[状态] 日志序号%u，补发进度%u，损坏帧%u；文本行：转发%u，丢弃%u，超长%u，损坏%u\n",
+                logNext, replayCursor, framesBad, linesForwarded, linesDropped, linesOversized, linesGarbled);
+}
+
+/**
+ * 计算CRC16-CCITT（多项式0x1021，初值0xFFFF），与STM32端一致
+ */
+uint16_t frameCrc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
     }
   }
+  return crc;
 }
 
 /**
- * 处理STM32数据
+ * STM32未设置设备ID（帧中为0）时填入本机设备ID并重新计算CRC
  */
-void processSTM32Data() {
-  static String buffer; // 静态缓冲区处理数据分片
-
-  while (Serial.available() > 0) {
-    char c = Serial.read();
-    buffer += c;
-
-    // 检测到换行符（STM32数据结束标志）
-    if (c == '\n') {
-      buffer.trim(); // 去除首尾空白（包括\r）
-
-      if (buffer.length() > 0) {
-        // 转发数据到UDP服务器
-        udp.beginPacket(targetIPStr, targetPort);
-        udp.write(buffer.c_str());
-        udp.endPacket();
-        
-        Serial.println("[数据转发] " + buffer);
-        lastDataTime = millis(); // 更新最后接收时间
-      }
-      buffer = ""; // 清空缓冲区
+void stampDeviceId(uint8_t* frame) {
+  if (frame[6] | frame[7] | frame[8] | frame[9]) {
+    return;
+  }
+  frame[6] = (uint8_t)deviceId;
+  frame[7] = (uint8_t)(deviceId >> 8);
+  frame[8] = (uint8_t)(deviceId >> 16);
+  frame[9] = (uint8_t)(deviceId >> 24);
+  uint16_t crc = frameCrc16(frame, FRAME_SIZE - 2);
+  frame[FRAME_SIZE - 2] = (uint8_t)crc;
+  frame[FRAME_SIZE - 1] = (uint8_t)(crc >> 8);
+}
+
+/**
+ * 转发一帧数据到UDP服务器
+ * @return 是否成功交给网络协议栈
+ */
+bool forwardPacket(const char* data, size_t len) {
+  if (WiFi.status() != WL_CONNECTED || !udp.beginPacket(targetIPStr, targetPort)) {
+    return false;
+  }
+  udp.write((const uint8_t*)data, len);
+  return udp.endPacket() == 1;
+}
+
+/**
+ * 将若干条日志记录打包为一个记录报文发送
+ * @return 是否成功交给网络协议栈
+ */
+bool sendLogRecords(const uint32_t* seqs, uint8_t count, uint8_t flags) {
+  uint8_t* p = batchBuf;
+  *p++ = 'S';
+  *p++ = 'F';
+  *p++ = LOG_VERSION;
+  *p++ = flags;
+  *p++ = (uint8_t)bootId;
+  *p++ = (uint8_t)(bootId >> 8);
+  *p++ = count;
+  *p++ = 0;
+
+  for (uint8_t i = 0; i < count; i++) {
+    const LogSlot& slot = logSlots[seqs[i] % LOG_CAPACITY];
+    uint32_t seq = seqs[i];
+    uint32_t age = millis() - slot.rxTime;
+    *p++ = (uint8_t)seq;
+    *p++ = (uint8_t)(seq >> 8);
+    *p++ = (uint8_t)(seq >> 16);
+    *p++ = (uint8_t)(seq >> 24);
+    *p++ = (uint8_t)age;
+    *p++ = (uint8_t)(age >> 8);
+    *p++ = (uint8_t)(age >> 16);
+    *p++ = (uint8_t)(age >> 24);
+    memcpy(p, slot.frame, FRAME_SIZE);
+    p += FRAME_SIZE;
+  }
+
+  if (WiFi.status() != WL_CONNECTED || !udp.beginPacket(targetIPStr, targetPort)) {
+    return false;
+  }
+  udp.write(batchBuf, p - batchBuf);
+  return udp.endPacket() == 1;
+}
+
+/**
+ * 发送等待合并的实时记录，失败时记录保留为待补发
+ */
+void flushLive() {
+  uint32_t seqs[BATCH_MAX_RECORDS];
+  uint8_t count = 0;
+
+  for (uint32_t seq = liveStart; seq < logNext; seq++) {
+    seqs[count++] = seq;
+  }
+  liveStart = logNext;
+  if (count > 0 && sendLogRecords(seqs, count, 0)) {
+    for (uint8_t i = 0; i < count; i++) {
+      logSlots[seqs[i] % LOG_CAPACITY].pending = false;
     }
   }
+}
 
-  // 检测数据超时
-  if (millis() - lastDataTime > DATA_TIMEOUT) {
-    Serial.println("[警告] 超过30秒未收到STM32数据！");
-    lastDataTime = millis();
+/**
+ * 将一帧存入环形日志并加入实时发送，发送失败时保留为待补发
+ * 日志满时覆盖最旧的记录
+ */
+void logFrame(const uint8_t* frame) {
+  uint32_t seq = logNext++;
+  LogSlot& slot = logSlots[seq % LOG_CAPACITY];
+
+  slot.rxTime = millis();
+  slot.pending = true;
+  memcpy(slot.frame, frame, FRAME_SIZE);
+
+  if (seq == liveStart) {
+    liveTime = slot.rxTime;
+  }
+  if (logNext - liveStart >= COALESCE_RECORDS || WiFi.status() != WL_CONNECTED) {
+    flushLive();
+  }
+}
+
+/**
+ * 合并等待超时后发送实时记录
+ */
+void pollLive() {
+  if (liveStart != logNext && millis() - liveTime >= COALESCE_TIMEOUT) {
+    flushLive();
+  }
+}
+
+/**
+ * 限速补发待发送的记录：每REPLAY_INTERVAL毫秒将最多REPLAY_BURST条合并为一个报文，从最旧的开始
+ * 等待合并的实时记录不参与补发
+ */
+void replayPending() {
+  if (WiFi.status() != WL_CONNECTED || millis() - lastReplayTime < REPLAY_INTERVAL) {
+    return;
+  }
+  lastReplayTime = millis();
+
+  uint32_t oldest = logNext > LOG_CAPACITY ? logNext - LOG_CAPACITY : 0;
+  if (replayCursor < oldest) {
+    replayCursor = oldest; // 未来得及补发的记录已被覆盖
+  }
+
+  uint32_t seqs[REPLAY_BURST];
+  uint8_t count = 0;
+  uint32_t scan = replayCursor;
+  while (scan < liveStart && count < REPLAY_BURST) {
+    if (logSlots[scan % LOG_CAPACITY].pending) {
+      seqs[count++] = scan;
+    }
+    scan++;
+  }
+
+  if (count > 0) {
+    if (!sendLogRecords(seqs, count, LOG_FLAG_REPLAY)) {
+      return; // 发送失败，下次从这里继续
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      logSlots[seqs[i] % LOG_CAPACITY].pending = false;
+    }
+    Serial.printf("[补发] %u条，进度%u/%u\n", count, scan, logNext);
+  }
+  replayCursor = scan;
+}
+
+/**
+ * 处理服务器发来的补发请求，将仍在日志中的记录标记为待补发
+ */
+void processServerRequests() {
+  uint8_t req[LOG_REQUEST_SIZE];
+
+  while (udp.parsePacket() > 0) {
+    int len = udp.read(req, sizeof(req));
+    if (len != LOG_REQUEST_SIZE || req[0] != 'S' || req[1] != 'Q' ||
+        (req[2] | (req[3] << 8)) != bootId) {
+      continue; // 其他报文或上一次启动的请求
+    }
+
+    uint32_t from = req[4] | (req[5] << 8) | ((uint32_t)req[6] << 16) | ((uint32_t)req[7] << 24);
+    uint32_t count = req[8] | (req[9] << 8);
+    uint32_t oldest = logNext > LOG_CAPACITY ? logNext - LOG_CAPACITY : 0;
+    uint32_t first = from > oldest ? from : oldest;
+    uint32_t end = from + count < logNext ? from + count : logNext;
+
+    for (uint32_t seq = first; seq < end; seq++) {
+      logSlots[seq % LOG_CAPACITY].pending = true;
+    }
+    if (first < end && first < replayCursor) {
+      replayCursor = first;
+    }
+    Serial.printf("[补发请求] 序号%u起%u条，可补发%u条\n", from, count, first < end ? end - first : 0);
+  }
+}
+
+/**
+ * 检查帧缓冲区中已收到的部分：同步字、版本与长度
+ * @return 已收到的字节仍可能是一个有效帧的开头
+ */
+bool framePrefixValid() {
+  return (frameLen < 2 || frameBuf[1] == FRAME_SYNC1) &&
+         (frameLen < 4 || (frameBuf[2] == FRAME_VERSION && frameBuf[3] == FRAME_SIZE));
+}
+
+/**
+ * 帧校验失败后重新同步：丢弃首字节，在其余已缓冲的字节中查找下一个可能的帧开头
+ * 帧背靠背发送，丢失一个字节时下一帧的同步字就在缓冲区末尾，下一帧因此不受影响
+ */
+void frameResync() {
+  do {
+    size_t start = 1;
+    while (start < frameLen && frameBuf[start] != FRAME_SYNC0) start++;
+    frameLen -= start;
+    memmove(frameBuf, frameBuf + start, frameLen);
+  } while (frameLen > 0 && !framePrefixValid());
+
+  if (frameLen == 0) {
+    lineGarbled = true; // 后续字节是损坏帧的剩余部分，不作为文本转发
   }
 }
 
 /**
- * 监控Wi-Fi连接状态
+ * 处理一个二进制帧字节
+ * 文本行只含ASCII字符，0xA5总是帧的开头：未以\n结束的行已不完整（换行丢失或混入了帧数据），直接丢弃
+ * @return 字节是否已被帧接收消费
  */
-void checkWiFi() {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("\nWi-Fi断开，尝试重连...");
-    WiFi.reconnect();
-    delay(2000);
+bool handleFrameByte(uint8_t c) {
+  if (frameLen == 0) {
+    if (c != FRAME_SYNC0) {
+      return false;
+    }
+    if (lineLen > 0 && !lineOverflow && !lineGarbled) {
+      linesGarbled++;
+    }
+    lineLen = 0;
+    lineOverflow = false;
+    lineGarbled = false;
+  }
+  frameBuf[frameLen++] = c;
 
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("重连成功！");
+  if (!framePrefixValid()) {
+    if (frameLen == 4) {
+      framesBad++;
+      Serial.println("[警告] 不支持的帧版本或长度");
+    }
+    frameResync();
+  } else if (frameLen == FRAME_SIZE) {
+    uint16_t crc = frameBuf[FRAME_SIZE - 2] | (frameBuf[FRAME_SIZE - 1] << 8);
+    if (crc == frameCrc16(frameBuf, FRAME_SIZE - 2)) {
+      stampDeviceId(frameBuf);
+      logFrame(frameBuf);
+      lastDataTime = millis(); // 更新最后接收时间
+      Serial.printf("[数据转发] 二进制帧 seq=%u, 日志序号%u\n", frameBuf[4] | (frameBuf[5] << 8), logNext - 1);
+      frameLen = 0;
     } else {
-      Serial.println("重连失败！");
+      framesBad++;
+      Serial.println("[警告] 帧CRC校验失败，已丢弃");
+      frameResync();
     }
   }
-}
\ No newline at end of file
+  return true;
+}
+
+/**
+ * 一行文本接收完成：去除首尾空白后直接从行缓冲区转发，含非ASCII字节的行丢弃
+ */
+void handleLine() {
+  size_t start = 0;
+  size_t end = lineLen;
+  while (start < end && isspace((unsigned char)lineBuf[start])) start++;
+  while (end > start && isspace((unsigned char)lineBuf[end - 1])) end--;
+  if (start == end) {
+    return;
+  }
+  // 文本行只含可打印ASCII字符，其余视为损坏的数据
+  for (size_t i = start; i < end; i++) {
+    uint8_t b = (uint8_t)lineBuf[i];
+    if ((b < 0x20 && b != '\t') || b > 0x7E) {
+      linesGarbled++;
+      return;
+    }
+  }
+
+  // 转发数据到UDP服务器（文本行不进入日志，断网期间丢弃）
+  lastDataTime = millis(); // 更新最后接收时间
+  if (forwardPacket(lineBuf + start, end - start)) {
+    linesForwarded++;
+    Serial.print("[数据转发] ");
+    Serial.write(lineBuf + start, end - start);
+    Serial.println();
+  } else {
+    linesDropped++;
+  }
+}
+
+/**
+ * 处理STM32数据
+ * 同时支持二进制遥测帧（以同步字0xA5 0x5A开头）和兼容的文本行（以\n结尾）
+ * 二进制帧经环形日志转发，断网期间不会丢失
+ * 串口数据按块读出，文本行在固定大小的缓冲区中拼接，全程不分配堆内存；
+ * 超长的行被丢弃，直到下一个\n重新同步；帧出错时在已缓冲的字节中查找下一个同步字重新同步
+ */
+void processSTM32Data() {
+  static uint8_t chunk[RX_CHUNK_SIZE];
+
+  int avail;
+  while ((avail = Serial.available()) > 0) {
+    size_t n = Serial.readBytes(chunk, avail < RX_CHUNK_SIZE ? avail : RX_CHUNK_SIZE);
+
+    for (size_t i = 0; i < n; i++) {
+      uint8_t c = chunk[i];
+      if (handleFrameByte(c)) {
+        continue;
+      }
+
+      // 检测到换行符（STM32数据结束标志）
+      if (c == '\n') {
+        if (!lineOverflow && !lineGarbled) {
+          handleLine();
+        }
+        lineLen = 0;
+        lineOverflow = false;
+        lineGarbled = false;
+      } else if (lineOverflow || lineGarbled) {
+        // 丢弃超长或损坏行的剩余部分
+      } else if (lineLen < LINE_BUFFER_SIZE) {
+        lineBuf[lineLen++] = (char)c;
+      } else {
+        lineOverflow = true;
+        linesOversized++;
+        Serial.println("[警告] 文本行超长，已丢弃");
+      }
+    }
+  }
+
+  // 检测数据超时
+  if (millis() - lastDataTime > DATA_TIMEOUT) {
+    Serial.printf("[警告] 超过30秒未收到STM32数据！文本行：转发%u，丢弃%u，超长%u\n",
+                  linesForwarded, linesDropped, linesOversized);
+    lastDataTime = millis();
+  }
+}
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+@文件        : budget_report.py
+@描述        : 固件Flash/RAM预算与栈使用报告
+@注意事项    : 输入为GNU ld的map文件和-fstack-usage生成的.su文件：
+               - 按输出段汇总Flash（.isr_vector/.text/.rodata/.ARM/.data初值）与RAM（.data/.bss/堆栈保留区）
+               - 按模块（Core/Src下的目录、HAL、newlib的libc/libm、libgcc）汇总代码量，
+                 浮点snprintf、pow、log10等库函数带来的增长会体现在libc/libm/libgcc中
+               - 列出栈帧最大的函数；.su只给出单个函数的栈帧，调用链深度仍须结合调用关系判断
+               - 指定--history时与上一条记录比较并追加本次结果（含git提交号），便于逐提交跟踪
+               超出tools/budget.json中的任一上限时返回1
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+FLASH_SECTIONS = (".isr_vector", ".text", ".rodata", ".ARM.extab", ".ARM", ".preinit_array",
+                  ".init_array", ".fini_array")
+RAM_SECTIONS = (".data", ".bss", "._user_heap_stack")
+
+# 输出段行：段名顶格；输入段行：以空格开头。地址和大小可能因名字过长换到下一行
+OUTPUT_RE = re.compile(r"^(\.[\w.]+)\s*(?:0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+INPUT_RE = re.compile(r"^ (\.[\w.]+|COMMON)\s*(?:0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?$")
+ADDR_SIZE_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.+))?$")
+
+
+def parse_map(path):
+    """
+    @函数名      : parse_map
+    @描述        : 解析map文件的Memory map部分
+    @返回值      : (各输出段大小, [(输出段, 输入段, 目标文件, 大小)])
+    """
+    sections = {}
+    contributions = []
+    current = None
+    pending = None  # 名字独占一行，等待下一行的地址和大小
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        lines = f.read().split("\n")
+    try:
+        start = lines.index("Linker script and memory map")
+    except ValueError:
+        start = 0
+
+    for line in lines[start:]:
+        if pending is not None:
+            m = ADDR_SIZE_RE.match(line)
+            kind, name = pending
+            pending = None
+            if m:
+                size = int(m.group(2), 16)
+                if kind == "out":
+                    sections[name] = size
+                elif m.group(3) and size:
+                    contributions.append((current, name, m.group(3).strip(), size))
+                continue
+
+        if line.startswith(".") or line.startswith("._"):
+            m = OUTPUT_RE.match(line)
+            if m:
+                current = m.group(1)
+                if m.group(3):
+                    sections[current] = int(m.group(3), 16)
+                else:
+                    pending = ("out", current)
+            continue
+
+        if current is None:
+            continue
+        m = INPUT_RE.match(line)
+        if m:
+            if m.group(2) is None:
+                pending = ("in", m.group(1))
+            else:
+                size = int(m.group(3), 16)
+                if size:
+                    contributions.append((current, m.group(1), m.group(4).strip(), size))
+    return sections, contributions
+
+
+def module_of(obj, source_root):
+    """
+    @函数名      : module_of
+    @描述        : 将目标文件映射为报告中的模块名
+    """
+    archive = re.search(r"(lib\w+)\.a\(", obj)
+    if archive:
+        lib = archive.group(1)
+        if lib.startswith("libc"):
+            return "libc"
+        if lib.startswith("libm"):
+            return "libm"
+        return lib
+    obj = obj.replace("\\", "/")
+    m = re.search(r"Core/Src/([\w]+)/", obj)
+    if m:
+        return m.group(1)
+    if "STM32F1xx_HAL_Driver" in obj:
+        return "hal"
+    if "Host/sim" in obj:
+        return "sim"
+    m = re.search(r"Core/Src/(\w+)\.c", obj)
+    if m:
+        return "core:" + m.group(1)
+    if "startup" in obj:
+        return "startup"
+    return "toolchain"
+
+
+def parse_su(root):
+    """
+    @函数名      : parse_su
+    @描述        : 收集目录下全部.su文件
+    @返回值      : [(栈帧字节数, 函数, 位置, 类型)]，类型为static/dynamic/bounded
+    """
+    frames = []
+    for dirpath, _, files in os.walk(root):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(dirpath, name), encoding="utf-8", errors="replace") as f:
+                for line in f:
+                    parts = line.rstrip("\n").split("\t")
+                    if len(parts) != 3:
+                        continue
+                    where, size, kind = parts
+                    loc, _, func = where.rpartition(":")
+                    frames.append((int(size), func, loc, kind))
+    frames.sort(key=lambda x: -x[0])
+    return frames
+
+
+def git_revision(source_root):
+    try:
+        rev = subprocess.run(["git", "-C", source_root, "rev-parse", "--short", "HEAD"],
+                             capture_output=True, text=True, check=True).stdout.strip()
+        dirty = subprocess.run(["git", "-C", source_root, "status", "--porcelain", "--untracked-files=no"],
+                               capture_output=True, text=True, check=True).stdout.strip()
+        return rev + ("+" if dirty else "")
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def read_last_history(path):
+    if not path or not os.path.exists(path):
+        return None
+    with open(path, encoding="utf-8") as f:
+        rows = [l.rstrip("\n").split("\t") for l in f if l.strip() and not l.startswith("#")]
+    return rows[-1] if rows else None
+
+
+def delta(now, before):
+    if before is None:
+        return ""
+    d = now - before
+    return " (%+d)" % d if d else ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description="flash/RAM budget and stack usage report")
+    parser.add_argument("--map", required=True, help="GNU ld map file")
+    parser.add_argument("--su-dir", help="directory searched recursively for .su files")
+    parser.add_argument("--budget", help="JSON file with flash_bytes / ram_bytes / stack_frame_bytes")
+    parser.add_argument("--history", help="TSV file: compared against its last row, then appended")
+    parser.add_argument("--source-root", default=".", help="repository root, for the git revision")
+    parser.add_argument("--top", type=int, default=10, help="number of entries in the top lists")
+    args = parser.parse_args()
+
+    sections, contributions = parse_map(args.map)
+    flash = sum(sections.get(s, 0) for s in FLASH_SECTIONS) + sections.get(".data", 0)
+    ram = sum(sections.get(s, 0) for s in RAM_SECTIONS)
+    frames = parse_su(args.su_dir) if args.su_dir else []
+    max_frame = frames[0][0] if frames else 0
+
+    modules = {}
+    for out, _, obj, size in contributions:
+        if out in FLASH_SECTIONS or out == ".data":
+            mod = module_of(obj, args.source_root)
+            modules[mod] = modules.get(mod, 0) + size
+
+    revision = git_revision(args.source_root)
+    last = read_last_history(args.history)
+    last_flash = int(last[1]) if last else None
+    last_ram = int(last[2]) if last else None
+    last_frame = int(last[3]) if last else None
+
+    print("=== budget report @ %s ===" % revision)
+    print("sections:")
+    for name in FLASH_SECTIONS + RAM_SECTIONS:
+        if sections.get(name):
+            print("  %-18s %8d" % (name, sections[name]))
+    print("flash %d bytes%s, RAM %d bytes%s (incl. heap/stack reserve)" %
+          (flash, delta(flash, last_flash), ram, delta(ram, last_ram)))
+
+    print("flash by module:")
+    for mod, size in sorted(modules.items(), key=lambda x: -x[1]):
+        print("  %-24s %8d" % (mod, size))
+
+    print("largest input sections:")
+    for out, sec, obj, size in sorted(contributions, key=lambda x: -x[3])[:args.top]:
+        if out in FLASH_SECTIONS or out in RAM_SECTIONS:
+            print("  %-8s %-40s %6d  %s" % (out, sec[:40], size, os.path.basename(obj)))
+
+    if frames:
+        print("largest stack frames:")
+        for size, func, loc, kind in frames[:args.top]:
+            print("  %6d %-15s %-32s %s" % (size, kind, func, os.path.relpath(loc, args.source_root)
+                                          if os.path.isabs(loc) else loc))
+        dynamic = [f for f in frames if f[3] != "static"]
+        if dynamic:
+            print("  %d functions with dynamic stack usage" % len(dynamic))
+
+    failed = []
+    if args.budget:
+        with open(args.budget, encoding="utf-8") as f:
+            budget = json.load(f)
+        for key, value in (("flash_bytes", flash), ("ram_bytes", ram), ("stack_frame_bytes", max_frame)):
+            if key in budget and value > budget[key]:
+                failed.append("%s %d > %d" % (key, value, budget[key]))
+
+    if args.history:
+        new = not os.path.exists(args.history)
+        with open(args.history, "a", encoding="utf-8") as f:
+            if new:
+                f.write("# revision\tflash\tram\tmax_stack_frame\n")
+            f.write("%s\t%d\t%d\t%d\n" % (revision, flash, ram, max_frame))
+    if last_frame is not None and max_frame > last_frame:
+        print("note: largest stack frame grew %d -> %d bytes" % (last_frame, max_frame))
+
+    for f in failed:
+        print("OVER BUDGET: " + f)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
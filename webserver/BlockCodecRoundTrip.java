@@ -0,0 +1,213 @@
+import com.airdetection.model.AirData;
+import com.airdetection.store.SegmentStore;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.time.LocalDate;
+import java.util.ArrayList;
+import java.util.Comparator;
+import java.util.List;
+import java.util.Random;
+import java.util.stream.Stream;
+
+/**
+ * 段文件数据块（BlockCodec）的往返检查
+ * 经SegmentStore写入临时目录后重新打开查询，读出的时间戳和各指标的位模式须与写入的完全一致：
+ * - 十分位整数编码，以及差值超出12位时的64位转义（时间戳和整数列）
+ * - XOR编码：相同值、有效位落在上一个窗口内（窗口复用）和建立新窗口，NaN、无穷和-0.0
+ * - 同一天内乱序写入、时间范围互相重叠的块，读出按时间有序
+ * - 块头（十分位标志、点数、时间范围）损坏的块整块丢弃，不被错误解码或按错误的时间范围返回
+ *
+ * 运行（先 mvn compile，需要lombok生成的AirData）：
+ * java -cp target/classes BlockCodecRoundTrip.java
+ * 全部通过时返回0，否则输出不一致之处并返回1
+ */
+public class BlockCodecRoundTrip {
+
+    private static final long DAY_MS = 86_400_000L;
+    private static final long DAY_START = Math.floorDiv(1_700_000_000_000L, DAY_MS) * DAY_MS;
+    private static final String DEVICE = "0000abcd";
+
+    private static int failures = 0;
+
+    public static void main(String[] args) throws IOException {
+        Random random = new Random(7);
+
+        tenths(random);
+        xorWindows(random);
+        outOfOrder(random);
+        corruptedHeader(random);
+
+        System.out.println(failures == 0 ? "BlockCodecRoundTrip: 全部通过" : "BlockCodecRoundTrip: " + failures + " 项失败");
+        System.exit(failures == 0 ? 0 : 1);
+    }
+
+    // 十分位整数列：小幅变化落在前几档，偶尔跳变超过±2048触发64位转义；时间戳间隔同样有大跳变
+    private static void tenths(Random random) throws IOException {
+        List<AirData> points = new ArrayList<>();
+        long ts = DAY_START;
+        double temperature = 23.5;
+        double tvoc = 120;
+        for (int i = 0; i < 2000; i++) {
+            ts += i % 250 == 0 ? 3_600_000L + random.nextInt(100_000) : 1000 + random.nextInt(40);
+            temperature = Math.round((temperature + (random.nextInt(21) - 10) / 10.0) * 10) / 10.0;
+            tvoc = i % 97 == 0 ? tvoc + 1e9 * (random.nextBoolean() ? 1 : -1) : tvoc + random.nextInt(5) - 2;
+            points.add(point(ts, temperature, 45.0 + (i % 7) / 10.0, -12.3, tvoc,
+                    i % 300 == 0 ? 1e13 : 400 + i, 0.0));
+        }
+        check("十分位与64位转义", points, 500);
+    }
+
+    // XOR列：在一个基准值附近抖动低位（窗口复用），间或变换量级（新窗口）和写入特殊值
+    private static void xorWindows(Random random) throws IOException {
+        List<AirData> points = new ArrayList<>();
+        long ts = DAY_START + 3_600_000L;
+        double base = Math.PI;
+        for (int i = 0; i < 3000; i++) {
+            ts += 1000;
+            if (i % 400 == 0) {
+                base = random.nextDouble() * Math.pow(10, random.nextInt(12) - 6);
+            }
+            long bits = Double.doubleToRawLongBits(base) ^ (random.nextInt(1 << 12) & ~((1 << (i % 5)) - 1));
+            double jitter = Double.longBitsToDouble(bits);
+            double special;
+            switch (i % 11) {
+                case 0:
+                    special = Double.NaN;
+                    break;
+                case 1:
+                    special = Double.POSITIVE_INFINITY;
+                    break;
+                case 2:
+                    special = -0.0;
+                    break;
+                default:
+                    special = random.nextGaussian();
+            }
+            points.add(point(ts, jitter, i % 3 == 0 ? jitter : base, special,
+                    random.nextDouble(), base, i % 50 == 0 ? -jitter : jitter));
+        }
+        check("XOR窗口复用与新窗口", points, 700);
+    }
+
+    // 先写当天较晚的点，再写较早的点，并让两批的时间范围交错
+    private static void outOfOrder(Random random) throws IOException {
+        List<AirData> points = new ArrayList<>();
+        long[] starts = {DAY_START + 7_200_000L, DAY_START, DAY_START + 7_200_500L, DAY_START + 3_600_000L};
+        for (long start : starts) {
+            for (int i = 0; i < 600; i++) {
+                points.add(point(start + i * 1000L, i / 10.0, random.nextDouble(), 1.5, 300, 450 + i, 8.0));
+            }
+        }
+        check("乱序与重叠的块", points, 256);
+    }
+
+    // 改写块头的十分位标志、点数、最小和最大时间戳的最低位：损坏的块不被读出
+    private static void corruptedHeader(Random random) throws IOException {
+        int[] offsets = {3, 7, 15, 23};
+        for (int offset : offsets) {
+            List<AirData> points = new ArrayList<>();
+            for (int i = 0; i < 100; i++) {
+                points.add(point(DAY_START + i * 1000L, 20 + i / 10.0, random.nextDouble(), 1.5, 300, 450, 8.0));
+            }
+            Path dir = Files.createTempDirectory("block-codec");
+            try {
+                write(dir, points, 1000);
+                try (FileChannel channel = FileChannel.open(segmentPath(dir), StandardOpenOption.READ,
+                        StandardOpenOption.WRITE)) {
+                    ByteBuffer b = ByteBuffer.allocate(1);
+                    channel.read(b, offset);
+                    b.put(0, (byte) (b.get(0) ^ 0x01)).rewind();
+                    channel.write(b, offset);
+                }
+                List<AirData> read = read(dir);
+                expect(read.isEmpty(), "块头偏移" + offset + "损坏后仍读出" + read.size() + "个点");
+            } finally {
+                delete(dir);
+            }
+        }
+    }
+
+    // 写入、重新打开、读出并与写入的点按时间排序后逐位比较
+    private static void check(String name, List<AirData> points, int blockPoints) throws IOException {
+        Path dir = Files.createTempDirectory("block-codec");
+        try {
+            write(dir, points, blockPoints);
+            List<AirData> read = read(dir);
+            List<AirData> expected = new ArrayList<>(points);
+            expected.sort(Comparator.comparingLong(AirData::getTimestamp));
+
+            if (!expect(read.size() == expected.size(),
+                    name + ": 写入" + expected.size() + "点，读出" + read.size() + "点")) {
+                return;
+            }
+            int mismatches = 0;
+            for (int i = 0; i < expected.size(); i++) {
+                AirData e = expected.get(i);
+                AirData r = read.get(i);
+                boolean same = e.getTimestamp() == r.getTimestamp()
+                        && same(e.getTemperature(), r.getTemperature()) && same(e.getHumidity(), r.getHumidity())
+                        && same(e.getMethane(), r.getMethane()) && same(e.getTvoc(), r.getTvoc())
+                        && same(e.getCo2(), r.getCo2()) && same(e.getPm25(), r.getPm25());
+                if (!same && mismatches++ < 5) {
+                    System.out.println(name + ": 第" + i + "点不一致，写入 " + e + "，读出 " + r);
+                }
+            }
+            expect(mismatches == 0, name + ": " + mismatches + "个点不一致");
+            System.out.println(name + ": " + expected.size() + " 点，" + Files.size(segmentPath(dir)) + " 字节");
+        } finally {
+            delete(dir);
+        }
+    }
+
+    private static void write(Path dir, List<AirData> points, int blockPoints) throws IOException {
+        try (SegmentStore store = new SegmentStore(dir, blockPoints, Long.MAX_VALUE / 2)) {
+            for (AirData p : points) {
+                store.append(DEVICE, p);
+            }
+            store.flush();
+        }
+    }
+
+    // 新开的SegmentStore没有写入缓冲，读出的点全部来自段文件
+    private static List<AirData> read(Path dir) throws IOException {
+        List<AirData> read = new ArrayList<>();
+        try (SegmentStore store = new SegmentStore(dir, 1000, Long.MAX_VALUE / 2)) {
+            store.query(DEVICE, DAY_START, DAY_START + DAY_MS, SegmentStore.ALL_FIELDS,
+                    (ts, t, h, m, v, c, p) -> read.add(point(ts, t, h, m, v, c, p)));
+        }
+        return read;
+    }
+
+    private static Path segmentPath(Path dir) {
+        return dir.resolve(DEVICE).resolve(LocalDate.ofEpochDay(DAY_START / DAY_MS) + ".seg");
+    }
+
+    private static AirData point(long ts, double temperature, double humidity, double methane,
+                                 double tvoc, double co2, double pm25) {
+        return AirData.builder().deviceId(DEVICE).timestamp(ts).temperature(temperature).humidity(humidity)
+                .methane(methane).tvoc(tvoc).co2(co2).pm25(pm25).build();
+    }
+
+    private static boolean same(double a, double b) {
+        return Double.doubleToRawLongBits(a) == Double.doubleToRawLongBits(b);
+    }
+
+    private static boolean expect(boolean ok, String message) {
+        if (!ok) {
+            failures++;
+            System.out.println("失败: " + message);
+        }
+        return ok;
+    }
+
+    private static void delete(Path dir) throws IOException {
+        try (Stream<Path> files = Files.walk(dir)) {
+            files.sorted(Comparator.reverseOrder()).forEach(p -> p.toFile().delete());
+        }
+    }
+}
@@ -0,0 +1,75 @@
+import com.airdetection.udp.ReportLineParser;
+
+import java.lang.management.ManagementFactory;
+import java.nio.charset.StandardCharsets;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+/**
+ * 文本上报行解析的对比测试：原正则表达式路径与 ReportLineParser
+ * 输出每次解析的平均耗时和分配字节数（HotSpot的线程分配计数）
+ *
+ * 运行（先 mvn compile）：java -cp target/classes ReportParserBenchmark.java [iterations]
+ */
+public class ReportParserBenchmark {
+
+    // 与原 UDPServer.parseData 相同的正则表达式
+    private static final Pattern DATA_PATTERN = Pattern.compile(
+        "Humidity: (\\d+\\.\\d+)%, Temperature: (\\d+\\.\\d+) C, " +
+        "Methane: (-?\\d+\\.\\d+) ppm, TVOC: (\\d+) ppb, CO2eq: (\\d+) ppm, " +
+        "Dust\\(PM2\\.5\\): (\\d+\\.\\d+) ug/m\\^3"
+    );
+
+    private static final byte[] LINE = ("Humidity: 45.2%, Temperature: 25.3 C, Methane: 1234.5 ppm, " +
+            "TVOC: 250 ppb, CO2eq: 450 ppm, Dust(PM2.5): 15.5 ug/m^3").getBytes(StandardCharsets.US_ASCII);
+
+    private static double sink;
+
+    public static void main(String[] args) {
+        int iterations = args.length > 0 ? Integer.parseInt(args[0]) : 2_000_000;
+        ReportLineParser parser = new ReportLineParser();
+        ReportLineParser.Values values = new ReportLineParser.Values();
+
+        // 两种路径结果须一致
+        parser.parse(LINE, 0, LINE.length, values);
+        double[] expected = regex(LINE, LINE.length);
+        double[] actual = {values.humidity, values.temperature, values.methane, values.tvoc, values.co2, values.pm25};
+        if (!java.util.Arrays.equals(expected, actual)) {
+            throw new IllegalStateException("解析结果不一致");
+        }
+
+        for (int round = 0; round < 3; round++) {
+            measure("regex ", iterations, () -> sink += regex(LINE, LINE.length)[0]);
+            measure("parser", iterations, () -> {
+                parser.parse(LINE, 0, LINE.length, values);
+                sink += values.humidity;
+            });
+        }
+    }
+
+    private static double[] regex(byte[] data, int length) {
+        Matcher matcher = DATA_PATTERN.matcher(new String(data, 0, length, StandardCharsets.UTF_8));
+        if (!matcher.find()) {
+            throw new IllegalArgumentException("不匹配");
+        }
+        double[] v = new double[6];
+        for (int i = 0; i < 6; i++) {
+            v[i] = Double.parseDouble(matcher.group(i + 1));
+        }
+        return v;
+    }
+
+    private static void measure(String name, int iterations, Runnable op) {
+        com.sun.management.ThreadMXBean mx = (com.sun.management.ThreadMXBean) ManagementFactory.getThreadMXBean();
+        long tid = Thread.currentThread().getId();
+        long bytes0 = mx.getThreadAllocatedBytes(tid);
+        long t0 = System.nanoTime();
+        for (int i = 0; i < iterations; i++) {
+            op.run();
+        }
+        long t1 = System.nanoTime();
+        long bytes1 = mx.getThreadAllocatedBytes(tid);
+        System.out.printf("%s %8.1f ns/op %8.1f B/op%n", name, (t1 - t0) / (double) iterations,
+                (bytes1 - bytes0) / (double) iterations);
+    }
+}
@@ -0,0 +1,122 @@
+import com.airdetection.model.AirData;
+import com.airdetection.store.Resolution;
+import com.airdetection.store.SegmentStore;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.util.Comparator;
+import java.util.Random;
+import java.util.stream.Stream;
+
+/**
+ * 磁盘存储 SegmentStore 的容量和查询测试
+ * 在临时目录中写入若干设备若干天的1Hz模拟数据（时间戳带毫秒级接收抖动，各指标按传感器分辨率
+ * 随机游走），输出写入速度、每点字节数，以及单个设备查询1小时、1天和全部天数的原始点和汇总的耗时
+ *
+ * 运行（先 mvn compile，需要lombok生成的AirData）：
+ * java -cp target/classes SegmentStoreBenchmark.java [设备数] [天数]
+ */
+public class SegmentStoreBenchmark {
+
+    private static final long DAY_MS = 86_400_000L;
+    private static long sink;
+
+    public static void main(String[] args) throws IOException {
+        int deviceCount = args.length > 0 ? Integer.parseInt(args[0]) : 10;
+        int days = args.length > 1 ? Integer.parseInt(args[1]) : 7;
+        Path dir = Files.createTempDirectory("segment-bench");
+        long start = Math.floorDiv(System.currentTimeMillis(), DAY_MS) * DAY_MS - days * DAY_MS;
+        long points = (long) deviceCount * days * 86_400;
+
+        try (SegmentStore store = new SegmentStore(dir, 3600, Long.MAX_VALUE / 2)) {
+            Random random = new Random(1);
+            AirData data = new AirData();
+            double[] walk = {25.0, 45.0, 1.5, 250, 450, 15.5};
+            long t0 = System.nanoTime();
+            for (int device = 0; device < deviceCount; device++) {
+                String id = String.format("%08x", device);
+                for (int s = 0; s < days * 86_400; s++) {
+                    // 温湿度0.1分辨率缓慢变化，甲烷和PM2.5有ADC噪声，TVOC和CO2为整数
+                    walk[0] += (random.nextInt(21) - 10) / 100.0;
+                    walk[1] += (random.nextInt(3) - 1) * 0.1 * (random.nextInt(20) == 0 ? 1 : 0);
+                    walk[3] = Math.max(0, walk[3] + random.nextInt(5) - 2);
+                    walk[4] = Math.max(400, walk[4] + random.nextInt(5) - 2);
+                    data.setTimestamp(start + s * 1000L + random.nextInt(40));
+                    data.setTemperature(Math.round(walk[0] * 10) / 10.0);
+                    data.setHumidity(Math.round(walk[1] * 10) / 10.0);
+                    data.setMethane(Math.round((walk[2] + random.nextGaussian() * 0.2) * 10) / 10.0);
+                    data.setTvoc(walk[3]);
+                    data.setCo2(walk[4]);
+                    data.setPm25(Math.round((walk[5] + random.nextGaussian()) * 10) / 10.0);
+                    store.append(id, data);
+                }
+            }
+            store.flush();
+            long t1 = System.nanoTime();
+
+            long bytes = size(dir);
+            System.out.printf("写入 %d 设备 × %d 天 = %d 点，%.0f 点/秒%n", deviceCount, days, points,
+                    points / ((t1 - t0) / 1e9));
+            long segmentBytes = size(dir, ".seg");
+            System.out.printf("磁盘 %.1f MB，%.2f 字节/点（原始56字节/点），其中汇总 %.1f MB%n", bytes / 1e6,
+                    bytes / (double) points, (bytes - segmentBytes) / 1e6);
+
+            String id = String.format("%08x", deviceCount / 2);
+            long end = start + days * DAY_MS;
+            for (int round = 0; round < 3; round++) {
+                System.out.printf("-- 第%d轮%n", round + 1);
+                query(store, id, "1小时", end - DAY_MS / 24, end);
+                query(store, id, "1天", end - DAY_MS, end);
+                query(store, id, days + "天", start, end);
+                query(store, id, days + "天(仅温度)", start, end, 1);
+                for (Resolution resolution : Resolution.values()) {
+                    rollups(store, id, days + "天" + resolution.label() + "汇总", resolution, start, end);
+                }
+            }
+        } finally {
+            try (Stream<Path> files = Files.walk(dir)) {
+                files.sorted(Comparator.reverseOrder()).forEach(p -> p.toFile().delete());
+            }
+        }
+    }
+
+    private static void query(SegmentStore store, String id, String name, long from, long to) throws IOException {
+        query(store, id, name, from, to, SegmentStore.ALL_FIELDS);
+    }
+
+    private static void query(SegmentStore store, String id, String name, long from, long to, int fieldMask)
+            throws IOException {
+        long[] count = {0};
+        long t0 = System.nanoTime();
+        store.query(id, from, to, fieldMask, (ts, t, h, m, v, c, p) -> {
+            count[0]++;
+            sink += ts;
+        });
+        long t1 = System.nanoTime();
+        System.out.printf("查询%-12s %8d 点 %8.2f ms%n", name, count[0], (t1 - t0) / 1e6);
+    }
+
+    private static void rollups(SegmentStore store, String id, String name, Resolution resolution, long from, long to)
+            throws IOException {
+        long[] count = {0};
+        long t0 = System.nanoTime();
+        store.queryRollups(id, resolution, from, to, (start, bucket) -> {
+            count[0]++;
+            sink += bucket.count();
+        });
+        long t1 = System.nanoTime();
+        System.out.printf("查询%-12s %8d 桶 %8.2f ms%n", name, count[0], (t1 - t0) / 1e6);
+    }
+
+    private static long size(Path dir) throws IOException {
+        return size(dir, "");
+    }
+
+    private static long size(Path dir, String suffix) throws IOException {
+        try (Stream<Path> files = Files.walk(dir)) {
+            return files.filter(p -> Files.isRegularFile(p) && p.toString().endsWith(suffix))
+                    .mapToLong(p -> p.toFile().length()).sum();
+        }
+    }
+}
@@ -0,0 +1,71 @@
+import com.airdetection.model.AirData;
+import com.airdetection.store.SeriesStore;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ConcurrentLinkedQueue;
+
+/**
+ * 历史数据存储的对比测试：原 ConcurrentLinkedQueue（每次写入循环调用size()裁剪，读取整体复制）
+ * 与 SeriesStore 列式环形存储
+ * 分别测量写入、读取最新点（/api/latest）和读取最近100点（/api/history）的平均耗时
+ *
+ * 运行（先 mvn compile，需要lombok生成的AirData）：
+ * java -cp target/classes SeriesStoreBenchmark.java [容量]
+ */
+public class SeriesStoreBenchmark {
+
+    private static final int HISTORY = 100;
+    private static long sink;
+
+    public static void main(String[] args) {
+        int capacity = args.length > 0 ? Integer.parseInt(args[0]) : 100_000;
+        int writes = Math.max(capacity * 2, 200_000);
+        int reads = 20_000;
+        AirData sample = AirData.builder().temperature(25.3).humidity(45.2).methane(1.5)
+                .tvoc(250).co2(450).pm25(15.5).timestamp(System.currentTimeMillis()).build();
+
+        for (int round = 0; round < 3; round++) {
+            System.out.printf("-- 容量%d，第%d轮%n", capacity, round + 1);
+
+            ConcurrentLinkedQueue<AirData> queue = new ConcurrentLinkedQueue<>();
+            // 原实现每次写入时size()遍历整个队列，容量很大时写入次数相应减少以控制耗时
+            int queueWrites = Math.min(writes, 20_000_000 / capacity + capacity);
+            long t0 = System.nanoTime();
+            for (int i = 0; i < queueWrites; i++) {
+                queue.add(sample);
+                while (queue.size() > capacity) {
+                    queue.poll();
+                }
+            }
+            long t1 = System.nanoTime();
+            for (int i = 0; i < reads; i++) {
+                List<AirData> copy = new ArrayList<>(queue);
+                sink += copy.get(copy.size() - 1).getTimestamp();
+            }
+            long t2 = System.nanoTime();
+            report("queue", queueWrites, t1 - t0, reads, t2 - t1, t2 - t1);
+
+            SeriesStore store = new SeriesStore(capacity);
+            t0 = System.nanoTime();
+            for (int i = 0; i < writes; i++) {
+                store.append(sample);
+            }
+            t1 = System.nanoTime();
+            for (int i = 0; i < reads; i++) {
+                sink += store.latest().getTimestamp();
+            }
+            t2 = System.nanoTime();
+            for (int i = 0; i < reads; i++) {
+                store.forEach(store.endSequence() - HISTORY, (seq, ts, t, h, m, v, c, p) -> sink += ts);
+            }
+            long t3 = System.nanoTime();
+            report("store", writes, t1 - t0, reads, t2 - t1, t3 - t2);
+        }
+    }
+
+    private static void report(String name, int writes, long writeNs, int reads, long latestNs, long historyNs) {
+        System.out.printf("%s 写入 %10.1f ns/点  最新点 %10.1f ns  最近%d点 %10.1f ns%n", name,
+                writeNs / (double) writes, latestNs / (double) reads, HISTORY, historyNs / (double) reads);
+    }
+}
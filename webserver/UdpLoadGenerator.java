@@ -0,0 +1,124 @@
+import java.net.InetSocketAddress;
+import java.nio.ByteBuffer;
+import java.nio.channels.DatagramChannel;
+import java.util.Random;
+import java.util.concurrent.locks.LockSupport;
+
+/**
+ * UDP接收流水线的压测工具：模拟多个ESP8266转发端，按给定速率发送存储转发记录报文
+ * 报文格式与 WebClient/WebClient.ino 一致，每个模拟设备使用独立的源端口、启动ID、日志序号和设备ID
+ * 设备ID为 LOAD_DEVICE_BASE 加设备编号（f0000000、f0000001…），与真实设备区分，存储和汇总按设备分开
+ *
+ * 运行：java UdpLoadGenerator.java [host] [port] [devices] [packets/s] [seconds] [records/packet]
+ * 默认：127.0.0.1 9091 200 20000 30 1
+ * 服务端的接收、丢弃和发布计数见 GET /api/ingest
+ */
+public class UdpLoadGenerator {
+
+    private static final int FRAME_SIZE = 32;
+    private static final int HEADER_SIZE = 8;
+    private static final int RECORD_SIZE = 8 + FRAME_SIZE;
+    private static final long LOAD_DEVICE_BASE = 0xF0000000L;
+
+    public static void main(String[] args) throws Exception {
+        String host = args.length > 0 ? args[0] : "127.0.0.1";
+        int port = args.length > 1 ? Integer.parseInt(args[1]) : 9091;
+        int devices = args.length > 2 ? Integer.parseInt(args[2]) : 200;
+        int rate = args.length > 3 ? Integer.parseInt(args[3]) : 20000;
+        int seconds = args.length > 4 ? Integer.parseInt(args[4]) : 30;
+        int batch = args.length > 5 ? Integer.parseInt(args[5]) : 1;
+
+        InetSocketAddress target = new InetSocketAddress(host, port);
+        DatagramChannel[] channels = new DatagramChannel[devices];
+        int[] bootIds = new int[devices];
+        long[] seqs = new long[devices];
+        Random random = new Random();
+        for (int i = 0; i < devices; i++) {
+            channels[i] = DatagramChannel.open();
+            channels[i].bind(new InetSocketAddress(0));
+            bootIds[i] = random.nextInt(0x10000);
+        }
+
+        ByteBuffer buf = ByteBuffer.allocate(HEADER_SIZE + batch * RECORD_SIZE);
+        long interval = 1_000_000_000L / rate;
+        long start = System.nanoTime();
+        long end = start + seconds * 1_000_000_000L;
+        long next = start;
+        long sent = 0;
+        long lastReport = start;
+        long lastSent = 0;
+
+        System.out.printf("发送到 %s，设备%d个，目标%d包/秒，每包%d条记录，持续%d秒%n", target, devices, rate, batch, seconds);
+        while (System.nanoTime() < end) {
+            int device = (int) (sent % devices);
+            buildPacket(buf, LOAD_DEVICE_BASE + device, bootIds[device], seqs[device], batch);
+            seqs[device] += batch;
+            buf.flip();
+            channels[device].send(buf, target);
+            sent++;
+
+            next += interval;
+            long now = System.nanoTime();
+            if (next > now) {
+                LockSupport.parkNanos(next - now);
+            }
+            if (now - lastReport >= 1_000_000_000L) {
+                System.out.printf("%d包/秒%n", (sent - lastSent) * 1_000_000_000L / (now - lastReport));
+                lastReport = now;
+                lastSent = sent;
+            }
+        }
+
+        double elapsed = (System.nanoTime() - start) / 1e9;
+        System.out.printf("共发送%d包（%d条记录），平均%.0f包/秒%n", sent, sent * batch, sent / elapsed);
+        for (DatagramChannel channel : channels) {
+            channel.close();
+        }
+    }
+
+    // 构造一个记录报文：头部后跟batch条记录，每条带一个CRC正确的遥测帧
+    private static void buildPacket(ByteBuffer buf, long deviceId, int bootId, long seq, int batch) {
+        buf.clear();
+        buf.put((byte) 'S').put((byte) 'F').put((byte) 2).put((byte) 0);
+        buf.put((byte) bootId).put((byte) (bootId >> 8)).put((byte) batch).put((byte) 0);
+        for (int i = 0; i < batch; i++) {
+            putU32(buf, seq + i);
+            putU32(buf, 0);
+            int frame = buf.position();
+            buf.put((byte) 0xA5).put((byte) 0x5A).put((byte) 1).put((byte) FRAME_SIZE);
+            buf.put((byte) (seq + i)).put((byte) ((seq + i) >> 8));
+            putU32(buf, deviceId);                          // 设备ID
+            putU32(buf, System.currentTimeMillis());        // 时间戳
+            buf.put((byte) 0x3F).put((byte) 0);             // 全部字段有效
+            putU16(buf, 452);                               // 湿度 45.2%
+            putU16(buf, 253);                               // 温度 25.3℃
+            putU32(buf, 15);                                // 甲烷 1.5ppm
+            putU16(buf, 250);                               // TVOC
+            putU16(buf, 450);                               // CO2当量
+            putU16(buf, 155);                               // PM2.5 15.5
+            putU16(buf, crc16(buf.array(), frame, FRAME_SIZE - 2));
+        }
+    }
+
+    private static void putU16(ByteBuffer buf, int v) {
+        buf.put((byte) v).put((byte) (v >> 8));
+    }
+
+    private static void putU32(ByteBuffer buf, long v) {
+        putU16(buf, (int) v);
+        putU16(buf, (int) (v >> 16));
+    }
+
+    // CRC16-CCITT（多项式0x1021，初值0xFFFF）
+    private static int crc16(byte[] buf, int off, int len) {
+        int crc = 0xFFFF;
+        for (int i = off; i < off + len; i++) {
+            crc ^= (buf[i] & 0xFF) << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) != 0 ? (crc << 1) ^ 0x1021 : crc << 1;
+            }
+            crc &= 0xFFFF;
+        }
+        return crc;
+    }
+}
@@ -1,13 +1,30 @@
 package com.airdetection.controller;
 
 import com.airdetection.model.AirData;
+import com.airdetection.model.DeviceInfo;
+import com.airdetection.model.RollupSeries;
 import com.airdetection.service.DataService;
+import com.airdetection.store.DownsampledSeries;
+import com.airdetection.store.Resolution;
+import com.airdetection.store.SeriesStore;
+import com.airdetection.udp.UDPServer;
 import org.springframework.beans.factory.annotation.Autowired;
+import org.springframework.http.HttpHeaders;
+import org.springframework.http.MediaType;
+import org.springframework.http.ResponseEntity;
 import org.springframework.web.bind.annotation.GetMapping;
+import org.springframework.web.bind.annotation.PathVariable;
+import org.springframework.web.bind.annotation.RequestHeader;
 import org.springframework.web.bind.annotation.RequestMapping;
+import org.springframework.web.bind.annotation.RequestParam;
 import org.springframework.web.bind.annotation.RestController;
+import org.springframework.web.servlet.mvc.method.annotation.StreamingResponseBody;
 
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.List;
+import java.util.Map;
 
 @RestController
 @RequestMapping("/api")
@@ -16,6 +33,13 @@ public class ApiController {
     @Autowired
     private DataService dataService;
 
+    @Autowired
+    private UDPServer udpServer;
+
+    // /api/series 默认和最大输出点数
+    private static final int DEFAULT_SERIES_POINTS = 1000;
+    private static final int MAX_SERIES_POINTS = 100_000;
+
     @GetMapping("/history")
     public List<AirData> getHistoryData() {
         return dataService.getHistoryData();
@@ -23,10 +47,137 @@ public class ApiController {
     
     @GetMapping("/latest")
     public AirData getLatestData() {
-        List<AirData> history = dataService.getHistoryData();
-        if (history.isEmpty()) {
-            return null;
+        return dataService.getLatestData();
+    }
+
+    @GetMapping("/devices")
+    public List<DeviceInfo> getDevices() {
+        return dataService.getDevices();
+    }
+
+    @GetMapping("/devices/{id}/history")
+    public ResponseEntity<List<AirData>> getDeviceHistory(@PathVariable String id) {
+        List<AirData> history = dataService.getHistoryData(id);
+        return history != null ? ResponseEntity.ok(history) : ResponseEntity.notFound().build();
+    }
+
+    @GetMapping("/devices/{id}/latest")
+    public ResponseEntity<AirData> getDeviceLatest(@PathVariable String id) {
+        if (dataService.getHistoryStore(id) == null) {
+            return ResponseEntity.notFound().build();
+        }
+        return ResponseEntity.ok(dataService.getLatestData(id));
+    }
+
+    /**
+     * 设备的汇总数据，from/to为毫秒时间戳（默认最近一天），resolution为1m、1h或1d（默认按时间范围自动选择）
+     */
+    @GetMapping("/devices/{id}/rollups")
+    public ResponseEntity<RollupSeries> getDeviceRollups(@PathVariable String id,
+                                                         @RequestParam(required = false) Long from,
+                                                         @RequestParam(required = false) Long to,
+                                                         @RequestParam(required = false) String resolution)
+            throws IOException {
+        long end = to != null ? to : System.currentTimeMillis();
+        long start = from != null ? from : end - 86_400_000L;
+        Resolution chosen = resolution != null ? Resolution.parse(resolution) : null;
+        if (resolution != null && chosen == null) {
+            return ResponseEntity.badRequest().build();
         }
-        return history.get(history.size() - 1);
+        try {
+            return ResponseEntity.ok(dataService.getRollups(id, start, end, chosen));
+        } catch (IllegalArgumentException e) {
+            return ResponseEntity.badRequest().build();
+        }
+    }
+
+    /**
+     * 降采样的时间序列，用于绘图
+     * device默认为最近收到数据的设备，from/to为毫秒时间戳（默认最近一天），fields为逗号分隔的指标名（默认全部），
+     * maxPoints为输出点数上限，format为ndjson或binary（默认按Accept头选择，否则ndjson）
+     * 响应流式写出，数据来源（raw或汇总分辨率）在X-Series-Source头中
+     */
+    @GetMapping("/series")
+    public ResponseEntity<StreamingResponseBody> getSeries(
+            @RequestParam(required = false) String device,
+            @RequestParam(required = false) Long from,
+            @RequestParam(required = false) Long to,
+            @RequestParam(required = false) String fields,
+            @RequestParam(required = false) Integer maxPoints,
+            @RequestParam(required = false) String format,
+            @RequestHeader(value = HttpHeaders.ACCEPT, required = false) String accept) throws IOException {
+        String deviceId = device != null ? device : dataService.getLastDeviceId();
+        if (deviceId == null) {
+            return ResponseEntity.notFound().build();
+        }
+        long end = to != null ? to : System.currentTimeMillis();
+        long start = from != null ? from : end - 86_400_000L;
+        List<SeriesStore.Field> selected = parseFields(fields);
+        if (selected == null || start >= end) {
+            return ResponseEntity.badRequest().build();
+        }
+        boolean binary;
+        if (format == null) {
+            binary = accept != null && accept.contains(SeriesEncoder.BINARY);
+        } else if ("binary".equals(format) || "ndjson".equals(format)) {
+            binary = "binary".equals(format);
+        } else {
+            return ResponseEntity.badRequest().build();
+        }
+        int limit = Math.max(3, Math.min(maxPoints != null ? maxPoints : DEFAULT_SERIES_POINTS, MAX_SERIES_POINTS));
+        int fieldMask = 0;
+        for (SeriesStore.Field field : selected) {
+            fieldMask |= 1 << field.ordinal();
+        }
+
+        // 查询在写响应前完成，设备ID无效等错误仍能返回状态码
+        DownsampledSeries series;
+        try {
+            series = dataService.querySeries(deviceId, start, end, fieldMask, limit);
+        } catch (IllegalArgumentException e) {
+            return ResponseEntity.badRequest().build();
+        }
+        StreamingResponseBody body = binary
+                ? out -> SeriesEncoder.writeBinary(out, selected, series)
+                : out -> SeriesEncoder.writeNdjson(out, deviceId, start, end, selected, series);
+        return ResponseEntity.ok()
+                .contentType(MediaType.parseMediaType(binary ? SeriesEncoder.BINARY : SeriesEncoder.NDJSON))
+                .header("X-Series-Source", series.source())
+                .body(body);
+    }
+
+    /**
+     * 解析逗号分隔的指标名，null表示全部指标；有未知指标或为空时返回null
+     */
+    private static List<SeriesStore.Field> parseFields(String fields) {
+        if (fields == null) {
+            return Arrays.asList(SeriesStore.Field.values());
+        }
+        List<SeriesStore.Field> result = new ArrayList<>();
+        for (String name : fields.split(",")) {
+            SeriesStore.Field match = null;
+            for (SeriesStore.Field field : SeriesStore.Field.values()) {
+                if (SeriesEncoder.name(field).equals(name.trim())) {
+                    match = field;
+                }
+            }
+            if (match == null) {
+                return null;
+            }
+            if (!result.contains(match)) {
+                result.add(match);
+            }
+        }
+        return result;
+    }
+
+    @GetMapping("/ingest")
+    public Map<String, Long> getIngestStats() {
+        return udpServer.getStats();
+    }
+
+    @GetMapping("/storage")
+    public Map<String, Long> getStorageStats() {
+        return dataService.getStorageStats();
     }
-} 
\ No newline at end of file
+}
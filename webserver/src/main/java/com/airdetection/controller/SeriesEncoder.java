@@ -0,0 +1,106 @@
+package com.airdetection.controller;
+
+import com.airdetection.store.DownsampledSeries;
+import com.airdetection.store.SeriesStore;
+
+import java.io.BufferedOutputStream;
+import java.io.BufferedWriter;
+import java.io.DataOutputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.OutputStreamWriter;
+import java.io.Writer;
+import java.nio.charset.StandardCharsets;
+import java.util.List;
+
+/**
+ * /api/series 的响应编码，边编码边写出，响应以分块传输发送
+ */
+final class SeriesEncoder {
+
+    static final String NDJSON = "application/x-ndjson";
+    static final String BINARY = "application/octet-stream";
+
+    private static final byte[] BINARY_MAGIC = {'A', 'Q', 'S', '1'};
+
+    private SeriesEncoder() {
+    }
+
+    /**
+     * NDJSON：第一行为元数据 {"device","source","from","to","fields","points"}，
+     * 之后每行一个点 {"timestamp":..., 各指标...}，NaN写为null
+     */
+    static void writeNdjson(OutputStream out, String deviceId, long from, long to,
+                            List<SeriesStore.Field> fields, DownsampledSeries series) throws IOException {
+        Writer writer = new BufferedWriter(new OutputStreamWriter(out, StandardCharsets.UTF_8), 16384);
+        StringBuilder line = new StringBuilder(128);
+        line.append("{\"device\":\"").append(deviceId)
+                .append("\",\"source\":\"").append(series.source())
+                .append("\",\"from\":").append(from)
+                .append(",\"to\":").append(to)
+                .append(",\"fields\":[");
+        for (int k = 0; k < fields.size(); k++) {
+            line.append(k > 0 ? ",\"" : "\"").append(name(fields.get(k))).append('"');
+        }
+        line.append("],\"points\":").append(series.size()).append("}\n");
+        writer.append(line);
+
+        for (int i = 0; i < series.size(); i++) {
+            line.setLength(0);
+            line.append("{\"timestamp\":").append(series.timestamp(i));
+            for (SeriesStore.Field field : fields) {
+                double v = series.value(field, i);
+                line.append(",\"").append(name(field)).append("\":");
+                if (Double.isFinite(v)) {
+                    line.append(v);
+                } else {
+                    line.append("null");
+                }
+            }
+            line.append("}\n");
+            writer.append(line);
+        }
+        writer.flush();
+    }
+
+    /*
+     * 列式二进制（小端，可直接映射为JavaScript的BigInt64Array/Float64Array）：
+     *   0  u8[4]  'A' 'Q' 'S' '1'
+     *   4  u32    点数n
+     *   8  u8     指标数k
+     *   9  u8[k]  各指标在SeriesStore.Field中的序号
+     *      补0到8字节边界
+     *      i64[n] 时间戳（毫秒）
+     *      f64[n] 每个指标一列，共k列
+     */
+    static void writeBinary(OutputStream out, List<SeriesStore.Field> fields, DownsampledSeries series)
+            throws IOException {
+        DataOutputStream data = new DataOutputStream(new BufferedOutputStream(out, 16384));
+        int n = series.size();
+        data.write(BINARY_MAGIC);
+        data.writeInt(Integer.reverseBytes(n));
+        data.writeByte(fields.size());
+        for (SeriesStore.Field field : fields) {
+            data.writeByte(field.ordinal());
+        }
+        for (int offset = 9 + fields.size(); offset % 8 != 0; offset++) {
+            data.writeByte(0);
+        }
+        for (int i = 0; i < n; i++) {
+            data.writeLong(Long.reverseBytes(series.timestamp(i)));
+        }
+        for (SeriesStore.Field field : fields) {
+            for (int i = 0; i < n; i++) {
+                data.writeLong(Long.reverseBytes(Double.doubleToRawLongBits(series.value(field, i))));
+            }
+        }
+        data.flush();
+    }
+
+    /**
+     * 指标在JSON和请求参数中的名称，与AirData的属性名相同
+     */
+    static String name(SeriesStore.Field field) {
+        return field.name().toLowerCase();
+    }
+}
@@ -10,6 +10,7 @@ import lombok.NoArgsConstructor;
 @NoArgsConstructor
 @AllArgsConstructor
 public class AirData {
+    private String deviceId;       // 设备ID（8位十六进制）
     private double temperature;    // 温度 (℃)
     private double humidity;       // 湿度 (%)
     private double methane;        // 甲烷浓度 (PPM)
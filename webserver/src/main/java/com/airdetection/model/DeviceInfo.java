@@ -0,0 +1,14 @@
+package com.airdetection.model;
+
+import lombok.AllArgsConstructor;
+import lombok.Data;
+import lombok.NoArgsConstructor;
+
+@Data
+@NoArgsConstructor
+@AllArgsConstructor
+public class DeviceInfo {
+    private String deviceId;       // 设备ID（8位十六进制）
+    private long points;           // 累计收到的数据点数
+    private long lastTimestamp;    // 最新数据的时间戳，没有数据时为0
+}
@@ -0,0 +1,37 @@
+package com.airdetection.model;
+
+import lombok.AllArgsConstructor;
+import lombok.Data;
+import lombok.NoArgsConstructor;
+
+import java.util.List;
+import java.util.Map;
+
+@Data
+@NoArgsConstructor
+@AllArgsConstructor
+public class RollupSeries {
+    private String deviceId;       // 设备ID（8位十六进制）
+    private String resolution;     // 汇总分辨率：1m、1h、1d
+    private List<Bucket> buckets;  // 按时间排序的非空桶
+
+    @Data
+    @NoArgsConstructor
+    @AllArgsConstructor
+    public static class Bucket {
+        private long start;                     // 桶起始时间戳
+        private long count;                     // 桶内点数
+        private Map<String, FieldStats> fields; // 各指标的统计，键与AirData的属性名相同
+    }
+
+    @Data
+    @NoArgsConstructor
+    @AllArgsConstructor
+    public static class FieldStats {
+        private long count;        // 有效值个数，为0时各统计量为null
+        private Double min;
+        private Double max;
+        private Double mean;
+        private Double stddev;     // 总体标准差
+    }
+}
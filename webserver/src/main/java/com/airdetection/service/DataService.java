@@ -1,67 +1,293 @@
 package com.airdetection.service;
 
 import com.airdetection.model.AirData;
+import com.airdetection.model.DeviceInfo;
+import com.airdetection.model.RollupSeries;
+import com.airdetection.store.DownsampledSeries;
+import com.airdetection.store.Lttb;
+import com.airdetection.store.PointBuffer;
+import com.airdetection.store.Resolution;
+import com.airdetection.store.SegmentStore;
+import com.airdetection.store.SeriesStore;
+import com.airdetection.udp.TelemetryFrame;
 import com.alibaba.fastjson.JSON;
 import lombok.extern.slf4j.Slf4j;
 import org.springframework.beans.factory.annotation.Autowired;
+import org.springframework.beans.factory.annotation.Value;
 import org.springframework.messaging.simp.SimpMessagingTemplate;
 import org.springframework.stereotype.Service;
 
+import javax.annotation.PostConstruct;
+import javax.annotation.PreDestroy;
+import java.io.IOException;
+import java.nio.file.Paths;
 import java.util.ArrayList;
+import java.util.LinkedHashMap;
 import java.util.List;
-import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
 
 @Slf4j
 @Service
 public class DataService {
 
+    // /api/history 返回的最大点数
     private static final int MAX_HISTORY_SIZE = 100;
+    // 启动时从磁盘恢复到内存的时间范围
+    private static final long RESTORE_MS = 86_400_000L;
+    // 自动选择汇总分辨率时的最大桶数：1天选1分钟（1440桶），30天选1小时（720桶）
+    private static final int MAX_ROLLUP_BUCKETS = 1500;
+    // 降采样查询读取原始点的最大时间范围（1Hz约17万点），更长的范围读取汇总的均值
+    private static final long MAX_RAW_RANGE_MS = 2 * 86_400_000L;
+    // 降采样查询读取汇总时，桶数不超过输出点数的倍数，LTTB再从中选点
+    private static final int ROLLUP_OVERSAMPLE = 16;
     
-    // 使用线程安全的队列存储历史数据
-    private final ConcurrentLinkedQueue<AirData> historyData = new ConcurrentLinkedQueue<>();
+    // 每个设备一个列式环形存储，设备索引无全局锁：写入只锁各自的存储，读取无锁
+    private final ConcurrentHashMap<String, SeriesStore> devices = new ConcurrentHashMap<>();
+    private final int capacity;
+    
+    // 全部历史数据的磁盘存储
+    private final SegmentStore segmentStore;
+    
+    // 最近收到数据的设备，/api/history 和 /api/latest 返回该设备的数据
+    private volatile String lastDeviceId;
     
     @Autowired
     private SimpMessagingTemplate messagingTemplate;
     
+    public DataService(@Value("${data.history.capacity:3600}") int capacity,
+                       @Value("${data.storage.dir:data}") String storageDir,
+                       @Value("${data.storage.block-points:3600}") int blockPoints,
+                       @Value("${data.storage.flush-interval:60}") int flushIntervalSeconds) throws IOException {
+        this.capacity = capacity;
+        this.segmentStore = new SegmentStore(Paths.get(storageDir), blockPoints, flushIntervalSeconds * 1000L);
+        log.info("每个设备的历史数据容量: {}点，磁盘存储目录: {}，每块最多{}点，刷新间隔{}秒",
+                capacity, Paths.get(storageDir).toAbsolutePath(), blockPoints, flushIntervalSeconds);
+    }
+    
+    /**
+     * 从磁盘恢复各设备最近一天内的数据到内存历史，只解码最近capacity个点所在的块
+     */
+    @PostConstruct
+    public void restore() {
+        long now = System.currentTimeMillis();
+        try {
+            for (String deviceId : segmentStore.deviceIds()) {
+                SeriesStore store = new SeriesStore(capacity);
+                AirData point = new AirData();
+                long from = segmentStore.latestStart(deviceId, now - RESTORE_MS, capacity);
+                segmentStore.query(deviceId, from, Long.MAX_VALUE, SegmentStore.ALL_FIELDS,
+                        (timestamp, temperature, humidity, methane, tvoc, co2, pm25) -> {
+                            point.setTimestamp(timestamp);
+                            point.setTemperature(temperature);
+                            point.setHumidity(humidity);
+                            point.setMethane(methane);
+                            point.setTvoc(tvoc);
+                            point.setCo2(co2);
+                            point.setPm25(pm25);
+                            store.append(point);
+                        });
+                if (store.endSequence() > 0) {
+                    devices.put(deviceId, store);
+                    log.info("设备{}: 从磁盘恢复{}个点", deviceId, Math.min(store.endSequence(), capacity));
+                }
+            }
+        } catch (IOException e) {
+            log.error("从磁盘恢复历史数据失败: {}", e.getMessage(), e);
+        }
+    }
+    
+    @PreDestroy
+    public void close() {
+        segmentStore.close();
+        log.info("磁盘存储已关闭: {}", segmentStore.stats());
+    }
+    
     /**
      * 处理新收到的数据
      */
     public void processNewData(AirData data) {
+        if (data.getDeviceId() == null) {
+            data.setDeviceId(TelemetryFrame.UNKNOWN_DEVICE);
+        }
+        
         // 保存到历史数据
         addToHistory(data);
         
         // 通过WebSocket发送到前端
         sendToWebSocket(data);
         
-        log.info("处理新数据：{}", data);
+        log.debug("处理新数据：{}", data);
     }
     
     /**
-     * 添加数据到历史记录，控制历史记录大小
+     * 添加数据到所属设备的内存历史（存满后覆盖最旧的数据）和磁盘存储
      */
     private void addToHistory(AirData data) {
-        historyData.add(data);
-        // 如果超出最大容量，移除最旧的数据
-        while (historyData.size() > MAX_HISTORY_SIZE) {
-            historyData.poll();
-        }
+        segmentStore.append(data.getDeviceId(), data);
+        devices.computeIfAbsent(data.getDeviceId(), id -> {
+            log.info("新设备: {}", id);
+            return new SeriesStore(capacity);
+        }).append(data);
+        lastDeviceId = data.getDeviceId();
     }
     
     /**
-     * 通过WebSocket发送数据到前端
+     * 通过WebSocket发送数据到前端：汇总主题和设备主题 /topic/air-data/{设备ID}
      */
     private void sendToWebSocket(AirData data) {
         try {
-            messagingTemplate.convertAndSend("/topic/air-data", JSON.toJSONString(data));
+            String json = JSON.toJSONString(data);
+            messagingTemplate.convertAndSend("/topic/air-data", json);
+            messagingTemplate.convertAndSend("/topic/air-data/" + data.getDeviceId(), json);
         } catch (Exception e) {
             log.error("发送数据到WebSocket失败: {}", e.getMessage(), e);
         }
     }
     
     /**
-     * 获取历史数据
+     * 获取最近收到数据的设备的历史数据
      */
     public List<AirData> getHistoryData() {
-        return new ArrayList<>(historyData);
+        String deviceId = lastDeviceId;
+        return deviceId != null ? getHistoryData(deviceId) : new ArrayList<>();
+    }
+    
+    /**
+     * 获取设备最近的历史数据（最多MAX_HISTORY_SIZE个点），设备不存在时返回null
+     */
+    public List<AirData> getHistoryData(String deviceId) {
+        SeriesStore store = devices.get(deviceId);
+        if (store == null) {
+            return null;
+        }
+        List<AirData> result = new ArrayList<>(MAX_HISTORY_SIZE);
+        store.forEach(store.endSequence() - MAX_HISTORY_SIZE,
+                (seq, timestamp, temperature, humidity, methane, tvoc, co2, pm25) -> result.add(AirData.builder()
+                        .deviceId(deviceId)
+                        .timestamp(timestamp)
+                        .temperature(temperature)
+                        .humidity(humidity)
+                        .methane(methane)
+                        .tvoc(tvoc)
+                        .co2(co2)
+                        .pm25(pm25)
+                        .build()));
+        return result;
+    }
+    
+    /**
+     * 最近收到数据的设备，没有数据时返回null
+     */
+    public String getLastDeviceId() {
+        return lastDeviceId;
+    }
+    
+    /**
+     * 获取最近收到数据的设备的最新数据点，没有数据时返回null
+     */
+    public AirData getLatestData() {
+        String deviceId = lastDeviceId;
+        return deviceId != null ? getLatestData(deviceId) : null;
+    }
+    
+    /**
+     * 获取设备的最新数据点，O(1)，设备不存在时返回null
+     */
+    public AirData getLatestData(String deviceId) {
+        SeriesStore store = devices.get(deviceId);
+        AirData data = store != null ? store.latest() : null;
+        if (data != null) {
+            data.setDeviceId(deviceId);
+        }
+        return data;
+    }
+    
+    /**
+     * 已知设备列表
+     */
+    public List<DeviceInfo> getDevices() {
+        List<DeviceInfo> result = new ArrayList<>(devices.size());
+        for (Map.Entry<String, SeriesStore> entry : devices.entrySet()) {
+            SeriesStore store = entry.getValue();
+            long end = store.endSequence();
+            long lastTimestamp = end > 0 ? store.timestamp(end - 1) : 0;
+            result.add(new DeviceInfo(entry.getKey(), end, lastTimestamp));
+        }
+        return result;
+    }
+    
+    /**
+     * 设备的历史数据存储，供按序号增量或零拷贝遍历，设备不存在时返回null
+     */
+    public SeriesStore getHistoryStore(String deviceId) {
+        return devices.get(deviceId);
+    }
+    
+    /**
+     * 按时间顺序访问设备在[from, to)内的全部历史数据（读取磁盘存储）
+     * @param fieldMask 需要的指标，第i位对应SeriesStore.Field的第i项，未选中的指标为NaN
+     */
+    public void queryHistory(String deviceId, long from, long to, int fieldMask,
+                             SegmentStore.RangeVisitor visitor) throws IOException {
+        segmentStore.query(deviceId, from, to, fieldMask, visitor);
+    }
+    
+    /**
+     * 设备在[from, to)内的汇总数据
+     * @param resolution 汇总分辨率，为null时按时间范围自动选择桶数不超过MAX_ROLLUP_BUCKETS的最细分辨率
+     */
+    public RollupSeries getRollups(String deviceId, long from, long to, Resolution resolution) throws IOException {
+        Resolution chosen = resolution != null ? resolution : Resolution.forRange(from, to, MAX_ROLLUP_BUCKETS);
+        List<RollupSeries.Bucket> buckets = new ArrayList<>();
+        segmentStore.queryRollups(deviceId, chosen, from, to, (start, bucket) -> {
+            Map<String, RollupSeries.FieldStats> fields = new LinkedHashMap<>();
+            for (SeriesStore.Field field : SeriesStore.Field.values()) {
+                long count = bucket.count(field);
+                fields.put(field.name().toLowerCase(), count > 0
+                        ? new RollupSeries.FieldStats(count, bucket.min(field), bucket.max(field),
+                                bucket.mean(field), bucket.stddev(field))
+                        : new RollupSeries.FieldStats(0, null, null, null, null));
+            }
+            buckets.add(new RollupSeries.Bucket(start, bucket.count(), fields));
+        });
+        return new RollupSeries(deviceId, chosen.label(), buckets);
+    }
+    
+    /**
+     * 设备在[from, to)内降采样到最多maxPoints个点的序列
+     * 时间范围不超过MAX_RAW_RANGE_MS时读取原始点，否则读取桶数不超过maxPoints * ROLLUP_OVERSAMPLE的
+     * 最细分辨率汇总的均值，再用LTTB按fieldMask中的指标选点
+     * @param fieldMask 需要的指标，第i位对应SeriesStore.Field的第i项
+     * @param maxPoints 输出点数上限，至少为3
+     */
+    public DownsampledSeries querySeries(String deviceId, long from, long to, int fieldMask, int maxPoints)
+            throws IOException {
+        PointBuffer points = new PointBuffer(Math.min(maxPoints * ROLLUP_OVERSAMPLE, 65536));
+        String source;
+        if (to - from <= MAX_RAW_RANGE_MS) {
+            segmentStore.query(deviceId, from, to, fieldMask, points::add);
+            source = "raw";
+        } else {
+            Resolution resolution = Resolution.forRange(from, to, maxPoints * ROLLUP_OVERSAMPLE);
+            double[] means = new double[SeriesStore.Field.values().length];
+            segmentStore.queryRollups(deviceId, resolution, from, to, (start, bucket) -> {
+                for (SeriesStore.Field field : SeriesStore.Field.values()) {
+                    int f = field.ordinal();
+                    // 桶内该指标没有有效值时均值为NaN，LTTB跳过，输出为null
+                    means[f] = (fieldMask & (1 << f)) != 0 ? bucket.mean(field) : Double.NaN;
+                }
+                points.add(start, means[0], means[1], means[2], means[3], means[4], means[5]);
+            });
+            source = resolution.label();
+        }
+        return new DownsampledSeries(source, points, Lttb.select(points, fieldMask, maxPoints));
+    }
+    
+    /**
+     * 磁盘存储统计
+     */
+    public Map<String, Long> getStorageStats() {
+        return segmentStore.stats();
     }
-} 
\ No newline at end of file
+}
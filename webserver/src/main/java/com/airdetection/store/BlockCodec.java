@@ -0,0 +1,376 @@
+package com.airdetection.store;
+
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import java.util.zip.CRC32;
+
+/**
+ * 段文件中的数据块编解码
+ * 一个块保存一批按时间排序的点，各列单独压缩、依次存放，查询时可只解码需要的列：
+ * 时间戳用差值的差值（delta-of-delta）编码，各指标用Gorilla的XOR编码（与前一个值异或，
+ * 只保存有效位），块之间互不依赖
+ * 传感器读数大多是0.1分辨率的十进制数，其二进制尾数几乎每位都在变，XOR编码效果很差；
+ * 因此一个块中某指标的全部值都能由十分位整数精确还原时，改为对该整数做差值编码
+ *
+ * 块布局（大端）：
+ *   0  u16  魔数 'T' 'S'
+ *   2  u8   版本
+ *   3  u8   按十分位整数编码的指标列（第i位对应第i个指标）
+ *   4  i32  点数
+ *   8  i64  最小时间戳
+ *   16 i64  最大时间戳
+ *   24 i32×7 时间戳列和6个指标列的字节数
+ *   52 i32  CRC32，覆盖块头0~51字节和列数据（版本1只覆盖列数据）
+ *   56      列数据
+ * 块头参与校验，点数、时间范围或十分位标志损坏的块整块丢弃，不会被错误解码或被查询跳过；
+ * 版本1的块仍可读取，已有的段文件不会在下次写入前被当作不完整的尾部截掉
+ */
+final class BlockCodec {
+
+    static final int MAGIC = 0x5453;
+    static final int VERSION = 2;
+    static final int VERSION_DATA_CRC = 1;   // 校验值只覆盖列数据的旧版本
+    static final int HEADER_SIZE = 56;
+    static final int COLUMN_COUNT = 1 + PointBuffer.FIELD_COUNT;
+
+    private static final int DECIMAL_OFFSET = 3;
+    private static final int COUNT_OFFSET = 4;
+    private static final int MIN_TS_OFFSET = 8;
+    private static final int MAX_TS_OFFSET = 16;
+    private static final int LENGTHS_OFFSET = 24;
+    private static final int CRC_OFFSET = 52;
+
+    private BlockCodec() {
+    }
+
+    /**
+     * 把buffer中已按时间排序的全部点编码为一个块
+     */
+    static ByteBuffer encode(PointBuffer points) {
+        int count = points.size();
+        BitWriter[] writers = new BitWriter[COLUMN_COUNT];
+        writers[0] = new BitWriter(count * 2 + 16);
+        encodeIntegers(points.timestamps, count, true, writers[0]);
+        int decimalMask = 0;
+        long[] tenths = new long[count];
+        for (int f = 0; f < PointBuffer.FIELD_COUNT; f++) {
+            writers[f + 1] = new BitWriter(count * 2 + 16);
+            if (toTenths(points.columns[f], count, tenths)) {
+                encodeIntegers(tenths, count, false, writers[f + 1]);
+                decimalMask |= 1 << f;
+            } else {
+                encodeValues(points.columns[f], count, writers[f + 1]);
+            }
+        }
+
+        int payload = 0;
+        for (BitWriter writer : writers) {
+            payload += writer.length();
+        }
+        ByteBuffer block = ByteBuffer.allocate(HEADER_SIZE + payload);
+        block.putShort((short) MAGIC);
+        block.put((byte) VERSION);
+        block.put((byte) decimalMask);
+        block.putInt(count);
+        block.putLong(points.timestamps[0]);
+        block.putLong(points.timestamps[count - 1]);
+        for (BitWriter writer : writers) {
+            block.putInt(writer.length());
+        }
+        block.putInt(0);
+        for (BitWriter writer : writers) {
+            block.put(writer.bytes(), 0, writer.length());
+        }
+
+        CRC32 crc = new CRC32();
+        crc.update(block.array(), 0, CRC_OFFSET);
+        crc.update(block.array(), HEADER_SIZE, payload);
+        block.putInt(CRC_OFFSET, (int) crc.getValue());
+        block.flip();
+        return block;
+    }
+
+    /**
+     * 检查offset处是否为完整且校验正确的块
+     * @return 块的总字节数，不完整或损坏时返回-1
+     */
+    static int check(ByteBuffer buf, int offset, int limit) {
+        if (limit - offset < HEADER_SIZE || (buf.getShort(offset) & 0xFFFF) != MAGIC
+                || buf.getInt(offset + COUNT_OFFSET) <= 0) {
+            return -1;
+        }
+        int version = buf.get(offset + 2);
+        if (version != VERSION && version != VERSION_DATA_CRC) {
+            return -1;
+        }
+        long payload = 0;
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            int length = buf.getInt(offset + LENGTHS_OFFSET + c * 4);
+            if (length < 0) {
+                return -1;
+            }
+            payload += length;
+        }
+        if (payload > limit - offset - HEADER_SIZE) {
+            return -1;
+        }
+
+        ByteBuffer data = buf.duplicate();
+        CRC32 crc = new CRC32();
+        if (version == VERSION) {
+            data.limit(offset + CRC_OFFSET).position(offset);
+            crc.update(data);
+        }
+        data.limit(offset + HEADER_SIZE + (int) payload).position(offset + HEADER_SIZE);
+        crc.update(data);
+        if ((int) crc.getValue() != buf.getInt(offset + CRC_OFFSET)) {
+            return -1;
+        }
+        return HEADER_SIZE + (int) payload;
+    }
+
+    static int count(ByteBuffer buf, int offset) {
+        return buf.getInt(offset + COUNT_OFFSET);
+    }
+
+    static long minTimestamp(ByteBuffer buf, int offset) {
+        return buf.getLong(offset + MIN_TS_OFFSET);
+    }
+
+    static long maxTimestamp(ByteBuffer buf, int offset) {
+        return buf.getLong(offset + MAX_TS_OFFSET);
+    }
+
+    /**
+     * 把offset处的块解码追加到out，fieldMask中未选中的指标列不解码，填入NaN
+     * 块须已经check确认完整
+     */
+    static void decode(ByteBuffer buf, int offset, int fieldMask, PointBuffer out) {
+        int count = count(buf, offset);
+        int base = out.size;
+        out.ensureCapacity(base + count);
+
+        int decimalMask = buf.get(offset + DECIMAL_OFFSET);
+        int column = offset + HEADER_SIZE;
+        int length = buf.getInt(offset + LENGTHS_OFFSET);
+        decodeIntegers(new BitReader(buf, column), true, out.timestamps, base, count);
+        for (int f = 0; f < PointBuffer.FIELD_COUNT; f++) {
+            column += length;
+            length = buf.getInt(offset + LENGTHS_OFFSET + (f + 1) * 4);
+            if ((fieldMask & (1 << f)) == 0) {
+                Arrays.fill(out.columns[f], base, base + count, Double.NaN);
+            } else if ((decimalMask & (1 << f)) != 0) {
+                decodeTenths(new BitReader(buf, column), out.columns[f], base, count);
+            } else {
+                decodeValues(new BitReader(buf, column), out.columns[f], base, count);
+            }
+        }
+        out.size = base + count;
+    }
+
+    // 全部值都能由十分位整数精确还原时把整数写入tenths并返回true；NaN、无穷和-0.0不能还原
+    private static boolean toTenths(double[] values, int count, long[] tenths) {
+        for (int i = 0; i < count; i++) {
+            double v = values[i];
+            if (!(Math.abs(v) < 1e15)) {
+                return false;
+            }
+            long q = Math.round(v * 10);
+            if (Double.doubleToRawLongBits(q / 10.0) != Double.doubleToRawLongBits(v)) {
+                return false;
+            }
+            tenths[i] = q;
+        }
+        return true;
+    }
+
+    private static void decodeTenths(BitReader in, double[] out, int base, int count) {
+        long[] tenths = new long[count];
+        decodeIntegers(in, false, tenths, 0, count);
+        for (int i = 0; i < count; i++) {
+            out[base + i] = tenths[i] / 10.0;
+        }
+    }
+
+    /*
+     * 整数序列（时间戳和十分位整数）：首个值原样64位，之后按差值d分档：
+     * 0 -> '0'；[-63,64] -> '10'+7位；[-255,256] -> '110'+9位；[-2047,2048] -> '1110'+12位；
+     * 其他 -> '1111'+64位。时间戳取差值的差值（delta-of-delta），1Hz上报时只剩毫秒级的接收抖动，
+     * 大多落在前两档；十分位整数取一阶差值
+     */
+    private static void encodeIntegers(long[] values, int count, boolean secondOrder, BitWriter out) {
+        out.write(values[0], 64);
+        long prevDelta = 0;
+        for (int i = 1; i < count; i++) {
+            long delta = values[i] - values[i - 1];
+            long d = secondOrder ? delta - prevDelta : delta;
+            prevDelta = delta;
+            if (d == 0) {
+                out.write(0, 1);
+            } else if (d >= -63 && d <= 64) {
+                out.write(0b10, 2);
+                out.write(d + 63, 7);
+            } else if (d >= -255 && d <= 256) {
+                out.write(0b110, 3);
+                out.write(d + 255, 9);
+            } else if (d >= -2047 && d <= 2048) {
+                out.write(0b1110, 4);
+                out.write(d + 2047, 12);
+            } else {
+                out.write(0b1111, 4);
+                out.write(d, 64);
+            }
+        }
+    }
+
+    private static void decodeIntegers(BitReader in, boolean secondOrder, long[] out, int base, int count) {
+        long value = in.read(64);
+        out[base] = value;
+        long delta = 0;
+        for (int i = 1; i < count; i++) {
+            long d;
+            if (!in.readBit()) {
+                d = 0;
+            } else if (!in.readBit()) {
+                d = in.read(7) - 63;
+            } else if (!in.readBit()) {
+                d = in.read(9) - 255;
+            } else if (!in.readBit()) {
+                d = in.read(12) - 2047;
+            } else {
+                d = in.read(64);
+            }
+            delta = secondOrder ? delta + d : d;
+            value += delta;
+            out[base + i] = value;
+        }
+    }
+
+    /*
+     * 指标值（Gorilla XOR）：首个值原样64位，之后与前一个值的位模式异或：
+     * 相同 -> '0'；有效位落在上一个窗口内 -> '10'+窗口内的位；
+     * 否则 -> '11'+前导零个数(5位)+有效位数-1(6位)+有效位，并以此作为新窗口
+     */
+    private static void encodeValues(double[] values, int count, BitWriter out) {
+        long prev = Double.doubleToRawLongBits(values[0]);
+        out.write(prev, 64);
+        int prevLeading = -1;
+        int prevTrailing = 0;
+        for (int i = 1; i < count; i++) {
+            long bits = Double.doubleToRawLongBits(values[i]);
+            long xor = bits ^ prev;
+            prev = bits;
+            if (xor == 0) {
+                out.write(0, 1);
+                continue;
+            }
+            int leading = Math.min(Long.numberOfLeadingZeros(xor), 31);
+            int trailing = Long.numberOfTrailingZeros(xor);
+            if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+                out.write(0b10, 2);
+                out.write(xor >>> prevTrailing, 64 - prevLeading - prevTrailing);
+            } else {
+                int significant = 64 - leading - trailing;
+                out.write(0b11, 2);
+                out.write(leading, 5);
+                out.write(significant - 1, 6);
+                out.write(xor >>> trailing, significant);
+                prevLeading = leading;
+                prevTrailing = trailing;
+            }
+        }
+    }
+
+    private static void decodeValues(BitReader in, double[] out, int base, int count) {
+        long bits = in.read(64);
+        out[base] = Double.longBitsToDouble(bits);
+        int leading = 0;
+        int trailing = 0;
+        for (int i = 1; i < count; i++) {
+            if (in.readBit()) {
+                if (in.readBit()) {
+                    leading = (int) in.read(5);
+                    int significant = (int) in.read(6) + 1;
+                    trailing = 64 - leading - significant;
+                }
+                bits ^= in.read(64 - leading - trailing) << trailing;
+            }
+            out[base + i] = Double.longBitsToDouble(bits);
+        }
+    }
+
+    /**
+     * 按位写入（高位在前），字节数组按需增长
+     */
+    private static final class BitWriter {
+        private byte[] buf;
+        private long bitCount = 0;
+
+        BitWriter(int initialBytes) {
+            buf = new byte[initialBytes];
+        }
+
+        /**
+         * 写入value的低bits位，bits为1~64
+         */
+        void write(long value, int bits) {
+            while (bits > 0) {
+                int index = (int) (bitCount >>> 3);
+                if (index >= buf.length) {
+                    buf = Arrays.copyOf(buf, buf.length * 2);
+                }
+                int free = 8 - (int) (bitCount & 7);
+                int take = Math.min(free, bits);
+                int chunk = (int) (value >>> (bits - take)) & ((1 << take) - 1);
+                buf[index] |= (byte) (chunk << (free - take));
+                bitCount += take;
+                bits -= take;
+            }
+        }
+
+        byte[] bytes() {
+            return buf;
+        }
+
+        int length() {
+            return (int) ((bitCount + 7) >>> 3);
+        }
+    }
+
+    /**
+     * 按位读取（高位在前），直接读映射的段文件
+     */
+    private static final class BitReader {
+        private final ByteBuffer buf;
+        private final int start;
+        private long bitPos = 0;
+
+        BitReader(ByteBuffer buf, int start) {
+            this.buf = buf;
+            this.start = start;
+        }
+
+        boolean readBit() {
+            int b = buf.get(start + (int) (bitPos >>> 3));
+            boolean bit = ((b >>> (7 - (int) (bitPos & 7))) & 1) != 0;
+            bitPos++;
+            return bit;
+        }
+
+        /**
+         * 读取bits位（1~64）作为无符号值
+         */
+        long read(int bits) {
+            long value = 0;
+            while (bits > 0) {
+                int avail = 8 - (int) (bitPos & 7);
+                int take = Math.min(avail, bits);
+                int b = buf.get(start + (int) (bitPos >>> 3)) & 0xFF;
+                value = (value << take) | ((b >>> (avail - take)) & ((1 << take) - 1));
+                bitPos += take;
+                bits -= take;
+            }
+            return value;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+package com.airdetection.store;
+
+/**
+ * 降采样后的序列：查询得到的点和其中被选中输出的点的下标
+ */
+public final class DownsampledSeries {
+
+    private final String source;
+    private final PointBuffer points;
+    private final int[] selected;
+
+    /**
+     * @param source   数据来源：raw表示原始点，否则为汇总分辨率的标签（各桶的均值）
+     * @param points   按时间排序的点
+     * @param selected 输出的点在points中的下标，升序
+     */
+    public DownsampledSeries(String source, PointBuffer points, int[] selected) {
+        this.source = source;
+        this.points = points;
+        this.selected = selected;
+    }
+
+    public String source() {
+        return source;
+    }
+
+    /**
+     * 降采样前的点数
+     */
+    public int sourceSize() {
+        return points.size();
+    }
+
+    public int size() {
+        return selected.length;
+    }
+
+    public long timestamp(int i) {
+        return points.timestamps[selected[i]];
+    }
+
+    public double value(SeriesStore.Field field, int i) {
+        return points.columns[field.ordinal()][selected[i]];
+    }
+}
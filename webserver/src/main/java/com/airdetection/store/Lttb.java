@@ -0,0 +1,122 @@
+package com.airdetection.store;
+
+/**
+ * LTTB（Largest-Triangle-Three-Buckets）降采样
+ * 首尾两点保留，中间的点均分为threshold-2个桶，每个桶选出与上一个选中点、下一个桶的平均点
+ * 构成的三角形面积最大的点，能保留峰谷形状
+ * 多个指标共用时间轴：各指标的面积按该指标在数据中的取值范围归一化后相加，
+ * 因此选出的点对每个指标都有代表性，输出仍是按行的点；无效值（NaN）不参与取值范围、平均点和面积
+ */
+public final class Lttb {
+
+    private Lttb() {
+    }
+
+    /**
+     * 选出最多threshold个点
+     * @param points    按时间排序的点
+     * @param fieldMask 参与选点的指标，第i位对应SeriesStore.Field的第i项
+     * @param threshold 输出点数上限，至少为3
+     * @return 选中的点的下标，升序；点数不超过threshold时返回全部下标
+     */
+    public static int[] select(PointBuffer points, int fieldMask, int threshold) {
+        int n = points.size();
+        if (threshold < 3) {
+            throw new IllegalArgumentException("输出点数至少为3: " + threshold);
+        }
+        if (n <= threshold) {
+            int[] all = new int[n];
+            for (int i = 0; i < n; i++) {
+                all[i] = i;
+            }
+            return all;
+        }
+
+        long[] ts = points.timestamps;
+        double[][] columns = points.columns;
+        int fieldCount = 0;
+        int[] fields = new int[PointBuffer.FIELD_COUNT];
+        double[] scale = new double[PointBuffer.FIELD_COUNT];
+        for (int f = 0; f < PointBuffer.FIELD_COUNT; f++) {
+            if ((fieldMask & (1 << f)) == 0) {
+                continue;
+            }
+            double min = Double.POSITIVE_INFINITY;
+            double max = Double.NEGATIVE_INFINITY;
+            for (int i = 0; i < n; i++) {
+                double v = columns[f][i];
+                if (!Double.isNaN(v)) {
+                    min = Math.min(min, v);
+                    max = Math.max(max, v);
+                }
+            }
+            // 取值恒定或没有有效值的指标不参与选点
+            if (max > min) {
+                fields[fieldCount] = f;
+                scale[fieldCount] = 1.0 / (max - min);
+                fieldCount++;
+            }
+        }
+
+        int[] selected = new int[threshold];
+        double[] avgY = new double[fieldCount];
+        int[] avgYCount = new int[fieldCount];
+        double every = (double) (n - 2) / (threshold - 2);
+        long base = ts[0];
+        int a = 0;
+        selected[0] = 0;
+
+        for (int b = 0; b < threshold - 2; b++) {
+            // 下一个桶的平均点
+            int avgStart = (int) ((b + 1) * every) + 1;
+            int avgEnd = Math.min((int) ((b + 2) * every) + 1, n);
+            double avgX = 0;
+            for (int k = 0; k < fieldCount; k++) {
+                avgY[k] = 0;
+                avgYCount[k] = 0;
+            }
+            for (int i = avgStart; i < avgEnd; i++) {
+                avgX += ts[i] - base;
+                for (int k = 0; k < fieldCount; k++) {
+                    double v = columns[fields[k]][i];
+                    if (!Double.isNaN(v)) {
+                        avgY[k] += v;
+                        avgYCount[k]++;
+                    }
+                }
+            }
+            avgX /= avgEnd - avgStart;
+            for (int k = 0; k < fieldCount; k++) {
+                // 下一个桶全部无效时avgY为NaN，该指标在本桶不贡献面积
+                avgY[k] = avgYCount[k] > 0 ? avgY[k] / avgYCount[k] : Double.NaN;
+            }
+
+            // 当前桶中与上一个选中点a构成最大三角形的点
+            int rangeStart = (int) (b * every) + 1;
+            int rangeEnd = (int) ((b + 1) * every) + 1;
+            double ax = ts[a] - base;
+            double maxArea = -1;
+            int next = rangeStart;
+            for (int i = rangeStart; i < rangeEnd; i++) {
+                double x = ts[i] - base;
+                double area = 0;
+                for (int k = 0; k < fieldCount; k++) {
+                    double[] y = columns[fields[k]];
+                    double ay = y[a];
+                    double triangle = Math.abs((ax - avgX) * (y[i] - ay) - (ax - x) * (avgY[k] - ay)) * scale[k];
+                    if (!Double.isNaN(triangle)) {
+                        area += triangle;
+                    }
+                }
+                if (area > maxArea) {
+                    maxArea = area;
+                    next = i;
+                }
+            }
+            selected[b + 1] = next;
+            a = next;
+        }
+        selected[threshold - 1] = n - 1;
+        return selected;
+    }
+}
@@ -0,0 +1,119 @@
+package com.airdetection.store;
+
+import com.airdetection.model.AirData;
+
+import java.util.Arrays;
+
+/**
+ * 可增长的列式点缓冲：时间戳和各指标各占一个基本类型数组
+ * 用作SegmentStore的写入缓冲和查询时的解码缓冲，非线程安全
+ */
+public final class PointBuffer {
+
+    static final int FIELD_COUNT = SeriesStore.Field.values().length;
+
+    long[] timestamps;
+    final double[][] columns = new double[FIELD_COUNT][];   // [Field.ordinal()][下标]
+    int size = 0;
+
+    public PointBuffer(int initialCapacity) {
+        int capacity = Math.max(16, initialCapacity);
+        timestamps = new long[capacity];
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            columns[f] = new double[capacity];
+        }
+    }
+
+    public void add(AirData data) {
+        ensureCapacity(size + 1);
+        int i = size++;
+        timestamps[i] = data.getTimestamp();
+        columns[SeriesStore.Field.TEMPERATURE.ordinal()][i] = data.getTemperature();
+        columns[SeriesStore.Field.HUMIDITY.ordinal()][i] = data.getHumidity();
+        columns[SeriesStore.Field.METHANE.ordinal()][i] = data.getMethane();
+        columns[SeriesStore.Field.TVOC.ordinal()][i] = data.getTvoc();
+        columns[SeriesStore.Field.CO2.ordinal()][i] = data.getCo2();
+        columns[SeriesStore.Field.PM25.ordinal()][i] = data.getPm25();
+    }
+
+    /**
+     * 追加一个点，参数顺序与SegmentStore.RangeVisitor相同，可直接作为查询回调
+     */
+    public void add(long timestamp, double temperature, double humidity,
+                    double methane, double tvoc, double co2, double pm25) {
+        ensureCapacity(size + 1);
+        int i = size++;
+        timestamps[i] = timestamp;
+        columns[SeriesStore.Field.TEMPERATURE.ordinal()][i] = temperature;
+        columns[SeriesStore.Field.HUMIDITY.ordinal()][i] = humidity;
+        columns[SeriesStore.Field.METHANE.ordinal()][i] = methane;
+        columns[SeriesStore.Field.TVOC.ordinal()][i] = tvoc;
+        columns[SeriesStore.Field.CO2.ordinal()][i] = co2;
+        columns[SeriesStore.Field.PM25.ordinal()][i] = pm25;
+    }
+
+    /**
+     * 追加另一个缓冲的全部点
+     */
+    public void addAll(PointBuffer other) {
+        ensureCapacity(size + other.size);
+        System.arraycopy(other.timestamps, 0, timestamps, size, other.size);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            System.arraycopy(other.columns[f], 0, columns[f], size, other.size);
+        }
+        size += other.size;
+    }
+
+    public int size() {
+        return size;
+    }
+
+    public long timestamp(int i) {
+        return timestamps[i];
+    }
+
+    public double value(SeriesStore.Field field, int i) {
+        return columns[field.ordinal()][i];
+    }
+
+    public void clear() {
+        size = 0;
+    }
+
+    /**
+     * 按时间戳稳定排序
+     * 数据通常已有序或只有少量补发的迟到点，插入排序在这种情况下接近线性
+     */
+    public void sortByTime() {
+        for (int i = 1; i < size; i++) {
+            long ts = timestamps[i];
+            if (ts >= timestamps[i - 1]) {
+                continue;
+            }
+            int j = i;
+            while (j > 0 && timestamps[j - 1] > ts) {
+                j--;
+            }
+            // 把第i个点移到位置j，各列同样移动
+            System.arraycopy(timestamps, j, timestamps, j + 1, i - j);
+            timestamps[j] = ts;
+            for (int f = 0; f < FIELD_COUNT; f++) {
+                double[] column = columns[f];
+                double v = column[i];
+                System.arraycopy(column, j, column, j + 1, i - j);
+                column[j] = v;
+            }
+        }
+    }
+
+    void ensureCapacity(int capacity) {
+        if (capacity <= timestamps.length) {
+            return;
+        }
+        int grown = Math.max(capacity, timestamps.length * 2);
+        timestamps = Arrays.copyOf(timestamps, grown);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            columns[f] = Arrays.copyOf(columns[f], grown);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+package com.airdetection.store;
+
+/**
+ * 汇总数据的时间分辨率
+ * 每种分辨率的汇总按固定槽位存放在设备目录下的文件中，一个文件覆盖bucketsPerFile个桶，
+ * 文件名为首个桶所在的日期加分辨率和槽位格式版本后缀，如 2026-10-17.1m.v2
+ */
+public enum Resolution {
+    MINUTE("1m", 60_000L, 1440),
+    HOUR("1h", 3_600_000L, 1536),
+    DAY("1d", 86_400_000L, 1024);
+
+    private final String label;
+    private final long bucketMs;
+    private final int bucketsPerFile;
+
+    Resolution(String label, long bucketMs, int bucketsPerFile) {
+        this.label = label;
+        this.bucketMs = bucketMs;
+        this.bucketsPerFile = bucketsPerFile;
+    }
+
+    public String label() {
+        return label;
+    }
+
+    public long bucketMs() {
+        return bucketMs;
+    }
+
+    int bucketsPerFile() {
+        return bucketsPerFile;
+    }
+
+    /**
+     * 时间戳所在桶的起始时刻
+     */
+    public long bucketStart(long timestamp) {
+        return Math.floorDiv(timestamp, bucketMs) * bucketMs;
+    }
+
+    /**
+     * 桶数不超过maxBuckets的最细分辨率，都超过时返回DAY
+     */
+    public static Resolution forRange(long from, long to, int maxBuckets) {
+        for (Resolution resolution : values()) {
+            if ((to - from + resolution.bucketMs - 1) / resolution.bucketMs <= maxBuckets) {
+                return resolution;
+            }
+        }
+        return DAY;
+    }
+
+    /**
+     * 按标签（1m、1h、1d）查找，未知标签返回null
+     */
+    public static Resolution parse(String label) {
+        for (Resolution resolution : values()) {
+            if (resolution.label.equals(label)) {
+                return resolution;
+            }
+        }
+        return null;
+    }
+}
@@ -0,0 +1,127 @@
+package com.airdetection.store;
+
+import com.airdetection.model.AirData;
+
+import java.nio.ByteBuffer;
+
+/**
+ * 一个时间桶内各指标的汇总：桶内点数，以及每个指标的有效值个数、最小值、最大值、和、平方和
+ * 这些量都可以增量累加，均值和标准差由它们算出；无效的读数（NaN）不计入该指标
+ */
+public final class RollupBucket {
+
+    // 磁盘上的记录：点数i64，之后每个指标依次为有效值个数(i64)、最小值、最大值、和、平方和（f64）
+    static final int RECORD_SIZE = 8 + PointBuffer.FIELD_COUNT * 5 * 8;
+    private static final int FIELD_SIZE = 5 * 8;
+
+    private long count = 0;
+    private final long[] counts = new long[PointBuffer.FIELD_COUNT];
+    private final double[] min = new double[PointBuffer.FIELD_COUNT];
+    private final double[] max = new double[PointBuffer.FIELD_COUNT];
+    private final double[] sum = new double[PointBuffer.FIELD_COUNT];
+    private final double[] sumOfSquares = new double[PointBuffer.FIELD_COUNT];
+    boolean modified = false;   // 自上次写回后有新的点，不属于磁盘记录
+
+    void add(AirData data) {
+        add(SeriesStore.Field.TEMPERATURE, data.getTemperature());
+        add(SeriesStore.Field.HUMIDITY, data.getHumidity());
+        add(SeriesStore.Field.METHANE, data.getMethane());
+        add(SeriesStore.Field.TVOC, data.getTvoc());
+        add(SeriesStore.Field.CO2, data.getCo2());
+        add(SeriesStore.Field.PM25, data.getPm25());
+        count++;
+        modified = true;
+    }
+
+    private void add(SeriesStore.Field field, double value) {
+        if (Double.isNaN(value)) {
+            return;
+        }
+        int f = field.ordinal();
+        if (counts[f] == 0 || value < min[f]) {
+            min[f] = value;
+        }
+        if (counts[f] == 0 || value > max[f]) {
+            max[f] = value;
+        }
+        sum[f] += value;
+        sumOfSquares[f] += value * value;
+        counts[f]++;
+    }
+
+    void copyFrom(RollupBucket other) {
+        count = other.count;
+        System.arraycopy(other.counts, 0, counts, 0, counts.length);
+        System.arraycopy(other.min, 0, min, 0, min.length);
+        System.arraycopy(other.max, 0, max, 0, max.length);
+        System.arraycopy(other.sum, 0, sum, 0, sum.length);
+        System.arraycopy(other.sumOfSquares, 0, sumOfSquares, 0, sumOfSquares.length);
+    }
+
+    void read(ByteBuffer buf, int offset) {
+        count = buf.getLong(offset);
+        for (int f = 0; f < PointBuffer.FIELD_COUNT; f++) {
+            int base = offset + 8 + f * FIELD_SIZE;
+            counts[f] = buf.getLong(base);
+            min[f] = buf.getDouble(base + 8);
+            max[f] = buf.getDouble(base + 16);
+            sum[f] = buf.getDouble(base + 24);
+            sumOfSquares[f] = buf.getDouble(base + 32);
+        }
+    }
+
+    void write(ByteBuffer buf, int offset) {
+        buf.putLong(offset, count);
+        for (int f = 0; f < PointBuffer.FIELD_COUNT; f++) {
+            int base = offset + 8 + f * FIELD_SIZE;
+            buf.putLong(base, counts[f]);
+            buf.putDouble(base + 8, min[f]);
+            buf.putDouble(base + 16, max[f]);
+            buf.putDouble(base + 24, sum[f]);
+            buf.putDouble(base + 32, sumOfSquares[f]);
+        }
+    }
+
+    /**
+     * 桶内的点数，包括部分指标无效的点
+     */
+    public long count() {
+        return count;
+    }
+
+    /**
+     * 指标的有效值个数，为0时该指标的统计量均为NaN
+     */
+    public long count(SeriesStore.Field field) {
+        return counts[field.ordinal()];
+    }
+
+    public double min(SeriesStore.Field field) {
+        return counts[field.ordinal()] > 0 ? min[field.ordinal()] : Double.NaN;
+    }
+
+    public double max(SeriesStore.Field field) {
+        return counts[field.ordinal()] > 0 ? max[field.ordinal()] : Double.NaN;
+    }
+
+    public double sum(SeriesStore.Field field) {
+        return sum[field.ordinal()];
+    }
+
+    public double sumOfSquares(SeriesStore.Field field) {
+        return sumOfSquares[field.ordinal()];
+    }
+
+    public double mean(SeriesStore.Field field) {
+        long n = counts[field.ordinal()];
+        return n > 0 ? sum[field.ordinal()] / n : Double.NaN;
+    }
+
+    /**
+     * 总体标准差，由平方和算出，舍入误差可能使方差略小于0，此时取0
+     */
+    public double stddev(SeriesStore.Field field) {
+        double mean = mean(field);
+        return Math.sqrt(Math.max(0, sumOfSquares[field.ordinal()] / counts[field.ordinal()] - mean * mean));
+    }
+}
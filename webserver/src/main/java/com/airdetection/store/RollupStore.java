@@ -0,0 +1,264 @@
+package com.airdetection.store;
+
+import com.airdetection.model.AirData;
+import lombok.extern.slf4j.Slf4j;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.DirectoryStream;
+import java.nio.file.Files;
+import java.nio.file.NoSuchFileException;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.time.LocalDate;
+import java.time.format.DateTimeParseException;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.TreeMap;
+import java.util.TreeSet;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.LongAdder;
+
+/**
+ * 多分辨率汇总（1分钟、1小时、1天），随写入增量维护，与段文件存放在同一设备目录
+ * 每个桶在文件中有固定的槽位（RollupBucket.RECORD_SIZE字节，点数为0表示空桶），查询按偏移直接读取；
+ * 文件名带槽位格式版本（FORMAT_VERSION），槽位布局改变后旧文件不会被按新布局读取；
+ * 写入时桶第一次被修改会先读出已有的槽位（重启前的数据或补发的迟到点），之后在内存中累加，
+ * 刷新时把修改过的桶整桶覆盖写回，写回后只保留各分辨率当前的桶
+ */
+@Slf4j
+final class RollupStore {
+
+    private static final long DAY_MS = 86_400_000L;
+    private static final Resolution[] RESOLUTIONS = Resolution.values();
+    // 槽位布局的版本，v2起每个指标单独记录有效值个数
+    private static final String FORMAT_VERSION = "v2";
+
+    /**
+     * 单个设备尚未写回的桶，按分辨率分开
+     */
+    private static final class DeviceRollups {
+        @SuppressWarnings("unchecked")
+        final Map<Long, RollupBucket>[] dirty = new Map[RESOLUTIONS.length];
+        long latest = Long.MIN_VALUE;   // 最新的点的时间戳
+
+        DeviceRollups() {
+            for (int r = 0; r < RESOLUTIONS.length; r++) {
+                dirty[r] = new LinkedHashMap<>();
+            }
+        }
+    }
+
+    private final Path root;
+    private final ConcurrentHashMap<String, DeviceRollups> devices = new ConcurrentHashMap<>();
+
+    final LongAdder bucketsWritten = new LongAdder();
+    final LongAdder pointsSkipped = new LongAdder();
+
+    RollupStore(Path root) {
+        this.root = root;
+    }
+
+    /**
+     * 把一个点累加到各分辨率所在的桶；读取已有槽位失败时跳过该分辨率，避免写回时覆盖已有数据
+     */
+    void append(String deviceId, AirData data) {
+        DeviceRollups rollups = devices.computeIfAbsent(deviceId, id -> new DeviceRollups());
+        long ts = data.getTimestamp();
+        synchronized (rollups) {
+            rollups.latest = Math.max(rollups.latest, ts);
+            for (int r = 0; r < RESOLUTIONS.length; r++) {
+                long start = RESOLUTIONS[r].bucketStart(ts);
+                RollupBucket bucket = rollups.dirty[r].get(start);
+                if (bucket == null) {
+                    try {
+                        bucket = load(deviceId, RESOLUTIONS[r], start);
+                    } catch (IOException e) {
+                        pointsSkipped.increment();
+                        log.error("读取设备{}的{}汇总失败: {}", deviceId, RESOLUTIONS[r].label(), e.getMessage());
+                        continue;
+                    }
+                    rollups.dirty[r].put(start, bucket);
+                }
+                bucket.add(data);
+            }
+        }
+    }
+
+    /**
+     * 写回全部修改过的桶
+     */
+    void flush() {
+        for (Map.Entry<String, DeviceRollups> entry : devices.entrySet()) {
+            DeviceRollups rollups = entry.getValue();
+            synchronized (rollups) {
+                for (int r = 0; r < RESOLUTIONS.length; r++) {
+                    Resolution resolution = RESOLUTIONS[r];
+                    long current = resolution.bucketStart(rollups.latest);
+                    Iterator<Map.Entry<Long, RollupBucket>> it = rollups.dirty[r].entrySet().iterator();
+                    while (it.hasNext()) {
+                        Map.Entry<Long, RollupBucket> bucket = it.next();
+                        if (bucket.getValue().modified) {
+                            try {
+                                store(entry.getKey(), resolution, bucket.getKey(), bucket.getValue());
+                                bucketsWritten.increment();
+                            } catch (IOException e) {
+                                // 保留在内存中，下次刷新时重试
+                                log.error("写入设备{}的{}汇总失败: {}", entry.getKey(), resolution.label(),
+                                        e.getMessage());
+                                continue;
+                            }
+                            bucket.getValue().modified = false;
+                        }
+                        if (bucket.getKey() != current) {
+                            it.remove();
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * 按时间顺序访问起始时刻在[resolution.bucketStart(from), to)内的非空桶，包括尚未写回的桶
+     */
+    void query(String deviceId, Resolution resolution, long from, long to, SegmentStore.BucketVisitor visitor)
+            throws IOException {
+        if (from >= to) {
+            return;
+        }
+        int r = resolution.ordinal();
+        long first = Math.floorDiv(from, resolution.bucketMs());
+        long last = Math.floorDiv(to - 1, resolution.bucketMs());
+
+        // 未写回的桶比文件中的新，覆盖文件中的同一槽位
+        TreeMap<Long, RollupBucket> pending = new TreeMap<>();
+        DeviceRollups rollups = devices.get(deviceId);
+        if (rollups != null) {
+            synchronized (rollups) {
+                for (Map.Entry<Long, RollupBucket> entry : rollups.dirty[r].entrySet()) {
+                    long index = Math.floorDiv(entry.getKey(), resolution.bucketMs());
+                    if (index >= first && index <= last) {
+                        RollupBucket copy = new RollupBucket();
+                        copy.copyFrom(entry.getValue());
+                        pending.put(index, copy);
+                    }
+                }
+            }
+        }
+
+        RollupBucket bucket = new RollupBucket();
+        int perFile = resolution.bucketsPerFile();
+        for (long file : files(deviceId, resolution, Math.floorDiv(first, perFile), Math.floorDiv(last, perFile),
+                pending)) {
+            long fileFirst = Math.max(first, file * perFile);
+            long fileLast = Math.min(last, file * perFile + perFile - 1);
+            ByteBuffer slots = read(deviceId, resolution, file, (int) (fileFirst - file * perFile),
+                    (int) (fileLast - fileFirst + 1));
+            for (long index = fileFirst; index <= fileLast; index++) {
+                RollupBucket source = pending.get(index);
+                if (source == null) {
+                    int offset = (int) (index - fileFirst) * RollupBucket.RECORD_SIZE;
+                    if (offset + RollupBucket.RECORD_SIZE > slots.limit()) {
+                        continue;
+                    }
+                    bucket.read(slots, offset);
+                    source = bucket;
+                }
+                if (source.count() > 0) {
+                    visitor.visit(index * resolution.bucketMs(), source);
+                }
+            }
+        }
+    }
+
+    // 设备在[firstFile, lastFile]内有汇总文件或未写回桶的文件序号，升序
+    private long[] files(String deviceId, Resolution resolution, long firstFile, long lastFile,
+                         TreeMap<Long, RollupBucket> pending) throws IOException {
+        TreeSet<Long> files = new TreeSet<>();
+        for (long index : pending.keySet()) {
+            files.add(Math.floorDiv(index, resolution.bucketsPerFile()));
+        }
+        Path dir = root.resolve(deviceId);
+        if (Files.isDirectory(dir)) {
+            String suffix = suffix(resolution);
+            try (DirectoryStream<Path> list = Files.newDirectoryStream(dir, "*" + suffix)) {
+                for (Path path : list) {
+                    String name = path.getFileName().toString();
+                    long file;
+                    try {
+                        long day = LocalDate.parse(name.substring(0, name.length() - suffix.length())).toEpochDay();
+                        file = day * DAY_MS / (resolution.bucketMs() * resolution.bucketsPerFile());
+                    } catch (DateTimeParseException e) {
+                        continue;
+                    }
+                    if (file >= firstFile && file <= lastFile) {
+                        files.add(file);
+                    }
+                }
+            }
+        }
+        long[] result = new long[files.size()];
+        int n = 0;
+        for (long file : files) {
+            result[n++] = file;
+        }
+        return result;
+    }
+
+    // 读取文件中从槽位slot开始的count个槽位，文件不存在或较短时缺少的部分不在返回的缓冲中
+    private ByteBuffer read(String deviceId, Resolution resolution, long file, int slot, int count)
+            throws IOException {
+        ByteBuffer buf = ByteBuffer.allocate(count * RollupBucket.RECORD_SIZE);
+        try (FileChannel channel = FileChannel.open(path(deviceId, resolution, file), StandardOpenOption.READ)) {
+            long position = (long) slot * RollupBucket.RECORD_SIZE;
+            int n;
+            while (buf.hasRemaining() && (n = channel.read(buf, position)) > 0) {
+                position += n;
+            }
+        } catch (NoSuchFileException e) {
+            // 只有未写回的桶
+        }
+        buf.flip();
+        return buf;
+    }
+
+    private RollupBucket load(String deviceId, Resolution resolution, long start) throws IOException {
+        long index = Math.floorDiv(start, resolution.bucketMs());
+        long file = Math.floorDiv(index, resolution.bucketsPerFile());
+        ByteBuffer slot = read(deviceId, resolution, file, (int) (index - file * resolution.bucketsPerFile()), 1);
+        RollupBucket bucket = new RollupBucket();
+        if (slot.limit() == RollupBucket.RECORD_SIZE) {
+            bucket.read(slot, 0);
+        }
+        return bucket;
+    }
+
+    private void store(String deviceId, Resolution resolution, long start, RollupBucket bucket) throws IOException {
+        long index = Math.floorDiv(start, resolution.bucketMs());
+        long file = Math.floorDiv(index, resolution.bucketsPerFile());
+        long slot = index - file * resolution.bucketsPerFile();
+        ByteBuffer buf = ByteBuffer.allocate(RollupBucket.RECORD_SIZE);
+        bucket.write(buf, 0);
+
+        Path path = path(deviceId, resolution, file);
+        Files.createDirectories(path.getParent());
+        try (FileChannel channel = FileChannel.open(path, StandardOpenOption.CREATE, StandardOpenOption.WRITE)) {
+            long position = slot * RollupBucket.RECORD_SIZE;
+            while (buf.hasRemaining()) {
+                position += channel.write(buf, position);
+            }
+        }
+    }
+
+    private Path path(String deviceId, Resolution resolution, long file) {
+        long day = file * resolution.bucketsPerFile() * resolution.bucketMs() / DAY_MS;
+        return root.resolve(deviceId).resolve(LocalDate.ofEpochDay(day) + suffix(resolution));
+    }
+
+    private static String suffix(Resolution resolution) {
+        return "." + resolution.label() + "." + FORMAT_VERSION;
+    }
+}
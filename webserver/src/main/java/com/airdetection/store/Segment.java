@@ -0,0 +1,115 @@
+package com.airdetection.store;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.util.Arrays;
+
+/**
+ * 段文件的只读视图：把文件映射到内存并建立块索引（偏移、点数、时间范围）
+ * 当天的段仍在追加，refresh发现文件变长时重新映射并只索引新增的块；
+ * 索引以不可变快照发布，查询读取快照无需加锁
+ */
+final class Segment implements Closeable {
+
+    /**
+     * 某一时刻的映射和块索引，offsets等数组中前blocks项有效且不再改变
+     */
+    static final class View {
+        final ByteBuffer map;
+        final int blocks;
+        final int[] offsets;
+        final long[] minTimestamps;
+        final long[] maxTimestamps;
+
+        View(ByteBuffer map, int blocks, int[] offsets, long[] minTimestamps, long[] maxTimestamps) {
+            this.map = map;
+            this.blocks = blocks;
+            this.offsets = offsets;
+            this.minTimestamps = minTimestamps;
+            this.maxTimestamps = maxTimestamps;
+        }
+    }
+
+    private static final View EMPTY = new View(ByteBuffer.allocate(0), 0, new int[0], new long[0], new long[0]);
+
+    private final Path path;
+    private final FileChannel channel;
+    private volatile View view = EMPTY;
+    private long mappedSize = 0;
+    private int indexedEnd = 0;      // 已索引的块的结束偏移
+
+    Segment(Path path) throws IOException {
+        this.path = path;
+        this.channel = FileChannel.open(path, StandardOpenOption.READ);
+    }
+
+    Path path() {
+        return path;
+    }
+
+    /**
+     * 索引文件新增的块并返回最新视图
+     * 末尾不完整的块（正在写入或崩溃时写了一半）不索引，下次刷新时再检查
+     */
+    synchronized View refresh() throws IOException {
+        long size = Math.min(channel.size(), Integer.MAX_VALUE);
+        if (size == mappedSize) {
+            return view;
+        }
+        MappedByteBuffer map = channel.map(FileChannel.MapMode.READ_ONLY, 0, size);
+        mappedSize = size;
+
+        View old = view;
+        int blocks = old.blocks;
+        int[] offsets = old.offsets;
+        long[] minTimestamps = old.minTimestamps;
+        long[] maxTimestamps = old.maxTimestamps;
+        int limit = (int) size;
+        int offset = indexedEnd;
+        int length;
+        while ((length = BlockCodec.check(map, offset, limit)) > 0) {
+            if (blocks == offsets.length) {
+                int grown = Math.max(16, blocks * 2);
+                offsets = Arrays.copyOf(offsets, grown);
+                minTimestamps = Arrays.copyOf(minTimestamps, grown);
+                maxTimestamps = Arrays.copyOf(maxTimestamps, grown);
+            }
+            offsets[blocks] = offset;
+            minTimestamps[blocks] = BlockCodec.minTimestamp(map, offset);
+            maxTimestamps[blocks] = BlockCodec.maxTimestamp(map, offset);
+            blocks++;
+            offset += length;
+        }
+        indexedEnd = offset;
+        view = new View(map, blocks, offsets, minTimestamps, maxTimestamps);
+        return view;
+    }
+
+    /**
+     * 文件开头连续的完整块的总长度，用于写入前截掉崩溃时写了一半的尾部
+     */
+    static long validLength(FileChannel channel) throws IOException {
+        long size = Math.min(channel.size(), Integer.MAX_VALUE);
+        if (size == 0) {
+            return 0;
+        }
+        MappedByteBuffer map = channel.map(FileChannel.MapMode.READ_ONLY, 0, size);
+        int offset = 0;
+        int length;
+        while ((length = BlockCodec.check(map, offset, (int) size)) > 0) {
+            offset += length;
+        }
+        return offset;
+    }
+
+    @Override
+    public void close() throws IOException {
+        // 已发布的映射在通道关闭后仍然有效，正在进行的查询不受影响
+        channel.close();
+    }
+}
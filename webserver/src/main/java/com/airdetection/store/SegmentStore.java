@@ -0,0 +1,528 @@
+package com.airdetection.store;
+
+import com.airdetection.model.AirData;
+import lombok.extern.slf4j.Slf4j;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.DirectoryStream;
+import java.nio.file.Files;
+import java.nio.file.NoSuchFileException;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.time.LocalDate;
+import java.time.format.DateTimeParseException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Comparator;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.LongAdder;
+import java.util.regex.Pattern;
+
+/**
+ * 磁盘上的只追加列式时间序列存储
+ * 每个设备每天（UTC）一个段文件 {目录}/{设备ID}/{yyyy-MM-dd}.seg，由BlockCodec编码的块依次追加；
+ * 写入先进入各设备的内存缓冲，攒满blockPoints个点或超过flushIntervalMs时整批编码为一个块写入，
+ * 查询通过Segment映射段文件，按块的时间范围跳过无关的块，并合并尚未写入的缓冲
+ * 异常退出时最多丢失一个刷新间隔内的数据，写了一半的块在下次写入该段前被截掉
+ * 同时由RollupStore在同一目录维护1分钟、1小时、1天的汇总，长时间范围的查询读汇总而不扫描原始点
+ */
+@Slf4j
+public final class SegmentStore implements Closeable {
+
+    /**
+     * 查询结果的逐点回调，未选中的指标为NaN
+     */
+    @FunctionalInterface
+    public interface RangeVisitor {
+        void visit(long timestamp, double temperature, double humidity,
+                   double methane, double tvoc, double co2, double pm25);
+    }
+
+    /**
+     * 汇总查询的逐桶回调，bucket在回调返回后会被复用
+     */
+    @FunctionalInterface
+    public interface BucketVisitor {
+        void visit(long start, RollupBucket bucket);
+    }
+
+    // 全部指标的fieldMask
+    public static final int ALL_FIELDS = (1 << PointBuffer.FIELD_COUNT) - 1;
+
+    private static final long DAY_MS = 86_400_000L;
+    private static final String SUFFIX = ".seg";
+    private static final Pattern DEVICE_ID = Pattern.compile("[0-9A-Za-z_-]{1,32}");
+    // 同时保持映射的段文件数
+    private static final int MAX_OPEN_SEGMENTS = 256;
+
+    /**
+     * 单个设备的写入缓冲
+     */
+    private static final class DeviceBuffer {
+        final PointBuffer points;
+        long day;               // 缓冲中的点所属的日期（epoch day）
+        long firstAppendTime;   // 缓冲中第一个点的写入时刻
+
+        DeviceBuffer(int capacity) {
+            points = new PointBuffer(capacity);
+        }
+    }
+
+    private final Path root;
+    private final int blockPoints;
+    private final long flushIntervalMs;
+    private final ConcurrentHashMap<String, DeviceBuffer> buffers = new ConcurrentHashMap<>();
+    // 本次运行中已检查过尾部的段文件
+    private final Set<Path> verified = ConcurrentHashMap.newKeySet();
+    private final Map<Path, Segment> segments = new LinkedHashMap<Path, Segment>(16, 0.75f, true) {
+        @Override
+        protected boolean removeEldestEntry(Map.Entry<Path, Segment> eldest) {
+            if (size() <= MAX_OPEN_SEGMENTS) {
+                return false;
+            }
+            closeQuietly(eldest.getValue());
+            return true;
+        }
+    };
+    private final RollupStore rollups;
+    private final ScheduledExecutorService flusher;
+    private long lastRollupFlush = System.currentTimeMillis();   // 仅由刷新线程访问
+
+    private final LongAdder pointsWritten = new LongAdder();
+    private final LongAdder blocksWritten = new LongAdder();
+    private final LongAdder bytesWritten = new LongAdder();
+    private final LongAdder pointsDropped = new LongAdder();
+
+    /**
+     * @param root            数据目录，不存在时创建
+     * @param blockPoints     每个块的点数上限
+     * @param flushIntervalMs 缓冲中的点最长等待时间
+     */
+    public SegmentStore(Path root, int blockPoints, long flushIntervalMs) throws IOException {
+        if (blockPoints < 1 || flushIntervalMs < 1) {
+            throw new IllegalArgumentException("块点数和刷新间隔须为正数");
+        }
+        this.root = Files.createDirectories(root);
+        this.blockPoints = blockPoints;
+        this.flushIntervalMs = flushIntervalMs;
+        this.rollups = new RollupStore(this.root);
+
+        long period = Math.min(1000, flushIntervalMs);
+        flusher = Executors.newSingleThreadScheduledExecutor(r -> {
+            Thread thread = new Thread(r, "segment-flusher");
+            thread.setDaemon(true);
+            return thread;
+        });
+        flusher.scheduleWithFixedDelay(this::flushExpired, period, period, TimeUnit.MILLISECONDS);
+    }
+
+    /**
+     * 追加一个点并累加到各分辨率的汇总，缓冲满时在调用线程中写入
+     */
+    public void append(String deviceId, AirData data) {
+        checkDeviceId(deviceId);
+        DeviceBuffer buffer = buffers.computeIfAbsent(deviceId,
+                id -> new DeviceBuffer(Math.min(blockPoints, 256)));
+        long day = Math.floorDiv(data.getTimestamp(), DAY_MS);
+        synchronized (buffer) {
+            if (buffer.points.size() > 0 && buffer.day != day) {
+                flush(deviceId, buffer);
+            }
+            if (buffer.points.size() == 0) {
+                buffer.day = day;
+                buffer.firstAppendTime = System.currentTimeMillis();
+            }
+            buffer.points.add(data);
+            if (buffer.points.size() >= blockPoints) {
+                flush(deviceId, buffer);
+            }
+        }
+        rollups.append(deviceId, data);
+    }
+
+    /**
+     * 写入全部缓冲和汇总
+     */
+    public void flush() {
+        for (Map.Entry<String, DeviceBuffer> entry : buffers.entrySet()) {
+            DeviceBuffer buffer = entry.getValue();
+            synchronized (buffer) {
+                flush(entry.getKey(), buffer);
+            }
+        }
+        rollups.flush();
+    }
+
+    // 刷新线程：写入等待超过刷新间隔的缓冲，每个刷新间隔写回一次汇总
+    private void flushExpired() {
+        long now = System.currentTimeMillis();
+        if (now - lastRollupFlush >= flushIntervalMs) {
+            lastRollupFlush = now;
+            rollups.flush();
+        }
+        for (Map.Entry<String, DeviceBuffer> entry : buffers.entrySet()) {
+            DeviceBuffer buffer = entry.getValue();
+            synchronized (buffer) {
+                if (buffer.points.size() > 0 && now - buffer.firstAppendTime >= flushIntervalMs) {
+                    flush(entry.getKey(), buffer);
+                }
+            }
+        }
+    }
+
+    // 把缓冲编码为一个块追加到所属的段文件，须持有buffer的锁；写入失败时丢弃这批点
+    private void flush(String deviceId, DeviceBuffer buffer) {
+        PointBuffer points = buffer.points;
+        if (points.size() == 0) {
+            return;
+        }
+        points.sortByTime();
+        ByteBuffer block = BlockCodec.encode(points);
+        Path path = segmentPath(deviceId, buffer.day);
+        int length = block.remaining();
+
+        try {
+            Files.createDirectories(path.getParent());
+            try (FileChannel channel = FileChannel.open(path, StandardOpenOption.CREATE,
+                    StandardOpenOption.WRITE)) {
+                long end = channel.size();
+                if (verified.add(path)) {
+                    long valid = Segment.validLength(channel);
+                    if (valid < end) {
+                        log.warn("段文件{}尾部有{}字节不完整的数据，已截掉", path, end - valid);
+                        channel.truncate(valid);
+                        end = valid;
+                    }
+                }
+                // 整块一次写入，读取方按块头的长度判断块是否已写完整
+                while (block.hasRemaining()) {
+                    end += channel.write(block, end);
+                }
+            }
+            pointsWritten.add(points.size());
+            blocksWritten.increment();
+            bytesWritten.add(length);
+        } catch (IOException e) {
+            pointsDropped.add(points.size());
+            log.error("写入段文件{}失败，丢弃{}个点: {}", path, points.size(), e.getMessage());
+        }
+        points.clear();
+    }
+
+    /**
+     * 按时间顺序访问设备在[from, to)内的点，包括尚未写入磁盘的缓冲
+     * @param fieldMask 需要解码的指标，第i位对应SeriesStore.Field的第i项
+     */
+    public void query(String deviceId, long from, long to, int fieldMask, RangeVisitor visitor) throws IOException {
+        checkDeviceId(deviceId);
+        if (from >= to) {
+            return;
+        }
+        PointBuffer scratch = new PointBuffer(blockPoints);
+        PointBuffer pending = new PointBuffer(16);
+        long pendingDay = Long.MIN_VALUE;
+        DeviceBuffer buffer = buffers.get(deviceId);
+        if (buffer != null) {
+            synchronized (buffer) {
+                pending.addAll(buffer.points);
+                pendingDay = buffer.day;
+            }
+            pending.sortByTime();
+        }
+
+        for (long day : days(deviceId, Math.floorDiv(from, DAY_MS), Math.floorDiv(to - 1, DAY_MS), pendingDay)) {
+            Segment segment = segment(deviceId, day);
+            Segment.View view = segment != null ? segment.refresh() : null;
+            queryDay(view, day == pendingDay ? pending : null, from, to, fieldMask, scratch, visitor);
+        }
+    }
+
+    /*
+     * 一天内的查询：选出时间范围与[from, to)相交的块，按最小时间戳排序后把时间范围互相重叠的
+     * 块（补发的迟到数据）归为一组，一组解码后排序再输出，保证结果按时间有序；
+     * 未写入的缓冲作为一个额外的块参与分组
+     */
+    private static void queryDay(Segment.View view, PointBuffer pending, long from, long to, int fieldMask,
+                                 PointBuffer scratch, RangeVisitor visitor) {
+        int blocks = view != null ? view.blocks : 0;
+        boolean hasPending = pending != null && pending.size() > 0
+                && pending.timestamp(pending.size() - 1) >= from && pending.timestamp(0) < to;
+        int n = 0;
+        int[] chunks = new int[blocks + 1];
+        long[] minTs = new long[blocks + 1];
+        long[] maxTs = new long[blocks + 1];
+        for (int b = 0; b < blocks; b++) {
+            if (view.maxTimestamps[b] >= from && view.minTimestamps[b] < to) {
+                chunks[n] = b;
+                minTs[n] = view.minTimestamps[b];
+                maxTs[n] = view.maxTimestamps[b];
+                n++;
+            }
+        }
+        if (hasPending) {
+            chunks[n] = -1;
+            minTs[n] = pending.timestamp(0);
+            maxTs[n] = pending.timestamp(pending.size() - 1);
+            n++;
+        }
+
+        Integer[] order = new Integer[n];
+        boolean sorted = true;
+        for (int i = 0; i < n; i++) {
+            order[i] = i;
+            sorted &= i == 0 || minTs[i] >= minTs[i - 1];
+        }
+        if (!sorted) {
+            Arrays.sort(order, Comparator.comparingLong(k -> minTs[k]));
+        }
+
+        int i = 0;
+        while (i < n) {
+            scratch.clear();
+            long groupEnd = maxTs[order[i]];
+            int groupSize = 0;
+            do {
+                int chunk = chunks[order[i]];
+                if (chunk >= 0) {
+                    BlockCodec.decode(view.map, view.offsets[chunk], fieldMask, scratch);
+                } else {
+                    scratch.addAll(pending);
+                }
+                groupEnd = Math.max(groupEnd, maxTs[order[i]]);
+                groupSize++;
+                i++;
+            } while (i < n && minTs[order[i]] <= groupEnd);
+            if (groupSize > 1) {
+                scratch.sortByTime();
+            }
+            emit(scratch, from, to, fieldMask, visitor);
+        }
+    }
+
+    private static void emit(PointBuffer points, long from, long to, int fieldMask, RangeVisitor visitor) {
+        double[][] c = points.columns;
+        for (int i = 0; i < points.size(); i++) {
+            long ts = points.timestamps[i];
+            if (ts < from || ts >= to) {
+                continue;
+            }
+            visitor.visit(ts,
+                    field(c, 0, fieldMask, i), field(c, 1, fieldMask, i), field(c, 2, fieldMask, i),
+                    field(c, 3, fieldMask, i), field(c, 4, fieldMask, i), field(c, 5, fieldMask, i));
+        }
+    }
+
+    // 缓冲中的点各列都有值，未选中的指标统一输出NaN
+    private static double field(double[][] columns, int f, int fieldMask, int i) {
+        return (fieldMask & (1 << f)) != 0 ? columns[f][i] : Double.NaN;
+    }
+
+    /**
+     * 设备在from之后最近limit个点所在的块中最早的时间戳，不足limit个点时返回from
+     * 只读块头中的点数和时间范围，不解码：从返回的时刻起查询即可得到最近的limit个点，
+     * 多出的点不超过一个块和与之时间重叠的补发块
+     */
+    public long latestStart(String deviceId, long from, int limit) throws IOException {
+        checkDeviceId(deviceId);
+        long pendingDay = Long.MIN_VALUE;
+        long pendingMin = Long.MAX_VALUE;
+        long pendingMax = Long.MIN_VALUE;
+        int pendingCount = 0;
+        DeviceBuffer buffer = buffers.get(deviceId);
+        if (buffer != null) {
+            synchronized (buffer) {
+                pendingCount = buffer.points.size();
+                pendingDay = buffer.day;
+                for (int i = 0; i < pendingCount; i++) {
+                    pendingMin = Math.min(pendingMin, buffer.points.timestamp(i));
+                    pendingMax = Math.max(pendingMax, buffer.points.timestamp(i));
+                }
+            }
+        }
+
+        // 从最新的一天起，各天的块（及缓冲）按最大时间戳从新到旧累计点数
+        long[] days = days(deviceId, Math.floorDiv(from, DAY_MS), Long.MAX_VALUE / DAY_MS, pendingDay);
+        long start = Long.MAX_VALUE;
+        long remaining = limit;
+        for (int d = days.length - 1; d >= 0; d--) {
+            Segment segment = segment(deviceId, days[d]);
+            Segment.View view = segment != null ? segment.refresh() : null;
+            int blocks = view != null ? view.blocks : 0;
+            boolean hasPending = days[d] == pendingDay && pendingCount > 0;
+            int n = blocks + (hasPending ? 1 : 0);
+            long[] minTs = new long[n];
+            long[] maxTs = new long[n];
+            int[] counts = new int[n];
+            for (int b = 0; b < blocks; b++) {
+                minTs[b] = view.minTimestamps[b];
+                maxTs[b] = view.maxTimestamps[b];
+                counts[b] = BlockCodec.count(view.map, view.offsets[b]);
+            }
+            if (hasPending) {
+                minTs[blocks] = pendingMin;
+                maxTs[blocks] = pendingMax;
+                counts[blocks] = pendingCount;
+            }
+
+            Integer[] order = new Integer[n];
+            for (int i = 0; i < n; i++) {
+                order[i] = i;
+            }
+            Arrays.sort(order, Comparator.comparingLong((Integer k) -> maxTs[k]).reversed());
+            for (int k : order) {
+                if (maxTs[k] < from) {
+                    continue;
+                }
+                start = Math.min(start, minTs[k]);
+                remaining -= counts[k];
+                if (remaining <= 0) {
+                    return Math.max(from, start);
+                }
+            }
+        }
+        return from;
+    }
+
+    /**
+     * 按时间顺序访问设备在某一分辨率下起始时刻位于[resolution.bucketStart(from), to)的非空汇总桶，
+     * 包括尚未写回磁盘的桶
+     */
+    public void queryRollups(String deviceId, Resolution resolution, long from, long to, BucketVisitor visitor)
+            throws IOException {
+        checkDeviceId(deviceId);
+        rollups.query(deviceId, resolution, from, to, visitor);
+    }
+
+    /**
+     * 磁盘上有数据的设备
+     */
+    public List<String> deviceIds() throws IOException {
+        List<String> result = new ArrayList<>();
+        try (DirectoryStream<Path> dirs = Files.newDirectoryStream(root, Files::isDirectory)) {
+            for (Path dir : dirs) {
+                String name = dir.getFileName().toString();
+                if (DEVICE_ID.matcher(name).matches()) {
+                    result.add(name);
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * 存储统计：写入的点数、块数、字节数，写入失败丢弃的点数、缓冲中的点数，写回的汇总桶数和未计入汇总的点数
+     */
+    public Map<String, Long> stats() {
+        long buffered = 0;
+        for (DeviceBuffer buffer : buffers.values()) {
+            synchronized (buffer) {
+                buffered += buffer.points.size();
+            }
+        }
+        Map<String, Long> result = new LinkedHashMap<>();
+        result.put("pointsWritten", pointsWritten.sum());
+        result.put("blocksWritten", blocksWritten.sum());
+        result.put("bytesWritten", bytesWritten.sum());
+        result.put("pointsDropped", pointsDropped.sum());
+        result.put("buffered", buffered);
+        result.put("rollupBucketsWritten", rollups.bucketsWritten.sum());
+        result.put("rollupPointsSkipped", rollups.pointsSkipped.sum());
+        return result;
+    }
+
+    /**
+     * 停止刷新线程并写入全部缓冲
+     */
+    @Override
+    public void close() {
+        flusher.shutdown();
+        try {
+            flusher.awaitTermination(5, TimeUnit.SECONDS);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+        flush();
+        synchronized (segments) {
+            segments.values().forEach(SegmentStore::closeQuietly);
+            segments.clear();
+        }
+    }
+
+    // 设备在[firstDay, lastDay]内有段文件或缓冲数据的日期，升序
+    private long[] days(String deviceId, long firstDay, long lastDay, long pendingDay) throws IOException {
+        long[] days = new long[16];
+        int n = 0;
+        if (pendingDay >= firstDay && pendingDay <= lastDay) {
+            days[n++] = pendingDay;
+        }
+        Path dir = root.resolve(deviceId);
+        if (Files.isDirectory(dir)) {
+            try (DirectoryStream<Path> files = Files.newDirectoryStream(dir, "*" + SUFFIX)) {
+                for (Path file : files) {
+                    String name = file.getFileName().toString();
+                    long day;
+                    try {
+                        day = LocalDate.parse(name.substring(0, name.length() - SUFFIX.length())).toEpochDay();
+                    } catch (DateTimeParseException e) {
+                        continue;
+                    }
+                    if (day >= firstDay && day <= lastDay && day != pendingDay) {
+                        if (n == days.length) {
+                            days = Arrays.copyOf(days, n * 2);
+                        }
+                        days[n++] = day;
+                    }
+                }
+            }
+        }
+        days = Arrays.copyOf(days, n);
+        Arrays.sort(days);
+        return days;
+    }
+
+    private Path segmentPath(String deviceId, long day) {
+        return root.resolve(deviceId).resolve(LocalDate.ofEpochDay(day) + SUFFIX);
+    }
+
+    // 打开并缓存段文件的只读视图，文件不存在时返回null
+    private Segment segment(String deviceId, long day) throws IOException {
+        Path path = segmentPath(deviceId, day);
+        synchronized (segments) {
+            Segment segment = segments.get(path);
+            if (segment == null) {
+                try {
+                    segment = new Segment(path);
+                } catch (NoSuchFileException e) {
+                    return null;
+                }
+                segments.put(path, segment);
+            }
+            return segment;
+        }
+    }
+
+    // 设备ID用作目录名，只允许字母、数字、下划线和连字符
+    private static void checkDeviceId(String deviceId) {
+        if (deviceId == null || !DEVICE_ID.matcher(deviceId).matches()) {
+            throw new IllegalArgumentException("无效的设备ID: " + deviceId);
+        }
+    }
+
+    private static void closeQuietly(Segment segment) {
+        try {
+            segment.close();
+        } catch (IOException e) {
+            log.warn("关闭段文件{}失败: {}", segment.path(), e.getMessage());
+        }
+    }
+}
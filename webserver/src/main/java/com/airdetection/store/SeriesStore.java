@@ -0,0 +1,173 @@
+package com.airdetection.store;
+
+import com.airdetection.model.AirData;
+
+import java.lang.invoke.VarHandle;
+
+/**
+ * 固定容量的时间序列环形存储（列式：时间戳和各指标各占一个基本类型数组）
+ * 写入按序号依次写入槽位后以volatile发布，读取无锁：读出槽位后重新检查发布序号，
+ * 若期间该槽位已被覆盖则丢弃（类似seqlock），因此读者看到的点要么完整要么被跳过
+ * 写入须串行（append为同步方法），读取可任意并发
+ */
+public final class SeriesStore {
+
+    /**
+     * 存储的指标列
+     */
+    public enum Field {
+        TEMPERATURE, HUMIDITY, METHANE, TVOC, CO2, PM25
+    }
+
+    private static final Field[] FIELDS = Field.values();
+
+    /**
+     * 逐点访问回调，参数直接取自列数组，不创建中间对象
+     */
+    @FunctionalInterface
+    public interface PointVisitor {
+        void visit(long seq, long timestamp, double temperature, double humidity,
+                   double methane, double tvoc, double co2, double pm25);
+    }
+
+    private final int capacity;
+    private final long[] timestamps;
+    private final double[][] columns;       // [Field.ordinal()][槽位]
+    private volatile long published = 0;    // 已发布的点数，也是下一个点的序号
+
+    /**
+     * @param capacity 保存的点数，内存占用约为 capacity * 56 字节
+     */
+    public SeriesStore(int capacity) {
+        if (capacity < 2) {
+            throw new IllegalArgumentException("容量至少为2: " + capacity);
+        }
+        this.capacity = capacity;
+        this.timestamps = new long[capacity];
+        this.columns = new double[FIELDS.length][capacity];
+    }
+
+    /**
+     * 追加一个点
+     * @return 该点的序号
+     */
+    public synchronized long append(AirData data) {
+        long seq = published;
+        int slot = (int) (seq % capacity);
+
+        // 上一次发布之后的写入不得早于发布被其他线程看到
+        VarHandle.storeStoreFence();
+        timestamps[slot] = data.getTimestamp();
+        columns[Field.TEMPERATURE.ordinal()][slot] = data.getTemperature();
+        columns[Field.HUMIDITY.ordinal()][slot] = data.getHumidity();
+        columns[Field.METHANE.ordinal()][slot] = data.getMethane();
+        columns[Field.TVOC.ordinal()][slot] = data.getTvoc();
+        columns[Field.CO2.ordinal()][slot] = data.getCo2();
+        columns[Field.PM25.ordinal()][slot] = data.getPm25();
+        published = seq + 1;
+        return seq;
+    }
+
+    public int capacity() {
+        return capacity;
+    }
+
+    /**
+     * 下一个点的序号（已写入的总点数）
+     */
+    public long endSequence() {
+        return published;
+    }
+
+    /**
+     * 最早仍可读取的点的序号
+     * 正在写入的槽位会覆盖序号为 endSequence() - capacity 的点，因此可读范围比容量少一个点
+     */
+    public long firstSequence() {
+        return firstSequence(published);
+    }
+
+    /**
+     * 最新的点，没有数据时返回null
+     */
+    public AirData latest() {
+        while (true) {
+            long end = published;
+            if (end == 0) {
+                return null;
+            }
+            int slot = (int) ((end - 1) % capacity);
+            AirData data = AirData.builder()
+                    .timestamp(timestamps[slot])
+                    .temperature(columns[Field.TEMPERATURE.ordinal()][slot])
+                    .humidity(columns[Field.HUMIDITY.ordinal()][slot])
+                    .methane(columns[Field.METHANE.ordinal()][slot])
+                    .tvoc(columns[Field.TVOC.ordinal()][slot])
+                    .co2(columns[Field.CO2.ordinal()][slot])
+                    .pm25(columns[Field.PM25.ordinal()][slot])
+                    .build();
+            if (retained(end - 1)) {
+                return data;
+            }
+        }
+    }
+
+    /**
+     * 按序号从from开始依次访问到当前末尾，已被覆盖的点被跳过
+     * @return 下一次增量访问的起始序号
+     */
+    public long forEach(long from, PointVisitor visitor) {
+        long end = published;
+        long seq = Math.max(from, firstSequence(end));
+        double[] t = columns[Field.TEMPERATURE.ordinal()];
+        double[] h = columns[Field.HUMIDITY.ordinal()];
+        double[] m = columns[Field.METHANE.ordinal()];
+        double[] v = columns[Field.TVOC.ordinal()];
+        double[] c = columns[Field.CO2.ordinal()];
+        double[] p = columns[Field.PM25.ordinal()];
+
+        for (; seq < end; seq++) {
+            int slot = (int) (seq % capacity);
+            long ts = timestamps[slot];
+            double temperature = t[slot];
+            double humidity = h[slot];
+            double methane = m[slot];
+            double tvoc = v[slot];
+            double co2 = c[slot];
+            double pm25 = p[slot];
+            if (!retained(seq)) {
+                // 读取期间被写入覆盖，跳到仍保留的最早位置
+                seq = firstSequence(published) - 1;
+                continue;
+            }
+            visitor.visit(seq, ts, temperature, humidity, methane, tvoc, co2, pm25);
+        }
+        return end;
+    }
+
+    /**
+     * 单个指标在某序号的取值，调用后须以retained检查是否仍有效
+     */
+    public double value(Field field, long seq) {
+        return columns[field.ordinal()][(int) (seq % capacity)];
+    }
+
+    /**
+     * 某序号的时间戳，调用后须以retained检查是否仍有效
+     */
+    public long timestamp(long seq) {
+        return timestamps[(int) (seq % capacity)];
+    }
+
+    /**
+     * 检查之前读出的序号为seq的数据在读取期间未被覆盖
+     */
+    public boolean retained(long seq) {
+        VarHandle.loadLoadFence();
+        return seq >= firstSequence(published);
+    }
+
+    private long firstSequence(long end) {
+        return Math.max(0, end - capacity + 1);
+    }
+}
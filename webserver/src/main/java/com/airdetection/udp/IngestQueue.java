@@ -0,0 +1,95 @@
+package com.airdetection.udp;
+
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicLongArray;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+
+/**
+ * 有界无锁队列（多生产者多消费者，基于每个槽位的序号）
+ * 接收线程与解析线程之间的交接队列：队列满时offer立即返回false，由调用方计入丢弃，
+ * 不会阻塞接收线程
+ */
+public final class IngestQueue<E> {
+
+    private final int mask;
+    private final AtomicReferenceArray<E> items;
+    private final AtomicLongArray sequences;   // 槽位序号：等于入队位置时可写，等于入队位置+1时可读
+    private final AtomicLong tail = new AtomicLong();
+    private final AtomicLong head = new AtomicLong();
+
+    /**
+     * @param capacity 容量，向上取整为2的幂
+     */
+    public IngestQueue(int capacity) {
+        int size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        items = new AtomicReferenceArray<>(size);
+        sequences = new AtomicLongArray(size);
+        for (int i = 0; i < size; i++) {
+            sequences.set(i, i);
+        }
+    }
+
+    /**
+     * 入队
+     * @return false - 队列已满
+     */
+    public boolean offer(E item) {
+        long pos = tail.get();
+        while (true) {
+            int index = (int) (pos & mask);
+            long diff = sequences.get(index) - pos;
+            if (diff == 0) {
+                if (tail.compareAndSet(pos, pos + 1)) {
+                    items.lazySet(index, item);
+                    sequences.lazySet(index, pos + 1);
+                    return true;
+                }
+                pos = tail.get();
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.get();
+            }
+        }
+    }
+
+    /**
+     * 出队
+     * @return 队首元素，队列为空时返回null
+     */
+    public E poll() {
+        long pos = head.get();
+        while (true) {
+            int index = (int) (pos & mask);
+            long diff = sequences.get(index) - (pos + 1);
+            if (diff == 0) {
+                if (head.compareAndSet(pos, pos + 1)) {
+                    E item = items.get(index);
+                    items.lazySet(index, null);
+                    sequences.lazySet(index, pos + mask + 1);
+                    return item;
+                }
+                pos = head.get();
+            } else if (diff < 0) {
+                return null;
+            } else {
+                pos = head.get();
+            }
+        }
+    }
+
+    /**
+     * 当前元素个数（并发修改时为近似值）
+     */
+    public int size() {
+        return (int) Math.max(0, tail.get() - head.get());
+    }
+
+    public int capacity() {
+        return mask + 1;
+    }
+}
@@ -0,0 +1,39 @@
+package com.airdetection.udp;
+
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.concurrent.atomic.LongAdder;
+
+/**
+ * UDP接收流水线各阶段的计数
+ * 接收线程和解析线程并发累加，读取为近似快照
+ */
+public class IngestStats {
+
+    // 接收阶段
+    final LongAdder received = new LongAdder();         // 收到的报文
+    final LongAdder receivedBytes = new LongAdder();
+    final LongAdder queueDrops = new LongAdder();       // 解析队列已满而丢弃的报文
+    // 解析阶段
+    final LongAdder parsed = new LongAdder();           // 解析线程处理的报文
+    final LongAdder invalid = new LongAdder();          // 格式错误的报文或记录
+    final LongAdder duplicates = new LongAdder();       // 重复的日志记录
+    final LongAdder published = new LongAdder();        // 交给DataService的数据点
+    final LongAdder requests = new LongAdder();         // 发出的补发请求
+
+    /**
+     * 计数快照，键为计数名
+     */
+    public Map<String, Long> snapshot() {
+        Map<String, Long> map = new LinkedHashMap<>();
+        map.put("received", received.sum());
+        map.put("receivedBytes", receivedBytes.sum());
+        map.put("queueDrops", queueDrops.sum());
+        map.put("parsed", parsed.sum());
+        map.put("invalid", invalid.sum());
+        map.put("duplicates", duplicates.sum());
+        map.put("published", published.sum());
+        map.put("requests", requests.sum());
+        return map;
+    }
+}
@@ -0,0 +1,235 @@
+package com.airdetection.udp;
+
+import com.airdetection.model.AirData;
+import com.airdetection.service.DataService;
+import lombok.extern.slf4j.Slf4j;
+
+import java.net.SocketAddress;
+import java.nio.ByteBuffer;
+import java.nio.channels.DatagramChannel;
+import java.nio.charset.StandardCharsets;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.locks.LockSupport;
+
+/**
+ * 解析线程：从自己的队列取出报文，解析后交给DataService
+ * 同一源地址的报文总是分配给同一个解析线程，因此序号水位等按源地址的状态只由一个线程访问，
+ * 同一转发端的数据也保持接收顺序
+ */
+@Slf4j
+class IngestWorker implements Runnable {
+
+    // 补发请求的间隔，以及每轮每个转发端最多请求的缺失区间数
+    private static final long REQUEST_INTERVAL_MS = 10000;
+    private static final int MAX_REQUEST_RANGES = 8;
+    // 转发端超过这么多轮没有有效记录时丢弃其水位：此时缺失的记录都已放弃请求（MAX_ATTEMPTS轮），
+    // 转发端重新上线后补发的是它未发出的记录，从新的水位开始不会重复
+    private static final int IDLE_ROUNDS = 2 * SequenceWatermark.MAX_ATTEMPTS;
+
+    // 队列为空时先自旋，再逐步延长休眠，最长1ms
+    private static final int SPIN_LIMIT = 100;
+    private static final long MAX_PARK_NANOS = 1_000_000;
+
+    private final IngestQueue<ReceivedPacket> queue;
+    private final DataService dataService;
+    private final IngestStats stats;
+    private final DatagramChannel replyChannel;
+    private final ReportLineParser lineParser = new ReportLineParser();
+    private final ReportLineParser.Values lineValues = new ReportLineParser.Values();
+    private volatile boolean running = true;
+
+    // 本线程负责的各转发端（按源地址区分）的日志序号水位，只登记至少解析出一条记录的源地址
+    private final Map<SocketAddress, SequenceWatermark> watermarks = new HashMap<>();
+    private long lastRequestTime = 0;
+
+    IngestWorker(int queueCapacity, DataService dataService, IngestStats stats, DatagramChannel replyChannel) {
+        this.queue = new IngestQueue<>(queueCapacity);
+        this.dataService = dataService;
+        this.stats = stats;
+        this.replyChannel = replyChannel;
+    }
+
+    IngestQueue<ReceivedPacket> getQueue() {
+        return queue;
+    }
+
+    void stop() {
+        running = false;
+    }
+
+    @Override
+    public void run() {
+        int idle = 0;
+        long park = 1000;
+
+        while (running) {
+            // 每轮都检查补发间隔，持续有报文到达、队列始终不空时也按时请求
+            requestMissing();
+
+            ReceivedPacket packet = queue.poll();
+            if (packet == null) {
+                if (idle++ < SPIN_LIMIT) {
+                    Thread.onSpinWait();
+                } else {
+                    LockSupport.parkNanos(park);
+                    park = Math.min(park * 2, MAX_PARK_NANOS);
+                }
+                continue;
+            }
+            idle = 0;
+            park = 1000;
+
+            try {
+                handle(packet);
+                stats.parsed.increment();
+            } catch (Exception e) {
+                stats.invalid.increment();
+                log.error("处理数据出错: {}", e.getMessage(), e);
+            }
+        }
+    }
+
+    private void handle(ReceivedPacket packet) {
+        // 解析数据并通知服务：存储转发记录、二进制遥测帧优先，否则按文本格式解析
+        if (LogRecord.isRecord(packet.data, 0, packet.length)) {
+            processRecords(packet);
+            return;
+        }
+
+        AirData airData;
+        if (TelemetryFrame.isFrame(packet.data, 0, packet.length)) {
+            airData = parseFrame(packet.data, packet.length);
+        } else {
+            if (log.isTraceEnabled()) {
+                log.trace("收到数据: {}", new String(packet.data, 0, packet.length, StandardCharsets.UTF_8));
+            }
+            airData = parseLine(packet.data, packet.length);
+        }
+        publish(airData);
+    }
+
+    private void publish(AirData airData) {
+        if (airData == null) {
+            stats.invalid.increment();
+            return;
+        }
+        dataService.processNewData(airData);
+        stats.published.increment();
+    }
+
+    // 解析二进制遥测帧为AirData对象
+    private AirData parseFrame(byte[] data, int length) {
+        try {
+            AirData airData = TelemetryFrame.decode(data, 0, length);
+            log.debug("收到遥测帧: seq={}", TelemetryFrame.sequence(data, 0));
+            return airData;
+        } catch (IllegalArgumentException e) {
+            log.warn("遥测帧无效: {}", e.getMessage());
+        }
+        return null;
+    }
+
+    // 解析存储转发记录报文并逐条通知服务：按日志序号去重，时间戳按记录在转发端的存放时长还原
+    private void processRecords(ReceivedPacket packet) {
+        byte[] data = packet.data;
+        int count;
+        try {
+            count = LogRecord.check(data, 0, packet.length);
+        } catch (IllegalArgumentException e) {
+            stats.invalid.increment();
+            log.warn("记录报文无效: {}", e.getMessage());
+            return;
+        }
+
+        int bootId = LogRecord.bootId(data, 0);
+        boolean replay = (LogRecord.flags(data, 0) & LogRecord.FLAG_REPLAY) != 0;
+        // 新的源地址在解析出第一条记录后才登记，伪造或损坏的报文不会占用水位
+        SequenceWatermark watermark = watermarks.get(packet.source);
+        boolean known = watermark != null;
+        if (!known) {
+            watermark = new SequenceWatermark();
+        }
+        boolean decoded = false;
+        for (int i = 0; i < count; i++) {
+            int rec = LogRecord.recordOffset(0, i);
+            long seq = LogRecord.sequence(data, rec);
+            if (!watermark.accept(bootId, seq)) {
+                stats.duplicates.increment();
+                log.debug("重复的日志记录: {} seq={}", packet.source, seq);
+                continue;
+            }
+            try {
+                AirData airData = TelemetryFrame.decode(data, LogRecord.frameOffset(rec), TelemetryFrame.FRAME_SIZE);
+                airData.setTimestamp(airData.getTimestamp() - LogRecord.age(data, rec));
+                decoded = true;
+                publish(airData);
+            } catch (IllegalArgumentException e) {
+                stats.invalid.increment();
+                log.warn("日志记录无效: seq={}, {}", seq, e.getMessage());
+            }
+        }
+        if (decoded) {
+            watermark.setLastSeen(System.currentTimeMillis());
+            if (!known) {
+                watermarks.put(packet.source, watermark);
+            }
+        }
+        log.debug("收到{}报文: {}条记录, 水位={}", replay ? "补发" : "日志", count, watermark.getWatermark());
+    }
+
+    // 距上次请求超过REQUEST_INTERVAL_MS时，向本线程负责的各转发端请求水位之后缺失的记录，
+    // 并丢弃超过IDLE_ROUNDS轮不活动的转发端
+    private void requestMissing() {
+        long now = System.currentTimeMillis();
+        if (now - lastRequestTime < REQUEST_INTERVAL_MS) {
+            return;
+        }
+        lastRequestTime = now;
+
+        Iterator<Map.Entry<SocketAddress, SequenceWatermark>> it = watermarks.entrySet().iterator();
+        while (it.hasNext()) {
+            Map.Entry<SocketAddress, SequenceWatermark> entry = it.next();
+            SequenceWatermark watermark = entry.getValue();
+            if (now - watermark.getLastSeen() > IDLE_ROUNDS * REQUEST_INTERVAL_MS) {
+                it.remove();
+                log.info("转发端{}超过{}秒没有记录，丢弃其水位", entry.getKey(), IDLE_ROUNDS * REQUEST_INTERVAL_MS / 1000);
+                continue;
+            }
+            List<long[]> ranges = watermark.takeRequests(MAX_REQUEST_RANGES);
+            for (long[] range : ranges) {
+                byte[] req = LogRecord.encodeRequest(watermark.getBootId(), range[0], (int) range[1]);
+                try {
+                    replyChannel.send(ByteBuffer.wrap(req), entry.getKey());
+                    stats.requests.increment();
+                    log.info("请求补发: {} 序号{}起{}条", entry.getKey(), range[0], range[1]);
+                } catch (Exception e) {
+                    log.warn("发送补发请求失败: {}", e.getMessage());
+                }
+            }
+        }
+    }
+
+    // 解析文本上报行为AirData对象
+    private AirData parseLine(byte[] data, int length) {
+        ReportLineParser.Values v = lineValues;
+        try {
+            lineParser.parse(data, 0, length, v);
+        } catch (IllegalArgumentException e) {
+            log.warn("数据格式不匹配: {}，{}", e.getMessage(), new String(data, 0, length, StandardCharsets.UTF_8));
+            return null;
+        }
+        return AirData.builder()
+                .deviceId(TelemetryFrame.UNKNOWN_DEVICE)
+                .humidity(v.humidity)
+                .temperature(v.temperature)
+                .methane(v.methane)
+                .tvoc(v.tvoc)
+                .co2(v.co2)
+                .pm25(v.pm25)
+                .timestamp(System.currentTimeMillis())
+                .build();
+    }
+}
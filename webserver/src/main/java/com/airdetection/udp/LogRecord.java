@@ -0,0 +1,115 @@
+package com.airdetection.udp;
+
+/**
+ * ESP8266存储转发日志的记录报文与补发请求
+ * 格式与 WebClient/WebClient.ino 中的说明保持一致（小端字节序）：
+ * 记录报文为8字节头部（'S' 'F'、版本、标志、启动ID、记录条数、保留）加若干条40字节记录
+ * （日志序号、存放时长、32字节遥测帧），补发请求为 'S' 'Q'、启动ID、起始序号、条数
+ */
+public final class LogRecord {
+
+    public static final int MAGIC0 = 'S';
+    public static final int MAGIC1 = 'F';
+    public static final int REQUEST_MAGIC1 = 'Q';
+    public static final int VERSION = 2;
+    public static final int HEADER_SIZE = 8;
+    public static final int RECORD_SIZE = 8 + TelemetryFrame.FRAME_SIZE;
+    public static final int REQUEST_SIZE = 10;
+
+    // 标志位
+    public static final int FLAG_REPLAY = 1;
+
+    // 单个请求可覆盖的最大条数
+    public static final int MAX_REQUEST_COUNT = 0xFFFF;
+
+    private LogRecord() {
+    }
+
+    /**
+     * 判断数据是否为记录报文
+     */
+    public static boolean isRecord(byte[] buf, int off, int len) {
+        return len >= 2 && (buf[off] & 0xFF) == MAGIC0 && (buf[off + 1] & 0xFF) == MAGIC1;
+    }
+
+    /**
+     * 校验记录报文头部，长度、版本或记录条数不正确时抛出IllegalArgumentException
+     * @return 报文中的记录条数
+     */
+    public static int check(byte[] buf, int off, int len) {
+        if (len < HEADER_SIZE) {
+            throw new IllegalArgumentException("记录报文长度不足: " + len);
+        }
+        int version = buf[off + 2] & 0xFF;
+        if (version != VERSION) {
+            throw new IllegalArgumentException("不支持的记录版本: v" + version);
+        }
+        int count = buf[off + 6] & 0xFF;
+        if (count == 0 || len != HEADER_SIZE + count * RECORD_SIZE) {
+            throw new IllegalArgumentException("记录条数与报文长度不符: " + count + ", " + len);
+        }
+        return count;
+    }
+
+    public static int flags(byte[] buf, int off) {
+        return buf[off + 3] & 0xFF;
+    }
+
+    public static int bootId(byte[] buf, int off) {
+        return u16(buf, off + 4);
+    }
+
+    /**
+     * 第index条记录在报文中的偏移
+     */
+    public static int recordOffset(int off, int index) {
+        return off + HEADER_SIZE + index * RECORD_SIZE;
+    }
+
+    /**
+     * 记录的日志序号，rec为recordOffset返回的偏移
+     */
+    public static long sequence(byte[] buf, int rec) {
+        return u32(buf, rec);
+    }
+
+    /**
+     * 记录在ESP8266上存放的毫秒数，用于还原合并或补发记录的采样时刻
+     */
+    public static long age(byte[] buf, int rec) {
+        return u32(buf, rec + 4);
+    }
+
+    /**
+     * 遥测帧在报文中的偏移
+     */
+    public static int frameOffset(int rec) {
+        return rec + 8;
+    }
+
+    /**
+     * 编码补发请求
+     */
+    public static byte[] encodeRequest(int bootId, long from, int count) {
+        byte[] req = new byte[REQUEST_SIZE];
+        req[0] = (byte) MAGIC0;
+        req[1] = (byte) REQUEST_MAGIC1;
+        req[2] = (byte) bootId;
+        req[3] = (byte) (bootId >> 8);
+        req[4] = (byte) from;
+        req[5] = (byte) (from >> 8);
+        req[6] = (byte) (from >> 16);
+        req[7] = (byte) (from >> 24);
+        req[8] = (byte) count;
+        req[9] = (byte) (count >> 8);
+        return req;
+    }
+
+    private static int u16(byte[] buf, int pos) {
+        return (buf[pos] & 0xFF) | (buf[pos + 1] & 0xFF) << 8;
+    }
+
+    private static long u32(byte[] buf, int pos) {
+        return (u16(buf, pos) | (long) u16(buf, pos + 2) << 16) & 0xFFFFFFFFL;
+    }
+}
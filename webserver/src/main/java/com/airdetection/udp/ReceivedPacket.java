@@ -0,0 +1,19 @@
+package com.airdetection.udp;
+
+import java.net.SocketAddress;
+
+/**
+ * 接收线程交给解析线程的一个UDP报文
+ */
+final class ReceivedPacket {
+
+    final byte[] data;
+    final int length;
+    final SocketAddress source;
+
+    ReceivedPacket(byte[] data, int length, SocketAddress source) {
+        this.data = data;
+        this.length = length;
+        this.source = source;
+    }
+}
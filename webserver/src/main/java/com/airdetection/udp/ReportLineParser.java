@@ -0,0 +1,166 @@
+package com.airdetection.udp;
+
+import java.nio.charset.StandardCharsets;
+
+/**
+ * STM32文本上报行的解析器
+ * 直接在收到的字节上按固定字段顺序单遍解析为基本类型，不创建String、Matcher等中间对象，
+ * 只在输入非法时分配异常。接受的格式与原正则表达式一致（首尾空白除外不允许多余内容）：
+ * Humidity: 45.2%, Temperature: 25.3 C, Methane: 1.5 ppm, TVOC: 250 ppb, CO2eq: 450 ppm, Dust(PM2.5): 15.5 ug/m^3
+ * 小数须含整数和小数部分，仅甲烷允许负号；数值最多15位有效数字，转换结果与Double.parseDouble相同
+ * 实例保存解析位置，非线程安全，每个解析线程使用自己的实例
+ */
+public final class ReportLineParser {
+
+    private static final byte[] HUMIDITY = ascii("Humidity: ");
+    private static final byte[] TEMPERATURE = ascii("%, Temperature: ");
+    private static final byte[] METHANE = ascii(" C, Methane: ");
+    private static final byte[] TVOC = ascii(" ppm, TVOC: ");
+    private static final byte[] CO2 = ascii(" ppb, CO2eq: ");
+    private static final byte[] PM25 = ascii(" ppm, Dust(PM2.5): ");
+    private static final byte[] END = ascii(" ug/m^3");
+
+    private static final int MAX_DIGITS = 15;
+    private static final double[] POW10 = new double[MAX_DIGITS + 1];
+
+    static {
+        POW10[0] = 1;
+        for (int i = 1; i <= MAX_DIGITS; i++) {
+            POW10[i] = POW10[i - 1] * 10;
+        }
+    }
+
+    /**
+     * 解析结果，由调用方复用
+     */
+    public static final class Values {
+        public double humidity;
+        public double temperature;
+        public double methane;
+        public double tvoc;
+        public double co2;
+        public double pm25;
+    }
+
+    private byte[] buf;
+    private int start;
+    private int pos;
+    private int end;
+
+    /**
+     * 解析一行上报数据，格式不符时抛出IllegalArgumentException，消息指出出错位置和期望内容
+     */
+    public void parse(byte[] data, int off, int len, Values out) {
+        buf = data;
+        start = off;
+        pos = off;
+        end = off + len;
+        while (pos < end && isSpace(buf[pos])) {
+            pos++;
+        }
+        while (end > pos && isSpace(buf[end - 1])) {
+            end--;
+        }
+
+        expect(HUMIDITY);
+        out.humidity = decimal(false);
+        expect(TEMPERATURE);
+        out.temperature = decimal(false);
+        expect(METHANE);
+        out.methane = decimal(true);
+        expect(TVOC);
+        out.tvoc = integer();
+        expect(CO2);
+        out.co2 = integer();
+        expect(PM25);
+        out.pm25 = decimal(false);
+        expect(END);
+        if (pos != end) {
+            throw error("行尾");
+        }
+    }
+
+    private void expect(byte[] literal) {
+        if (end - pos < literal.length) {
+            throw error('"' + new String(literal, StandardCharsets.US_ASCII) + '"');
+        }
+        for (int i = 0; i < literal.length; i++) {
+            if (buf[pos + i] != literal[i]) {
+                pos += i;
+                throw error('"' + new String(literal, i, literal.length - i, StandardCharsets.US_ASCII) + '"');
+            }
+        }
+        pos += literal.length;
+    }
+
+    // 解析 [-]整数部分.小数部分
+    private double decimal(boolean signed) {
+        boolean negative = false;
+        if (signed && pos < end && buf[pos] == '-') {
+            negative = true;
+            pos++;
+        }
+        int digitsStart = pos;
+        long mantissa = digits(0);
+        if (pos == digitsStart) {
+            throw error("数字");
+        }
+        if (pos >= end || buf[pos] != '.') {
+            throw error("小数点");
+        }
+        pos++;
+        int fractionStart = pos;
+        mantissa = digits(mantissa);
+        int fraction = pos - fractionStart;
+        if (fraction == 0) {
+            throw error("小数部分");
+        }
+        if (pos - digitsStart - 1 > MAX_DIGITS) {
+            pos = digitsStart;
+            throw error("不超过" + MAX_DIGITS + "位的数值");
+        }
+        // 尾数与10的幂均可精确表示，一次除法即得到正确舍入的结果
+        double value = mantissa / POW10[fraction];
+        return negative ? -value : value;
+    }
+
+    // 解析非负整数
+    private double integer() {
+        int digitsStart = pos;
+        long value = digits(0);
+        if (pos == digitsStart) {
+            throw error("数字");
+        }
+        if (pos - digitsStart > MAX_DIGITS) {
+            pos = digitsStart;
+            throw error("不超过" + MAX_DIGITS + "位的数值");
+        }
+        return value;
+    }
+
+    // 读取连续数字并累加到value，位数由调用方检查（超过MAX_DIGITS时结果不再使用）
+    private long digits(long value) {
+        while (pos < end) {
+            int d = buf[pos] - '0';
+            if (d < 0 || d > 9) {
+                break;
+            }
+            value = value * 10 + d;
+            pos++;
+        }
+        return value;
+    }
+
+    private IllegalArgumentException error(String expected) {
+        String found = pos < end ? String.format("'%c'(0x%02x)", (char) (buf[pos] & 0xFF), buf[pos] & 0xFF) : "行尾";
+        return new IllegalArgumentException(String.format("第%d字节: 期望%s, 实际为%s", pos - start, expected, found));
+    }
+
+    private static boolean isSpace(byte b) {
+        return b == ' ' || b == '\t' || b == '\r' || b == '\n';
+    }
+
+    private static byte[] ascii(String s) {
+        return s.getBytes(StandardCharsets.US_ASCII);
+    }
+}
@@ -0,0 +1,136 @@
+package com.airdetection.udp;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.BitSet;
+import java.util.List;
+
+/**
+ * 单个转发端的日志序号水位
+ * 水位之前的记录均已收到（或因超出窗口而放弃），水位与最大序号之间用位图记录收到情况，
+ * 用于剔除重复的补发记录和生成缺失区间的补发请求
+ * 非线程安全，同一源地址的报文总是分配给同一个解析线程（IngestWorker），由该线程独占使用
+ */
+public class SequenceWatermark {
+
+    // 跟踪的序号窗口，大于ESP8266环形日志容量（256条）
+    public static final int WINDOW = 1024;
+
+    // 同一缺失记录最多请求的轮数，之后放弃（记录可能已被转发端覆盖）
+    public static final int MAX_ATTEMPTS = 3;
+
+    private final BitSet received = new BitSet(WINDOW);
+    private final long[] pastLimits = new long[MAX_ATTEMPTS]; // 最近几轮的请求上限
+    private int round = 0;
+    private int bootId = -1;
+    private long highest = -1;          // 已收到的最大序号
+    private long watermark = -1;        // 此序号及之前的记录无需再请求
+    private long requestLimit = -1;     // 上一轮请求时的最大序号，只请求缺失超过一轮的记录
+    private long lastSeen = 0;          // 最近一次收到有效记录的时间，IngestWorker据此淘汰不再活动的转发端
+
+    /**
+     * 登记收到的记录
+     * @return true - 新记录; false - 重复或已放弃的记录
+     */
+    public boolean accept(int bootId, long seq) {
+        if (bootId != this.bootId) {
+            // 转发端重启，日志序号重新开始
+            this.bootId = bootId;
+            received.clear();
+            highest = seq;
+            watermark = seq - 1;
+            requestLimit = seq;
+            Arrays.fill(pastLimits, -1);
+            received.set(index(seq));
+            advance();
+            return true;
+        }
+
+        if (seq > highest) {
+            if (seq - highest >= WINDOW) {
+                received.clear();
+            } else {
+                for (long s = highest + 1; s < seq; s++) {
+                    received.clear(index(s));
+                }
+            }
+            received.set(index(seq));
+            highest = seq;
+            watermark = Math.max(watermark, highest - WINDOW);
+            advance();
+            return true;
+        }
+
+        if (seq <= watermark || received.get(index(seq))) {
+            return false;
+        }
+        received.set(index(seq));
+        advance();
+        return true;
+    }
+
+    /**
+     * 取出本轮需要请求的缺失区间：仅包含上一轮时已缺失的记录，给转发端的主动补发留出时间
+     * @param maxRanges 最多返回的区间数
+     * @return 区间列表，每项为{起始序号, 条数}
+     */
+    public List<long[]> takeRequests(int maxRanges) {
+        List<long[]> ranges = new ArrayList<>();
+        long limit = Math.min(requestLimit, highest);
+        
+        // 已请求MAX_ATTEMPTS轮仍未收到的记录不再等待
+        long abandon = pastLimits[round % MAX_ATTEMPTS];
+        if (abandon > watermark) {
+            watermark = abandon;
+            advance();
+        }
+
+        long s = watermark + 1;
+
+        while (s <= limit && ranges.size() < maxRanges) {
+            if (received.get(index(s))) {
+                s++;
+                continue;
+            }
+            long from = s;
+            while (s <= limit && !received.get(index(s)) && s - from < LogRecord.MAX_REQUEST_COUNT) {
+                s++;
+            }
+            ranges.add(new long[]{from, s - from});
+        }
+        pastLimits[round % MAX_ATTEMPTS] = limit;
+        round++;
+        requestLimit = highest;
+        return ranges;
+    }
+
+    public int getBootId() {
+        return bootId;
+    }
+
+    public long getWatermark() {
+        return watermark;
+    }
+
+    public long getHighest() {
+        return highest;
+    }
+
+    public long getLastSeen() {
+        return lastSeen;
+    }
+
+    public void setLastSeen(long lastSeen) {
+        this.lastSeen = lastSeen;
+    }
+
+    private void advance() {
+        while (watermark < highest && received.get(index(watermark + 1))) {
+            watermark++;
+        }
+    }
+
+    private static int index(long seq) {
+        return (int) (seq % WINDOW);
+    }
+}
@@ -0,0 +1,117 @@
+package com.airdetection.udp;
+
+import com.airdetection.model.AirData;
+
+/**
+ * STM32二进制遥测帧解析
+ * 帧布局与固件 Core/Src/telemetry/telemetry.h 保持一致（固定32字节，小端字节序）
+ */
+public final class TelemetryFrame {
+
+    public static final int SYNC0 = 0xA5;
+    public static final int SYNC1 = 0x5A;
+    public static final int VERSION = 1;
+    public static final int FRAME_SIZE = 32;
+
+    // 字段有效位
+    public static final int VALID_HUMIDITY = 1;
+    public static final int VALID_TEMPERATURE = 1 << 1;
+    public static final int VALID_METHANE = 1 << 2;
+    public static final int VALID_TVOC = 1 << 3;
+    public static final int VALID_CO2 = 1 << 4;
+    public static final int VALID_PM25 = 1 << 5;
+
+    // 未设置设备ID（STM32和转发端都未填写，或文本格式数据）
+    public static final String UNKNOWN_DEVICE = "00000000";
+
+    private TelemetryFrame() {
+    }
+
+    /**
+     * 判断数据是否以遥测帧同步字开头
+     */
+    public static boolean isFrame(byte[] buf, int off, int len) {
+        return len >= 2 && (buf[off] & 0xFF) == SYNC0 && (buf[off + 1] & 0xFF) == SYNC1;
+    }
+
+    /**
+     * 解析一帧遥测数据，帧长度、版本或CRC不正确时抛出IllegalArgumentException
+     * 有效位未置位的字段（传感器读取失败、未校准）取NaN，存储和汇总据此跳过，不与真实的0混淆
+     */
+    public static AirData decode(byte[] buf, int off, int len) {
+        if (len < FRAME_SIZE || off < 0 || off + FRAME_SIZE > buf.length) {
+            throw new IllegalArgumentException("帧长度不足: " + len);
+        }
+        if (!isFrame(buf, off, len)) {
+            throw new IllegalArgumentException("同步字错误");
+        }
+        int version = u8(buf, off + 2);
+        int size = u8(buf, off + 3);
+        if (version != VERSION || size != FRAME_SIZE) {
+            throw new IllegalArgumentException("不支持的帧版本或长度: v" + version + ", " + size);
+        }
+        int crc = u16(buf, off + FRAME_SIZE - 2);
+        int expected = crc16(buf, off, FRAME_SIZE - 2);
+        if (crc != expected) {
+            throw new IllegalArgumentException(String.format("CRC校验失败: %04x != %04x", crc, expected));
+        }
+
+        int valid = u8(buf, off + 14);
+        return AirData.builder()
+                .deviceId(formatDeviceId(u32(buf, off + 6)))
+                .humidity((valid & VALID_HUMIDITY) != 0 ? u16(buf, off + 16) / 10.0 : Double.NaN)
+                .temperature((valid & VALID_TEMPERATURE) != 0 ? (short) u16(buf, off + 18) / 10.0 : Double.NaN)
+                .methane((valid & VALID_METHANE) != 0 ? u32(buf, off + 20) / 10.0 : Double.NaN)
+                .tvoc((valid & VALID_TVOC) != 0 ? u16(buf, off + 24) : Double.NaN)
+                .co2((valid & VALID_CO2) != 0 ? u16(buf, off + 26) : Double.NaN)
+                .pm25((valid & VALID_PM25) != 0 ? u16(buf, off + 28) / 10.0 : Double.NaN)
+                .timestamp(System.currentTimeMillis())
+                .build();
+    }
+
+    /**
+     * 读取帧序号
+     */
+    public static int sequence(byte[] buf, int off) {
+        return u16(buf, off + 4);
+    }
+
+    /**
+     * 设备ID格式化为8位小写十六进制，与ESP8266调试输出一致
+     */
+    public static String formatDeviceId(long id) {
+        char[] hex = new char[8];
+        for (int i = 7; i >= 0; i--) {
+            hex[i] = Character.forDigit((int) (id & 0xF), 16);
+            id >>>= 4;
+        }
+        return new String(hex);
+    }
+
+    /**
+     * CRC16-CCITT（多项式0x1021，初值0xFFFF）
+     */
+    public static int crc16(byte[] buf, int off, int len) {
+        int crc = 0xFFFF;
+        for (int i = off; i < off + len; i++) {
+            crc ^= (buf[i] & 0xFF) << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) != 0 ? (crc << 1) ^ 0x1021 : crc << 1;
+            }
+            crc &= 0xFFFF;
+        }
+        return crc;
+    }
+
+    private static int u8(byte[] buf, int pos) {
+        return buf[pos] & 0xFF;
+    }
+
+    private static int u16(byte[] buf, int pos) {
+        return (buf[pos] & 0xFF) | (buf[pos + 1] & 0xFF) << 8;
+    }
+
+    private static long u32(byte[] buf, int pos) {
+        return (u16(buf, pos) | (long) u16(buf, pos + 2) << 16) & 0xFFFFFFFFL;
+    }
+}
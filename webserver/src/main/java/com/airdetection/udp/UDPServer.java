@@ -1,6 +1,5 @@
 package com.airdetection.udp;
 
-import com.airdetection.model.AirData;
 import com.airdetection.service.DataService;
 import lombok.extern.slf4j.Slf4j;
 import org.springframework.beans.factory.annotation.Autowired;
@@ -9,66 +8,134 @@ import org.springframework.stereotype.Component;
 
 import javax.annotation.PostConstruct;
 import javax.annotation.PreDestroy;
-import java.net.DatagramPacket;
-import java.net.DatagramSocket;
-import java.nio.charset.StandardCharsets;
-import java.util.concurrent.ExecutorService;
+import java.io.IOException;
+import java.net.InetSocketAddress;
+import java.net.SocketAddress;
+import java.net.StandardSocketOptions;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.DatagramChannel;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
 import java.util.concurrent.Executors;
-import java.util.regex.Matcher;
-import java.util.regex.Pattern;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.TimeUnit;
 
+/**
+ * UDP接收流水线：接收线程 -> 有界无锁队列 -> 解析线程池
+ * 接收线程只做收包和按源地址分派，解析、去重和推送在解析线程中完成；
+ * 接收线程数大于1时以SO_REUSEPORT在同一端口打开多个通道，由内核按源地址分流
+ */
 @Slf4j
 @Component
 public class UDPServer {
     
+    // 最大报文长度，超过的部分被内核截断
+    private static final int MAX_DATAGRAM_SIZE = 2048;
+    // 吞吐统计的输出间隔
+    private static final long STATS_INTERVAL_S = 60;
+    
     @Value("${udp.server.port:8080}")
     private int port;
     
-    private DatagramSocket socket;
-    private boolean running = false;
-    private ExecutorService executorService;
+    @Value("${udp.server.receivers:1}")
+    private int receiverCount;
+    
+    @Value("${udp.server.workers:0}")
+    private int workerCount;
     
-    // 定义正则表达式模式匹配STM32发送的数据格式，支持负数和小数
-    private static final Pattern DATA_PATTERN = Pattern.compile(
-        "Humidity: (\\d+\\.\\d+)%, Temperature: (\\d+\\.\\d+) C, " +
-        "Methane: (-?\\d+\\.\\d+) ppm, TVOC: (\\d+) ppb, CO2eq: (\\d+) ppm, " +
-        "Dust\\(PM2\\.5\\): (\\d+\\.\\d+) ug/m\\^3"
-    );
+    @Value("${udp.server.queue-capacity:4096}")
+    private int queueCapacity;
+    
+    @Value("${udp.server.receive-buffer:4194304}")
+    private int receiveBuffer;
     
     @Autowired
     private DataService dataService;
     
+    private final IngestStats stats = new IngestStats();
+    private final List<DatagramChannel> channels = new ArrayList<>();
+    private IngestWorker[] workers;
+    private ScheduledExecutorService statsExecutor;
+    private volatile boolean running = false;
+    
+    // 上一次输出统计时的计数，仅由统计线程访问
+    private long lastReceived = 0;
+    private long lastPublished = 0;
+    
     @PostConstruct
     public void start() {
         try {
-            socket = new DatagramSocket(port);
+            int receivers = Math.max(1, receiverCount);
+            int workerThreads = workerCount > 0 ? workerCount : Runtime.getRuntime().availableProcessors();
+            
+            for (int i = 0; i < receivers; i++) {
+                channels.add(openChannel(receivers > 1));
+            }
             running = true;
-            executorService = Executors.newSingleThreadExecutor();
-            executorService.execute(this::receiveData);
-            log.info("UDP服务器已启动，监听端口: {}", port);
+            
+            workers = new IngestWorker[workerThreads];
+            for (int i = 0; i < workerThreads; i++) {
+                workers[i] = new IngestWorker(queueCapacity, dataService, stats, channels.get(0));
+                startThread(workers[i], "udp-worker-" + i);
+            }
+            for (int i = 0; i < receivers; i++) {
+                DatagramChannel channel = channels.get(i);
+                startThread(() -> receiveData(channel), "udp-receiver-" + i);
+            }
+            
+            statsExecutor = Executors.newSingleThreadScheduledExecutor();
+            statsExecutor.scheduleAtFixedRate(this::logStats, STATS_INTERVAL_S, STATS_INTERVAL_S, TimeUnit.SECONDS);
+            
+            log.info("UDP服务器已启动，监听端口: {}，接收线程{}个，解析线程{}个，队列容量{}，接收缓冲区{}字节",
+                    port, receivers, workerThreads, workers[0].getQueue().capacity(),
+                    channels.get(0).getOption(StandardSocketOptions.SO_RCVBUF));
         } catch (Exception e) {
             log.error("UDP服务器启动失败: {}", e.getMessage(), e);
         }
     }
     
-    private void receiveData() {
-        byte[] buffer = new byte[1024];
-        DatagramPacket packet = new DatagramPacket(buffer, buffer.length);
+    private DatagramChannel openChannel(boolean reusePort) throws IOException {
+        DatagramChannel channel = DatagramChannel.open();
+        if (reusePort) {
+            channel.setOption(StandardSocketOptions.SO_REUSEPORT, true);
+        }
+        // 内核实际取值受net.core.rmem_max限制
+        channel.setOption(StandardSocketOptions.SO_RCVBUF, receiveBuffer);
+        channel.bind(new InetSocketAddress(port));
+        channel.configureBlocking(true);
+        return channel;
+    }
+    
+    private void startThread(Runnable task, String name) {
+        Thread thread = new Thread(task, name);
+        thread.setDaemon(true);
+        thread.start();
+    }
+    
+    // 接收线程：收包后复制为独立的报文，按源地址交给固定的解析线程，队列满时丢弃
+    private void receiveData(DatagramChannel channel) {
+        ByteBuffer buffer = ByteBuffer.allocateDirect(MAX_DATAGRAM_SIZE);
         
         while (running) {
             try {
-                socket.receive(packet);
-                String data = new String(packet.getData(), 0, packet.getLength(), StandardCharsets.UTF_8);
-                log.info("收到数据: {}", data);
+                buffer.clear();
+                SocketAddress source = channel.receive(buffer);
+                buffer.flip();
                 
-                // 解析数据并通知服务
-                AirData airData = parseData(data);
-                if (airData != null) {
-                    dataService.processNewData(airData);
-                }
+                int length = buffer.remaining();
+                byte[] data = new byte[length];
+                buffer.get(data);
+                stats.received.increment();
+                stats.receivedBytes.add(length);
                 
-                // 重置packet长度，准备接收下一个数据包
-                packet.setLength(buffer.length);
+                IngestWorker worker = workers[Math.floorMod(source.hashCode(), workers.length)];
+                if (!worker.getQueue().offer(new ReceivedPacket(data, length, source))) {
+                    stats.queueDrops.increment();
+                }
+            } catch (ClosedChannelException e) {
+                break;
             } catch (Exception e) {
                 if (running) {
                     log.error("接收数据出错: {}", e.getMessage(), e);
@@ -77,46 +144,55 @@ public class UDPServer {
         }
     }
     
-    // 解析接收到的数据字符串为AirData对象
-    private AirData parseData(String data) {
-        try {
-            Matcher matcher = DATA_PATTERN.matcher(data);
-            if (matcher.find()) {
-                // 提取各个匹配组的数据
-                double humidity = Double.parseDouble(matcher.group(1));
-                double temperature = Double.parseDouble(matcher.group(2));
-                double methane = Double.parseDouble(matcher.group(3));
-                double tvoc = Double.parseDouble(matcher.group(4));
-                double co2 = Double.parseDouble(matcher.group(5));
-                double pm25 = Double.parseDouble(matcher.group(6));
-                
-                return AirData.builder()
-                        .humidity(humidity)
-                        .temperature(temperature)
-                        .methane(methane)
-                        .tvoc(tvoc)
-                        .co2(co2)
-                        .pm25(pm25)
-                        .timestamp(System.currentTimeMillis())
-                        .build();
-            } else {
-                log.warn("数据格式不匹配: {}", data);
+    // 定期输出各阶段吞吐和丢弃计数
+    private void logStats() {
+        Map<String, Long> snapshot = stats.snapshot();
+        long received = snapshot.get("received");
+        long published = snapshot.get("published");
+        int queued = 0;
+        for (IngestWorker worker : workers) {
+            queued += worker.getQueue().size();
+        }
+        log.info("UDP接收: {}包/秒，发布: {}点/秒，排队{}，累计{}",
+                (received - lastReceived) / STATS_INTERVAL_S, (published - lastPublished) / STATS_INTERVAL_S,
+                queued, snapshot);
+        lastReceived = received;
+        lastPublished = published;
+    }
+    
+    /**
+     * 接收流水线计数快照
+     */
+    public Map<String, Long> getStats() {
+        Map<String, Long> snapshot = stats.snapshot();
+        long queued = 0;
+        if (workers != null) {
+            for (IngestWorker worker : workers) {
+                queued += worker.getQueue().size();
             }
-        } catch (Exception e) {
-            log.error("解析数据出错: {}", e.getMessage(), e);
         }
-        return null;
+        snapshot.put("queued", queued);
+        return snapshot;
     }
     
     @PreDestroy
     public void stop() {
         running = false;
-        if (socket != null && !socket.isClosed()) {
-            socket.close();
+        for (DatagramChannel channel : channels) {
+            try {
+                channel.close();
+            } catch (IOException e) {
+                log.warn("关闭UDP通道失败: {}", e.getMessage());
+            }
+        }
+        if (workers != null) {
+            for (IngestWorker worker : workers) {
+                worker.stop();
+            }
         }
-        if (executorService != null) {
-            executorService.shutdown();
+        if (statsExecutor != null) {
+            statsExecutor.shutdown();
         }
         log.info("UDP服务器已关闭");
     }
-} 
\ No newline at end of file
+}